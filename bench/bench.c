@@ -0,0 +1,1102 @@
+/**
+ * JConf Benchmark Suite
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Measures parsing, validation, lookup, iteration and freeing over a
+ *              generated corpus, along with map and array micro-operations.
+ *              Results are printed as CSV so runs from different versions
+ *              can be diffed:
+ *
+ *                  corpus,op,bytes,ops,seconds,mb_s,ops_s,allocs_op,peak_heap,peak_rss_kb
+ *
+ *              Allocations are counted by installing a counting allocator as
+ *              the default allocator; allocs_op counts malloc and realloc
+ *              calls, peak_heap is the growth in live bytes during the
+ *              measurement and peak_rss_kb is the process peak so far.
+ *              The messages corpus compares parsing many small documents one
+ *              call at a time against jconf_parse_batch, and extracting them
+ *              into structs from a tree against jconf_bind_decode. The patch corpus
+ *              edits the wide document with a compiled JSON Patch against
+ *              reparsing it with the edit made, and the diff and equal corpora
+ *              compare documents with a copy that has one value changed. The
+ *              merge corpus overlays a small config on a large one, against
+ *              deep copying the large one. An optional argument
+ *              restricts the run to corpora whose name contains it.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/parser.h>
+#include <jconf/batch.h>
+#include <jconf/bind.h>
+#include <jconf/patch.h>
+#include <jconf/diff.h>
+#include <jconf/hash.h>
+#include <jconf/merge.h>
+#include <sys/resource.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+// Every benchmark repeats until it has run for this long.
+#define MIN_SECONDS    0.25
+#define MIN_ITERATIONS 3
+
+// Micro-operation sizes.
+#define MICRO_ELEMENTS 100000
+#define MICRO_KEYS     10000
+
+// Message batch sizes.
+#define MESSAGES        10000
+#define MESSAGE_SIZE    512
+#define MESSAGE_THREADS 4
+
+// Generated corpus definition.
+typedef struct _bench_corpus
+{
+    const char* name;
+    char* (*generate)(int*);
+    long (*lookup)(const jToken*);
+    int has_comments;       // Not valid strict input.
+
+} BenchCorpus;
+
+// Messages bound to structs.
+typedef struct _bench_item
+{
+    char* sku;
+    int qty;
+    double price;
+
+} BenchItem;
+
+typedef struct _bench_user
+{
+    char* name;
+    char* email;
+
+} BenchUser;
+
+typedef struct _bench_order
+{
+    int id;
+    char* type;
+    BenchUser user;
+    BenchItem* items;
+    size_t item_count;
+    int64_t ts;
+    int paid;
+
+} BenchOrder;
+
+static jBindField bench_item_fields[] = {
+    JCONF_BIND_FIELD(BenchItem, sku, JCONF_BIND_STRING),
+    JCONF_BIND_FIELD(BenchItem, qty, JCONF_BIND_INT),
+    JCONF_BIND_FIELD(BenchItem, price, JCONF_BIND_DOUBLE)
+};
+static jBindDesc bench_item_desc = JCONF_BIND_DESC(BenchItem, bench_item_fields);
+
+static jBindField bench_user_fields[] = {
+    JCONF_BIND_FIELD(BenchUser, name, JCONF_BIND_STRING),
+    JCONF_BIND_FIELD(BenchUser, email, JCONF_BIND_STRING)
+};
+static jBindDesc bench_user_desc = JCONF_BIND_DESC(BenchUser, bench_user_fields);
+
+static jBindField bench_order_fields[] = {
+    JCONF_BIND_FIELD(BenchOrder, id, JCONF_BIND_INT),
+    JCONF_BIND_FIELD(BenchOrder, type, JCONF_BIND_STRING),
+    JCONF_BIND_OBJECT_FIELD(BenchOrder, user, &bench_user_desc),
+    JCONF_BIND_ARRAY_FIELD(BenchOrder, items, item_count, JCONF_BIND_OBJECT, &bench_item_desc),
+    JCONF_BIND_FIELD(BenchOrder, ts, JCONF_BIND_INT64),
+    JCONF_BIND_FIELD(BenchOrder, paid, JCONF_BIND_BOOL)
+};
+static jBindDesc bench_order_desc = JCONF_BIND_DESC(BenchOrder, bench_order_fields);
+
+// Allocation counters (every JConf allocation goes through the counting allocator).
+static jAllocator    bench_allocator;
+static jAllocCounter bench_counter;
+
+/**
+ * Now
+ *
+ * Description: Returns a monotonic timestamp in seconds.
+ */
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Begin
+ *
+ * Description: Resets the allocation counters before a measurement.
+ */
+static void begin(void)
+{
+    bench_counter.allocs = bench_counter.reallocs = 0;
+    bench_counter.peak = bench_counter.live;
+}
+
+/**
+ * Report
+ *
+ * Description: Prints a result row.
+ *
+ * @param {corpus}[out]  // The corpus name.
+ * @param {op}[out]      // The operation name.
+ * @param {bytes}[out]   // The number of input bytes per operation (0 if none).
+ * @param {ops}[out]     // The number of operations.
+ * @param {elapsed}[out] // The total elapsed time.
+ * @param {base}[out]    // The live heap bytes before the measurement.
+ */
+static void report(const char* corpus, const char* op, size_t bytes, long ops, double elapsed, size_t base)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("%s,%s,%lu,%ld,%.6f,%.2f,%.1f,%.2f,%lu,%ld\n", corpus, op,
+        (unsigned long)bytes, ops, elapsed,
+        bytes * (double)ops / elapsed / (1024.0 * 1024.0),
+        ops / elapsed,
+        (double)(bench_counter.allocs + bench_counter.reallocs) / ops,
+        (unsigned long)(bench_counter.peak - base),
+        (long)usage.ru_maxrss);
+}
+
+/**
+ * Load File
+ *
+ * Description: Loads a file into a dynamically allocated buffer.
+ *
+ * @param {resc}[out] // The source path.
+ * @param {len}[in]   // The length of the buffer.
+ * @returns           // The file content in a char buffer.
+ */
+static char* load_file(const char* resc, int* len)
+{
+    char* buffer;
+    FILE* file;
+    long length;
+
+    if ((file = fopen(resc, "rb")) == NULL)
+        return NULL;
+
+    fseek(file, 0L, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0L, SEEK_SET);
+
+    buffer = (char*)malloc(length + 1);
+    length = fread(buffer, 1, length, file);
+    buffer[length] = 0;
+
+    fclose(file);
+    *len = (int)length;
+    return buffer;
+}
+
+/**
+ * Corpus Generators
+ *
+ * Description: Each generator returns a JSON document and its length.
+ */
+static char* generate_numbers(int* len)
+{
+    char* json = (char*)malloc(200000 * 24 + 3);
+    int i, n = sprintf(json, "[");
+
+    for (i = 0; i < 200000; i++)
+    {
+        if (i % 3 == 0)
+            n += sprintf(json + n, "%s%d", i ? "," : "", i * 7919);
+        else if (i % 3 == 1)
+            n += sprintf(json + n, ",-%d.%04d", i, i % 9973);
+        else
+            n += sprintf(json + n, ",%d.5e%d", i % 100, i % 12);
+    }
+
+    n += sprintf(json + n, "]");
+    *len = n;
+    return json;
+}
+
+static char* generate_strings(int* len)
+{
+    char* json = (char*)malloc(50000 * 64 + 3);
+    int i, n = sprintf(json, "[");
+
+    for (i = 0; i < 50000; i++)
+    {
+        n += sprintf(json + n, i % 4 == 0 ? "%s\"line %d\\nquoted \\\"text\\\" caf\\u00e9\"" :
+            "%s\"the quick brown fox jumps over %d lazy dogs\"", i ? "," : "", i);
+    }
+
+    n += sprintf(json + n, "]");
+    *len = n;
+    return json;
+}
+
+static char* generate_deep(int* len)
+{
+    char* json = (char*)malloc(200 * (128 * 9 + 8) + 3);
+    int i, j, n = sprintf(json, "[");
+
+    for (i = 0; i < 200; i++)
+    {
+        n += sprintf(json + n, "%s", i ? "," : "");
+        for (j = 0; j < 128; j++)
+            n += sprintf(json + n, "{\"a\":[");
+        n += sprintf(json + n, "%d", i);
+        for (j = 0; j < 128; j++)
+            n += sprintf(json + n, "]}");
+    }
+
+    n += sprintf(json + n, "]");
+    *len = n;
+    return json;
+}
+
+static char* generate_wide(int* len)
+{
+    char* json = (char*)malloc(20000 * 24 + 3);
+    int i, n = sprintf(json, "{");
+
+    for (i = 0; i < 20000; i++)
+        n += sprintf(json + n, "%s\"key_%05d\":%d", i ? "," : "", i, i);
+
+    n += sprintf(json + n, "}");
+    *len = n;
+    return json;
+}
+
+static char* generate_file(int* len)
+{
+    return load_file("test/test_two.json", len);
+}
+
+/**
+ * Corpus Lookups
+ *
+ * Description: Each lookup reads every leaf through jconf_get and returns the
+ *              number of calls.
+ */
+static long lookup_array(const jToken* root)
+{
+    int i, n = ((jArray*)root->data)->end;
+
+    for (i = 0; i < n; i++)
+        if (jconf_get(root, "a", i) == NULL)
+            return 0;
+
+    return n;
+}
+
+static long lookup_deep(const jToken* root)
+{
+    const jToken* token;
+    long calls = 0;
+    int i, n = ((jArray*)root->data)->end;
+
+    for (i = 0; i < n; i++)
+    {
+        for (token = jconf_get(root, "a", i); token->type == JCONF_OBJECT; calls++)
+            token = jconf_get(token, "oa", "a", 0);
+    }
+
+    return calls;
+}
+
+static long lookup_wide(const jToken* root)
+{
+    char key[16];
+    int i;
+
+    for (i = 0; i < 20000; i++)
+    {
+        sprintf(key, "key_%05d", i);
+        if (jconf_get(root, "o", key) == NULL)
+            return 0;
+    }
+
+    return i;
+}
+
+static long lookup_file(const jToken* root)
+{
+    int i, n = ((jArray*)root->data)->end;
+
+    for (i = 0; i < n; i++)
+    {
+        if (jconf_get(root, "ao", i, "_id") == NULL ||
+            jconf_get(root, "aoao", i, "friends", 0, "name") == NULL)
+            return 0;
+    }
+
+    return 2 * n;
+}
+
+/**
+ * Walk
+ *
+ * Description: Visits every token of a tree with the iterators.
+ *
+ * @param {token}[out] // The root token.
+ * @returns            // The number of tokens visited.
+ */
+static long walk(const jToken* token)
+{
+    jObjectIter members;
+    jArrayIter elements;
+    jToken* value;
+    long count = 1;
+
+    jconf_object_iter_begin(token, &members);
+    while (jconf_object_iter_next(&members, NULL, NULL, &value))
+        count += walk(value);
+
+    jconf_array_iter_begin(token, &elements);
+    while (jconf_array_iter_next(&elements, &value))
+        count += walk(value);
+
+    return count;
+}
+
+/**
+ * Bench Parse
+ *
+ * Description: Measures parsing a corpus in one mode.
+ *
+ * @param {corpus}[out] // The corpus.
+ * @param {json}[out]   // The corpus text.
+ * @param {length}[out] // The length of the text.
+ * @param {mode}[out]   // The parse mode.
+ * @param {op}[out]     // The name of the operation.
+ * @returns             // The number of parses ('0' on error).
+ */
+static long bench_parse(const BenchCorpus* corpus, const char* json, int length, jParseMode mode, const char* op)
+{
+    jParseOptions options;
+    double start, elapsed;
+    jToken* token;
+    size_t base;
+    jArgs args;
+    long n;
+
+    options.allocator = NULL;
+    options.stats = NULL;
+    options.duplicates = JCONF_DUP_LAST_WINS;
+    options.mode = mode;
+    options.hash = 0;
+
+    // Parse (trees are kept alive so the peak includes a single document).
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+    {
+        if ((token = jconf_json2c_ex(json, length, &options, &args)) == NULL)
+        {
+            fprintf(stderr, "%s: %s error %d on line %zu.\n", corpus->name, op, args.e, args.line);
+            return 0;
+        }
+        jconf_free_token(token);
+    }
+    elapsed = now() - start;
+    report(corpus->name, op, length, n, elapsed, base);
+    return n;
+}
+
+/**
+ * Bench Corpus
+ *
+ * Description: Measures parse (in the default and strict modes), validation,
+ *              lookup, iteration and free for one corpus. Corpora with comments are
+ *              not valid strict input and skip the strict parse.
+ *
+ * @param {corpus}[out] // The corpus.
+ */
+static int bench_corpus(const BenchCorpus* corpus)
+{
+    jToken** tokens;
+    double start, elapsed;
+    long i, n, calls;
+    size_t base;
+    jArgs args;
+    char* json;
+    int length;
+
+    if ((json = corpus->generate(&length)) == NULL)
+    {
+        fprintf(stderr, "%s: failed to load the corpus.\n", corpus->name);
+        return 0;
+    }
+
+    if ((n = bench_parse(corpus, json, length, JCONF_MODE_DEFAULT, "parse")) == 0)
+    {
+        free(json);
+        return 0;
+    }
+
+    if (!corpus->has_comments)
+        bench_parse(corpus, json, length, JCONF_MODE_STRICT, "parse_strict");
+
+    // Validate (no tree is built).
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (i = 0; i < MIN_ITERATIONS || now() - start < MIN_SECONDS; i++)
+        jconf_validate(json, length, JCONF_MODE_DEFAULT, &args);
+    elapsed = now() - start;
+    report(corpus->name, "validate", length, i, elapsed, base);
+
+    // Lookup.
+    tokens = (jToken**)malloc(sizeof(jToken*) * n);
+    tokens[0] = jconf_json2c(json, length, &args);
+
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (i = 0, calls = 0; i < MIN_ITERATIONS || now() - start < MIN_SECONDS; i++)
+        calls += corpus->lookup(tokens[0]);
+    elapsed = now() - start;
+    report(corpus->name, "jconf_get", 0, calls, elapsed, base);
+
+    // Iterate.
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (i = 0, calls = 0; i < MIN_ITERATIONS || now() - start < MIN_SECONDS; i++)
+        calls += walk(tokens[0]);
+    elapsed = now() - start;
+    report(corpus->name, "iterate", 0, calls, elapsed, base);
+
+    // Free (the same number of trees as parsed, released in one timed pass).
+    for (i = 1; i < n; i++)
+        tokens[i] = jconf_json2c(json, length, &args);
+
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (i = 0; i < n; i++)
+        jconf_free_token(tokens[i]);
+    elapsed = now() - start;
+    report(corpus->name, "free", length, n, elapsed, base);
+
+    free(tokens);
+    free(json);
+    return 1;
+}
+
+/**
+ * Bench Micro
+ *
+ * Description: Measures map and array operations outside the parser.
+ */
+static void bench_micro(void)
+{
+    static char keys[MICRO_KEYS][16];
+    double start;
+    long i, n, ops;
+    size_t base;
+    jArray arr;
+    jMap map;
+    int j;
+
+    for (j = 0; j < MICRO_KEYS; j++)
+        sprintf(keys[j], "key_%05d", j);
+
+    // Array push.
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0, ops = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+    {
+        jconf_init_array(&arr, 1, 2);
+        for (j = 0; j < MICRO_ELEMENTS; j++)
+            jconf_array_push(&arr, (void*)keys);
+        jconf_destroy_array(&arr);
+        ops += MICRO_ELEMENTS;
+    }
+    report("micro", "array_push", 0, ops, now() - start, base);
+
+    // Array get.
+    jconf_init_array(&arr, MICRO_ELEMENTS, 2);
+    for (j = 0; j < MICRO_ELEMENTS; j++)
+        jconf_array_push(&arr, (void*)keys);
+
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0, ops = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+    {
+        for (j = 0; j < MICRO_ELEMENTS; j++)
+            if (jconf_array_get(&arr, j) == NULL)
+                break;
+        ops += j;
+    }
+    report("micro", "array_get", 0, ops, now() - start, base);
+    jconf_destroy_array(&arr);
+
+    // Map set.
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0, ops = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+    {
+        jconf_init_map(&map);
+        for (j = 0; j < MICRO_KEYS; j++)
+            jconf_map_set(&map, keys[j], jconf_strlen(keys[j]), (void*)keys, NULL);
+        jconf_destroy_map(&map);
+        ops += MICRO_KEYS;
+    }
+    report("micro", "map_set", 0, ops, now() - start, base);
+
+    // Map get.
+    jconf_init_map(&map);
+    for (j = 0; j < MICRO_KEYS; j++)
+        jconf_map_set(&map, keys[j], jconf_strlen(keys[j]), (void*)keys, NULL);
+
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (i = 0, ops = 0; i < MIN_ITERATIONS || now() - start < MIN_SECONDS; i++)
+    {
+        for (j = 0; j < MICRO_KEYS; j++)
+            if (jconf_map_get(&map, keys[j]) == NULL)
+                break;
+        ops += j;
+    }
+    report("micro", "map_get", 0, ops, now() - start, base);
+    jconf_destroy_map(&map);
+}
+
+/**
+ * Copy String
+ *
+ * Description: Copies a string token the way jconf_bind_decode stores it.
+ *
+ * @param {token}[out] // The token.
+ * @returns            // The copy (NULL for a missing token).
+ */
+static char* copy_string(const jToken* token)
+{
+    size_t length;
+    char* copy;
+
+    if (token == NULL || token->type != JCONF_STRING)
+        return NULL;
+
+    length = strlen((const char*)token->data);
+    copy = (char*)jconf_malloc(NULL, length + 1);
+    memcpy(copy, token->data, length + 1);
+    return copy;
+}
+
+/**
+ * Extract Order
+ *
+ * Description: Extracts an order from a parsed message with jconf_get.
+ *
+ * @param {root}[out]  // The message.
+ * @param {order}[in]  // The order.
+ */
+static void extract_order(const jToken* root, BenchOrder* order)
+{
+    const jToken *items, *item;
+    size_t i;
+
+    memset(order, 0, sizeof(*order));
+    order->id = (int)strtol((const char*)jconf_get(root, "o", "id")->data, NULL, 10);
+    order->type = copy_string(jconf_get(root, "o", "type"));
+    order->user.name = copy_string(jconf_get(root, "oo", "user", "name"));
+    order->user.email = copy_string(jconf_get(root, "oo", "user", "email"));
+    order->ts = strtoll((const char*)jconf_get(root, "o", "ts")->data, NULL, 10);
+    order->paid = jconf_get(root, "o", "paid")->type == JCONF_TRUE;
+
+    items = jconf_get(root, "o", "items");
+    order->item_count = ((const jArray*)items->data)->end;
+    order->items = (BenchItem*)jconf_malloc(NULL, order->item_count * sizeof(BenchItem));
+
+    for (i = 0; i < order->item_count; i++)
+    {
+        item = (const jToken*)jconf_array_get((const jArray*)items->data, i);
+        order->items[i].sku = copy_string(jconf_get(item, "o", "sku"));
+        order->items[i].qty = (int)strtol((const char*)jconf_get(item, "o", "qty")->data, NULL, 10);
+        order->items[i].price = strtod((const char*)jconf_get(item, "o", "price")->data, NULL);
+    }
+}
+
+/**
+ * Bench Messages
+ *
+ * Description: Measures parsing many small messages with individual calls
+ *              and with batches (into one context, and across threads with a
+ *              context each). Batches reset their contexts before each run.
+ *              Orders are then extracted into structs from trees and with
+ *              jconf_bind_decode, and encoded with jconf_bind_encode.
+ */
+static void bench_messages(void)
+{
+    static char messages[MESSAGES][MESSAGE_SIZE];
+    static jInput inputs[MESSAGES];
+    static jDocument docs[MESSAGES];
+    jParserContext contexts[MESSAGE_THREADS];
+    jBatchOptions options;
+    size_t bytes, base, size;
+    BenchOrder order;
+    jToken* token;
+    double start;
+    long n, ops, sum;
+    char* text;
+    jArgs args;
+    int i, t;
+
+    for (i = 0, bytes = 0; i < MESSAGES; i++)
+    {
+        inputs[i].buffer = messages[i];
+        inputs[i].size = sprintf(messages[i],
+            "{\"id\": %d, \"type\": \"order\", \"user\": {\"name\": \"user_%05d\", \"email\": \"user_%05d@example.com\"}, "
+            "\"items\": [{\"sku\": \"A-%d\", \"qty\": 2, \"price\": 9.99}, {\"sku\": \"B-%d\", \"qty\": 1, \"price\": 24.5}], "
+            "\"ts\": 1700000000, \"paid\": true, \"note\": null}", i, i, i, i % 97, i % 89);
+        bytes += inputs[i].size;
+    }
+    bytes /= MESSAGES;
+
+    // Individual calls.
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0, ops = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++, ops += MESSAGES)
+    {
+        for (i = 0; i < MESSAGES; i++)
+        {
+            token = jconf_json2c(inputs[i].buffer, inputs[i].size, &args);
+            jconf_free_token(token);
+        }
+    }
+    report("messages", "json2c_loop", bytes, ops, now() - start, base);
+
+    for (t = 0; t < MESSAGE_THREADS; t++)
+        jconf_init_context(&contexts[t], 0);
+
+    options.parse.allocator = NULL;
+    options.parse.stats = NULL;
+    options.parse.duplicates = JCONF_DUP_LAST_WINS;
+    options.parse.mode = JCONF_MODE_DEFAULT;
+    options.parse.hash = 0;
+    options.contexts = contexts;
+
+    for (options.threads = 1; options.threads <= MESSAGE_THREADS; options.threads *= MESSAGE_THREADS)
+    {
+        // Warm the contexts (the counting allocator is not thread safe).
+        jconf_parse_batch(inputs, MESSAGES, docs, NULL, &options);
+
+        base = bench_counter.live;
+        begin();
+        start = now();
+        for (n = 0, ops = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++, ops += MESSAGES)
+        {
+            for (t = 0; t < MESSAGE_THREADS; t++)
+                jconf_context_reset(&contexts[t]);
+
+            if (jconf_parse_batch(inputs, MESSAGES, docs, NULL, &options) != MESSAGES)
+                fprintf(stderr, "messages: batch error.\n");
+        }
+        report("messages", options.threads == 1 ? "parse_batch" : "parse_batch_threads", bytes, ops, now() - start, base);
+    }
+
+    for (t = 0; t < MESSAGE_THREADS; t++)
+        jconf_destroy_context(&contexts[t]);
+
+    // Structs extracted from trees.
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0, ops = 0, sum = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++, ops += MESSAGES)
+    {
+        for (i = 0; i < MESSAGES; i++)
+        {
+            token = jconf_json2c(inputs[i].buffer, inputs[i].size, &args);
+            extract_order(token, &order);
+            jconf_free_token(token);
+
+            if (n == 0)
+                sum += order.id + order.items[1].qty;
+            jconf_bind_free(&bench_order_desc, &order, NULL);
+        }
+    }
+    report("messages", "tree_extract", bytes, ops, now() - start, base);
+
+    // Structs decoded directly.
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0, ops = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++, ops += MESSAGES)
+    {
+        for (i = 0; i < MESSAGES; i++)
+        {
+            if (!jconf_bind_decode(&bench_order_desc, inputs[i].buffer, inputs[i].size, &order, NULL, &args))
+                fprintf(stderr, "messages: bind error %d.\n", args.e);
+
+            if (n == 0)
+                sum -= order.id + order.items[1].qty;
+            jconf_bind_free(&bench_order_desc, &order, NULL);
+        }
+    }
+    report("messages", "bind_decode", bytes, ops, now() - start, base);
+
+    if (sum != 0)
+        fprintf(stderr, "messages: bound orders differ from the tree.\n");
+
+    jconf_bind_decode(&bench_order_desc, inputs[0].buffer, inputs[0].size, &order, NULL, &args);
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0, ops = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++, ops += MESSAGES)
+    {
+        for (i = 0; i < MESSAGES; i++)
+        {
+            text = jconf_bind_encode(&bench_order_desc, &order, &size);
+            jconf_free(NULL, text);
+        }
+    }
+    report("messages", "bind_encode", bytes, ops, now() - start, base);
+    jconf_bind_free(&bench_order_desc, &order, NULL);
+}
+
+/**
+ * Bench Patch
+ *
+ * Description: Measures resolving a compiled pointer and applying a small
+ *              compiled patch to the wide corpus in place, against parsing
+ *              the whole document again.
+ */
+static void bench_patch(void)
+{
+    static const char patch_json[] =
+        "[{\"op\": \"replace\", \"path\": \"/key_04242\", \"value\": 1},"
+        " {\"op\": \"add\", \"path\": \"/new\", \"value\": [1, 2]},"
+        " {\"op\": \"test\", \"path\": \"/new/1\", \"value\": 2},"
+        " {\"op\": \"remove\", \"path\": \"/new\"}]";
+
+    jToken *root, *head, *token;
+    jPointer pointer;
+    double start;
+    jPatch* patch;
+    long n, found;
+    size_t base;
+    jArgs args;
+    char* json;
+    int length;
+
+    json = generate_wide(&length);
+    root = jconf_json2c(json, length, &args);
+    head = jconf_json2c(patch_json, sizeof(patch_json) - 1, &args);
+    patch = jconf_patch_compile(head, NULL);
+    jconf_pointer_compile(&pointer, "/key_04242", 10);
+
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0, found = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+        found += jconf_pointer_get(root, &pointer) != NULL;
+    report("patch", "pointer_get", 0, n, now() - start, base);
+
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+    {
+        if (!jconf_patch_apply(patch, &root, NULL, NULL))
+        {
+            fprintf(stderr, "patch: the patch failed.\n");
+            break;
+        }
+    }
+    report("patch", "apply", 0, n, now() - start, base);
+
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+    {
+        token = jconf_json2c(json, length, &args);
+        jconf_free_token(token);
+    }
+    report("patch", "reparse", length, n, now() - start, base);
+
+    if (found != 0 && jconf_pointer_get(root, &pointer) == NULL)
+        fprintf(stderr, "patch: the pointer no longer resolves.\n");
+
+    jconf_pointer_free(&pointer);
+    jconf_patch_free(patch);
+    jconf_free_token(head);
+    jconf_free_token(root);
+    free(json);
+}
+
+/**
+ * Bench Diff
+ *
+ * Description: Measures diffing a corpus against a copy with one value
+ *              changed, when the copy is new (its hashes are computed, as
+ *              when a config is reloaded) and when it was compared before.
+ *              Allocations of the _new rows include making the copies.
+ *
+ * @param {name}[out]      // The name of the rows.
+ * @param {generate}[out]  // The corpus generator.
+ * @param {edit_json}[out] // A patch that changes one value.
+ */
+static void bench_diff(const char* name, char* (*generate)(int*), const char* edit_json)
+{
+    jToken *root, *head, *copy, *patch;
+    double start, elapsed;
+    char op[64];
+    jPatch* edit;
+    size_t base;
+    jArgs args;
+    char* json;
+    int length;
+    long n;
+
+    json = generate(&length);
+    root = jconf_json2c(json, length, &args);
+    head = jconf_json2c(edit_json, jconf_strlen(edit_json), &args);
+    edit = jconf_patch_compile(head, NULL);
+
+    base = bench_counter.live;
+    begin();
+    for (n = 0, elapsed = 0; n < MIN_ITERATIONS || elapsed < MIN_SECONDS; n++)
+    {
+        copy = jconf_copy_token(root);
+        jconf_patch_apply(edit, &copy, NULL, NULL);
+
+        start = now();
+        patch = jconf_diff(root, copy, NULL);
+        elapsed += now() - start;
+
+        if (patch == NULL || patch->data == NULL || ((jArray*)patch->data)->end != 1)
+            fprintf(stderr, "diff: the %s patch has the wrong changes.\n", name);
+
+        jconf_free_token(patch);
+        jconf_free_token(copy);
+    }
+    sprintf(op, "%s_new", name);
+    report("diff", op, length, n, elapsed, base);
+
+    copy = jconf_copy_token(root);
+    jconf_patch_apply(edit, &copy, NULL, NULL);
+    jconf_free_token(jconf_diff(root, copy, NULL));
+
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+        jconf_free_token(jconf_diff(root, copy, NULL));
+    sprintf(op, "%s_hashed", name);
+    report("diff", op, length, n, now() - start, base);
+
+    jconf_free_token(copy);
+    jconf_patch_free(edit);
+    jconf_free_token(head);
+    jconf_free_token(root);
+    free(json);
+}
+
+/**
+ * Bench Equal
+ *
+ * Description: Measures comparing a corpus with a copy that has one value
+ *              changed, parsed without hashes (every value is visited up to
+ *              the change) and with jParseOptions.hash (the digests of the
+ *              roots differ), and what hashing adds to the parse.
+ *
+ * @param {name}[out]      // The name of the rows.
+ * @param {generate}[out]  // The corpus generator.
+ * @param {edit_json}[out] // A patch that changes one value.
+ */
+static void bench_equal(const char* name, char* (*generate)(int*), const char* edit_json)
+{
+    jToken *root, *head, *copy;
+    jParseOptions options;
+    double start;
+    char op[64];
+    jPatch* edit;
+    size_t base;
+    jArgs args;
+    char* json;
+    int length, hashed;
+    long n;
+
+    json = generate(&length);
+    head = jconf_json2c(edit_json, jconf_strlen(edit_json), &args);
+    edit = jconf_patch_compile(head, NULL);
+
+    options.allocator = NULL;
+    options.stats = NULL;
+    options.duplicates = JCONF_DUP_LAST_WINS;
+    options.mode = JCONF_MODE_DEFAULT;
+
+    for (hashed = 0; hashed < 2; hashed++)
+    {
+        options.hash = hashed;
+        root = jconf_json2c_ex(json, length, &options, &args);
+        copy = jconf_json2c_ex(json, length, &options, &args);
+        jconf_patch_apply(edit, &copy, NULL, NULL);
+        if (hashed)
+            jconf_hash_token(copy, 0);
+
+        base = bench_counter.live;
+        begin();
+        start = now();
+        for (n = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+            if (jconf_equal(root, copy))
+                fprintf(stderr, "equal: the %s copy was not changed.\n", name);
+        sprintf(op, "%s_%s", name, hashed ? "hashed" : "plain");
+        report("equal", op, length, n, now() - start, base);
+
+        jconf_free_token(copy);
+
+        // Parse and free.
+        base = bench_counter.live;
+        begin();
+        start = now();
+        for (n = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+        {
+            copy = jconf_json2c_ex(json, length, &options, &args);
+            jconf_free_token(copy);
+        }
+        sprintf(op, "parse_%s", hashed ? "hashed" : "plain");
+        report("equal", op, length, n, now() - start, base);
+
+        jconf_free_token(root);
+    }
+
+    jconf_patch_free(edit);
+    jconf_free_token(head);
+    free(json);
+}
+
+/**
+ * Generate Services
+ *
+ * Description: Generates a layered config: an object of services with
+ *              nested settings.
+ *
+ * @param {len}[out] // Set to the length of the text.
+ * @returns          // The text.
+ */
+static char* generate_services(int* len)
+{
+    char* json = (char*)malloc(2000 * 256 + 3);
+    int i, n = sprintf(json, "{");
+
+    for (i = 0; i < 2000; i++)
+        n += sprintf(json + n, "%s\"service_%04d\": {\"port\": %d, \"hosts\": [\"a%d\", \"b%d\"], "
+            "\"limits\": {\"cpu\": %d, \"memory\": \"%dMi\"}, \"tags\": {\"tier\": \"web\", \"zone\": %d}}",
+            i ? ", " : "", i, 8000 + i, i, i, i % 8, 128 << (i % 4), i % 3);
+
+    n += sprintf(json + n, "}");
+    *len = n;
+    return json;
+}
+
+/**
+ * Bench Merge
+ *
+ * Description: Measures merging a small overlay into the services config,
+ *              which shares the unchanged services, against deep copying the
+ *              config (the cost of a merge that copies its inputs).
+ */
+static void bench_merge(void)
+{
+    const char* overlay_json = "{\"service_1042\": {\"limits\": {\"cpu\": 16}, \"tags\": null}, \"service_9999\": {\"port\": 1}}";
+    jToken *root, *overlay, *merged;
+    double start;
+    size_t base;
+    jArgs args;
+    char* json;
+    int length;
+    long n;
+
+    json = generate_services(&length);
+    root = jconf_json2c(json, length, &args);
+    overlay = jconf_json2c(overlay_json, jconf_strlen(overlay_json), &args);
+
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+        jconf_free_token(jconf_copy_token(root));
+    report("merge", "copy", length, n, now() - start, base);
+
+    base = bench_counter.live;
+    begin();
+    start = now();
+    for (n = 0; n < MIN_ITERATIONS || now() - start < MIN_SECONDS; n++)
+    {
+        if ((merged = jconf_merge(root, overlay, JCONF_MERGE_REPLACE)) == NULL || jconf_get(merged, "oo", "service_9999", "port") == NULL)
+            fprintf(stderr, "merge: the overlay was not merged.\n");
+        jconf_free_token(merged);
+    }
+    report("merge", "merge", length, n, now() - start, base);
+
+    jconf_free_token(overlay);
+    jconf_free_token(root);
+    free(json);
+}
+
+// The generated corpus.
+static const BenchCorpus corpora[] = {
+    { "numbers", &generate_numbers, &lookup_array, 0 },
+    { "strings", &generate_strings, &lookup_array, 0 },
+    { "deep",    &generate_deep,    &lookup_deep,  0 },
+    { "wide",    &generate_wide,    &lookup_wide,  0 },
+    { "file",    &generate_file,    &lookup_file,  1 }
+};
+
+/**
+ * Entry point
+ */
+int main(int argc, char* argv[])
+{
+    const char* filter = argc > 1 ? argv[1] : "";
+    int i, status = 0;
+
+    jconf_init_counting_allocator(&bench_allocator, &bench_counter, NULL);
+    jconf_set_allocator(&bench_allocator);
+
+    printf("corpus,op,bytes,ops,seconds,mb_s,ops_s,allocs_op,peak_heap,peak_rss_kb\n");
+
+    for (i = 0; i < (int)(sizeof(corpora) / sizeof(corpora[0])); i++)
+        if (strstr(corpora[i].name, filter) != NULL && !bench_corpus(&corpora[i]))
+            status = 1;
+
+    if (strstr("messages", filter) != NULL)
+        bench_messages();
+
+    if (strstr("patch", filter) != NULL)
+        bench_patch();
+
+    if (strstr("diff", filter) != NULL)
+    {
+        bench_diff("wide", &generate_wide, "[{\"op\": \"replace\", \"path\": \"/key_04242\", \"value\": -1}]");
+        bench_diff("file", &generate_file, "[{\"op\": \"replace\", \"path\": \"/300/friends/1/name\", \"value\": \"x\"}]");
+    }
+
+    if (strstr("merge", filter) != NULL)
+        bench_merge();
+
+    if (strstr("equal", filter) != NULL)
+        bench_equal("file", &generate_file, "[{\"op\": \"replace\", \"path\": \"/300/friends/1/name\", \"value\": \"x\"}]");
+
+    if (strstr("micro", filter) != NULL)
+        bench_micro();
+
+    return status;
+}
@@ -0,0 +1,126 @@
+/**
+ * JConf CBOR Benchmark
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Compares decoding CBOR against parsing the equivalent JSON text.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/parser.h>
+#include <jconf/cbor.h>
+#include <stdio.h>
+#include <time.h>
+
+#define ITERATIONS 50
+
+/**
+ * Now
+ *
+ * Description: Returns a monotonic timestamp in seconds.
+ */
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Load File
+ *
+ * Description: Loads a file into a dynamically allocated buffer.
+ *
+ * @param {resc}[out] // The source path.
+ * @param {len}[in]   // The length of the buffer.
+ * @returns           // The file content in a char buffer.
+ */
+static char* load_file(const char* resc, int* len)
+{
+    char* buffer;
+    FILE* file;
+    long length;
+
+    if ((file = fopen(resc, "rb")) == NULL)
+        return NULL;
+
+    fseek(file, 0L, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0L, SEEK_SET);
+
+    buffer = (char*)malloc(length + 1);
+    length = fread(buffer, 1, length, file);
+    buffer[length] = 0;
+
+    fclose(file);
+    *len = (int)length;
+    return buffer;
+}
+
+/**
+ * Report
+ *
+ * Description: Prints a benchmark result line.
+ *
+ * @param {name}[out]    // The benchmark name.
+ * @param {bytes}[out]   // The number of input bytes per iteration.
+ * @param {elapsed}[out] // The total elapsed time.
+ */
+static void report(const char* name, size_t bytes, double elapsed)
+{
+    printf("%-20s %10.2f MB/s %10.1f docs/s\n", name,
+        bytes * (double)ITERATIONS / elapsed / (1024.0 * 1024.0), ITERATIONS / elapsed);
+}
+
+/**
+ * Entry point
+ */
+int main(int argc, char* argv[])
+{
+    const char* path = argc > 1 ? argv[1] : "test/test_two.json";
+    unsigned char* cbor;
+    jToken* token;
+    double start;
+    size_t size;
+    jArgs args;
+    char* json;
+    int length, i;
+
+    if ((json = load_file(path, &length)) == NULL || (token = jconf_json2c(json, length, &args)) == NULL)
+    {
+        printf("Failed to load %s.\n", path);
+        return 1;
+    }
+
+    cbor = jconf_c2cbor(token, &size);
+    jconf_free_token(token);
+
+    printf("%s: %d bytes of JSON, %d bytes of CBOR\n", path, length, (int)size);
+
+    // Text path.
+    start = now();
+    for (i = 0; i < ITERATIONS; i++)
+        jconf_free_token(jconf_json2c(json, length, &args));
+    report("json2c", length, now() - start);
+
+    // Binary path.
+    start = now();
+    for (i = 0; i < ITERATIONS; i++)
+        jconf_free_token(jconf_cbor2c(cbor, size, &args));
+    report("cbor2c", size, now() - start);
+
+    // Encoding.
+    token = jconf_json2c(json, length, &args);
+    start = now();
+    for (i = 0; i < ITERATIONS; i++)
+        jconf_free(NULL, jconf_c2cbor(token, &size));
+    report("c2cbor", size, now() - start);
+
+    jconf_free_token(token);
+    jconf_free(NULL, cbor);
+    free(json);
+    return 0;
+}
@@ -0,0 +1,238 @@
+/**
+ * JConf C++ Benchmark
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Compares the C++ layer against the equivalent C calls on the
+ *              same tree: key lookups (with keys measured at run time and
+ *              at compile time), array indexing, range-for over arrays and
+ *              objects, and typed values. Both sides compute the same
+ *              checksum, which is verified. Results are CSV:
+ *
+ *                  api,op,ops,seconds,ops_s
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/jconf.hpp>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <time.h>
+
+// Every benchmark repeats until it has run for this long.
+#define MIN_SECONDS 0.25
+
+// Corpus size.
+#define RECORDS 10000
+
+static char keys[RECORDS][16];
+
+/**
+ * Now
+ *
+ * Description: Returns a monotonic timestamp in seconds.
+ */
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Generate
+ *
+ * Description: Generates an object of records with a few fields each:
+ *              {"k0": {"id": 0, "name": "n0", "tags": [0, 1, 2, 3]}, ...}
+ */
+static std::string generate()
+{
+    std::string json = "{";
+    char record[128];
+    int i;
+
+    for (i = 0; i < RECORDS; i++)
+    {
+        snprintf(keys[i], sizeof(keys[i]), "k%d", i);
+        snprintf(record, sizeof(record), "%s\"%s\": {\"id\": %d, \"name\": \"n%d\", \"tags\": [%d, %d, %d, %d]}",
+            i ? ", " : "", keys[i], i, i, i, i + 1, i + 2, i + 3);
+        json += record;
+    }
+
+    return json + "}";
+}
+
+// C lookups: every record by key, then its id by key.
+static long c_lookup(const jToken* root)
+{
+    const jToken *record, *id;
+    long sum = 0;
+    int i;
+
+    for (i = 0; i < RECORDS; i++)
+    {
+        record = (const jToken*)jconf_map_get_n((const jMap*)root->data, keys[i], strlen(keys[i]));
+        id = (const jToken*)jconf_map_get_n((const jMap*)record->data, "id", 2);
+        sum += strtoll((const char*)id->data, NULL, 10);
+    }
+
+    return sum;
+}
+
+static long cpp_lookup(jconf::value_ref root)
+{
+    long sum = 0;
+    int i;
+
+    for (i = 0; i < RECORDS; i++)
+        sum += root[keys[i]]["id"].get<long>();
+
+    return sum;
+}
+
+// C lookups of the id with its hash computed ahead of time.
+static long c_lookup_hashed(const jToken* root)
+{
+    static const jHash id_hash = jconf_map_key_hash("id", 2);
+    const jToken *record, *id;
+    long sum = 0;
+    int i;
+
+    for (i = 0; i < RECORDS; i++)
+    {
+        record = (const jToken*)jconf_map_get_n((const jMap*)root->data, keys[i], strlen(keys[i]));
+        id = (const jToken*)jconf_map_get_hashed((const jMap*)record->data, "id", 2, id_hash);
+        sum += strtoll((const char*)id->data, NULL, 10);
+    }
+
+    return sum;
+}
+
+static long cpp_lookup_hashed(jconf::value_ref root)
+{
+    using namespace jconf::literals;
+    long sum = 0;
+    int i;
+
+    for (i = 0; i < RECORDS; i++)
+        sum += root[keys[i]]["id"_jk].get<long>();
+
+    return sum;
+}
+
+// C iteration: members in document order, then the elements of each array.
+static long c_iterate(const jToken* root)
+{
+    const jToken *tags;
+    const jNode* node;
+    const jArray* arr;
+    long sum = 0;
+    size_t i;
+
+    for (node = ((const jMap*)root->data)->first; node != NULL; node = node->after)
+    {
+        tags = (const jToken*)jconf_map_get_n((const jMap*)((const jToken*)node->value)->data, "tags", 4);
+        arr = (const jArray*)tags->data;
+        for (i = 0; i < arr->end; i++)
+            sum += strtoll((const char*)((const jToken*)jconf_array_get(arr, i))->data, NULL, 10);
+    }
+
+    return sum;
+}
+
+static long cpp_iterate(jconf::value_ref root)
+{
+    long sum = 0;
+
+    for (auto [key, record] : root.members())
+        for (jconf::value_ref tag : record["tags"])
+            sum += tag.get<long>();
+
+    return sum;
+}
+
+// C indexing: every tag by index.
+static long c_index(const jToken* root)
+{
+    const jToken *record, *tags;
+    long sum = 0;
+    int i;
+
+    record = (const jToken*)jconf_map_get_n((const jMap*)root->data, "k7", 2);
+    tags = (const jToken*)jconf_map_get_n((const jMap*)record->data, "tags", 4);
+    for (i = 0; i < RECORDS; i++)
+        sum += strtoll((const char*)((const jToken*)jconf_array_get((const jArray*)tags->data, i & 3))->data, NULL, 10);
+
+    return sum;
+}
+
+static long cpp_index(jconf::value_ref root)
+{
+    jconf::value_ref tags = root["k7"]["tags"];
+    long sum = 0;
+    int i;
+
+    for (i = 0; i < RECORDS; i++)
+        sum += tags[i & 3].get<long>();
+
+    return sum;
+}
+
+/**
+ * Run
+ *
+ * Description: Times an operation and prints its row.
+ *
+ * @param {api}[out]  // The API name.
+ * @param {op}[out]   // The operation name.
+ * @param {fn}[out]   // The operation.
+ * @param {root}[out] // The tree.
+ * @returns           // The checksum.
+ */
+template <class Root>
+static long run(const char* api, const char* op, long (*fn)(Root), Root root)
+{
+    volatile long sum = 0;
+    double start, elapsed;
+    long n;
+
+    start = now();
+    for (n = 0; n < 3 || now() - start < MIN_SECONDS; n++)
+        sum = fn(root);
+    elapsed = now() - start;
+
+    printf("%s,%s,%ld,%.6f,%.0f\n", api, op, n * RECORDS, elapsed, n * RECORDS / elapsed);
+    return sum;
+}
+
+/**
+ * Entry point
+ */
+int main()
+{
+    std::string json = generate();
+    jconf::document doc = jconf::document::parse(json);
+    const jToken* root = doc.root().token();
+    int failures = 0;
+
+    if (!doc)
+    {
+        fprintf(stderr, "cpp: failed to parse the corpus.\n");
+        return 1;
+    }
+
+    printf("api,op,ops,seconds,ops_s\n");
+
+    failures += run("c", "lookup", &c_lookup, root) != run("cpp", "lookup", &cpp_lookup, doc.root());
+    failures += run("c", "lookup_hashed", &c_lookup_hashed, root) != run("cpp", "lookup_hashed", &cpp_lookup_hashed, doc.root());
+    failures += run("c", "iterate", &c_iterate, root) != run("cpp", "iterate", &cpp_iterate, doc.root());
+    failures += run("c", "index", &c_index, root) != run("cpp", "index", &cpp_index, doc.root());
+
+    if (failures)
+        fprintf(stderr, "cpp: %d checksums differ from the C API.\n", failures);
+
+    return failures;
+}
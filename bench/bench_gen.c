@@ -0,0 +1,320 @@
+/**
+ * JConf Generated Parser Benchmark
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Compares the parser generated by jconfgen for test_two.json
+ *              against the generic paths on the same document: building a
+ *              tree, binding with descriptors (hashed key dispatch) and the
+ *              generated switch. Validation is the floor of one pass over
+ *              the input. Every path computes the same checksum of the
+ *              decoded values, which is verified. Results are CSV:
+ *
+ *                  api,op,bytes,ops,seconds,mb_s
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/parser.h>
+#include <jconf/bind.h>
+#include <jconf/string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "gen/people.h"
+
+// Every benchmark repeats until it has run for this long.
+#define MIN_SECONDS 0.25
+
+// The document.
+#define INPUT "test/test_two.json"
+
+// The document bound with descriptors.
+typedef struct _bench_friend
+{
+    int64_t id;
+    char* name;
+    double* numbers;
+    size_t number_count;
+
+} BenchFriend;
+
+typedef struct _bench_person
+{
+    char *_id, *guid, *balance, *picture, *eyeColor, *greeting, *favoriteFruit;
+    int64_t index, age;
+    int isActive;
+    double rand;
+    char** tags;
+    size_t tag_count;
+    BenchFriend* friends;
+    size_t friend_count;
+
+} BenchPerson;
+
+typedef struct _bench_people
+{
+    BenchPerson* people;
+    size_t count;
+
+} BenchPeople;
+
+static jBindField friend_fields[] = {
+    JCONF_BIND_FIELD(BenchFriend, id, JCONF_BIND_INT64),
+    JCONF_BIND_FIELD(BenchFriend, name, JCONF_BIND_STRING),
+    JCONF_BIND_ARRAY_FIELD(BenchFriend, numbers, number_count, JCONF_BIND_DOUBLE, NULL)
+};
+static jBindDesc friend_desc = JCONF_BIND_DESC(BenchFriend, friend_fields);
+
+static jBindField person_fields[] = {
+    JCONF_BIND_FIELD(BenchPerson, _id, JCONF_BIND_STRING),
+    JCONF_BIND_FIELD(BenchPerson, index, JCONF_BIND_INT64),
+    JCONF_BIND_FIELD(BenchPerson, guid, JCONF_BIND_STRING),
+    JCONF_BIND_FIELD(BenchPerson, isActive, JCONF_BIND_BOOL),
+    JCONF_BIND_FIELD(BenchPerson, balance, JCONF_BIND_STRING),
+    JCONF_BIND_FIELD(BenchPerson, picture, JCONF_BIND_STRING),
+    JCONF_BIND_FIELD(BenchPerson, age, JCONF_BIND_INT64),
+    JCONF_BIND_FIELD(BenchPerson, eyeColor, JCONF_BIND_STRING),
+    JCONF_BIND_FIELD(BenchPerson, rand, JCONF_BIND_DOUBLE),
+    JCONF_BIND_ARRAY_FIELD(BenchPerson, tags, tag_count, JCONF_BIND_STRING, NULL),
+    JCONF_BIND_ARRAY_FIELD(BenchPerson, friends, friend_count, JCONF_BIND_OBJECT, &friend_desc),
+    JCONF_BIND_FIELD(BenchPerson, greeting, JCONF_BIND_STRING),
+    JCONF_BIND_FIELD(BenchPerson, favoriteFruit, JCONF_BIND_STRING)
+};
+static jBindDesc person_desc = JCONF_BIND_DESC(BenchPerson, person_fields);
+
+// Bind decodes objects, so the root array is wrapped in one.
+static jBindField people_fields[] = {
+    JCONF_BIND_ARRAY_FIELD(BenchPeople, people, count, JCONF_BIND_OBJECT, &person_desc)
+};
+static jBindDesc people_desc = JCONF_BIND_DESC(BenchPeople, people_fields);
+
+/**
+ * Now
+ *
+ * Description: Returns a monotonic timestamp in seconds.
+ */
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Load File
+ *
+ * Description: Loads a file into a dynamically allocated buffer.
+ *
+ * @param {resc}[out] // The source path.
+ * @param {len}[in]   // The length of the buffer.
+ * @returns           // The file content in a char buffer.
+ */
+static char* load_file(const char* resc, size_t* len)
+{
+    char* buffer;
+    FILE* file;
+    long length;
+
+    if ((file = fopen(resc, "rb")) == NULL || fseek(file, 0L, SEEK_END) || (length = ftell(file)) < 0 || fseek(file, 0L, SEEK_SET))
+        return NULL;
+
+    buffer = (char*)malloc(length + 1);
+    *len = fread(buffer, 1, length, file);
+    buffer[*len] = 0;
+
+    fclose(file);
+    return buffer;
+}
+
+// Checksums of the decoded values.
+static double tree_sum(const jToken* root)
+{
+    const jToken *person, *friend, *value;
+    jArrayIter people, friends, values;
+    double sum = 0;
+
+    jconf_array_iter_begin(root, &people);
+    while (jconf_array_iter_next(&people, (jToken**)&person))
+    {
+        sum += strtod((const char*)jconf_get(person, "o", "index")->data, NULL);
+        sum += strtod((const char*)jconf_get(person, "o", "age")->data, NULL);
+        sum += strtod((const char*)jconf_get(person, "o", "rand")->data, NULL);
+        sum += jconf_get(person, "o", "isActive")->type == JCONF_TRUE;
+        sum += jconf_strlen((const char*)jconf_get(person, "o", "guid")->data);
+        sum += ((const jArray*)jconf_get(person, "o", "tags")->data)->end;
+
+        jconf_array_iter_begin(jconf_get(person, "o", "friends"), &friends);
+        while (jconf_array_iter_next(&friends, (jToken**)&friend))
+        {
+            sum += strtod((const char*)jconf_get(friend, "o", "id")->data, NULL);
+            jconf_array_iter_begin(jconf_get(friend, "o", "numbers"), &values);
+            while (jconf_array_iter_next(&values, (jToken**)&value))
+                sum += strtod((const char*)value->data, NULL);
+        }
+    }
+
+    return sum;
+}
+
+static double bind_sum(const BenchPeople* root)
+{
+    double sum = 0;
+    size_t i, j, k;
+
+    for (i = 0; i < root->count; i++)
+    {
+        const BenchPerson* person = &root->people[i];
+        sum += person->index;
+        sum += person->age;
+        sum += person->rand;
+        sum += person->isActive;
+        sum += jconf_strlen(person->guid);
+        sum += person->tag_count;
+
+        for (j = 0; j < person->friend_count; j++)
+        {
+            sum += person->friends[j].id;
+            for (k = 0; k < person->friends[j].number_count; k++)
+                sum += person->friends[j].numbers[k];
+        }
+    }
+
+    return sum;
+}
+
+static double gen_sum(const People* root)
+{
+    double sum = 0;
+    size_t i, j, k;
+
+    for (i = 0; i < root->count; i++)
+    {
+        const PeopleItem* person = &root->items[i];
+        sum += person->index;
+        sum += person->age;
+        sum += person->rand;
+        sum += person->isActive;
+        sum += jconf_strlen(person->guid);
+        sum += person->tags_count;
+
+        for (j = 0; j < person->friends_count; j++)
+        {
+            sum += person->friends[j].id;
+            for (k = 0; k < person->friends[j].numbers_count; k++)
+                sum += person->friends[j].numbers[k];
+        }
+    }
+
+    return sum;
+}
+
+/**
+ * Report
+ *
+ * Description: Prints a result row.
+ */
+static void report(const char* api, size_t bytes, long n, double elapsed)
+{
+    printf("%s,parse_free,%lu,%ld,%.6f,%.2f\n", api, (unsigned long)bytes, n, elapsed, bytes * n / elapsed / 1e6);
+}
+
+/**
+ * Entry point
+ */
+int main()
+{
+    double start, elapsed, sums[3];
+    BenchPeople bound;
+    size_t size, wrapped_size;
+    char *json, *wrapped;
+    People people;
+    jToken* root;
+    jArgs args;
+    long n;
+    int i;
+
+    if ((json = load_file(INPUT, &size)) == NULL)
+    {
+        fprintf(stderr, "gen: cannot read %s.\n", INPUT);
+        return 1;
+    }
+
+    // The same document as {"people": [...]} for bind.
+    wrapped = (char*)malloc(size + 16);
+    wrapped_size = (size_t)sprintf(wrapped, "{\"people\": %s}", json);
+
+    printf("api,op,bytes,ops,seconds,mb_s\n");
+
+    start = now();
+    for (n = 0; n < 3 || now() - start < MIN_SECONDS; n++)
+    {
+        if (!jconf_validate(json, size, JCONF_MODE_DEFAULT, &args))
+        {
+            fprintf(stderr, "gen: validate error %d.\n", args.e);
+            return 1;
+        }
+    }
+    elapsed = now() - start;
+    printf("validate,validate,%lu,%ld,%.6f,%.2f\n", (unsigned long)size, n, elapsed, size * n / elapsed / 1e6);
+
+    start = now();
+    for (n = 0; n < 3 || now() - start < MIN_SECONDS; n++)
+    {
+        if ((root = jconf_json2c(json, size, &args)) == NULL)
+        {
+            fprintf(stderr, "gen: tree error %d.\n", args.e);
+            return 1;
+        }
+
+        if (n == 0)
+            sums[0] = tree_sum(root);
+        jconf_free_token(root);
+    }
+    report("tree", size, n, now() - start);
+
+    start = now();
+    for (n = 0; n < 3 || now() - start < MIN_SECONDS; n++)
+    {
+        if (!jconf_bind_decode(&people_desc, wrapped, wrapped_size, &bound, NULL, &args))
+        {
+            fprintf(stderr, "gen: bind error %d.\n", args.e);
+            return 1;
+        }
+
+        if (n == 0)
+            sums[1] = bind_sum(&bound);
+        jconf_bind_free(&people_desc, &bound, NULL);
+    }
+    report("bind", wrapped_size, n, now() - start);
+
+    start = now();
+    for (n = 0; n < 3 || now() - start < MIN_SECONDS; n++)
+    {
+        if (!people_parse(json, size, &people, NULL, &args))
+        {
+            fprintf(stderr, "gen: generated parser error %d at %lu.\n", args.e, (unsigned long)args.pos);
+            return 1;
+        }
+
+        if (n == 0)
+            sums[2] = gen_sum(&people);
+        people_free(&people, NULL);
+    }
+    report("generated", size, n, now() - start);
+
+    for (i = 1; i < 3; i++)
+    {
+        if (sums[i] != sums[0])
+        {
+            fprintf(stderr, "gen: checksum %.17g differs from the tree (%.17g).\n", sums[i], sums[0]);
+            return 1;
+        }
+    }
+
+    free(wrapped);
+    free(json);
+    return 0;
+}
@@ -0,0 +1,199 @@
+/**
+ * JConf Hash Benchmark
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Compares the map hash against the previous Jenkins one at a
+ *              time hash across key lengths. Throughput is measured over
+ *              generated keys, and distribution by placing 16384 keys that
+ *              differ in a few characters into buckets and reporting the
+ *              longest chain and the chi-squared statistic divided by the
+ *              bucket count (close to 1 for a uniform hash). Results are CSV:
+ *
+ *                  hash,key_len,mb_s,keys,buckets,max_chain,chi2
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/map.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#define KEYS       16384
+#define MAX_LENGTH 256
+#define MIN_BYTES  (64 * 1024 * 1024)
+
+// Hash function definition.
+typedef struct _bench_hash
+{
+    const char* name;
+    uint64_t (*hash)(const char*, int);
+    int (*bucket)(uint64_t, int);
+
+} BenchHash;
+
+static char keys[KEYS][MAX_LENGTH];
+static int chains[KEYS];
+
+/**
+ * Now
+ *
+ * Description: Returns a monotonic timestamp in seconds.
+ */
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Jenkins
+ *
+ * Description: The previous map hash and its bucket reduction.
+ */
+static uint64_t jenkins(const char* key, int length)
+{
+    unsigned int hash;
+    int i;
+
+    for (hash = i = 0; i < length; ++i)
+    {
+        hash += (unsigned char)key[i];
+        hash += (hash << 10);
+        hash ^= (hash >> 6);
+    }
+
+    hash += (hash << 3);
+    hash ^= (hash >> 11);
+    hash += (hash << 15);
+    return hash;
+}
+
+static int jenkins_bucket(uint64_t hash, int buckets)
+{
+    return (int)(hash % (buckets - 1));
+}
+
+/**
+ * Map Hash
+ *
+ * Description: The current map hash (keys are placed into buckets by a map).
+ */
+static uint64_t map_hash(const char* key, int length)
+{
+    return jconf_map_key_hash(key, length);
+}
+
+/**
+ * Generate
+ *
+ * Description: Generates keys of a length that share a prefix and differ in
+ *              their last few characters, like generated field names.
+ *
+ * @param {length}[out] // The key length.
+ */
+static void generate(int length)
+{
+    char suffix[16];
+    int i, n;
+
+    for (i = 0; i < KEYS; i++)
+    {
+        n = sprintf(suffix, "%d", i);
+        memset(keys[i], 'k', length);
+        memcpy(keys[i] + (length > n ? length - n : 0), suffix, length > n ? n : length);
+    }
+}
+
+/**
+ * Distribution
+ *
+ * Description: Places the keys into buckets and reports the chain lengths.
+ *
+ * @param {hash}[out]   // The hash function.
+ * @param {length}[out] // The key length.
+ * @param {max}[in]     // Receives the longest chain.
+ * @returns             // The chi-squared statistic over the bucket count.
+ */
+static double distribution(const BenchHash* hash, int length, int* max)
+{
+    double expected = 1.0, chi2 = 0;
+    jNode* node;
+    jMap map;
+    int i;
+
+    for (i = 0; i < KEYS; i++)
+        chains[i] = 0;
+
+    if (hash->bucket == NULL)
+    {
+        // Let a map place the keys.
+        jconf_init_map(&map);
+        for (i = 0; i < KEYS; i++)
+            jconf_map_set(&map, keys[i], length, NULL, NULL);
+
+        for (i = 0; i < map.size; i++)
+            for (node = map.buckets[i]; node != NULL; node = node->next)
+                chains[i]++;
+
+        expected = (double)KEYS / map.size;
+        jconf_destroy_map(&map);
+    }
+    else
+    {
+        for (i = 0; i < KEYS; i++)
+            chains[hash->bucket(hash->hash(keys[i], length), KEYS)]++;
+    }
+
+    for (i = 0, *max = 0; i < KEYS; i++)
+    {
+        chi2 += (chains[i] - expected) * (chains[i] - expected) / expected;
+        if (chains[i] > *max)
+            *max = chains[i];
+    }
+
+    return chi2 / KEYS;
+}
+
+/**
+ * Entry point
+ */
+int main(void)
+{
+    static const BenchHash hashes[] = {
+        { "jenkins", &jenkins, &jenkins_bucket },
+        { "jconf_map_key_hash", &map_hash, NULL }
+    };
+    static const int lengths[] = { 4, 8, 16, 32, 64, 128, 256 };
+    volatile uint64_t sink = 0;
+    double start, elapsed, chi2;
+    size_t bytes;
+    int h, l, i, max;
+
+    jconf_map_set_seed(1);
+    printf("hash,key_len,mb_s,keys,buckets,max_chain,chi2\n");
+
+    for (l = 0; l < (int)(sizeof(lengths) / sizeof(lengths[0])); l++)
+    {
+        generate(lengths[l]);
+
+        for (h = 0; h < 2; h++)
+        {
+            start = now();
+            for (bytes = 0; bytes < MIN_BYTES; bytes += (size_t)KEYS * lengths[l])
+                for (i = 0; i < KEYS; i++)
+                    sink += hashes[h].hash(keys[i], lengths[l]);
+            elapsed = now() - start;
+
+            chi2 = distribution(&hashes[h], lengths[l], &max);
+            printf("%s,%d,%.2f,%d,%d,%d,%.3f\n", hashes[h].name, lengths[l],
+                bytes / elapsed / (1024.0 * 1024.0), KEYS, KEYS, max, chi2);
+        }
+    }
+
+    return (int)(sink & 0);
+}
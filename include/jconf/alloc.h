@@ -0,0 +1,56 @@
+/**
+ * JConf Alloc
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Allocator interface used by the JConf data structures.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __ALLOC_JCONF_H__
+#define __ALLOC_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>  // For size_t.
+
+// jAllocator struct definition. A NULL allocator uses the default allocator set
+// with jconf_set_allocator, or malloc, realloc and free if none is set.
+typedef struct _j_allocator
+{
+    void* (*alloc)(void* ctx, size_t size);
+    void* (*realloc)(void* ctx, void* ptr, size_t old_size, size_t size);
+    void  (*free)(void* ctx, void* ptr);
+    void* ctx;
+
+} jAllocator;
+
+// jAllocCounter struct definition (statistics kept by a counting allocator).
+typedef struct _j_alloc_counter
+{
+    const jAllocator* parent;
+    size_t allocs, reallocs, frees;
+    size_t bytes, live, peak;
+
+} jAllocCounter;
+
+// jAllocator API.
+void  jconf_set_allocator(const jAllocator*);
+const jAllocator* jconf_get_allocator(void);
+
+void* jconf_malloc(const jAllocator*, size_t);
+void* jconf_realloc(const jAllocator*, void*, size_t, size_t);
+void  jconf_free(const jAllocator*, void*);
+
+void  jconf_init_counting_allocator(jAllocator*, jAllocCounter*, const jAllocator*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -17,25 +17,40 @@
 extern "C" {
 #endif
 
+#include "alloc.h"   // For custom allocators.
+#include "atomic.h"  // For the fields shared between threads.
 #include <stdlib.h>  // For standard macros and dynamic memory allocation.
+#include <stdint.h>  // For SIZE_MAX.
+
+// Number of elements stored inside the jArray struct before allocating.
+#define JCONF_ARRAY_INLINE 4
 
 // jArray struct definition.
 typedef struct _j_array
 {
-    int size, end, expand;
+    size_t size, end, expand;
     void** values;
+    const jAllocator* allocator;
+    JCONF_ATOMIC(uint64_t) digest;  // Content hash of the array (0 until computed, see jconf/hash.h).
+    JCONF_ATOMIC(size_t) refs;      // Trees sharing the array besides its owner (see jconf/merge.h).
+    void* inline_values[JCONF_ARRAY_INLINE];
 
 } jArray;
 
 // jArray API.
-int   jconf_init_array(jArray*, int, int);
+int   jconf_init_array(jArray*, size_t, size_t);
+int   jconf_init_array_with(jArray*, size_t, size_t, const jAllocator*);
 void  jconf_destroy_array(jArray*);
 
+int   jconf_array_reserve(jArray*, size_t);
 int   jconf_array_push(jArray*, void*);
 void* jconf_array_pop(jArray*);
 
-int   jconf_array_set(jArray*, int, void*);
-void* jconf_array_get(jArray*, int);
+int   jconf_array_set(jArray*, size_t, void*);
+void* jconf_array_get(const jArray*, size_t);
+
+int   jconf_array_insert(jArray*, size_t, void*);
+void* jconf_array_remove(jArray*, size_t);
 
 #ifdef __cplusplus
 }
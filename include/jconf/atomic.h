@@ -0,0 +1,28 @@
+/**
+ * JConf Atomic
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Declares the fields of trees that the library updates from
+ *              several threads (reference counts and memoized hashes). C code
+ *              sees C11 atomics and accesses them with <stdatomic.h>, like
+ *              the rest of the library. C++ before C++23 has no _Atomic, so it
+ *              sees the plain type, which has the same size and alignment;
+ *              C++ code must not write these fields.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __ATOMIC_JCONF_H__
+#define __ATOMIC_JCONF_H__
+
+#ifdef __cplusplus
+    #define JCONF_ATOMIC(type) type
+#else
+    #include <stdatomic.h>
+    #define JCONF_ATOMIC(type) _Atomic(type)
+#endif
+
+#endif
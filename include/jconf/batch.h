@@ -0,0 +1,55 @@
+/**
+ * JConf Batch
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Parses many small documents back to back (e.g messages from a
+ *              queue). Documents are allocated from parser contexts, so each
+ *              one costs a few arena bumps instead of a malloc per token, and
+ *              the inputs can be split across threads with one context each.
+ *
+ *              Threads share the allocator of the parse options when no
+ *              contexts are given, and contexts take their chunks from the
+ *              default allocator, so with more than one thread the allocator
+ *              (and the one set with jconf_set_allocator) must be thread-safe.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __BATCH_JCONF_H__
+#define __BATCH_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "document.h"
+#include "context.h"
+
+// jInput struct definition (one document to parse).
+typedef struct _j_input
+{
+    const char* buffer;
+    size_t size;
+
+} jInput;
+
+// jBatchOptions struct definition.
+typedef struct _j_batch_options
+{
+    jParseOptions parse;        // Mode, duplicate policy and allocator (statistics are not collected).
+    jParserContext* contexts;   // One context per thread (NULL to allocate each tree with parse.allocator).
+    size_t threads;             // Threads to parse with, including the caller (0 or 1 for the caller only).
+
+} jBatchOptions;
+
+// jBatch API.
+size_t jconf_parse_batch(const jInput*, size_t, jDocument*, jArgs*, const jBatchOptions*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * JConf Bind
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Decodes JSON straight into C structs described by tables of
+ *              fields, in one pass over the input and without building a
+ *              tree, and encodes structs back to JSON. Keys are dispatched
+ *              with a perfect hash of each table (hash and displace) built by
+ *              jconf_bind_init.
+ *
+ *                  typedef struct { char* host; int port; } Server;
+ *
+ *                  static jBindField server_fields[] = {
+ *                      JCONF_BIND_FIELD(Server, host, JCONF_BIND_STRING),
+ *                      JCONF_BIND_FIELD(Server, port, JCONF_BIND_INT)
+ *                  };
+ *                  static jBindDesc server_desc = JCONF_BIND_DESC(Server, server_fields);
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __BIND_JCONF_H__
+#define __BIND_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+#include <stddef.h>  // For offsetof.
+
+// The most fields in one descriptor.
+#define JCONF_BIND_MAX_FIELDS 128
+
+// Field types.
+typedef enum _j_bind_type
+{
+    JCONF_BIND_BOOL = 0,    // int (0 or 1)
+    JCONF_BIND_INT,         // int
+    JCONF_BIND_INT64,       // int64_t
+    JCONF_BIND_DOUBLE,      // double
+    JCONF_BIND_STRING,      // char* (allocated, escape sequences decoded)
+    JCONF_BIND_OBJECT,      // A nested struct described by desc.
+    JCONF_BIND_ARRAY        // A pointer to allocated elements of type element
+                            // (with desc for structs) and a size_t count.
+
+} jBindType;
+
+struct _j_bind_desc;
+
+// jBindField struct definition.
+typedef struct _j_bind_field
+{
+    const char* key;
+    jBindType type;
+    size_t offset;                      // The offset of the member.
+    struct _j_bind_desc* desc;          // Objects and arrays of objects.
+    jBindType element;                  // Arrays: the element type.
+    size_t count;                       // Arrays: the offset of the size_t count.
+
+} jBindField;
+
+// jBindDesc struct definition. The dispatch table is filled in by
+// jconf_bind_init (called by the first decode if needed; call it before
+// sharing a descriptor between threads).
+typedef struct _j_bind_desc
+{
+    jBindField* fields;
+    size_t count;
+    size_t size;                        // The size of the struct.
+
+    int ready;
+    unsigned int bits;                  // The table holds 1 << bits slots.
+    unsigned char displace[JCONF_BIND_MAX_FIELDS / 2];
+    unsigned char slots[2 * JCONF_BIND_MAX_FIELDS];
+
+} jBindDesc;
+
+// Field and descriptor initializers.
+#define JCONF_BIND_FIELD(type, member, kind) \
+    { #member, kind, offsetof(type, member), NULL, JCONF_BIND_BOOL, 0 }
+#define JCONF_BIND_FIELD_KEY(type, member, key, kind) \
+    { key, kind, offsetof(type, member), NULL, JCONF_BIND_BOOL, 0 }
+#define JCONF_BIND_OBJECT_FIELD(type, member, desc) \
+    { #member, JCONF_BIND_OBJECT, offsetof(type, member), desc, JCONF_BIND_BOOL, 0 }
+#define JCONF_BIND_ARRAY_FIELD(type, member, count, element, desc) \
+    { #member, JCONF_BIND_ARRAY, offsetof(type, member), desc, element, offsetof(type, count) }
+#define JCONF_BIND_DESC(type, fields) \
+    { fields, sizeof(fields) / sizeof(fields[0]), sizeof(type), 0, 0, { 0 }, { 0 } }
+
+// jBind API. Decoding zeroes the struct first; keys without fields are
+// skipped and null values leave fields zero. Strings and arrays are allocated
+// with the allocator (NULL for the default) and released by jconf_bind_free.
+int   jconf_bind_init(jBindDesc*);
+int   jconf_bind_decode(jBindDesc*, const char*, size_t, void*, const jAllocator*, jArgs*);
+char* jconf_bind_encode(jBindDesc*, const void*, size_t*);
+void  jconf_bind_free(const jBindDesc*, void*, const jAllocator*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
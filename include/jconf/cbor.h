@@ -0,0 +1,39 @@
+/**
+ * JConf CBOR
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Converts jToken trees to and from CBOR (RFC 8949). Numbers are
+ *              stored as binary integers and floats, and every container and
+ *              string is length-prefixed so decoding never scans for delimiters.
+ *              Strings are stored as CBOR text: their JSON escape sequences
+ *              are decoded when encoding, and quotes, backslashes and control
+ *              characters are escaped again when decoding.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __CBOR_JCONF_H__
+#define __CBOR_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+#include <stddef.h>  // For size_t.
+
+// The maximum nesting depth accepted by the decoder.
+#define JCONF_CBOR_MAX_DEPTH 512
+
+// JConf CBOR API.
+unsigned char* jconf_c2cbor(jToken*, size_t*);
+jToken*        jconf_cbor2c(const unsigned char*, size_t, jArgs*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * JConf Parser Context
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: A reusable parser context that keeps warm memory between
+ *              documents. Trees parsed with a context are allocated from its
+ *              arena and stay valid until the context is reset or destroyed;
+ *              they must not be freed with jconf_free_token.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __CONTEXT_JCONF_H__
+#define __CONTEXT_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+
+#define JCONF_CONTEXT_CHUNK_SIZE (64 * 1024)
+#define JCONF_CONTEXT_HINTS      16
+
+// Arena chunk definition (the chunk memory follows the header).
+typedef struct _j_arena_chunk
+{
+    struct _j_arena_chunk* next;
+    size_t size, used;
+
+} jArenaChunk;
+
+// jParserContext struct definition.
+typedef struct _j_parser_context
+{
+    jArenaChunk *head, *current;
+    size_t chunk_size;
+    void* last;
+    jAllocator allocator;
+
+    // Array size hinted at each nesting depth: the average size of the
+    // arrays of earlier parses, halving the weight of each older parse.
+    size_t hints[JCONF_CONTEXT_HINTS];
+    size_t next_sums[JCONF_CONTEXT_HINTS], next_counts[JCONF_CONTEXT_HINTS];
+
+} jParserContext;
+
+// jParserContext API.
+int     jconf_init_context(jParserContext*, size_t);
+void    jconf_destroy_context(jParserContext*);
+void    jconf_context_reset(jParserContext*);
+jToken* jconf_context_json2c(jParserContext*, const char*, size_t, jArgs*);
+jToken* jconf_context_json2c_ex(jParserContext*, const char*, size_t, const jParseOptions*, jArgs*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,755 @@
+/**
+ * JConf Cursor
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Inline scanners that decode JSON values in place, shared by
+ *              jconf_bind_decode and the parsers generated by jconfgen. The
+ *              input follows the parser's default mode, and errors are
+ *              reported in jArgs with the codes and positions of the parser.
+ *              Each scanner starts on the first character of a value and
+ *              ends on its last; null leaves the destination as it is.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __CURSOR_JCONF_H__
+#define __CURSOR_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+#include "alloc.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+// The deepest nesting of objects and arrays entered with jconf_cursor_enter.
+#define JCONF_CURSOR_MAX_DEPTH 512
+
+// The longest number converted to a double without allocating.
+#define JCONF_CURSOR_NUMBER 128
+
+// jCursor struct definition.
+typedef struct _j_cursor
+{
+    const char* buffer;
+    size_t size, depth;
+    const jAllocator* allocator;        // Strings and arrays (NULL for the default).
+    jArgs* args;
+
+} jCursor;
+
+/**
+ * JConf Cursor Init
+ *
+ * Description: Starts a cursor at the beginning of a buffer.
+ *
+ * @param[in]  {c}         // The cursor.
+ * @param[out] {buffer}    // The string to decode.
+ * @param[out] {size}      // The size of the buffer.
+ * @param[out] {allocator} // The allocator.
+ * @param[in]  {args}      // The object to store decoding related information
+ */
+static __inline void jconf_cursor_init(jCursor* c, const char* buffer, size_t size, const jAllocator* allocator, jArgs* args)
+{
+    c->buffer = buffer;
+    c->size = size;
+    c->depth = 0;
+    c->allocator = allocator;
+    c->args = args;
+
+    args->e = JCONF_NO_ERROR;
+    args->line = 1;
+    args->pos = 0;
+}
+
+/**
+ * JConf Cursor Space
+ *
+ * Description: Skips spaces and comments, counting lines.
+ *
+ * @param[in]  {c} // The cursor.
+ * @returns        // '1' at the next token, '0' on error.
+ */
+static __inline int jconf_cursor_space(jCursor* c)
+{
+    const char* buffer = c->buffer;
+    size_t size = c->size;
+    jArgs* args = c->args;
+    char ch;
+
+    for (; args->pos < size; args->pos++)
+    {
+        if (jconf_isspace((ch = buffer[args->pos])))
+        {
+            if (ch == '\n') args->line++;
+            continue;
+        }
+
+        if (ch != '/')
+            return 1;
+
+        ch = ++args->pos < size ? buffer[args->pos] : 0;
+        if (ch == '*')
+        {
+            for (args->pos++; args->pos + 1 < size && !(buffer[args->pos] == '*' && buffer[args->pos + 1] == '/'); args->pos++)
+                if (buffer[args->pos] == '\n') args->line++;
+
+            args->pos++;
+        }
+        else if (ch == '/')
+        {
+            // Stop before the new line so that it is counted.
+            while (args->pos + 1 < size && buffer[args->pos + 1] != '\n')
+                args->pos++;
+        }
+        else if (ch != 0)
+        {
+            args->e = JCONF_UNEXPECTED_TOK;
+            return 0;
+        }
+
+        if (args->pos >= size)
+            break;
+    }
+
+    args->e = JCONF_UNEXPECTED_EOF;
+    return 0;
+}
+
+/**
+ * JConf Cursor Keyword
+ *
+ * Description: Checks for a keyword at the current position.
+ *
+ * @param[out] {c}       // The cursor.
+ * @param[out] {keyword} // The keyword.
+ * @param[out] {length}  // The length of the keyword.
+ * @returns              // '1' if the keyword is present.
+ */
+static __inline int jconf_cursor_keyword(const jCursor* c, const char* keyword, size_t length)
+{
+    size_t pos = c->args->pos;
+    return pos + length <= c->size && !memcmp(keyword, c->buffer + pos, length);
+}
+
+/**
+ * JConf Cursor Mismatch
+ *
+ * Description: Reports a value of the wrong type at the current position.
+ *
+ * @param[in]  {c} // The cursor.
+ * @returns        // '0'
+ */
+static __inline int jconf_cursor_mismatch(jCursor* c)
+{
+    c->args->e = JCONF_TYPE_MISMATCH;
+    return 0;
+}
+
+/**
+ * JConf Cursor Null
+ *
+ * Description: Skips a null at the current position.
+ *
+ * @param[in]  {c} // The cursor.
+ * @returns        // '1' if the value is null.
+ */
+static __inline int jconf_cursor_null(jCursor* c)
+{
+    if (!jconf_cursor_keyword(c, "null", 4))
+        return 0;
+
+    c->args->pos += 3;
+    return 1;
+}
+
+/**
+ * JConf Cursor Hex
+ *
+ * Description: Reads the four hexadecimal digits of a \u escape.
+ *
+ * @param[out] {p} // The digits.
+ * @returns        // The code unit.
+ */
+static __inline unsigned int jconf_cursor_hex(const char* p)
+{
+    unsigned int value = 0;
+    int i;
+
+    for (i = 0; i < 4; i++)
+        value = (value << 4) | (unsigned int)((jconf_isdigit(p[i])) ? p[i] - '0' : (p[i] | 0x20) - 'a' + 10);
+
+    return value;
+}
+
+/**
+ * JConf Cursor Unescape
+ *
+ * Description: Copies a scanned string, decoding its escape sequences. \u
+ *              escapes are written as UTF-8, joining surrogate pairs; a lone
+ *              surrogate becomes U+FFFD. The output is never longer than
+ *              the input.
+ *
+ * @param[in]  {dest}   // The destination.
+ * @param[out] {src}    // The string without quotes.
+ * @param[out] {length} // The length of the string.
+ * @returns             // The length of the output.
+ */
+static __inline size_t jconf_cursor_unescape(char* dest, const char* src, size_t length)
+{
+    unsigned int cp, low;
+    size_t i, n = 0;
+    char ch;
+
+    for (i = 0; i < length; i++)
+    {
+        if ((ch = src[i]) != '\\')
+        {
+            dest[n++] = ch;
+            continue;
+        }
+
+        switch ((ch = src[++i]))
+        {
+            case 'b': dest[n++] = '\b'; break;
+            case 'f': dest[n++] = '\f'; break;
+            case 'n': dest[n++] = '\n'; break;
+            case 'r': dest[n++] = '\r'; break;
+            case 't': dest[n++] = '\t'; break;
+            case 'u':
+                cp = jconf_cursor_hex(src + i + 1);
+                i += 4;
+
+                if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 < length && src[i + 1] == '\\' && src[i + 2] == 'u' &&
+                    (low = jconf_cursor_hex(src + i + 3)) >= 0xDC00 && low <= 0xDFFF)
+                {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                else if (cp >= 0xD800 && cp <= 0xDFFF)
+                    cp = 0xFFFD;
+
+                if (cp < 0x80)
+                    dest[n++] = (char)cp;
+                else if (cp < 0x800)
+                {
+                    dest[n++] = (char)(0xC0 | (cp >> 6));
+                    dest[n++] = (char)(0x80 | (cp & 0x3F));
+                }
+                else if (cp < 0x10000)
+                {
+                    dest[n++] = (char)(0xE0 | (cp >> 12));
+                    dest[n++] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                    dest[n++] = (char)(0x80 | (cp & 0x3F));
+                }
+                else
+                {
+                    dest[n++] = (char)(0xF0 | (cp >> 18));
+                    dest[n++] = (char)(0x80 | ((cp >> 12) & 0x3F));
+                    dest[n++] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                    dest[n++] = (char)(0x80 | (cp & 0x3F));
+                }
+                break;
+
+            default: dest[n++] = ch; break;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * JConf Cursor Scan String
+ *
+ * Description: Scans the string at the current position, ending on its
+ *              closing quote, with the checks of the parser's default mode.
+ *
+ * @param[in]  {c}    // The cursor.
+ * @param[in]  {dest} // Receives the decoded string (NULL to skip it).
+ * @returns           // '1' if successful, '0' on error.
+ */
+static __inline int jconf_cursor_scan_string(jCursor* c, char** dest)
+{
+    const char* buffer = c->buffer;
+    size_t size = c->size;
+    jArgs* args = c->args;
+    size_t init_pos, length;
+    int j;
+    char ch;
+
+    init_pos = args->pos + 1;
+    while (++args->pos < size && (ch = buffer[args->pos]) != '\"')
+    {
+        if (ch != '\\')
+            continue;
+
+        // Unrecognized control sequence.
+        if (++args->pos >= size || !(jconf_isctrl((ch = buffer[args->pos])))) {
+            args->e = JCONF_INVALID_CTRL_SEQUENCE; return 0;
+        }
+
+        if (ch == 'u')
+        {
+            // Expected four hexadecimal digits.
+            if (args->pos + 4 >= size) {
+                args->e = JCONF_HEX_REQUIRED; return 0;
+            }
+
+            for (j = 0; j < 4; j++)
+            {
+                // Invalid hex char.
+                args->pos++;
+                if (!(jconf_isxdigit(buffer[args->pos]))) {
+                    args->e = JCONF_INVALID_HEX; return 0;
+                }
+            }
+        }
+    }
+
+    if (args->pos >= size) {
+        args->e = JCONF_UNEXPECTED_TOK; return 0;
+    }
+
+    if (dest != NULL)
+    {
+        length = args->pos - init_pos;
+        if ((*dest = (char*)jconf_malloc(c->allocator, length + 1)) == NULL) {
+            args->e = JCONF_OUT_OF_MEMORY; return 0;
+        }
+
+        (*dest)[jconf_cursor_unescape(*dest, buffer + init_pos, length)] = 0;
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Cursor Scan Number
+ *
+ * Description: Scans the number at the current position, ending on its last
+ *              character, with the grammar of the parser's default mode.
+ *
+ * @param[in]  {c}       // The cursor.
+ * @param[in]  {integer} // Receives '1' for integers.
+ * @returns              // '1' if successful, '0' on error.
+ */
+static __inline int jconf_cursor_scan_number(jCursor* c, int* integer)
+{
+    // JSON number states
+    static const int
+        INIT = 0,
+        DIGIT = 1,
+        ZERO = 2,
+        DIGIT_PLUS_ZERO = 3,
+        DECIMAL = 4,
+        EXP = 5,
+        DECIMAL_DIGIT = 6;
+
+    const char* buffer = c->buffer;
+    size_t size = c->size;
+    jArgs* args = c->args;
+    size_t init_pos = args->pos;
+    int state = 0;
+    char ch;
+
+    *integer = 1;
+    args->e = JCONF_INVALID_NUMBER;
+
+    for (; args->pos < size && (ch = buffer[args->pos]) != ',' && ch != '}' && ch != ']'; args->pos++)
+    {
+        if (jconf_isspace(ch))
+            break;
+
+        switch(state)
+        {
+            case 0: // INIT
+                if (ch == '-') { state = DIGIT; break; }
+
+            case 1: // DIGIT
+                if (ch == '0') { state = ZERO; }
+                else if (jconf_isdigit(ch)) { state = DIGIT_PLUS_ZERO; }
+                else return 0;
+                break;
+
+            case 2: // ZERO
+            case 3: // DIGIT_PLUS_ZERO
+                if (ch == '.') { state = DECIMAL; *integer = 0; }
+                else if (ch == 'e' || ch == 'E') { state = EXP; *integer = 0; }
+                else if (state == ZERO || !jconf_isdigit(ch)) return 0;
+                break;
+
+            case 4: // DECIMAL
+                if (ch == 'e' || ch == 'E') { state = EXP; }
+                else if (!jconf_isdigit(ch)) return 0;
+                break;
+
+            case 5: // EXP
+                state = DECIMAL_DIGIT;
+                if (ch == '+' || ch == '-') { break; }
+
+            case 6: // DECIMAL_DIGIT
+                if (!jconf_isdigit(ch)) return 0;
+                break;
+        }
+    }
+
+    if (state == INIT || state == EXP || state == DIGIT) return 0;
+
+    args->e = JCONF_NO_ERROR;
+    args->pos--;
+    return 1;
+}
+
+/**
+ * JConf Cursor Skip
+ *
+ * Description: Skips a value. Objects and arrays are checked with
+ *              jconf_validate.
+ *
+ * @param[in]  {c} // The cursor.
+ * @returns        // '1' if successful, '0' on error.
+ */
+static __inline int jconf_cursor_skip(jCursor* c)
+{
+    jArgs* args = c->args;
+    jArgs nested;
+    int integer, status;
+    char ch;
+
+    if ((ch = c->buffer[args->pos]) == '{' || ch == '[')
+    {
+        status = jconf_validate(c->buffer + args->pos, c->size - args->pos, JCONF_MODE_DEFAULT, &nested);
+        args->e = nested.e;
+        args->pos += nested.pos;
+        args->line += nested.line - 1;
+        return status;
+    }
+
+    if (ch == '\"')
+        return jconf_cursor_scan_string(c, NULL);
+
+    if (jconf_cursor_keyword(c, "false", 5))
+        args->pos += 4;
+    else if (jconf_cursor_keyword(c, "true", 4) || jconf_cursor_keyword(c, "null", 4))
+        args->pos += 3;
+    else
+        return jconf_cursor_scan_number(c, &integer);
+
+    return 1;
+}
+
+/**
+ * JConf Cursor Bool
+ *
+ * Description: Decodes true or false.
+ *
+ * @param[in]  {c}     // The cursor.
+ * @param[in]  {value} // Receives '1' or '0'.
+ * @returns            // '1' if successful, '0' on error.
+ */
+static __inline int jconf_cursor_bool(jCursor* c, int* value)
+{
+    if (jconf_cursor_keyword(c, "true", 4)) { *value = 1; c->args->pos += 3; return 1; }
+    if (jconf_cursor_keyword(c, "false", 5)) { *value = 0; c->args->pos += 4; return 1; }
+    return jconf_cursor_null(c) || jconf_cursor_mismatch(c);
+}
+
+/**
+ * JConf Cursor Numeric
+ *
+ * Description: Checks that the value at the current position can be a
+ *              number (malformed values are reported by the scanner).
+ *
+ * @param[out] {c} // The cursor.
+ * @returns        // '1' if the value is not a string, object, array or
+ *                 // boolean.
+ */
+static __inline int jconf_cursor_numeric(const jCursor* c)
+{
+    char ch = c->buffer[c->args->pos];
+    return ch != '\"' && ch != '{' && ch != '[' && !jconf_cursor_keyword(c, "true", 4) && !jconf_cursor_keyword(c, "false", 5);
+}
+
+/**
+ * JConf Cursor Int64
+ *
+ * Description: Decodes an integer. Integers out of range fail with
+ *              JCONF_INVALID_NUMBER, and other numbers are mismatches.
+ *
+ * @param[in]  {c}     // The cursor.
+ * @param[in]  {value} // Receives the integer.
+ * @returns            // '1' if successful, '0' on error.
+ */
+static __inline int jconf_cursor_int64(jCursor* c, int64_t* value)
+{
+    size_t start = c->args->pos;
+    const char *p, *end;
+    uint64_t n = 0, limit;
+    int integer, negative;
+
+    if (jconf_cursor_null(c)) return 1;
+    if (!jconf_cursor_numeric(c)) return jconf_cursor_mismatch(c);
+    if (!jconf_cursor_scan_number(c, &integer)) return 0;
+
+    if (!integer)
+    {
+        c->args->pos = start;
+        return jconf_cursor_mismatch(c);
+    }
+
+    p = c->buffer + start;
+    end = c->buffer + c->args->pos;
+    negative = *p == '-';
+    limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+
+    for (p += negative; p <= end; p++)
+    {
+        if (n > (limit - (uint64_t)(*p - '0')) / 10)
+        {
+            c->args->e = JCONF_INVALID_NUMBER;
+            c->args->pos = start;
+            return 0;
+        }
+        n = n * 10 + (uint64_t)(*p - '0');
+    }
+
+    *value = negative ? (n == (uint64_t)INT64_MAX + 1 ? INT64_MIN : -(int64_t)n) : (int64_t)n;
+    return 1;
+}
+
+/**
+ * JConf Cursor Int
+ *
+ * Description: Decodes an integer in the range of an int.
+ *
+ * @param[in]  {c}     // The cursor.
+ * @param[in]  {value} // Receives the integer.
+ * @returns            // '1' if successful, '0' on error.
+ */
+static __inline int jconf_cursor_int(jCursor* c, int* value)
+{
+    size_t start = c->args->pos;
+    int64_t n = *value;
+
+    if (!jconf_cursor_int64(c, &n)) return 0;
+
+    if (n < INT_MIN || n > INT_MAX)
+    {
+        c->args->e = JCONF_INVALID_NUMBER;
+        c->args->pos = start;
+        return 0;
+    }
+
+    *value = (int)n;
+    return 1;
+}
+
+/**
+ * JConf Cursor Double
+ *
+ * Description: Decodes a number. The buffer need not be null terminated,
+ *              so the number is copied before strtod reads it (to the heap
+ *              if it is longer than JCONF_CURSOR_NUMBER).
+ *
+ * @param[in]  {c}     // The cursor.
+ * @param[in]  {value} // Receives the number.
+ * @returns            // '1' if successful, '0' on error.
+ */
+static __inline int jconf_cursor_double(jCursor* c, double* value)
+{
+    char number[JCONF_CURSOR_NUMBER], *text = number;
+    size_t start = c->args->pos, length;
+    int integer;
+
+    if (jconf_cursor_null(c)) return 1;
+    if (!jconf_cursor_numeric(c)) return jconf_cursor_mismatch(c);
+    if (!jconf_cursor_scan_number(c, &integer)) return 0;
+
+    length = c->args->pos + 1 - start;
+    if (length >= JCONF_CURSOR_NUMBER && (text = (char*)jconf_malloc(c->allocator, length + 1)) == NULL)
+    {
+        c->args->e = JCONF_OUT_OF_MEMORY;
+        return 0;
+    }
+
+    memcpy(text, c->buffer + start, length);
+    text[length] = 0;
+    *value = strtod(text, NULL);
+
+    if (text != number)
+        jconf_free(c->allocator, text);
+    return 1;
+}
+
+/**
+ * JConf Cursor String
+ *
+ * Description: Decodes a string, freeing the previous one (the last of
+ *              duplicate keys is kept).
+ *
+ * @param[in]  {c}     // The cursor.
+ * @param[in]  {value} // The string.
+ * @returns            // '1' if successful, '0' on error.
+ */
+static __inline int jconf_cursor_string(jCursor* c, char** value)
+{
+    if (jconf_cursor_null(c)) return 1;
+    if (c->buffer[c->args->pos] != '\"') return jconf_cursor_mismatch(c);
+
+    jconf_free(c->allocator, *value);
+    *value = NULL;
+    return jconf_cursor_scan_string(c, value);
+}
+
+/**
+ * JConf Cursor Enter
+ *
+ * Description: Enters the object or array at the current position and moves
+ *              to its first token.
+ *
+ * @param[in]  {c} // The cursor.
+ * @returns        // '1' if successful, '0' on error.
+ */
+static __inline int jconf_cursor_enter(jCursor* c)
+{
+    if (++c->depth > JCONF_CURSOR_MAX_DEPTH)
+    {
+        c->args->e = JCONF_MAX_DEPTH;
+        return 0;
+    }
+
+    c->args->pos++;
+    return jconf_cursor_space(c);
+}
+
+/**
+ * JConf Cursor Close
+ *
+ * Description: Leaves an empty object or array.
+ *
+ * @param[in]  {c}     // The cursor.
+ * @param[out] {close} // The closing character.
+ * @returns            // '1' if the container was closed.
+ */
+static __inline int jconf_cursor_close(jCursor* c, char close)
+{
+    if (c->buffer[c->args->pos] != close)
+        return 0;
+
+    c->depth--;
+    return 1;
+}
+
+/**
+ * JConf Cursor Key
+ *
+ * Description: Scans a key and its colon, and moves to the value.
+ *
+ * @param[in]  {c}   // The cursor.
+ * @param[in]  {key} // Receives the key (not null terminated, escapes kept).
+ * @param[in]  {len} // Receives the length of the key.
+ * @returns          // '1' if successful, '0' on error.
+ */
+static __inline int jconf_cursor_key(jCursor* c, const char** key, size_t* len)
+{
+    jArgs* args = c->args;
+    size_t start;
+
+    if (c->buffer[args->pos] != '\"')
+    {
+        args->e = JCONF_UNEXPECTED_TOK;
+        return 0;
+    }
+
+    start = args->pos + 1;
+    if (!jconf_cursor_scan_string(c, NULL))
+        return 0;
+
+    *key = c->buffer + start;
+    *len = args->pos - start;
+
+    args->pos++;
+    if (!jconf_cursor_space(c)) return 0;
+    if (c->buffer[args->pos] != ':')
+    {
+        args->e = JCONF_UNEXPECTED_TOK;
+        return 0;
+    }
+
+    args->pos++;
+    return jconf_cursor_space(c);
+}
+
+/**
+ * JConf Cursor Next
+ *
+ * Description: Moves past a member or element to the next one, or leaves the
+ *              container at its closing character.
+ *
+ * @param[in]  {c}     // The cursor.
+ * @param[out] {close} // The closing character.
+ * @returns            // '1' at the next value, '0' when the container is
+ *                     // closed, '-1' on error.
+ */
+static __inline int jconf_cursor_next(jCursor* c, char close)
+{
+    jArgs* args = c->args;
+
+    args->pos++;
+    if (!jconf_cursor_space(c)) return -1;
+
+    if (c->buffer[args->pos] == close)
+    {
+        c->depth--;
+        return 0;
+    }
+
+    if (c->buffer[args->pos] != ',')
+    {
+        args->e = JCONF_UNEXPECTED_TOK;
+        return -1;
+    }
+
+    args->pos++;
+    return jconf_cursor_space(c) ? 1 : -1;
+}
+
+/**
+ * JConf Cursor Grow
+ *
+ * Description: Doubles the capacity of an array being decoded.
+ *
+ * @param[in]  {c}    // The cursor.
+ * @param[in]  {data} // The elements.
+ * @param[in]  {cap}  // The capacity.
+ * @param[out] {size} // The size of an element.
+ * @returns           // '1' if successful, '0' if out of memory.
+ */
+static __inline int jconf_cursor_grow(jCursor* c, void** data, size_t* cap, size_t size)
+{
+    size_t grown = *cap ? *cap * 2 : 4;
+    void* p;
+
+    if ((p = jconf_realloc(c->allocator, *data, *cap * size, grown * size)) == NULL)
+    {
+        c->args->e = JCONF_OUT_OF_MEMORY;
+        return 0;
+    }
+
+    *data = p;
+    *cap = grown;
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
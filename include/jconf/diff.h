@@ -0,0 +1,74 @@
+/**
+ * JConf Diff
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Structural diff of two trees, as the operations of a JSON
+ *              Patch (RFC 6902) that turns the first into the second.
+ *              Every container memoizes a 64 bit hash of its content (see
+ *              jconf/hash.h) when it is parsed with jParseOptions.hash set or
+ *              first compared. Subtrees whose hashes differ are known to have
+ *              changed; equal hashes are confirmed with jconf_equal, since
+ *              they can collide, so only subtrees shared by a merge (see
+ *              jconf/merge.h) are skipped without being visited.
+ *              Objects are matched by key; arrays are trimmed of their
+ *              common prefix and suffix and the rest is aligned with the
+ *              shortest edit script of their elements (Myers), falling back
+ *              to matching by position when it is long.
+ *
+ *              Values are compared as jconf_equal does. Hashes are stored in
+ *              the trees, so a tree shared between threads must be hashed
+ *              before it is diffed (see jconf/hash.h), and a tree edited
+ *              other than through jconf_patch_apply (which clears the hashes
+ *              along its paths) must be cleared with jconf_hash_clear.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __DIFF_JCONF_H__
+#define __DIFF_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+
+// Diff operations.
+typedef enum _j_diff_op
+{
+    JCONF_DIFF_ADD = 0,
+    JCONF_DIFF_REMOVE,
+    JCONF_DIFF_REPLACE
+
+} jDiffOp;
+
+// jDiffChange struct definition (one operation of the patch). Array indices
+// in paths account for the operations before them.
+typedef struct _j_diff_change
+{
+    jDiffOp op;
+    const char* path;               // A JSON pointer, valid during the callback.
+    size_t len;
+    const jToken* from;             // The old value (NULL for add).
+    const jToken* to;               // The new value (NULL for remove).
+
+} jDiffChange;
+
+// Change callback. Returns '1' to continue, '0' to stop the diff.
+typedef int (*jDiffCallback)(const jDiffChange*, void*);
+
+// jDiff API. jconf_diff_each returns '1' once every change was reported,
+// '0' if the callback stopped it or memory ran out. jconf_diff returns the
+// patch document allocated with the allocator (an empty array if the trees
+// are equal, NULL if out of memory).
+int     jconf_diff_each(const jToken*, const jToken*, jDiffCallback, void*);
+jToken* jconf_diff(const jToken*, const jToken*, const jAllocator*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * JConf Document
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Frozen documents and lock-free document publication.
+ *
+ *              A jDocument owns a parsed tree that is never modified again,
+ *              so any number of threads may read it concurrently with the
+ *              read-only accessors (jconf_get, jconf_map_get, jconf_array_get).
+ *              Its tree is hashed when it is created and published, so they
+ *              may also compare and diff it (see jconf/hash.h).
+ *
+ *              A jDocSlot holds the current document for hot reloading.
+ *              Readers enter with jconf_doc_acquire and leave with
+ *              jconf_doc_release without taking locks; jconf_doc_publish swaps
+ *              in a new document and frees the old one only after every
+ *              reader that could still see it has left (epoch based
+ *              reclamation, in the style of RCU).
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __DOCUMENT_JCONF_H__
+#define __DOCUMENT_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+
+// jDocument struct definition.
+typedef struct _j_document
+{
+    jToken* root;
+
+} jDocument;
+
+// jDocSlot definition (opaque, holds the published document).
+typedef struct _j_doc_slot jDocSlot;
+
+// jDocReader struct definition (state of one read-side critical section).
+typedef struct _j_doc_reader
+{
+    const jDocument* doc;
+    unsigned int stripe;
+    unsigned int parity;
+
+} jDocReader;
+
+// jDocument API.
+jDocument*       jconf_doc_create(jToken*);
+void             jconf_doc_free(jDocument*);
+const jToken*    jconf_doc_root(const jDocument*);
+
+// jDocSlot API.
+jDocSlot*        jconf_doc_slot_create(jDocument*);
+void             jconf_doc_slot_destroy(jDocSlot*);
+
+void             jconf_doc_publish(jDocSlot*, jDocument*);
+const jDocument* jconf_doc_acquire(jDocSlot*, jDocReader*);
+void             jconf_doc_release(jDocSlot*, jDocReader*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
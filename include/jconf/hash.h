@@ -0,0 +1,53 @@
+/**
+ * JConf Hash
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Content hashes and deep equality of trees. Values hash as
+ *              they compare: numbers by value (integers exactly, however
+ *              many digits they have), strings by their text as
+ *              written in the JSON, arrays in order and objects regardless
+ *              of the order of their members. Hashes do not depend on the
+ *              process (see jconf_map_hash), so a seed gives the same hash
+ *              in every run.
+ *
+ *              Objects and arrays memoize the hash of their content in
+ *              their digest when it is first computed, or while parsing
+ *              with jParseOptions.hash set. jconf_equal only reads the
+ *              digests, to reject containers that differ without visiting
+ *              them, so it is as safe to call from threads as jconf_get.
+ *              A tree edited other than through jconf_patch_apply must have
+ *              its digests cleared with jconf_hash_clear.
+ *
+ *              Hashing (and so diffing) writes the digests through a const
+ *              tree. A tree shared between threads must be hashed before it
+ *              is shared: jconf_doc_create, jconf_doc_publish and parsing
+ *              with jParseOptions.hash do so. Hashing a shared tree lazily
+ *              is not supported; the digests are relaxed atomics only so
+ *              that the memo itself is not a data race.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __HASH_JCONF_H__
+#define __HASH_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+
+// jHash API. jconf_hash_token memoizes the digests of the tree, so hash a
+// tree before sharing it between threads.
+jHash jconf_hash_token(const jToken*, uint64_t);
+void  jconf_hash_clear(jToken*);
+int   jconf_equal(const jToken*, const jToken*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
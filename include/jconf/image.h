@@ -0,0 +1,75 @@
+/**
+ * JConf Image
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: A compact, relocatable binary encoding of parsed jToken trees.
+ *              Images contain no pointers (only offsets from the start of the
+ *              image) and carry precomputed hash indexes for objects, so a
+ *              buffer that was written once can be mapped into memory and
+ *              queried directly without a parse step.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __IMAGE_JCONF_H__
+#define __IMAGE_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+#include <stddef.h>  // For size_t.
+#include <stdint.h>  // For fixed width integers.
+
+#define JCONF_IMAGE_MAGIC   0x464E434Au // "JCNF" in little endian.
+#define JCONF_IMAGE_VERSION 1
+#define JCONF_IMAGE_ORDER   0x01020304u // Byte order marker.
+
+// Offset of a value within an image (0 is never a valid value).
+typedef uint32_t jImageRef;
+
+// jImage header definition (stored at offset 0 of every image).
+typedef struct _j_image_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t order;
+    uint32_t size;
+    jImageRef root;
+    uint32_t reserved;
+
+} jImageHeader;
+
+// jImage struct definition (a read-only view over an image buffer).
+typedef struct _j_image
+{
+    const unsigned char* base;
+    uint32_t size;
+
+} jImage;
+
+// jImage writer API.
+size_t      jconf_image_size(jToken*);
+size_t      jconf_image_write(jToken*, void*, size_t);
+
+// jImage reader API.
+int         jconf_image_open(jImage*, const void*, size_t);
+jImageRef   jconf_image_root(const jImage*);
+jImageRef   jconf_image_get(const jImage*, jImageRef, const char*, ...);
+
+jType       jconf_image_type(const jImage*, jImageRef);
+uint32_t    jconf_image_count(const jImage*, jImageRef);
+const char* jconf_image_string(const jImage*, jImageRef, uint32_t*);
+
+jImageRef   jconf_image_index(const jImage*, jImageRef, uint32_t);
+jImageRef   jconf_image_key(const jImage*, jImageRef, const char*, uint32_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,397 @@
+/**
+ * JConf C++ API
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Header-only C++17 layer over the C API. A jconf::document owns
+ *              a parsed tree and frees it when it goes out of scope, and
+ *              jconf::value_ref is a pointer-sized view of a token with
+ *              accessors for keys, indices, iteration and typed values. Every
+ *              member is inline and calls straight into the C functions; no
+ *              member allocates or copies (strings are views of the tree).
+ *              Keys written as "name"_jk carry their length and their
+ *              process independent hash (jconf_map_hash), computed at compile
+ *              time. Maps place keys with the seeded jconf_map_key_hash, which
+ *              cannot be known ahead of time, so lookups hash the key again.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __JCONF_HPP__
+#define __JCONF_HPP__
+
+#include "parser.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace jconf
+{
+
+class value_ref;
+
+namespace detail
+{
+    // A constexpr copy of jconf_map_hash (src/map.c); the two must match.
+    constexpr std::uint64_t P0 = 0x2d358dccaa6c78a5ull;
+    constexpr std::uint64_t P1 = 0x8bb84b93962eacc9ull;
+    constexpr std::uint64_t P2 = 0x4b33a62ed433d4a3ull;
+    constexpr std::uint64_t P3 = 0x4d5a2da51de1aa47ull;
+
+    constexpr void mum(std::uint64_t& a, std::uint64_t& b) noexcept
+    {
+        std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+        std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        std::uint64_t t = rl + (rm0 << 32), c = t < rl;
+        std::uint64_t lo = t + (rm1 << 32);
+
+        c += lo < t;
+        a ^= lo;
+        b ^= rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    }
+
+    constexpr std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept
+    {
+        mum(a, b);
+        return a ^ b;
+    }
+
+    constexpr std::uint64_t read8(const char* p) noexcept
+    {
+        std::uint64_t v = 0;
+        for (int i = 7; i >= 0; i--)
+            v = (v << 8) | static_cast<unsigned char>(p[i]);
+        return v;
+    }
+
+    constexpr std::uint64_t read4(const char* p) noexcept
+    {
+        return static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) |
+            static_cast<std::uint64_t>(static_cast<unsigned char>(p[1])) << 8 |
+            static_cast<std::uint64_t>(static_cast<unsigned char>(p[2])) << 16 |
+            static_cast<std::uint64_t>(static_cast<unsigned char>(p[3])) << 24;
+    }
+}
+
+// Hashes a key exactly like jconf_map_hash, at compile time when the key is
+// a constant.
+constexpr jHash hash(const char* p, std::size_t len) noexcept
+{
+    std::uint64_t seed = detail::mix(detail::P0, detail::P1), see1 = 0, see2 = 0, a = 0, b = 0;
+    std::size_t i = len;
+
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            a = (detail::read4(p) << 32) | detail::read4(p + ((len >> 3) << 2));
+            b = (detail::read4(p + len - 4) << 32) | detail::read4(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (len > 0)
+        {
+            a = static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) << 16 |
+                static_cast<std::uint64_t>(static_cast<unsigned char>(p[len >> 1])) << 8 |
+                static_cast<unsigned char>(p[len - 1]);
+        }
+    }
+    else
+    {
+        if (i > 48)
+        {
+            see1 = see2 = seed;
+            do
+            {
+                seed = detail::mix(detail::read8(p) ^ detail::P1, detail::read8(p + 8) ^ seed);
+                see1 = detail::mix(detail::read8(p + 16) ^ detail::P2, detail::read8(p + 24) ^ see1);
+                see2 = detail::mix(detail::read8(p + 32) ^ detail::P3, detail::read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            }
+            while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+
+        for (; i > 16; i -= 16, p += 16)
+            seed = detail::mix(detail::read8(p) ^ detail::P1, detail::read8(p + 8) ^ seed);
+
+        a = detail::read8(p + i - 16);
+        b = detail::read8(p + i - 8);
+    }
+
+    a ^= detail::P1;
+    b ^= seed;
+    detail::mum(a, b);
+    return detail::mix(a ^ detail::P0 ^ len, b ^ detail::P1);
+}
+
+// A key with its length and unseeded hash (see the _jk literal).
+struct key
+{
+    const char* data;
+    std::size_t size;
+    jHash hash;
+
+    constexpr key(const char* data, std::size_t size) noexcept : data(data), size(size), hash(jconf::hash(data, size)) {}
+    explicit constexpr key(std::string_view name) noexcept : key(name.data(), name.size()) {}
+};
+
+namespace literals
+{
+    // "servers"_jk is a key measured and hashed at compile time.
+    constexpr key operator""_jk(const char* name, std::size_t size) noexcept
+    {
+        return key(name, size);
+    }
+}
+
+// Iterates the elements of an array.
+class array_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = value_ref;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_ref;
+
+    array_iterator(const jArray* arr, std::size_t index) noexcept : arr_(arr), index_(index) {}
+
+    inline value_ref operator*() const noexcept;
+    array_iterator& operator++() noexcept { ++index_; return *this; }
+    array_iterator operator++(int) noexcept { array_iterator it = *this; ++index_; return it; }
+    bool operator==(const array_iterator& other) const noexcept { return index_ == other.index_; }
+    bool operator!=(const array_iterator& other) const noexcept { return index_ != other.index_; }
+
+private:
+    const jArray* arr_;
+    std::size_t index_;
+};
+
+// Iterates the members of an object in document order.
+class object_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<std::string_view, value_ref>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    explicit object_iterator(const jNode* node) noexcept : node_(node) {}
+
+    inline value_type operator*() const noexcept;
+    object_iterator& operator++() noexcept { node_ = node_->after; return *this; }
+    object_iterator operator++(int) noexcept { object_iterator it = *this; node_ = node_->after; return it; }
+    bool operator==(const object_iterator& other) const noexcept { return node_ == other.node_; }
+    bool operator!=(const object_iterator& other) const noexcept { return node_ != other.node_; }
+
+private:
+    const jNode* node_;
+};
+
+// A begin and end pair for range-for.
+template <class Iterator>
+class range
+{
+public:
+    range(Iterator first, Iterator last) noexcept : first_(first), last_(last) {}
+
+    Iterator begin() const noexcept { return first_; }
+    Iterator end() const noexcept { return last_; }
+
+private:
+    Iterator first_, last_;
+};
+
+// A view of a token. A null view stands for a missing value: its accessors
+// return null views and its typed values are the defaults.
+class value_ref
+{
+public:
+    constexpr value_ref() noexcept : token_(nullptr) {}
+    constexpr value_ref(const jToken* token) noexcept : token_(token) {}
+
+    const jToken* token() const noexcept { return token_; }
+    explicit operator bool() const noexcept { return token_ != nullptr; }
+
+    jType type() const noexcept { return token_->type; }
+    bool is_null() const noexcept { return token_ != nullptr && token_->type == JCONF_NULL; }
+    bool is_bool() const noexcept { return token_ != nullptr && (token_->type == JCONF_TRUE || token_->type == JCONF_FALSE); }
+    bool is_number() const noexcept { return token_ != nullptr && (token_->type == JCONF_INT || token_->type == JCONF_DOUBLE); }
+    bool is_string() const noexcept { return token_ != nullptr && token_->type == JCONF_STRING; }
+    bool is_array() const noexcept { return token_ != nullptr && token_->type == JCONF_ARRAY; }
+    bool is_object() const noexcept { return token_ != nullptr && token_->type == JCONF_OBJECT; }
+
+    // Looks up a member of an object.
+    value_ref operator[](std::string_view key) const noexcept
+    {
+        if (!is_object() || token_->data == nullptr)
+            return value_ref();
+        return static_cast<const jToken*>(jconf_map_get_n(static_cast<const jMap*>(token_->data), key.data(), key.size()));
+    }
+
+    value_ref operator[](const char* key) const noexcept { return (*this)[std::string_view(key)]; }
+
+    // Looks up a member with a key of known length (buckets are seeded, so
+    // the key is hashed with the process seed here).
+    value_ref operator[](const jconf::key& key) const noexcept
+    {
+        if (!is_object() || token_->data == nullptr)
+            return value_ref();
+        return static_cast<const jToken*>(jconf_map_get_n(static_cast<const jMap*>(token_->data), key.data, key.size));
+    }
+
+    // Looks up an element of an array.
+    value_ref operator[](std::size_t index) const noexcept
+    {
+        if (!is_array() || token_->data == nullptr)
+            return value_ref();
+        return static_cast<const jToken*>(jconf_array_get(static_cast<const jArray*>(token_->data), index));
+    }
+
+    value_ref operator[](int index) const noexcept { return index < 0 ? value_ref() : (*this)[static_cast<std::size_t>(index)]; }
+
+    // The number of elements or members.
+    std::size_t size() const noexcept
+    {
+        if (is_array() && token_->data != nullptr)
+            return static_cast<const jArray*>(token_->data)->end;
+        if (is_object() && token_->data != nullptr)
+            return static_cast<const jMap*>(token_->data)->count;
+        return 0;
+    }
+
+    // The elements of an array (none for other values).
+    array_iterator begin() const noexcept { return array_iterator(array(), 0); }
+    array_iterator end() const noexcept { return array_iterator(array(), is_array() ? size() : 0); }
+
+    // The members of an object in document order (none for other values).
+    range<object_iterator> members() const noexcept
+    {
+        const jNode* first = is_object() && token_->data != nullptr ? static_cast<const jMap*>(token_->data)->first : nullptr;
+        return range<object_iterator>(object_iterator(first), object_iterator(nullptr));
+    }
+
+    // Typed values: bool, integers, floating point and std::string_view.
+    // Numbers are converted from their text; strings are views of the tree
+    // (with escape sequences as written).
+    template <class T>
+    T get() const noexcept
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            return token_ != nullptr && token_->type == JCONF_TRUE;
+        else if constexpr (std::is_same_v<T, std::string_view>)
+            return is_string() ? std::string_view(static_cast<const char*>(token_->data)) : std::string_view();
+        else if constexpr (std::is_integral_v<T>)
+        {
+            if (!is_number())
+                return T();
+            if (token_->type == JCONF_DOUBLE)
+                return static_cast<T>(std::strtod(static_cast<const char*>(token_->data), nullptr));
+            if constexpr (std::is_signed_v<T>)
+                return static_cast<T>(std::strtoll(static_cast<const char*>(token_->data), nullptr, 10));
+            else
+                return static_cast<T>(std::strtoull(static_cast<const char*>(token_->data), nullptr, 10));
+        }
+        else
+        {
+            static_assert(std::is_floating_point_v<T>, "jconf::value_ref::get supports bool, integers, floating point and std::string_view");
+            return is_number() ? static_cast<T>(std::strtod(static_cast<const char*>(token_->data), nullptr)) : T();
+        }
+    }
+
+    // A typed value, or a fallback when the value is missing or of another type.
+    template <class T>
+    T get_or(T fallback) const noexcept
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            return is_bool() ? get<bool>() : fallback;
+        else if constexpr (std::is_same_v<T, std::string_view>)
+            return is_string() ? get<std::string_view>() : fallback;
+        else
+            return is_number() ? get<T>() : fallback;
+    }
+
+private:
+    const jArray* array() const noexcept { return is_array() ? static_cast<const jArray*>(token_->data) : nullptr; }
+
+    const jToken* token_;
+};
+
+inline value_ref array_iterator::operator*() const noexcept
+{
+    return static_cast<const jToken*>(jconf_array_get(arr_, index_));
+}
+
+inline object_iterator::value_type object_iterator::operator*() const noexcept
+{
+    return value_type(std::string_view(node_->key, node_->len), static_cast<const jToken*>(node_->value));
+}
+
+// A parsed tree. Documents are move-only and free their tree (with the
+// allocator it was parsed with) when destroyed.
+class document
+{
+public:
+    document() noexcept : root_(nullptr), allocator_(nullptr) {}
+    explicit document(jToken* root, const jAllocator* allocator = nullptr) noexcept : root_(root), allocator_(allocator) {}
+
+    document(const document&) = delete;
+    document& operator=(const document&) = delete;
+
+    document(document&& other) noexcept : root_(other.root_), allocator_(other.allocator_) { other.root_ = nullptr; }
+
+    document& operator=(document&& other) noexcept
+    {
+        if (this != &other)
+        {
+            jconf_free_token_with(root_, allocator_);
+            root_ = other.root_;
+            allocator_ = other.allocator_;
+            other.root_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~document() { jconf_free_token_with(root_, allocator_); }
+
+    // Parses a buffer (args receives the error, if any).
+    static document parse(std::string_view json, jArgs* args = nullptr) noexcept
+    {
+        jArgs local;
+        return document(jconf_json2c(json.data(), json.size(), args != nullptr ? args : &local));
+    }
+
+    static document parse(std::string_view json, const jParseOptions& options, jArgs* args = nullptr) noexcept
+    {
+        jArgs local;
+        return document(jconf_json2c_ex(json.data(), json.size(), &options, args != nullptr ? args : &local), options.allocator);
+    }
+
+    explicit operator bool() const noexcept { return root_ != nullptr; }
+    value_ref root() const noexcept { return root_; }
+
+    value_ref operator[](std::string_view key) const noexcept { return root()[key]; }
+    value_ref operator[](const char* key) const noexcept { return root()[key]; }
+    value_ref operator[](const jconf::key& key) const noexcept { return root()[key]; }
+    value_ref operator[](std::size_t index) const noexcept { return root()[index]; }
+    value_ref operator[](int index) const noexcept { return root()[index]; }
+
+    // Gives up ownership of the tree.
+    jToken* release() noexcept { jToken* root = root_; root_ = nullptr; return root; }
+
+private:
+    jToken* root_;
+    const jAllocator* allocator_;
+};
+
+} // namespace jconf
+
+#endif
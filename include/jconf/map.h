@@ -18,36 +18,67 @@ extern "C" {
 #endif
 
 #include "string.h"     // For safe string functions.
+#include "alloc.h"      // For custom allocators.
+#include "atomic.h"     // For the fields shared between threads.
 #include <stdlib.h>     // For standard macros and dynamic memory allocation.
+#include <stdint.h>     // For uint64_t.
 
-#define JCONF_BUCKET_SIZE 100
+// The number of buckets allocated by the first insertion (a power of two).
+#define JCONF_MAP_MIN_SIZE 8
+
+// Full key hash cached in each node (see jconf_map_key_hash).
+typedef uint64_t jHash;
 
 // Struct definition for linked list nodes.
 typedef struct _j_node
 {
     const char* key;
     void* value;
-    int len;
-    struct _j_node* next;
+    size_t len;
+    jHash hash;
+    struct _j_node* next;   // The next node in the bucket.
+    struct _j_node* after;  // The next node in insertion order.
+    struct _j_node* before; // The previous node in insertion order.
 
 } jNode;
 
-// Struct definition for map.
+// Struct definition for map. The bucket count is a power of two (or zero
+// before the first insertion) and doubles when count reaches it.
 typedef struct _j_map
 {
-    jNode* buckets[JCONF_BUCKET_SIZE];
-    int count;
+    jNode** buckets;
+    jNode *first, *last;
+    size_t size;
+    size_t count;
+    const jAllocator* allocator;
+    JCONF_ATOMIC(jHash) digest;     // Content hash of the object (0 until computed, see jconf/hash.h).
+    JCONF_ATOMIC(size_t) refs;      // Trees sharing the object besides its owner (see jconf/merge.h).
 
 } jMap;
 
 // jMap API.
 void   jconf_init_map(jMap*);
+void   jconf_init_map_with(jMap*, const jAllocator*);
 void   jconf_destroy_map(jMap*);
 
-int    jconf_map_set(jMap*, const char*, int, void*, void**);
-void*  jconf_map_get(jMap*, const char*);
+int    jconf_map_set(jMap*, const char*, size_t, void*, void**);
+int    jconf_map_add(jMap*, const char*, size_t, void*, jNode**);
+int    jconf_map_append(jMap*, const char*, size_t, void*);
+void*  jconf_map_get(const jMap*, const char*);
+void*  jconf_map_get_n(const jMap*, const char*, size_t);
+void*  jconf_map_get_hashed(const jMap*, const char*, size_t, jHash);
+jHash  jconf_map_hash(const char*, size_t);
+jHash  jconf_map_key_hash(const char*, size_t);
+int    jconf_map_probe(const jMap*, const char*, size_t);
 void   jconf_map_delete(jMap*, jNode*, const char*);
 
+jNode* jconf_map_find_node(const jMap*, const char*, size_t, jHash);
+void   jconf_map_unlink(jMap*, jNode*);
+void   jconf_map_relink(jMap*, jNode*);
+
+uint64_t jconf_map_seed(void);
+void     jconf_map_set_seed(uint64_t);
+
 #ifdef __cplusplus
 }
 #endif
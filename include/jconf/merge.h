@@ -0,0 +1,69 @@
+/**
+ * JConf Merge
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Layered merging of trees with JSON Merge Patch (RFC 7396)
+ *              semantics: the members of an overlay object are merged into
+ *              the base object, null members remove keys and any other
+ *              value replaces the base, except that arrays may be merged by
+ *              a policy.
+ *
+ *              The merged tree shares the objects and arrays that the merge
+ *              left unchanged with its inputs instead of copying them: a
+ *              shared container counts the trees that refer to it besides
+ *              its owner, and jconf_free_token frees it with the last one.
+ *              Only the objects on the paths of the overlay are rebuilt (and
+ *              their scalar members copied), so merging a small overlay into
+ *              a large base costs the width of those objects, not the size
+ *              of the base, and the trees may be freed in any order.
+ *
+ *              Shared containers must not be edited in place.
+ *              jconf_patch_apply replaces the shared containers on the paths
+ *              it edits with copies (jconf_unshare_with), so patching one
+ *              tree leaves the others unchanged; other edits need a
+ *              jconf_copy_token. The inputs and the result must have been
+ *              allocated with the same allocator. The counts are atomic, so
+ *              an input may be merged from several threads at once, but not
+ *              freed while it is being merged.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __MERGE_JCONF_H__
+#define __MERGE_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+
+// Array merge policies (for arrays in the overlay where the base has arrays).
+typedef enum _j_merge_policy
+{
+    JCONF_MERGE_REPLACE = 0,    // The overlay array replaces the base (RFC 7396).
+    JCONF_MERGE_APPEND,         // The overlay elements are appended to the base.
+    JCONF_MERGE_UNION,          // The overlay elements not already present (see jconf_equal) are appended.
+    JCONF_MERGE_INDEX           // Elements are merged with the base element at their index;
+                                // elements past the end of the base are appended.
+
+} jMergePolicy;
+
+// jMerge API. The base may be NULL (absent). Returns the merged tree (NULL if
+// out of memory), freed with jconf_free_token (or jconf_free_token_with).
+jToken* jconf_merge(const jToken*, const jToken*, jMergePolicy);
+jToken* jconf_merge_with(const jToken*, const jToken*, jMergePolicy, const jAllocator*);
+
+// Sharing API (used by jconf_patch_apply to copy shared containers before
+// editing them).
+int     jconf_shared(const jToken*);
+jToken* jconf_unshare_with(const jToken*, const jAllocator*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -40,7 +40,10 @@ typedef enum _j_err_code
     JCONF_UNEXPECTED_EOF,
     JCONF_EXPECTED_EOF,
     JCONF_INVALID_NUMBER,
-    JCONF_OUT_OF_MEMORY
+    JCONF_OUT_OF_MEMORY,
+    JCONF_DUPLICATE_KEY,
+    JCONF_MAX_DEPTH,
+    JCONF_TYPE_MISMATCH
 
 } J_ERROR_CODE;
 
@@ -70,15 +73,96 @@ typedef struct _j_token
 typedef struct _j_args
 {
     J_ERROR_CODE e;
-    int line;
-    int pos;
+    size_t line;
+    size_t pos;
 
 } jArgs;
 
-// JConf API.
-jToken* jconf_json2c(const char*, int, jArgs*);
-jToken* jconf_get(jToken*, const char*, ...);
+// jParseStats struct definition. Statistics are only collected when the
+// library is built with JCONF_STATS defined (e.g make STATS=1); otherwise the
+// instrumentation is compiled out and the struct is left untouched.
+typedef struct _j_parse_stats
+{
+    size_t tokens[JCONF_INT + 1];          // Tokens by jType.
+    int max_depth;                         // Deepest container nesting.
+    size_t string_bytes, escapes;          // Bytes of strings and keys, escape sequences.
+    size_t allocs, alloc_bytes;            // Allocations made by the parser.
+    size_t map_inserts, map_collisions;    // Keys inserted, inserts into non-empty buckets.
+    size_t map_probes;                     // Entries compared while inserting.
+    int map_max_probe;                     // Longest comparison chain.
+    double time_total, time_strings, time_numbers; // Phase timings (seconds).
+
+} jParseStats;
+
+// Duplicate key policies. Repeated keys in an object are detected by the
+// same map probe that inserts the member.
+typedef enum _j_dup_policy
+{
+    JCONF_DUP_LAST_WINS = 0,    // Keep the first key, replace its value (default).
+    JCONF_DUP_FIRST_WINS,       // Keep the first value, discard the repeats.
+    JCONF_DUP_ERROR,            // Fail with JCONF_DUPLICATE_KEY at the repeated key.
+    JCONF_DUP_KEEP_ALL,         // Keep every member (lookups return the last).
+    JCONF_DUP_TRUSTED           // No duplicate checks; members are appended.
+
+} jDupPolicy;
+
+// Parse modes. Each mode is compiled into its own scanner, so a mode pays
+// nothing for the syntax it does not accept.
+typedef enum _j_parse_mode
+{
+    JCONF_MODE_DEFAULT = 0,     // Comments, an object or array at the root.
+    JCONF_MODE_STRICT,          // RFC 8259: no comments, any value at the root, strict
+                                // numbers and strings, nothing but space after the root.
+    JCONF_MODE_RELAXED          // Config files: comments, trailing commas, single quoted
+                                // strings and unquoted keys.
+
+} jParseMode;
+
+// The deepest nesting jconf_validate accepts (one bit of its stack per level).
+#define JCONF_VALIDATE_MAX_DEPTH 65536
+
+// jParseOptions struct definition (per call settings for jconf_json2c_ex).
+typedef struct _j_parse_options
+{
+    const jAllocator* allocator;
+    jParseStats* stats;
+    jDupPolicy duplicates;
+    jParseMode mode;
+    int hash;                   // Memoize the hash of every object and array (see jconf/hash.h).
+
+} jParseOptions;
+
+// jObjectIter struct definition (walks an object's members in document order).
+typedef struct _j_object_iter
+{
+    const jNode* node;
+
+} jObjectIter;
+
+// jArrayIter struct definition (walks an array's elements).
+typedef struct _j_array_iter
+{
+    const jArray* arr;
+    size_t index;
+
+} jArrayIter;
+
+// JConf API. jconf_get (like jconf_map_get and jconf_array_get) only reads the
+// tree, so concurrent calls are safe as long as no thread modifies it.
+jToken* jconf_json2c(const char*, size_t, jArgs*);
+jToken* jconf_json2c_ex(const char*, size_t, const jParseOptions*, jArgs*);
+int jconf_validate(const char*, size_t, jParseMode, jArgs*);
+jToken* jconf_get(const jToken*, const char*, ...);
 void jconf_free_token(jToken*);
+void jconf_free_token_with(jToken*, const jAllocator*);
+jToken* jconf_copy_token(const jToken*);
+jToken* jconf_copy_token_with(const jToken*, const jAllocator*);
+
+// JConf iteration API.
+void jconf_object_iter_begin(const jToken*, jObjectIter*);
+int  jconf_object_iter_next(jObjectIter*, const char**, size_t*, jToken**);
+void jconf_array_iter_begin(const jToken*, jArrayIter*);
+int  jconf_array_iter_next(jArrayIter*, jToken**);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,98 @@
+/**
+ * JConf Patch
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: JSON Pointer (RFC 6901) and JSON Patch (RFC 6902) on trees.
+ *              A pointer is compiled once into reference tokens with their
+ *              keys hashed and array indices parsed, so resolving it costs
+ *              one pre-hashed probe or one index per level. A patch is
+ *              compiled from a patch document into steps of compiled
+ *              pointers and applied in place through jMap and jArray. Every
+ *              change is logged, so a step that fails (e.g a test) rolls the
+ *              whole patch back. Objects and arrays shared with other trees
+ *              by a merge (see jconf/merge.h) are copied before they change,
+ *              so patching a merged tree leaves its inputs unchanged.
+ *
+ *              Keys are compared with their text as written in the JSON, as
+ *              jconf_get does, so pointers are not unescaped beyond ~0 and ~1.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __PATCH_JCONF_H__
+#define __PATCH_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+
+// Array indices of reference tokens that are not one.
+#define JCONF_POINTER_NONE ((size_t)-1)     // Not an array index.
+#define JCONF_POINTER_END  ((size_t)-2)     // "-", past the last element.
+
+// jPointerRef struct definition (one reference token).
+typedef struct _j_pointer_ref
+{
+    const char* key;                        // The key, with ~1 and ~0 decoded.
+    size_t len;
+    jHash hash;                             // jconf_map_key_hash of the key.
+    size_t index;                           // The array index it names.
+
+} jPointerRef;
+
+// jPointer struct definition.
+typedef struct _j_pointer
+{
+    jPointerRef* refs;
+    size_t count;                           // 0 for "", the whole document.
+    char* keys;
+
+} jPointer;
+
+// Patch Error Codes.
+typedef enum _j_patch_error
+{
+    JCONF_PATCH_OK = 0,
+    JCONF_PATCH_INVALID,            // The patch document or a pointer is malformed.
+    JCONF_PATCH_NOT_FOUND,          // A path (or its parent) does not exist.
+    JCONF_PATCH_TEST_FAILED,
+    JCONF_PATCH_OUT_OF_MEMORY
+
+} jPatchError;
+
+// jPatchResult struct definition. On error, op is the index of the failing
+// operation.
+typedef struct _j_patch_result
+{
+    jPatchError e;
+    size_t op;
+
+} jPatchResult;
+
+// jPatch definition (opaque, a compiled patch).
+typedef struct _j_patch jPatch;
+
+// jPointer API.
+int     jconf_pointer_compile(jPointer*, const char*, size_t);
+void    jconf_pointer_free(jPointer*);
+jToken* jconf_pointer_get(const jToken*, const jPointer*);
+jToken* jconf_pointer_resolve(const jToken*, const char*);
+
+// jPatch API. A compiled patch refers to the values of the patch document,
+// which must outlive it; applying copies them into the tree. The allocator
+// is the one the tree was built with (NULL for the default). On error the
+// tree is left as it was.
+jPatch* jconf_patch_compile(const jToken*, jPatchResult*);
+void    jconf_patch_free(jPatch*);
+int     jconf_patch_apply(const jPatch*, jToken**, const jAllocator*, jPatchResult*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
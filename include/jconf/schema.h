@@ -0,0 +1,78 @@
+/**
+ * JConf Schema
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Validates trees against a JSON Schema (draft 7 subset). The
+ *              schema is compiled once into a program of nodes with the
+ *              property names of each object hashed ahead of time, so checking
+ *              an object is one pre-hashed probe per property. Supported
+ *              keywords are type, enum, const, properties, required, items (a
+ *              single schema), minimum, maximum, exclusiveMinimum,
+ *              exclusiveMaximum, minLength, maxLength, minItems, maxItems,
+ *              minProperties and maxProperties. Annotations and unknown
+ *              keywords are ignored; other validation keywords are rejected.
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#ifndef __SCHEMA_JCONF_H__
+#define __SCHEMA_JCONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser.h"
+
+// The longest path reported in a jSchemaResult (longer paths are truncated).
+#define JCONF_SCHEMA_PATH 256
+
+// Schema Error Codes.
+typedef enum _j_schema_error
+{
+    JCONF_SCHEMA_OK = 0,
+    JCONF_SCHEMA_INVALID,           // The schema is malformed.
+    JCONF_SCHEMA_UNSUPPORTED,       // The schema uses a keyword outside the subset.
+    JCONF_SCHEMA_OUT_OF_MEMORY,
+    JCONF_SCHEMA_TYPE,
+    JCONF_SCHEMA_ENUM,              // Not one of enum, or not equal to const.
+    JCONF_SCHEMA_MINIMUM,
+    JCONF_SCHEMA_MAXIMUM,
+    JCONF_SCHEMA_MIN_LENGTH,
+    JCONF_SCHEMA_MAX_LENGTH,
+    JCONF_SCHEMA_MIN_ITEMS,
+    JCONF_SCHEMA_MAX_ITEMS,
+    JCONF_SCHEMA_MIN_PROPERTIES,
+    JCONF_SCHEMA_MAX_PROPERTIES,
+    JCONF_SCHEMA_REQUIRED
+
+} jSchemaError;
+
+// jSchemaResult struct definition. On error, token is the failing value (or
+// schema value when compiling) and path is its JSON pointer (e.g /servers/0).
+typedef struct _j_schema_result
+{
+    jSchemaError e;
+    const jToken* token;
+    char path[JCONF_SCHEMA_PATH];
+
+} jSchemaResult;
+
+// jSchema definition (opaque, a compiled schema).
+typedef struct _j_schema jSchema;
+
+// jSchema API. A compiled schema refers to the names and enum values of the
+// schema tree, which must outlive it. Checks only read the schema and the
+// tree, so one schema can check trees from any number of threads.
+jSchema* jconf_schema_compile(const jToken*, jSchemaResult*);
+void     jconf_schema_free(jSchema*);
+int      jconf_schema_check(const jSchema*, const jToken*, jSchemaResult*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -17,11 +17,13 @@
 extern "C" {
 #endif
 
+#include <stddef.h> // For size_t.
+
 // String library.
-int  jconf_strncmp(const char*, const char*, int);
-int  jconf_strcmp(const char*, const char*);
-void jconf_strncpy(char*, const char*, int);
-int  jconf_strlen(const char*);
+int    jconf_strncmp(const char*, const char*, size_t);
+int    jconf_strcmp(const char*, const char*);
+void   jconf_strncpy(char*, const char*, size_t);
+size_t jconf_strlen(const char*);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,214 @@
+/**
+ * JConf Alloc Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/alloc.h>
+#include <stdlib.h>
+#include <stddef.h>
+
+// The allocator used in place of NULL (libc when unset).
+static const jAllocator* jconf_default_allocator = NULL;
+
+// Header stored before each block of a counting allocator (keeps alignment).
+typedef union _j_alloc_header
+{
+    size_t size;
+    max_align_t align;
+
+} jAllocHeader;
+
+/**
+ * JConf Set Allocator
+ *
+ * Description: Sets the allocator used wherever no allocator is provided,
+ *              which includes every structure created by jconf_json2c. It
+ *              should be set before any JConf memory is allocated and not
+ *              changed while that memory is alive.
+ * @param[out] {allocator} // The default allocator (NULL for libc).
+ */
+void jconf_set_allocator(const jAllocator* allocator)
+{
+    jconf_default_allocator = allocator;
+}
+
+/**
+ * JConf Get Allocator
+ *
+ * Description: Returns the default allocator.
+ * @returns // The default allocator (NULL for libc).
+ */
+const jAllocator* jconf_get_allocator(void)
+{
+    return jconf_default_allocator;
+}
+
+/**
+ * JConf Malloc
+ *
+ * Description: Allocates memory with the provided allocator.
+ * @param[out] {allocator} // The allocator (NULL for malloc).
+ * @param[out] {size}      // The number of bytes to allocate.
+ * @returns                // The memory (NULL if out of memory).
+ */
+void* jconf_malloc(const jAllocator* allocator, size_t size)
+{
+    if (allocator == NULL && (allocator = jconf_default_allocator) == NULL)
+        return malloc(size);
+
+    return allocator->alloc(allocator->ctx, size);
+}
+
+/**
+ * JConf Realloc
+ *
+ * Description: Resizes memory with the provided allocator.
+ * @param[out] {allocator} // The allocator (NULL for realloc).
+ * @param[out] {ptr}       // The memory to resize.
+ * @param[out] {old_size}  // The current size of the memory.
+ * @param[out] {size}      // The new size.
+ * @returns                // The memory (NULL if out of memory).
+ */
+void* jconf_realloc(const jAllocator* allocator, void* ptr, size_t old_size, size_t size)
+{
+    if (allocator == NULL && (allocator = jconf_default_allocator) == NULL)
+        return realloc(ptr, size);
+
+    return allocator->realloc(allocator->ctx, ptr, old_size, size);
+}
+
+/**
+ * JConf Free
+ *
+ * Description: Frees memory with the provided allocator.
+ * @param[out] {allocator} // The allocator (NULL for free).
+ * @param[out] {ptr}       // The memory to free.
+ */
+void jconf_free(const jAllocator* allocator, void* ptr)
+{
+    if (allocator == NULL && (allocator = jconf_default_allocator) == NULL)
+        free(ptr);
+    else if (ptr != NULL)
+        allocator->free(allocator->ctx, ptr);
+}
+
+/**
+ * JConf Counting Alloc
+ *
+ * Description: Allocates from the parent allocator and counts the request.
+ * @param[in]  {ctx}  // The jAllocCounter.
+ * @param[out] {size} // The number of bytes to allocate.
+ * @returns           // The memory (NULL if out of memory).
+ */
+static void* jconf_counting_alloc(void* ctx, size_t size)
+{
+    jAllocCounter* counter = (jAllocCounter*)ctx;
+    jAllocHeader* header;
+
+    // The parent is called directly so a counting default allocator does not recurse.
+    if (counter->parent != NULL)
+        header = (jAllocHeader*)counter->parent->alloc(counter->parent->ctx, sizeof(*header) + size);
+    else
+        header = (jAllocHeader*)malloc(sizeof(*header) + size);
+
+    if (header == NULL)
+        return NULL;
+
+    header->size = size;
+    counter->allocs++;
+    counter->bytes += size;
+
+    if ((counter->live += size) > counter->peak)
+        counter->peak = counter->live;
+
+    return header + 1;
+}
+
+/**
+ * JConf Counting Realloc
+ *
+ * Description: Resizes memory from the parent allocator and counts the request.
+ * @param[in]  {ctx}      // The jAllocCounter.
+ * @param[out] {ptr}      // The memory to resize.
+ * @param[out] {old_size} // The current size of the memory.
+ * @param[out] {size}     // The new size.
+ * @returns               // The memory (NULL if out of memory).
+ */
+static void* jconf_counting_realloc(void* ctx, void* ptr, size_t old_size, size_t size)
+{
+    jAllocCounter* counter = (jAllocCounter*)ctx;
+    jAllocHeader* header;
+
+    if (ptr == NULL)
+        return jconf_counting_alloc(ctx, size);
+
+    header = (jAllocHeader*)ptr - 1;
+    old_size = header->size;
+
+    if (counter->parent != NULL)
+        header = (jAllocHeader*)counter->parent->realloc(counter->parent->ctx, header,
+            sizeof(*header) + old_size, sizeof(*header) + size);
+    else
+        header = (jAllocHeader*)realloc(header, sizeof(*header) + size);
+
+    if (header == NULL)
+        return NULL;
+
+    header->size = size;
+    counter->reallocs++;
+    counter->bytes += size;
+    counter->live = counter->live - old_size + size;
+
+    if (counter->live > counter->peak)
+        counter->peak = counter->live;
+
+    return header + 1;
+}
+
+/**
+ * JConf Counting Free
+ *
+ * Description: Frees memory to the parent allocator and counts the request.
+ * @param[in]  {ctx} // The jAllocCounter.
+ * @param[out] {ptr} // The memory to free.
+ */
+static void jconf_counting_free(void* ctx, void* ptr)
+{
+    jAllocCounter* counter = (jAllocCounter*)ctx;
+    jAllocHeader* header = (jAllocHeader*)ptr - 1;
+
+    counter->frees++;
+    counter->live -= header->size;
+
+    if (counter->parent != NULL)
+        counter->parent->free(counter->parent->ctx, header);
+    else
+        free(header);
+}
+
+/**
+ * JConf Init Counting Allocator
+ *
+ * Description: Initializes an allocator that counts calls and bytes (e.g for
+ *              tests and benchmarks) and forwards them to a parent allocator.
+ * @param[in]  {allocator} // The allocator to initialize.
+ * @param[in]  {counter}   // The counters, which are reset.
+ * @param[out] {parent}    // The allocator to forward to (NULL for libc).
+ */
+void jconf_init_counting_allocator(jAllocator* allocator, jAllocCounter* counter, const jAllocator* parent)
+{
+    counter->parent = parent;
+    counter->allocs = counter->reallocs = counter->frees = 0;
+    counter->bytes = counter->live = counter->peak = 0;
+
+    allocator->alloc = jconf_counting_alloc;
+    allocator->realloc = jconf_counting_realloc;
+    allocator->free = jconf_counting_free;
+    allocator->ctx = counter;
+}
@@ -10,6 +10,63 @@
  */
 
 #include <jconf/array.h>
+#include <string.h>
+
+/**
+ * JConf Array Grow
+ *
+ * Description: Moves the values to a larger buffer. The new slots are left
+ *              uninitialized; only slots below 'end' are ever read.
+ * @param[in]  {arr}  // The jArray to grow.
+ * @param[out] {size} // The new capacity.
+ * @returns // '1' if successful, '0' if out of memory.
+ */
+static int jconf_array_grow(jArray* arr, size_t size)
+{
+    void** values;
+    size_t i;
+
+    if (size > SIZE_MAX / sizeof(void*))
+        return 0;
+
+    if (arr->values == arr->inline_values)
+    {
+        // Leave the inline buffer.
+        if ((values = (void**)jconf_malloc(arr->allocator, size*sizeof(void*))) == NULL)
+            return 0;
+
+        for (i = 0; i < arr->end; i++)
+            values[i] = arr->values[i];
+    }
+    else
+    {
+        values = (void**)jconf_realloc(arr->allocator, arr->values, arr->size*sizeof(void*), size*sizeof(void*));
+        if (values == NULL)
+            return 0;
+    }
+
+    arr->values = values;
+    arr->size = size;
+    return 1;
+}
+
+/**
+ * JConf Array Next Size
+ *
+ * Description: Returns the capacity after the next geometric expansion.
+ * @param[out] {arr} // The jArray.
+ * @returns // The expanded capacity.
+ */
+static __inline size_t jconf_array_next_size(const jArray* arr, size_t size)
+{
+    size_t expand = arr->expand > 1 ? arr->expand : 2;
+
+    // Saturate instead of wrapping (the grow then fails).
+    if (size > SIZE_MAX / expand)
+        return SIZE_MAX;
+
+    return size * expand > JCONF_ARRAY_INLINE ? size * expand : JCONF_ARRAY_INLINE * 2;
+}
 
 /**
  * JConf Array Init
@@ -20,12 +77,40 @@
  * @param[out] {expand} // The expand rate.
  * @returns // '1' if successful, '0' if out of memory.
  */
-int jconf_init_array(jArray* arr, int size, int expand)
+int jconf_init_array(jArray* arr, size_t size, size_t expand)
+{
+    return jconf_init_array_with(arr, size, expand, NULL);
+}
+
+/**
+ * JConf Array Init With
+ *
+ * Description: Initializes the provided array with an allocator. Arrays of up
+ *              to JCONF_ARRAY_INLINE elements are stored in the struct itself,
+ *              so the struct must not be copied or moved once initialized.
+ * @param[in]  {arr}       // A pointer to the array to initialize.
+ * @param[out] {size}      // The initial size of the array.
+ * @param[out] {expand}    // The expand rate.
+ * @param[out] {allocator} // The allocator for the values (NULL for malloc).
+ * @returns // '1' if successful, '0' if out of memory.
+ */
+int jconf_init_array_with(jArray* arr, size_t size, size_t expand, const jAllocator* allocator)
 {
     arr->end = 0;
-    arr->size = size;
     arr->expand = expand;
-    arr->values = (void**)calloc(size, sizeof(void*));
+    arr->allocator = allocator;
+    atomic_init(&arr->digest, 0);
+    atomic_init(&arr->refs, 0);
+
+    if (size <= JCONF_ARRAY_INLINE)
+    {
+        arr->size = JCONF_ARRAY_INLINE;
+        arr->values = arr->inline_values;
+        return 1;
+    }
+
+    arr->size = size;
+    arr->values = size <= SIZE_MAX / sizeof(void*) ? (void**)jconf_malloc(allocator, size * sizeof(void*)) : NULL;
 
     if (arr->values == NULL)
         return 0;
@@ -41,7 +126,25 @@ int jconf_init_array(jArray* arr, int size, int expand)
  */
 void jconf_destroy_array(jArray* arr)
 {
-    free(arr->values);
+    if (arr->values != arr->inline_values)
+        jconf_free(arr->allocator, arr->values);
+}
+
+/**
+ * JConf Array Reserve
+ *
+ * Description: Ensures the array can hold a number of elements without
+ *              reallocating (e.g when the final size is known or estimated).
+ * @param[in]  {arr}  // The jArray to reserve memory for.
+ * @param[out] {size} // The number of elements.
+ * @returns // '1' if successful, '0' if out of memory.
+ */
+int jconf_array_reserve(jArray* arr, size_t size)
+{
+    if (size <= arr->size)
+        return 1;
+
+    return jconf_array_grow(arr, size);
 }
 
 /**
@@ -54,20 +157,9 @@ void jconf_destroy_array(jArray* arr)
  */
 int jconf_array_push(jArray* arr, void* value)
 {
-    int i;
-
     // The count exceeds the size, reallocate the array.
-    if (arr->end >= arr->size)
-    {
-        arr->size *= arr->expand;
-        arr->values = (void**)realloc(arr->values, arr->size*sizeof(void*));
-
-        if (arr->values == NULL)
-            return 0;
-
-        for (i = arr->end; i < arr->size; i++)
-            arr->values[i] = NULL;
-    }
+    if (arr->end >= arr->size && !jconf_array_grow(arr, jconf_array_next_size(arr, arr->size)))
+        return 0;
 
     // Add the element to the end of the array.
     arr->values[arr->end] = value;
@@ -97,31 +189,35 @@ void* jconf_array_pop(jArray* arr)
 /**
  * JConf Array Set
  *
- * Description: Sets an element for the provided jArray.
+ * Description: Sets an element for the provided jArray. Elements skipped
+ *              between the previous end and the index are set to NULL.
  * @param[in]  {arr}   // The jArray to insert the element into.
  * @param[out] {index} // The index of the element.
  * @param[out] {value} // The value to insert.
  */
-int jconf_array_set(jArray* arr, int index, void* value)
+int jconf_array_set(jArray* arr, size_t index, void* value)
 {
-    int i;
+    size_t i, size;
+
+    if (index >= SIZE_MAX / sizeof(void*))
+        return 0;
 
     // If the index exceeds the size of the array, reallocate enough memory.
     if (index >= arr->size)
     {
-        while (index >= arr->size)
-            arr->size *= arr->expand;
+        for (size = arr->size; index >= size; size = jconf_array_next_size(arr, size));
 
-        arr->values = (void**)realloc(arr->values, arr->size*sizeof(void*));
-        if (arr->values == NULL)
+        if (!jconf_array_grow(arr, size))
             return 0;
-
-        for (i = arr->end; i < arr->size; i++)
-            arr->values[i] = NULL;
     }
 
     if (index >= arr->end)
+    {
+        for (i = arr->end; i < index; i++)
+            arr->values[i] = NULL;
+
         arr->end = index + 1;
+    }
 
     // Insert the element.
     arr->values[index] = value;
@@ -136,11 +232,58 @@ int jconf_array_set(jArray* arr, int index, void* value)
  * @param[out] {index} // The index of the element.
  * @returns // The value at the index (NULL if not found or uninitialized).
  */
-void* jconf_array_get(jArray* arr, int index)
+void* jconf_array_get(const jArray* arr, size_t index)
 {
-    if (index >= arr->size)
+    if (index >= arr->end)
         return NULL;
 
     // Return the element.
     return arr->values[index];
-}
\ No newline at end of file
+}
+
+/**
+ * JConf Array Insert
+ *
+ * Description: Inserts an element before the element at an index (or at the
+ *              end), moving the elements after it. Does not allocate if the
+ *              array has room for another element.
+ * @param[in]  {arr}   // The jArray to insert the element into.
+ * @param[out] {index} // The index of the element (at most the length).
+ * @param[out] {value} // The value to insert.
+ * @returns // '1' if successful, '0' if out of range or out of memory.
+ */
+int jconf_array_insert(jArray* arr, size_t index, void* value)
+{
+    if (index > arr->end)
+        return 0;
+
+    if (arr->end >= arr->size && !jconf_array_grow(arr, jconf_array_next_size(arr, arr->size)))
+        return 0;
+
+    memmove(arr->values + index + 1, arr->values + index, (arr->end - index) * sizeof(void*));
+    arr->values[index] = value;
+    arr->end++;
+    return 1;
+}
+
+/**
+ * JConf Array Remove
+ *
+ * Description: Removes the element at an index, moving the elements after
+ *              it. The capacity is kept.
+ * @param[in]  {arr}   // The jArray to remove the element from.
+ * @param[out] {index} // The index of the element.
+ * @returns // The removed value (NULL if out of range).
+ */
+void* jconf_array_remove(jArray* arr, size_t index)
+{
+    void* value;
+
+    if (index >= arr->end)
+        return NULL;
+
+    value = arr->values[index];
+    memmove(arr->values + index, arr->values + index + 1, (arr->end - index - 1) * sizeof(void*));
+    arr->values[--arr->end] = NULL;
+    return value;
+}
@@ -0,0 +1,166 @@
+/**
+ * JConf Batch Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/batch.h>
+
+#if defined(_WIN32) || defined(WIN32)
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+// The most threads a batch starts.
+#define JCONF_BATCH_MAX_THREADS 64
+
+// A contiguous range of a batch parsed by one thread.
+typedef struct _j_batch_range
+{
+    const jInput* inputs;
+    jDocument* outs;
+    jArgs* errs;
+    size_t n, parsed;
+    jParserContext* context;
+    const jParseOptions* options;
+
+} jBatchRange;
+
+/**
+ * JConf Batch Range
+ *
+ * Description: Parses a range of the batch.
+ * @param[in] {range} // The range.
+ */
+static void jconf_batch_range(jBatchRange* range)
+{
+    jParseOptions options;
+    jArgs args, *out;
+    jToken* root;
+    size_t i;
+
+    // Statistics would be shared between threads.
+    options = *range->options;
+    options.stats = NULL;
+
+    for (i = 0, range->parsed = 0; i < range->n; i++)
+    {
+        out = range->errs != NULL ? &range->errs[i] : &args;
+
+        if (range->context != NULL)
+            root = jconf_context_json2c_ex(range->context, range->inputs[i].buffer, range->inputs[i].size, &options, out);
+        else
+            root = jconf_json2c_ex(range->inputs[i].buffer, range->inputs[i].size, &options, out);
+
+        range->outs[i].root = root;
+        if (root != NULL)
+            range->parsed++;
+    }
+}
+
+#if defined(_WIN32) || defined(WIN32)
+static DWORD WINAPI jconf_batch_thread(LPVOID arg)
+{
+    jconf_batch_range((jBatchRange*)arg);
+    return 0;
+}
+#else
+static void* jconf_batch_thread(void* arg)
+{
+    jconf_batch_range((jBatchRange*)arg);
+    return NULL;
+}
+#endif
+
+/**
+ * JConf Parse Batch
+ *
+ * Description: Parses documents back to back. With contexts, the trees are
+ *              allocated from them and stay valid until the contexts are
+ *              reset; otherwise each tree is freed with jconf_free_token_with
+ *              and the allocator of the parse options. The inputs are split
+ *              into one contiguous range per thread, and each thread uses
+ *              its own context. A range whose thread cannot be started is
+ *              parsed by the caller. Threads share the allocator of the parse
+ *              options, which must then be thread-safe.
+ * @param[out] {inputs}  // The documents.
+ * @param[out] {n}       // The number of documents.
+ * @param[in]  {outs}    // Receives the tree of each document (NULL on error).
+ * @param[in]  {errs}    // Receives the result of each document (may be NULL).
+ * @param[out] {options} // The batch options (NULL to parse with the defaults).
+ * @returns              // The number of documents parsed successfully.
+ */
+size_t jconf_parse_batch(const jInput* inputs, size_t n, jDocument* outs, jArgs* errs, const jBatchOptions* options)
+{
+    jBatchRange ranges[JCONF_BATCH_MAX_THREADS];
+    size_t i, threads, per, start, parsed = 0;
+    jParseOptions defaults;
+    int started[JCONF_BATCH_MAX_THREADS];
+#if defined(_WIN32) || defined(WIN32)
+    HANDLE handles[JCONF_BATCH_MAX_THREADS];
+#else
+    pthread_t handles[JCONF_BATCH_MAX_THREADS];
+#endif
+
+    defaults.allocator = NULL;
+    defaults.stats = NULL;
+    defaults.duplicates = JCONF_DUP_LAST_WINS;
+    defaults.mode = JCONF_MODE_DEFAULT;
+    defaults.hash = 0;
+
+    threads = options != NULL && options->threads > 1 ? options->threads : 1;
+    if (threads > JCONF_BATCH_MAX_THREADS)
+        threads = JCONF_BATCH_MAX_THREADS;
+    if (threads > n)
+        threads = n > 0 ? n : 1;
+
+    per = (n + threads - 1) / threads;
+    for (i = 0; i < threads; i++)
+    {
+        start = i * per < n ? i * per : n;
+        ranges[i].inputs = inputs + start;
+        ranges[i].outs = outs + start;
+        ranges[i].errs = errs != NULL ? errs + start : NULL;
+        ranges[i].n = n - start < per ? n - start : per;
+        ranges[i].context = options != NULL && options->contexts != NULL ? &options->contexts[i] : NULL;
+        ranges[i].options = options != NULL ? &options->parse : &defaults;
+        started[i] = 0;
+    }
+
+    // The caller parses the first range while the other threads run.
+    for (i = 1; i < threads; i++)
+    {
+#if defined(_WIN32) || defined(WIN32)
+        started[i] = (handles[i] = CreateThread(NULL, 0, jconf_batch_thread, &ranges[i], 0, NULL)) != NULL;
+#else
+        started[i] = pthread_create(&handles[i], NULL, jconf_batch_thread, &ranges[i]) == 0;
+#endif
+    }
+
+    jconf_batch_range(&ranges[0]);
+
+    for (i = 0; i < threads; i++)
+    {
+        if (i > 0 && started[i])
+        {
+#if defined(_WIN32) || defined(WIN32)
+            WaitForSingleObject(handles[i], INFINITE);
+            CloseHandle(handles[i]);
+#else
+            pthread_join(handles[i], NULL);
+#endif
+        }
+        else if (i > 0)
+            jconf_batch_range(&ranges[i]);
+
+        parsed += ranges[i].parsed;
+    }
+
+    return parsed;
+}
@@ -0,0 +1,673 @@
+/**
+ * JConf Bind Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/bind.h>
+#include <jconf/cursor.h>
+#include <jconf/string.h>
+#include <jconf/map.h>
+#include <stdio.h>
+#include <math.h>
+
+// Multipliers used to place keys in the dispatch table.
+#define JCONF_BIND_DISPLACE 0x9E3779B97F4A7C15ull
+#define JCONF_BIND_MIX      0xFF51AFD7ED558CCDull
+
+// Growable output buffer used by the encoder.
+typedef struct _j_bind_buffer
+{
+    char* data;
+    size_t size, cap;
+
+} jBindBuffer;
+
+// Forward declarations.
+static int jconf_bind_value(jCursor*, const jBindField*, char*);
+
+/**
+ * JConf Bind Slot
+ *
+ * Description: Places a key hash in a table of 1 << bits slots.
+ *
+ * @param[out] {hash}     // The key hash.
+ * @param[out] {displace} // The displacement of the key's bucket.
+ * @param[out] {bits}     // The size of the table.
+ * @returns               // The slot.
+ */
+static __inline size_t jconf_bind_slot(jHash hash, unsigned int displace, unsigned int bits)
+{
+    return (size_t)(((hash ^ (displace * JCONF_BIND_DISPLACE)) * JCONF_BIND_MIX) >> (64 - bits));
+}
+
+/**
+ * JConf Bind Bucket
+ *
+ * Description: Returns the bucket of a key hash; a table has a quarter as
+ *              many buckets as slots.
+ *
+ * @param[out] {hash} // The key hash.
+ * @param[out] {bits} // The size of the table.
+ * @returns           // The bucket.
+ */
+static __inline size_t jconf_bind_bucket(jHash hash, unsigned int bits)
+{
+    return (size_t)(hash >> 32) & (((size_t)1 << (bits - 2)) - 1);
+}
+
+/**
+ * JConf Bind Field
+ *
+ * Description: Finds the field of a key with one probe of the dispatch table.
+ *
+ * @param[out] {desc} // The descriptor.
+ * @param[out] {key}  // The key (not null terminated).
+ * @param[out] {len}  // The length of the key.
+ * @returns           // The field (NULL if the key is not bound).
+ */
+static __inline const jBindField* jconf_bind_field(const jBindDesc* desc, const char* key, size_t len)
+{
+    const jBindField* field;
+    unsigned int index;
+    jHash hash;
+
+    hash = jconf_map_hash(key, len);
+    index = desc->slots[jconf_bind_slot(hash, desc->displace[jconf_bind_bucket(hash, desc->bits)], desc->bits)];
+    if (index == 0)
+        return NULL;
+
+    field = &desc->fields[index - 1];
+    return !jconf_strncmp(field->key, key, len) && field->key[len] == 0 ? field : NULL;
+}
+
+/**
+ * JConf Bind Table
+ *
+ * Description: Tries to build a perfect hash of the keys in a table of
+ *              1 << bits slots. The buckets are placed largest first, each
+ *              with the first displacement that moves all of its keys to
+ *              free slots.
+ *
+ * @param[in]  {desc}   // The descriptor.
+ * @param[out] {hashes} // The key hashes.
+ * @param[out] {bits}   // The size of the table.
+ * @returns             // '1' if successful, '0' if no displacement fits.
+ */
+static int jconf_bind_table(jBindDesc* desc, const jHash* hashes, unsigned int bits)
+{
+    unsigned char taken[2 * JCONF_BIND_MAX_FIELDS];
+    size_t i, j, n, bucket, buckets, largest;
+    size_t sizes[JCONF_BIND_MAX_FIELDS / 2];
+    unsigned int d;
+
+    buckets = (size_t)1 << (bits - 2);
+    memset(desc->slots, 0, sizeof(desc->slots));
+    memset(desc->displace, 0, sizeof(desc->displace));
+    memset(sizes, 0, sizeof(sizes));
+
+    for (i = 0, largest = 0; i < desc->count; i++)
+        if (++sizes[jconf_bind_bucket(hashes[i], bits)] > largest)
+            largest = sizes[jconf_bind_bucket(hashes[i], bits)];
+
+    for (n = largest; n > 0; n--)
+    {
+        for (bucket = 0; bucket < buckets; bucket++)
+        {
+            if (sizes[bucket] != n)
+                continue;
+
+            for (d = 0; d < 256; d++)
+            {
+                // The keys of the bucket must land on distinct free slots.
+                memcpy(taken, desc->slots, sizeof(taken));
+                for (i = 0; i < desc->count; i++)
+                {
+                    if (jconf_bind_bucket(hashes[i], bits) != bucket)
+                        continue;
+
+                    j = jconf_bind_slot(hashes[i], d, bits);
+                    if (taken[j])
+                        break;
+                    taken[j] = (unsigned char)(i + 1);
+                }
+
+                if (i == desc->count)
+                    break;
+            }
+
+            if (d == 256)
+                return 0;
+
+            desc->displace[bucket] = (unsigned char)d;
+            memcpy(desc->slots, taken, sizeof(taken));
+        }
+    }
+
+    desc->bits = bits;
+    return 1;
+}
+
+/**
+ * JConf Bind Init
+ *
+ * Description: Checks a descriptor and the descriptors it refers to, and
+ *              builds their dispatch tables.
+ *
+ * @param[in]  {desc} // The descriptor.
+ * @returns           // '1' if successful, '0' if a descriptor has too many
+ *                    // fields, duplicate keys or a field without a type.
+ */
+int jconf_bind_init(jBindDesc* desc)
+{
+    jHash hashes[JCONF_BIND_MAX_FIELDS];
+    const jBindField* field;
+    unsigned int bits;
+    size_t i, j;
+
+    if (desc->ready)
+        return 1;
+
+    if (desc->count > JCONF_BIND_MAX_FIELDS)
+        return 0;
+
+    for (i = 0; i < desc->count; i++)
+    {
+        field = &desc->fields[i];
+        hashes[i] = jconf_map_hash(field->key, jconf_strlen(field->key));
+
+        for (j = 0; j < i; j++)
+            if (hashes[j] == hashes[i] && !jconf_strcmp(desc->fields[j].key, field->key))
+                return 0;
+
+        // Objects need a descriptor; arrays hold scalars or objects.
+        if ((field->type == JCONF_BIND_OBJECT && field->desc == NULL) ||
+            (field->type == JCONF_BIND_ARRAY && (field->element == JCONF_BIND_ARRAY ||
+            (field->element == JCONF_BIND_OBJECT && field->desc == NULL) ||
+            (unsigned int)field->element > JCONF_BIND_ARRAY)) || (unsigned int)field->type > JCONF_BIND_ARRAY)
+            return 0;
+    }
+
+    // At most half of the slots are used.
+    for (bits = 2; ((size_t)1 << bits) < 2 * desc->count; bits++);
+    for (; bits <= 8 && !jconf_bind_table(desc, hashes, bits); bits++);
+
+    if (bits > 8)
+        return 0;
+
+    // Mark the descriptor before its children, which may refer back to it.
+    desc->ready = 1;
+
+    for (i = 0; i < desc->count; i++)
+    {
+        field = &desc->fields[i];
+        if (field->desc != NULL && !jconf_bind_init(field->desc))
+        {
+            desc->ready = 0;
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Bind Element Size
+ *
+ * Description: Returns the size of an array element.
+ *
+ * @param[out] {field} // The array field.
+ * @returns            // The size of an element.
+ */
+static size_t jconf_bind_element_size(const jBindField* field)
+{
+    switch (field->element)
+    {
+        case JCONF_BIND_INT64:  return sizeof(int64_t);
+        case JCONF_BIND_DOUBLE: return sizeof(double);
+        case JCONF_BIND_STRING: return sizeof(char*);
+        case JCONF_BIND_OBJECT: return field->desc->size;
+        default:                return sizeof(int);
+    }
+}
+
+/**
+ * JConf Bind Release
+ *
+ * Description: Frees the memory held by one field and zeroes it.
+ *
+ * @param[out] {field}     // The field.
+ * @param[out] {base}      // The struct.
+ * @param[out] {allocator} // The allocator.
+ */
+static void jconf_bind_release(const jBindField* field, char* base, const jAllocator* allocator)
+{
+    jBindField element;
+    size_t i, size, *count;
+    char** data;
+
+    switch (field->type)
+    {
+        case JCONF_BIND_STRING:
+            data = (char**)(base + field->offset);
+            jconf_free(allocator, *data);
+            *data = NULL;
+            break;
+
+        case JCONF_BIND_OBJECT:
+            jconf_bind_free(field->desc, base + field->offset, allocator);
+            break;
+
+        case JCONF_BIND_ARRAY:
+            data = (char**)(base + field->offset);
+            count = (size_t*)(base + field->count);
+
+            if (*data != NULL && (field->element == JCONF_BIND_STRING || field->element == JCONF_BIND_OBJECT))
+            {
+                memset(&element, 0, sizeof(element));
+                element.type = field->element;
+                element.desc = field->desc;
+                size = jconf_bind_element_size(field);
+
+                for (i = 0; i < *count; i++)
+                    jconf_bind_release(&element, *data + i * size, allocator);
+            }
+
+            jconf_free(allocator, *data);
+            *data = NULL;
+            *count = 0;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * JConf Bind Object
+ *
+ * Description: Decodes the object at the current position into a struct,
+ *              ending on its closing brace.
+ *
+ * @param[in]  {c}    // The cursor.
+ * @param[out] {desc} // The descriptor of the struct.
+ * @param[in]  {base} // The struct.
+ * @returns           // '1' if successful, '0' on error.
+ */
+static int jconf_bind_object(jCursor* c, const jBindDesc* desc, char* base)
+{
+    const jBindField* field;
+    const char* key;
+    size_t len;
+    int status;
+
+    if (!jconf_cursor_enter(c)) return 0;
+    if (jconf_cursor_close(c, '}')) return 1;
+
+    do
+    {
+        if (!jconf_cursor_key(c, &key, &len)) return 0;
+
+        field = jconf_bind_field(desc, key, len);
+        if (!(field != NULL ? jconf_bind_value(c, field, base) : jconf_cursor_skip(c))) return 0;
+    }
+    while ((status = jconf_cursor_next(c, '}')) > 0);
+
+    return status == 0;
+}
+
+/**
+ * JConf Bind Array
+ *
+ * Description: Decodes the array at the current position into allocated
+ *              elements, ending on its closing bracket. The count is kept
+ *              current so that a failed decode frees every element.
+ *
+ * @param[in]  {c}     // The cursor.
+ * @param[out] {field} // The array field.
+ * @param[in]  {base}  // The struct.
+ * @returns            // '1' if successful, '0' on error.
+ */
+static int jconf_bind_array(jCursor* c, const jBindField* field, char* base)
+{
+    char** data = (char**)(base + field->offset);
+    size_t* count = (size_t*)(base + field->count);
+    size_t size, cap = 0;
+    jBindField element;
+    int status;
+
+    memset(&element, 0, sizeof(element));
+    element.type = field->element;
+    element.desc = field->desc;
+    size = jconf_bind_element_size(field);
+
+    if (!jconf_cursor_enter(c)) return 0;
+    if (jconf_cursor_close(c, ']')) return 1;
+
+    do
+    {
+        if (*count == cap && !jconf_cursor_grow(c, (void**)data, &cap, size)) return 0;
+
+        memset(*data + *count * size, 0, size);
+        if (!jconf_bind_value(c, &element, *data + (*count)++ * size)) return 0;
+    }
+    while ((status = jconf_cursor_next(c, ']')) > 0);
+
+    return status == 0;
+}
+
+/**
+ * JConf Bind Value
+ *
+ * Description: Decodes the value at the current position into a field,
+ *              ending on its last character. Null leaves the field as it is.
+ *
+ * @param[in]  {c}     // The cursor.
+ * @param[out] {field} // The field.
+ * @param[in]  {base}  // The struct.
+ * @returns            // '1' if successful, '0' on error.
+ */
+static int jconf_bind_value(jCursor* c, const jBindField* field, char* base)
+{
+    void* dest = base + field->offset;
+    char ch;
+
+    switch (field->type)
+    {
+        case JCONF_BIND_BOOL:   return jconf_cursor_bool(c, (int*)dest);
+        case JCONF_BIND_INT:    return jconf_cursor_int(c, (int*)dest);
+        case JCONF_BIND_INT64:  return jconf_cursor_int64(c, (int64_t*)dest);
+        case JCONF_BIND_DOUBLE: return jconf_cursor_double(c, (double*)dest);
+        case JCONF_BIND_STRING: return jconf_cursor_string(c, (char**)dest);
+        default: break;
+    }
+
+    if (jconf_cursor_null(c))
+        return 1;
+
+    ch = c->buffer[c->args->pos];
+    if (field->type == JCONF_BIND_OBJECT && ch == '{')
+        return jconf_bind_object(c, field->desc, (char*)dest);
+
+    if (field->type == JCONF_BIND_ARRAY && ch == '[')
+    {
+        // The last of duplicate keys is kept.
+        jconf_bind_release(field, base, c->allocator);
+        return jconf_bind_array(c, field, base);
+    }
+
+    return jconf_cursor_mismatch(c);
+}
+
+/**
+ * JConf Bind Decode
+ *
+ * Description: Decodes a JSON object into a struct in one pass, without
+ *              building a tree. The input follows the parser's default mode;
+ *              values are checked against the field types, and keys without
+ *              fields have their values skipped. On error the struct is freed
+ *              and zeroed, and the error is reported like jconf_json2c
+ *              (JCONF_TYPE_MISMATCH for a value of the wrong type,
+ *              JCONF_INVALID_NUMBER for integers out of range, and
+ *              JCONF_UNEXPECTED_EXPR for a descriptor jconf_bind_init rejects).
+ *
+ * @param[in]  {desc}      // The descriptor of the struct.
+ * @param[out] {buffer}    // The string to decode.
+ * @param[out] {size}      // The size of the buffer.
+ * @param[in]  {object}    // The struct.
+ * @param[out] {allocator} // The allocator for strings and arrays (NULL for
+ *                         // the default).
+ * @param[in]  {args}      // The object to store decoding related information
+ * @returns                // '1' if successful, '0' on error.
+ */
+int jconf_bind_decode(jBindDesc* desc, const char* buffer, size_t size, void* object, const jAllocator* allocator, jArgs* args)
+{
+    jCursor c;
+
+    jconf_cursor_init(&c, buffer, size, allocator, args);
+    memset(object, 0, desc->size);
+
+    if (!jconf_bind_init(desc))
+    {
+        args->e = JCONF_UNEXPECTED_EXPR;
+        return 0;
+    }
+
+    if (!jconf_cursor_space(&c))
+        return 0;
+
+    if (buffer[args->pos] != '{')
+    {
+        args->e = JCONF_UNEXPECTED_TOK;
+        return 0;
+    }
+
+    if (!jconf_bind_object(&c, desc, (char*)object))
+    {
+        jconf_bind_free(desc, object, allocator);
+        memset(object, 0, desc->size);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Bind Free
+ *
+ * Description: Frees the strings and arrays of a decoded struct (not the
+ *              struct itself) and zeroes them.
+ *
+ * @param[out] {desc}      // The descriptor of the struct.
+ * @param[in]  {object}    // The struct.
+ * @param[out] {allocator} // The allocator used to decode it.
+ */
+void jconf_bind_free(const jBindDesc* desc, void* object, const jAllocator* allocator)
+{
+    size_t i;
+
+    for (i = 0; i < desc->count; i++)
+        jconf_bind_release(&desc->fields[i], (char*)object, allocator);
+}
+
+/**
+ * JConf Bind Append
+ *
+ * Description: Appends bytes to the output buffer.
+ *
+ * @param[in]  {out}  // The output buffer.
+ * @param[out] {data} // The bytes.
+ * @param[out] {n}    // The number of bytes.
+ * @returns           // '1' if successful, '0' if out of memory.
+ */
+static int jconf_bind_append(jBindBuffer* out, const char* data, size_t n)
+{
+    char* grown;
+    size_t cap;
+
+    if (out->size + n + 1 > out->cap)
+    {
+        for (cap = out->cap ? out->cap : 256; cap < out->size + n + 1; cap *= 2);
+
+        if ((grown = (char*)jconf_realloc(NULL, out->data, out->cap, cap)) == NULL)
+            return 0;
+
+        out->data = grown;
+        out->cap = cap;
+    }
+
+    memcpy(out->data + out->size, data, n);
+    out->size += n;
+    return 1;
+}
+
+/**
+ * JConf Bind Quote
+ *
+ * Description: Appends a quoted string, escaping quotes, backslashes and
+ *              control characters.
+ *
+ * @param[in]  {out} // The output buffer.
+ * @param[out] {s}   // The string.
+ * @returns          // '1' if successful, '0' if out of memory.
+ */
+static int jconf_bind_quote(jBindBuffer* out, const char* s)
+{
+    static const char hex[] = "0123456789abcdef";
+    const char* run;
+    char escape[6];
+
+    if (!jconf_bind_append(out, "\"", 1))
+        return 0;
+
+    for (run = s; *s != 0; s++)
+    {
+        if (*s != '\"' && *s != '\\' && (unsigned char)*s >= 0x20)
+            continue;
+
+        if (!jconf_bind_append(out, run, s - run))
+            return 0;
+        run = s + 1;
+
+        escape[0] = '\\';
+        switch (*s)
+        {
+            case '\"': escape[1] = '\"'; break;
+            case '\\': escape[1] = '\\'; break;
+            case '\b': escape[1] = 'b'; break;
+            case '\f': escape[1] = 'f'; break;
+            case '\n': escape[1] = 'n'; break;
+            case '\r': escape[1] = 'r'; break;
+            case '\t': escape[1] = 't'; break;
+            default:
+                escape[1] = 'u'; escape[2] = '0'; escape[3] = '0';
+                escape[4] = hex[(unsigned char)*s >> 4];
+                escape[5] = hex[*s & 0xF];
+                if (!jconf_bind_append(out, escape, 6))
+                    return 0;
+                continue;
+        }
+
+        if (!jconf_bind_append(out, escape, 2))
+            return 0;
+    }
+
+    return jconf_bind_append(out, run, s - run) && jconf_bind_append(out, "\"", 1);
+}
+
+/**
+ * JConf Bind Encode Value
+ *
+ * Description: Appends the JSON value of a field.
+ *
+ * @param[in]  {out}   // The output buffer.
+ * @param[out] {field} // The field.
+ * @param[out] {base}  // The struct.
+ * @returns            // '1' if successful, '0' if out of memory.
+ */
+static int jconf_bind_encode_value(jBindBuffer* out, const jBindField* field, const char* base)
+{
+    const void* src = base + field->offset;
+    const jBindField* child;
+    jBindField element;
+    char text[32];
+    size_t i, size, count;
+    double value;
+
+    switch (field->type)
+    {
+        case JCONF_BIND_BOOL:
+            return *(const int*)src ? jconf_bind_append(out, "true", 4) : jconf_bind_append(out, "false", 5);
+
+        case JCONF_BIND_INT:
+            return jconf_bind_append(out, text, snprintf(text, sizeof(text), "%d", *(const int*)src));
+
+        case JCONF_BIND_INT64:
+            return jconf_bind_append(out, text, snprintf(text, sizeof(text), "%lld", (long long)*(const int64_t*)src));
+
+        case JCONF_BIND_DOUBLE:
+            // Non-finite values have no JSON representation.
+            if (!isfinite((value = *(const double*)src)))
+                return jconf_bind_append(out, "null", 4);
+            return jconf_bind_append(out, text, snprintf(text, sizeof(text), "%.17g", value));
+
+        case JCONF_BIND_STRING:
+            if (*(char* const*)src == NULL)
+                return jconf_bind_append(out, "null", 4);
+            return jconf_bind_quote(out, *(char* const*)src);
+
+        case JCONF_BIND_OBJECT:
+            if (!jconf_bind_append(out, "{", 1))
+                return 0;
+
+            for (i = 0; i < field->desc->count; i++)
+            {
+                child = &field->desc->fields[i];
+                if ((i && !jconf_bind_append(out, ",", 1)) || !jconf_bind_quote(out, child->key) ||
+                    !jconf_bind_append(out, ":", 1) || !jconf_bind_encode_value(out, child, (const char*)src))
+                    return 0;
+            }
+
+            return jconf_bind_append(out, "}", 1);
+
+        case JCONF_BIND_ARRAY:
+            memset(&element, 0, sizeof(element));
+            element.type = field->element;
+            element.desc = field->desc;
+            size = jconf_bind_element_size(field);
+            count = *(char* const*)src != NULL ? *(const size_t*)(base + field->count) : 0;
+
+            if (!jconf_bind_append(out, "[", 1))
+                return 0;
+
+            for (i = 0; i < count; i++)
+                if ((i && !jconf_bind_append(out, ",", 1)) || !jconf_bind_encode_value(out, &element, *(char* const*)src + i * size))
+                    return 0;
+
+            return jconf_bind_append(out, "]", 1);
+    }
+
+    return 0;
+}
+
+/**
+ * JConf Bind Encode
+ *
+ * Description: Encodes a struct as a compact JSON object, with its fields in
+ *              declaration order. NULL strings and non-finite doubles are
+ *              written as null.
+ *
+ * @param[in]  {desc}   // The descriptor of the struct.
+ * @param[out] {object} // The struct.
+ * @param[in]  {size}   // Receives the length of the JSON.
+ * @returns             // A dynamically allocated, null terminated string
+ *                      // (NULL if out of memory or the descriptor is invalid).
+ */
+char* jconf_bind_encode(jBindDesc* desc, const void* object, size_t* size)
+{
+    jBindBuffer out;
+    jBindField root;
+
+    out.data = NULL;
+    out.size = out.cap = 0;
+    *size = 0;
+
+    memset(&root, 0, sizeof(root));
+    root.type = JCONF_BIND_OBJECT;
+    root.desc = desc;
+
+    if (!jconf_bind_init(desc) || !jconf_bind_encode_value(&out, &root, (const char*)object))
+    {
+        jconf_free(NULL, out.data);
+        return NULL;
+    }
+
+    out.data[out.size] = 0;
+    *size = out.size;
+    return out.data;
+}
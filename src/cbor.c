@@ -0,0 +1,923 @@
+/**
+ * JConf CBOR Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/cbor.h>
+#include <jconf/cursor.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+// CBOR major types.
+#define JCONF_CBOR_UINT   0
+#define JCONF_CBOR_NINT   1
+#define JCONF_CBOR_BYTES  2
+#define JCONF_CBOR_TEXT   3
+#define JCONF_CBOR_ARRAY  4
+#define JCONF_CBOR_MAP    5
+#define JCONF_CBOR_TAG    6
+#define JCONF_CBOR_SIMPLE 7
+
+// Additional information for indefinite lengths.
+#define JCONF_CBOR_INDEFINITE 31
+#define JCONF_CBOR_BREAK      0xFF
+
+// Forward declarations.
+static jToken* jconf_cbor_decode(const unsigned char*, size_t, size_t*, int, jArgs*);
+
+// Growable output buffer used by the encoder.
+typedef struct _j_cbor_buffer
+{
+    unsigned char* data;
+    size_t size, cap;
+
+} jCborBuffer;
+
+/**
+ * JConf CBOR Reserve
+ *
+ * Description: Ensures the output buffer can hold additional bytes.
+ * @param[in]  {out} // The output buffer.
+ * @param[out] {n}   // The number of bytes to reserve.
+ * @returns          // '1' if successful, '0' if out of memory.
+ */
+static __inline int jconf_cbor_reserve(jCborBuffer* out, size_t n)
+{
+    unsigned char* data;
+    size_t cap;
+
+    if (out->size + n <= out->cap)
+        return 1;
+
+    for (cap = out->cap ? out->cap : 256; cap < out->size + n; cap *= 2);
+
+    if ((data = (unsigned char*)jconf_realloc(NULL, out->data, out->cap, cap)) == NULL)
+        return 0;
+
+    out->data = data;
+    out->cap = cap;
+    return 1;
+}
+
+/**
+ * JConf CBOR Write
+ *
+ * Description: Writes an initial byte followed by a big-endian argument.
+ * @param[in]  {out}     // The output buffer.
+ * @param[out] {initial} // The initial byte.
+ * @param[out] {value}   // The argument.
+ * @param[out] {bytes}   // The number of argument bytes (0, 1, 2, 4 or 8).
+ * @returns              // '1' if successful, '0' if out of memory.
+ */
+static __inline int jconf_cbor_write(jCborBuffer* out, int initial, uint64_t value, int bytes)
+{
+    unsigned char* p;
+
+    if (!jconf_cbor_reserve(out, bytes + 1))
+        return 0;
+
+    p = out->data + out->size;
+    *p++ = (unsigned char)initial;
+
+    // Arguments are stored in network byte order.
+    while (bytes-- > 0)
+        *p++ = (unsigned char)(value >> (8 * bytes));
+
+    out->size = p - out->data;
+    return 1;
+}
+
+/**
+ * JConf CBOR Head
+ *
+ * Description: Writes the initial byte and argument of a data item using
+ *              the shortest encoding of the argument.
+ * @param[in]  {out}   // The output buffer.
+ * @param[out] {major} // The major type.
+ * @param[out] {value} // The argument (length, count or integer value).
+ * @returns            // '1' if successful, '0' if out of memory.
+ */
+static int jconf_cbor_head(jCborBuffer* out, int major, uint64_t value)
+{
+    if (value < 24)
+        return jconf_cbor_write(out, (major << 5) | (int)value, 0, 0);
+    if (value <= 0xFF)
+        return jconf_cbor_write(out, (major << 5) | 24, value, 1);
+    if (value <= 0xFFFF)
+        return jconf_cbor_write(out, (major << 5) | 25, value, 2);
+    if (value <= 0xFFFFFFFFu)
+        return jconf_cbor_write(out, (major << 5) | 26, value, 4);
+
+    return jconf_cbor_write(out, (major << 5) | 27, value, 8);
+}
+
+/**
+ * JConf CBOR String
+ *
+ * Description: Writes a text string. Strings in the tree hold JSON text, so
+ *              their escape sequences are decoded into the CBOR text.
+ * @param[in]  {out}    // The output buffer.
+ * @param[out] {text}   // The JSON text of the string.
+ * @param[out] {length} // The length of the text.
+ * @returns             // '1' if successful, '0' if out of memory.
+ */
+static int jconf_cbor_string(jCborBuffer* out, const char* text, size_t length)
+{
+    size_t start, n;
+
+    if (memchr(text, '\\', length) == NULL)
+    {
+        if (!jconf_cbor_head(out, JCONF_CBOR_TEXT, length) || !jconf_cbor_reserve(out, length))
+            return 0;
+
+        memcpy(out->data + out->size, text, length);
+        out->size += length;
+        return 1;
+    }
+
+    // Decode past the longest head, then move the text behind the head.
+    if (!jconf_cbor_reserve(out, length + 9))
+        return 0;
+
+    start = out->size;
+    n = jconf_cursor_unescape((char*)out->data + start + 9, text, length);
+    jconf_cbor_head(out, JCONF_CBOR_TEXT, n);
+
+    memmove(out->data + out->size, out->data + start + 9, n);
+    out->size += n;
+    return 1;
+}
+
+/**
+ * JConf CBOR Double
+ *
+ * Description: Writes a floating point value, using single precision when
+ *              the value is represented exactly.
+ * @param[in]  {out}   // The output buffer.
+ * @param[out] {value} // The value.
+ * @returns            // '1' if successful, '0' if out of memory.
+ */
+static int jconf_cbor_double(jCborBuffer* out, double value)
+{
+    union { double d; uint64_t u; } d;
+    union { float f; uint32_t u; } f;
+
+    f.f = (float)value;
+    if ((double)f.f == value)
+        return jconf_cbor_write(out, (JCONF_CBOR_SIMPLE << 5) | 26, f.u, 4);
+
+    d.d = value;
+    return jconf_cbor_write(out, (JCONF_CBOR_SIMPLE << 5) | 27, d.u, 8);
+}
+
+/**
+ * JConf CBOR Number
+ *
+ * Description: Converts the text of a number token to a binary data item.
+ *              Integers are stored as CBOR integers and numbers with a
+ *              fraction or exponent as decimal fractions (tag 4, [e, m]),
+ *              which keeps the exact digits of the source text. Numbers
+ *              with more than 19 significant digits are stored as floats.
+ * @param[in]  {out}  // The output buffer.
+ * @param[out] {text} // The number text.
+ * @returns           // '1' if successful, '0' if out of memory.
+ */
+static int jconf_cbor_number(jCborBuffer* out, const char* text)
+{
+    const char* p = text;
+    int negative, decimal = 0, exp_negative;
+    int64_t exponent = 0, exp = 0;
+    uint64_t mantissa = 0;
+
+    if ((negative = (*p == '-')))
+        p++;
+
+    // Accumulate the integer and fraction digits into the mantissa.
+    for (; (*p >= '0' && *p <= '9') || (*p == '.' && !decimal); p++)
+    {
+        if (*p == '.')
+        {
+            decimal = 1;
+            continue;
+        }
+
+        if (mantissa > (UINT64_MAX - (uint64_t)(*p - '0')) / 10)
+            return jconf_cbor_double(out, strtod(text, NULL));
+
+        mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        exponent -= decimal;
+    }
+
+    if (*p == 'e' || *p == 'E')
+    {
+        decimal = 1;
+        exp_negative = *++p == '-';
+        if (*p == '-' || *p == '+')
+            p++;
+
+        for (; *p >= '0' && *p <= '9' && exp < 100000; p++)
+            exp = exp * 10 + (*p - '0');
+
+        exponent += exp_negative ? -exp : exp;
+    }
+
+    // Negative zero has no integer representation.
+    if (*p != '\0' || (negative && mantissa == 0))
+        return jconf_cbor_double(out, strtod(text, NULL));
+
+    if (!decimal)
+        return negative ? jconf_cbor_head(out, JCONF_CBOR_NINT, mantissa - 1) : jconf_cbor_head(out, JCONF_CBOR_UINT, mantissa);
+
+    return jconf_cbor_head(out, JCONF_CBOR_TAG, 4) &&
+        jconf_cbor_head(out, JCONF_CBOR_ARRAY, 2) &&
+        (exponent < 0 ? jconf_cbor_head(out, JCONF_CBOR_NINT, (uint64_t)(-exponent - 1)) : jconf_cbor_head(out, JCONF_CBOR_UINT, (uint64_t)exponent)) &&
+        (negative ? jconf_cbor_head(out, JCONF_CBOR_NINT, mantissa - 1) : jconf_cbor_head(out, JCONF_CBOR_UINT, mantissa));
+}
+
+/**
+ * JConf CBOR Encode
+ *
+ * Description: Recursively encodes a token.
+ * @param[in]  {out}   // The output buffer.
+ * @param[out] {token} // The token to encode.
+ * @returns            // '1' if successful, '0' if out of memory.
+ */
+static int jconf_cbor_encode(jCborBuffer* out, jToken* token)
+{
+    jArray* arr;
+    jNode* node;
+    jMap* map;
+    size_t i;
+
+    switch (token->type)
+    {
+        case JCONF_FALSE:
+            return jconf_cbor_head(out, JCONF_CBOR_SIMPLE, 20);
+
+        case JCONF_TRUE:
+            return jconf_cbor_head(out, JCONF_CBOR_SIMPLE, 21);
+
+        case JCONF_NULL:
+            return jconf_cbor_head(out, JCONF_CBOR_SIMPLE, 22);
+
+        case JCONF_INT:
+        case JCONF_DOUBLE:
+            return jconf_cbor_number(out, (const char*)token->data);
+
+        case JCONF_STRING:
+            return jconf_cbor_string(out, (const char*)token->data, jconf_strlen((const char*)token->data));
+
+        case JCONF_ARRAY:
+            arr = (jArray*)token->data;
+            if (!jconf_cbor_head(out, JCONF_CBOR_ARRAY, arr == NULL ? 0 : arr->end))
+                return 0;
+
+            for (i = 0; arr != NULL && i < arr->end; i++)
+                if (!jconf_cbor_encode(out, (jToken*)jconf_array_get(arr, i)))
+                    return 0;
+            return 1;
+
+        case JCONF_OBJECT:
+            map = (jMap*)token->data;
+            if (!jconf_cbor_head(out, JCONF_CBOR_MAP, map == NULL ? 0 : map->count))
+                return 0;
+
+            for (node = map != NULL ? map->first : NULL; node; node = node->after)
+                if (!jconf_cbor_string(out, node->key, node->len) || !jconf_cbor_encode(out, (jToken*)node->value))
+                    return 0;
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * JConf CBOR Argument
+ *
+ * Description: Reads the argument of a data item.
+ * @param[out] {buffer} // The CBOR buffer.
+ * @param[out] {size}   // The size of the buffer.
+ * @param[in]  {pos}    // The read position (advanced past the argument).
+ * @param[out] {info}   // The additional information bits of the head.
+ * @param[in]  {value}  // Receives the argument.
+ * @returns             // '1' if successful, '0' if malformed, '-1' if truncated.
+ */
+static __inline int jconf_cbor_argument(const unsigned char* buffer, size_t size, size_t* pos, int info, uint64_t* value)
+{
+    int bytes;
+
+    if (info < 24)
+    {
+        *value = (uint64_t)info;
+        return 1;
+    }
+
+    if (info > 27)
+        return 0;
+
+    bytes = 1 << (info - 24);
+    if (size - *pos < (size_t)bytes)
+        return -1;
+
+    for (*value = 0; bytes > 0; bytes--)
+        *value = (*value << 8) | buffer[(*pos)++];
+
+    return 1;
+}
+
+/**
+ * JConf CBOR Text
+ *
+ * Description: Allocates the JSON text of a text string, escaping quotes,
+ *              backslashes and control characters as the parser stores them.
+ * @param[out] {src}     // The string bytes.
+ * @param[out] {length}  // The number of bytes.
+ * @param[in]  {escaped} // Receives the length of the text.
+ * @returns              // The text (NULL if out of memory).
+ */
+static char* jconf_cbor_text(const unsigned char* src, size_t length, size_t* escaped)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t i, n;
+    char* text;
+
+    // Count the escape sequences first.
+    for (i = 0, n = length; i < length; i++)
+        if (src[i] == '\"' || src[i] == '\\' || src[i] < 0x20)
+            n += (src[i] == '\b' || src[i] == '\f' || src[i] == '\n' || src[i] == '\r' || src[i] == '\t' ||
+                src[i] == '\"' || src[i] == '\\') ? 1 : 5;
+
+    if ((text = (char*)jconf_malloc(NULL, n + 1)) == NULL)
+        return NULL;
+
+    if (n == length)
+        memcpy(text, src, length);
+    else
+    {
+        for (i = 0, n = 0; i < length; i++)
+        {
+            if (src[i] != '\"' && src[i] != '\\' && src[i] >= 0x20)
+            {
+                text[n++] = (char)src[i];
+                continue;
+            }
+
+            text[n++] = '\\';
+            switch (src[i])
+            {
+                case '\"':  text[n++] = '\"'; break;
+                case '\\': text[n++] = '\\'; break;
+                case '\b':  text[n++] = 'b'; break;
+                case '\f':  text[n++] = 'f'; break;
+                case '\n':  text[n++] = 'n'; break;
+                case '\r':  text[n++] = 'r'; break;
+                case '\t':  text[n++] = 't'; break;
+                default:
+                    text[n++] = 'u'; text[n++] = '0'; text[n++] = '0';
+                    text[n++] = hex[src[i] >> 4];
+                    text[n++] = hex[src[i] & 0xF];
+                    break;
+            }
+        }
+    }
+
+    text[n] = 0;
+    *escaped = n;
+    return text;
+}
+
+/**
+ * JConf CBOR Digits
+ *
+ * Description: Writes the decimal digits of a decoded integer backwards from
+ *              the end of a buffer.
+ * @param[out] {value}    // The magnitude (for negative integers, -1 - value).
+ * @param[out] {negative} // Whether the integer is negative.
+ * @param[in]  {end}      // The end of the destination buffer (at least 22 bytes).
+ * @returns               // The start of the digits.
+ */
+static char* jconf_cbor_digits(uint64_t value, int negative, char* end)
+{
+    int carry = negative, digit;
+    char* p = end;
+
+    // Negative integers are encoded as -1 - n, so add one while formatting.
+    do
+    {
+        digit = (int)(value % 10) + carry;
+        carry = digit == 10;
+        *--p = (char)('0' + (carry ? 0 : digit));
+        value /= 10;
+    } while (value != 0);
+
+    if (carry)
+        *--p = '1';
+
+    if (negative)
+        *--p = '-';
+
+    return p;
+}
+
+/**
+ * JConf CBOR Format Integer
+ *
+ * Description: Converts a decoded integer to its JSON text.
+ * @param[out] {value}    // The magnitude (for negative integers, -1 - value).
+ * @param[out] {negative} // Whether the integer is negative.
+ * @returns               // The text (NULL if out of memory).
+ */
+static char* jconf_cbor_format_int(uint64_t value, int negative)
+{
+    char digits[24], *p;
+    size_t length;
+
+    p = jconf_cbor_digits(value, negative, digits + sizeof(digits));
+    return jconf_cbor_text((const unsigned char*)p, digits + sizeof(digits) - p, &length);
+}
+
+/**
+ * JConf CBOR Format Double
+ *
+ * Description: Converts a decoded float to the shortest JSON text that
+ *              reads back to the same value.
+ * @param[out] {value} // The value.
+ * @returns            // The text (NULL if out of memory).
+ */
+static char* jconf_cbor_format_double(double value)
+{
+    char text[40];
+    int precision, length;
+    size_t escaped;
+
+    for (precision = 15; precision < 17; precision++)
+    {
+        snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (strtod(text, NULL) == value)
+            break;
+    }
+
+    if (precision == 17)
+        snprintf(text, sizeof(text), "%.17g", value);
+
+    // Keep a fraction so that the text still reads as a double.
+    length = jconf_strlen(text);
+    if (strchr(text, '.') == NULL && strchr(text, 'e') == NULL)
+    {
+        text[length++] = '.';
+        text[length++] = '0';
+        text[length] = 0;
+    }
+
+    return jconf_cbor_text((const unsigned char*)text, (size_t)length, &escaped);
+}
+
+/**
+ * JConf CBOR Format Decimal
+ *
+ * Description: Converts a decoded decimal fraction (m * 10^e) to JSON text.
+ * @param[out] {mantissa} // The mantissa magnitude (for negative mantissas, -1 - m).
+ * @param[out] {negative} // Whether the mantissa is negative.
+ * @param[out] {exponent} // The base 10 exponent.
+ * @returns               // The text (NULL if out of memory).
+ */
+static char* jconf_cbor_format_decimal(uint64_t mantissa, int negative, int64_t exponent)
+{
+    char buffer[24], *digits, *text, *p;
+    int64_t point;
+    size_t len;
+
+    digits = jconf_cbor_digits(mantissa, negative, buffer + sizeof(buffer));
+    len = buffer + sizeof(buffer) - digits - negative;
+    point = (int64_t)len + exponent;
+
+    if ((text = (char*)jconf_malloc(NULL, len + 32 + (exponent >= 0 && point <= 21 ? (size_t)exponent : 0))) == NULL)
+        return NULL;
+
+    p = text;
+    if (negative)
+        *p++ = '-';
+
+    if (exponent >= 0 && point <= 21)
+    {
+        // Integral value: digits, trailing zeros and a fraction.
+        memcpy(p, digits + negative, len);
+        for (p += len; exponent > 0; exponent--)
+            *p++ = '0';
+        *p++ = '.';
+        *p++ = '0';
+    }
+    else if (exponent < 0 && point > 0)
+    {
+        memcpy(p, digits + negative, (size_t)point);
+        p += point;
+        *p++ = '.';
+        memcpy(p, digits + negative + point, len - (size_t)point);
+        p += len - (size_t)point;
+    }
+    else if (exponent < 0 && point > -6)
+    {
+        *p++ = '0';
+        *p++ = '.';
+        for (; point < 0; point++)
+            *p++ = '0';
+        memcpy(p, digits + negative, len);
+        p += len;
+    }
+    else
+    {
+        // Scientific notation with a single integer digit.
+        *p++ = digits[negative];
+        *p++ = '.';
+        if (len == 1)
+            *p++ = '0';
+        memcpy(p, digits + negative + 1, len - 1);
+        p += len - 1;
+        p += sprintf(p, "e%lld", (long long)(point - 1));
+    }
+
+    *p = 0;
+    return text;
+}
+
+/**
+ * JConf CBOR Half
+ *
+ * Description: Converts a half precision float to a double.
+ * @param[out] {half} // The half precision bits.
+ * @returns           // The value.
+ */
+static double jconf_cbor_half(unsigned int half)
+{
+    unsigned int exp = (half >> 10) & 0x1F, mant = half & 0x3FF;
+    double value;
+
+    if (exp == 0)
+        value = mant / 16777216.0;
+    else if (exp != 31)
+        value = (mant + 1024) * (exp >= 25 ? (double)(1u << (exp - 25)) : 1.0 / (double)(1u << (25 - exp)));
+    else
+        value = mant == 0 ? HUGE_VAL : (HUGE_VAL - HUGE_VAL);
+
+    return (half & 0x8000) ? -value : value;
+}
+
+/**
+ * JConf CBOR Decode Decimal
+ *
+ * Description: Decodes the content of a decimal fraction (tag 4). Fractions
+ *              with integer exponents and mantissas are converted to text
+ *              directly; any other content is decoded as a regular item.
+ * @param[out] {buffer} // The CBOR buffer.
+ * @param[out] {size}   // The size of the buffer.
+ * @param[in]  {pos}    // The read position (after the tag).
+ * @param[out] {depth}  // The current nesting depth.
+ * @param[in]  {args}   // The args struct to fill.
+ * @returns             // The decoded token (NULL on error).
+ */
+static jToken* jconf_cbor_decode_decimal(const unsigned char* buffer, size_t size, size_t* pos, int depth, jArgs* args)
+{
+    uint64_t exponent, mantissa;
+    size_t start = *pos, p;
+    int exp_major, major, info;
+    jToken* token;
+
+    p = start + 1;
+    if (start >= size || buffer[start] != ((JCONF_CBOR_ARRAY << 5) | 2) || p >= size)
+        return jconf_cbor_decode(buffer, size, pos, depth + 1, args);
+
+    // Read the exponent.
+    exp_major = buffer[p] >> 5;
+    info = buffer[p++] & 0x1F;
+    if (exp_major > JCONF_CBOR_NINT || jconf_cbor_argument(buffer, size, &p, info, &exponent) <= 0 ||
+        exponent > INT32_MAX || p >= size)
+        return jconf_cbor_decode(buffer, size, pos, depth + 1, args);
+
+    // Read the mantissa.
+    major = buffer[p] >> 5;
+    info = buffer[p++] & 0x1F;
+    if (major > JCONF_CBOR_NINT || jconf_cbor_argument(buffer, size, &p, info, &mantissa) <= 0)
+        return jconf_cbor_decode(buffer, size, pos, depth + 1, args);
+
+    if ((token = (jToken*)jconf_malloc(NULL, sizeof(*token))) == NULL ||
+        (token->data = jconf_cbor_format_decimal(mantissa, major == JCONF_CBOR_NINT,
+            exp_major == JCONF_CBOR_NINT ? -(int64_t)exponent - 1 : (int64_t)exponent)) == NULL)
+    {
+        jconf_free(NULL, token);
+        args->e = JCONF_OUT_OF_MEMORY;
+        args->pos = start;
+        return NULL;
+    }
+
+    token->type = JCONF_DOUBLE;
+    *pos = p;
+    return token;
+}
+
+/**
+ * JConf CBOR Decode
+ *
+ * Description: Recursively decodes the next data item.
+ * @param[out] {buffer} // The CBOR buffer.
+ * @param[out] {size}   // The size of the buffer.
+ * @param[in]  {pos}    // The read position.
+ * @param[out] {depth}  // The current nesting depth.
+ * @param[in]  {args}   // The args struct to fill.
+ * @returns             // The decoded token (NULL on error).
+ */
+static jToken* jconf_cbor_decode(const unsigned char* buffer, size_t size, size_t* pos, int depth, jArgs* args)
+{
+    union { double d; uint64_t u; } d;
+    union { float f; uint32_t u; } f;
+    jToken *token, *value, *prev;
+    int major, info, indefinite, status = 0;
+    uint64_t arg, len, i;
+    size_t start, length;
+    char* key;
+
+    start = *pos;
+    if (*pos >= size)
+    {
+        args->e = JCONF_UNEXPECTED_EOF;
+        return NULL;
+    }
+
+    if (depth > JCONF_CBOR_MAX_DEPTH)
+    {
+        args->e = JCONF_UNEXPECTED_EXPR;
+        return NULL;
+    }
+
+    major = buffer[*pos] >> 5;
+    info = buffer[(*pos)++] & 0x1F;
+    indefinite = info == JCONF_CBOR_INDEFINITE && (major == JCONF_CBOR_ARRAY || major == JCONF_CBOR_MAP);
+
+    // Tags carry no meaning for the tree, decode the tagged item instead.
+    if (major == JCONF_CBOR_TAG)
+    {
+        if ((status = jconf_cbor_argument(buffer, size, pos, info, &arg)) <= 0)
+            goto malformed;
+
+        if (arg == 4)
+            return jconf_cbor_decode_decimal(buffer, size, pos, depth, args);
+
+        return jconf_cbor_decode(buffer, size, pos, depth + 1, args);
+    }
+
+    arg = 0;
+    if (!indefinite && !(major == JCONF_CBOR_SIMPLE && info >= 25) &&
+        (status = jconf_cbor_argument(buffer, size, pos, info, &arg)) <= 0)
+        goto malformed;
+
+    if ((token = (jToken*)jconf_malloc(NULL, sizeof(*token))) == NULL)
+        goto out_of_memory;
+
+    token->data = NULL;
+
+    switch (major)
+    {
+        case JCONF_CBOR_UINT:
+        case JCONF_CBOR_NINT:
+            token->type = JCONF_INT;
+            if ((token->data = jconf_cbor_format_int(arg, major == JCONF_CBOR_NINT)) == NULL)
+                goto token_out_of_memory;
+            break;
+
+        case JCONF_CBOR_TEXT:
+            if (arg > size - *pos)
+                goto token_truncated;
+
+            token->type = JCONF_STRING;
+            if ((token->data = jconf_cbor_text(buffer + *pos, (size_t)arg, &length)) == NULL)
+                goto token_out_of_memory;
+
+            *pos += (size_t)arg;
+            break;
+
+        case JCONF_CBOR_ARRAY:
+            // Every element takes at least one byte, which bounds the allocation.
+            if (!indefinite && arg > size - *pos)
+                goto token_truncated;
+
+            token->type = JCONF_ARRAY;
+            if (!indefinite && arg == 0)
+                break;
+
+            if ((token->data = jconf_malloc(NULL, sizeof(jArray))) == NULL)
+                goto token_out_of_memory;
+
+            if (!jconf_init_array((jArray*)token->data, indefinite ? 4 : (size_t)arg, 2))
+            {
+                jconf_free(NULL, token->data);
+                token->data = NULL;
+                goto token_out_of_memory;
+            }
+
+            for (i = 0; indefinite ? (*pos < size && buffer[*pos] != JCONF_CBOR_BREAK) : i < arg; i++)
+            {
+                if ((value = jconf_cbor_decode(buffer, size, pos, depth + 1, args)) == NULL)
+                    goto token_error;
+
+                if (!jconf_array_push((jArray*)token->data, value))
+                {
+                    jconf_free_token(value);
+                    goto token_out_of_memory;
+                }
+            }
+
+            if (indefinite && (*pos)++ >= size)
+                goto token_truncated;
+            break;
+
+        case JCONF_CBOR_MAP:
+            if (!indefinite && arg > (size - *pos) / 2)
+                goto token_truncated;
+
+            token->type = JCONF_OBJECT;
+            if (!indefinite && arg == 0)
+                break;
+
+            if ((token->data = jconf_malloc(NULL, sizeof(jMap))) == NULL)
+                goto token_out_of_memory;
+
+            jconf_init_map((jMap*)token->data);
+
+            for (i = 0; indefinite ? (*pos < size && buffer[*pos] != JCONF_CBOR_BREAK) : i < arg; i++)
+            {
+                // Keys must be definite length text strings.
+                if (*pos >= size)
+                    goto token_truncated;
+
+                if ((buffer[*pos] >> 5) != JCONF_CBOR_TEXT)
+                    goto token_malformed;
+
+                info = buffer[(*pos)++] & 0x1F;
+                if ((status = jconf_cbor_argument(buffer, size, pos, info, &len)) <= 0 || len > INT32_MAX)
+                    goto token_malformed;
+
+                if (len > size - *pos)
+                    goto token_truncated;
+
+                if ((key = jconf_cbor_text(buffer + *pos, (size_t)len, &length)) == NULL)
+                    goto token_out_of_memory;
+
+                *pos += (size_t)len;
+                if ((value = jconf_cbor_decode(buffer, size, pos, depth + 1, args)) == NULL)
+                {
+                    jconf_free(NULL, key);
+                    goto token_error;
+                }
+
+                prev = NULL;
+                if (!jconf_map_set((jMap*)token->data, key, length, value, (void**)&prev))
+                {
+                    jconf_free(NULL, key);
+                    jconf_free_token(value);
+                    goto token_out_of_memory;
+                }
+
+                // The map keeps the original key when a key is repeated.
+                if (prev != NULL)
+                {
+                    jconf_free(NULL, key);
+                    jconf_free_token(prev);
+                }
+            }
+
+            if (indefinite && (*pos)++ >= size)
+                goto token_truncated;
+            break;
+
+        case JCONF_CBOR_SIMPLE:
+            if (info == 20 || info == 21 || info == 22 || info == 23)
+            {
+                token->type = info == 20 ? JCONF_FALSE : info == 21 ? JCONF_TRUE : JCONF_NULL;
+                break;
+            }
+
+            if (info < 25 || info > 27 || (status = jconf_cbor_argument(buffer, size, pos, info, &arg)) <= 0)
+                goto token_malformed;
+
+            if (info == 25)
+                d.d = jconf_cbor_half((unsigned int)arg);
+            else if (info == 26)
+            {
+                f.u = (uint32_t)arg;
+                d.d = f.f;
+            }
+            else
+                d.u = arg;
+
+            // JSON has no representation for infinities and NaN.
+            if (!isfinite(d.d))
+            {
+                token->type = JCONF_NULL;
+                break;
+            }
+
+            token->type = JCONF_DOUBLE;
+            if ((token->data = jconf_cbor_format_double(d.d)) == NULL)
+                goto token_out_of_memory;
+            break;
+
+        default:
+            // Byte strings have no JSON equivalent.
+            goto token_malformed;
+    }
+
+    return token;
+
+token_out_of_memory:
+    jconf_free_token(token);
+out_of_memory:
+    args->e = JCONF_OUT_OF_MEMORY;
+    args->pos = start;
+    return NULL;
+
+token_truncated:
+    status = -1;
+token_malformed:
+    jconf_free_token(token);
+malformed:
+    args->e = status < 0 ? JCONF_UNEXPECTED_EOF : JCONF_UNEXPECTED_TOK;
+    args->pos = start;
+    return NULL;
+
+token_error:
+    jconf_free_token(token);
+    return NULL;
+}
+
+/**
+ * JConf c2cbor
+ *
+ * Description: Encodes a jToken tree as CBOR. Strings and keys have their
+ *              JSON escape sequences decoded, so they are stored as the text
+ *              they represent. The buffer is allocated with the default
+ *              allocator and released with jconf_free(NULL, ...).
+ *
+ * @param[out] {root} // The root token.
+ * @param[in]  {size} // Receives the size of the encoding.
+ * @returns           // A dynamically allocated buffer (NULL if out of memory).
+ */
+unsigned char* jconf_c2cbor(jToken* root, size_t* size)
+{
+    jCborBuffer out;
+
+    out.data = NULL;
+    out.size = out.cap = 0;
+    *size = 0;
+
+    if (root == NULL || !jconf_cbor_encode(&out, root))
+    {
+        jconf_free(NULL, out.data);
+        return NULL;
+    }
+
+    *size = out.size;
+    return out.data;
+}
+
+/**
+ * JConf cbor2c
+ *
+ * Description: Decodes a CBOR buffer into a jToken tree.
+ *
+ * @param[out] {buffer} // The CBOR buffer.
+ * @param[out] {size}   // The size of the buffer.
+ * @param[in]  {args}   // The object to store decoding related information
+ *                      // (pos is the byte offset of the offending item).
+ * @returns             // The root token (NULL on error).
+ */
+jToken* jconf_cbor2c(const unsigned char* buffer, size_t size, jArgs* args)
+{
+    jToken* root;
+    size_t pos = 0;
+
+    args->e = JCONF_NO_ERROR;
+    args->line = 1;
+    args->pos = 0;
+
+    if ((root = jconf_cbor_decode(buffer, size, &pos, 0, args)) == NULL)
+        return NULL;
+
+    // The buffer must contain exactly one data item.
+    if (pos != size)
+    {
+        jconf_free_token(root);
+        args->e = JCONF_EXPECTED_EOF;
+        args->pos = pos;
+        return NULL;
+    }
+
+    args->pos = pos;
+    return root;
+}
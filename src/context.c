@@ -0,0 +1,192 @@
+/**
+ * JConf Parser Context Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/context.h>
+#include <string.h>
+
+#define JCONF_ARENA_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+/**
+ * JConf Arena Alloc
+ *
+ * Description: Allocates memory from the context arena. Chunks that were
+ *              used before the last reset are reused before new ones are
+ *              allocated.
+ * @param[in]  {ctx}  // The parser context.
+ * @param[out] {size} // The number of bytes to allocate.
+ * @returns           // The memory (NULL if out of memory).
+ */
+static void* jconf_arena_alloc(void* ctx, size_t size)
+{
+    jParserContext* context = (jParserContext*)ctx;
+    jArenaChunk *chunk, *next;
+    size_t chunk_size;
+    void* ptr;
+
+    size = JCONF_ARENA_ALIGN(size);
+    chunk = context->current;
+
+    if (chunk == NULL || chunk->size - chunk->used < size)
+    {
+        next = chunk == NULL ? context->head : chunk->next;
+
+        if (next != NULL && next->size >= size)
+        {
+            // Reuse a warm chunk.
+            next->used = 0;
+            chunk = next;
+        }
+        else
+        {
+            // Link a new chunk after the current one.
+            chunk_size = size > context->chunk_size ? size : context->chunk_size;
+            if ((next = (jArenaChunk*)jconf_malloc(NULL, sizeof(jArenaChunk) + chunk_size)) == NULL)
+                return NULL;
+
+            next->size = chunk_size;
+            next->used = 0;
+
+            if (chunk == NULL)
+            {
+                next->next = context->head;
+                context->head = next;
+            }
+            else
+            {
+                next->next = chunk->next;
+                chunk->next = next;
+            }
+            chunk = next;
+        }
+
+        context->current = chunk;
+    }
+
+    ptr = (char*)(chunk + 1) + chunk->used;
+    chunk->used += size;
+    context->last = ptr;
+    return ptr;
+}
+
+/**
+ * JConf Arena Realloc
+ *
+ * Description: Resizes arena memory, in place when it is the most recent
+ *              allocation and the chunk has room.
+ * @param[in]  {ctx}      // The parser context.
+ * @param[out] {ptr}      // The memory to resize.
+ * @param[out] {old_size} // The current size of the memory.
+ * @param[out] {size}     // The new size.
+ * @returns               // The memory (NULL if out of memory).
+ */
+static void* jconf_arena_realloc(void* ctx, void* ptr, size_t old_size, size_t size)
+{
+    jParserContext* context = (jParserContext*)ctx;
+    jArenaChunk* chunk = context->current;
+    void* copy;
+
+    if (ptr == NULL)
+        return jconf_arena_alloc(ctx, size);
+
+    old_size = JCONF_ARENA_ALIGN(old_size);
+    if (ptr == context->last && size > old_size && chunk->size - chunk->used >= JCONF_ARENA_ALIGN(size) - old_size)
+    {
+        chunk->used += JCONF_ARENA_ALIGN(size) - old_size;
+        return ptr;
+    }
+
+    if ((copy = jconf_arena_alloc(ctx, size)) == NULL)
+        return NULL;
+
+    memcpy(copy, ptr, old_size < size ? old_size : size);
+    return copy;
+}
+
+/**
+ * JConf Arena Free
+ *
+ * Description: Arena memory is released all at once by a reset.
+ * @param[in]  {ctx} // The parser context.
+ * @param[out] {ptr} // The memory to free.
+ */
+static void jconf_arena_free(void* ctx, void* ptr)
+{
+    (void)ctx;
+    (void)ptr;
+}
+
+/**
+ * JConf Init Context
+ *
+ * Description: Initializes a parser context.
+ * @param[in]  {context}    // The context to initialize.
+ * @param[out] {chunk_size} // The arena chunk size (0 for the default).
+ * @returns                 // '1' if successful, '0' if out of memory.
+ */
+int jconf_init_context(jParserContext* context, size_t chunk_size)
+{
+    int i;
+
+    context->head = context->current = NULL;
+    context->chunk_size = chunk_size == 0 ? JCONF_CONTEXT_CHUNK_SIZE : chunk_size;
+    context->last = NULL;
+
+    context->allocator.alloc = jconf_arena_alloc;
+    context->allocator.realloc = jconf_arena_realloc;
+    context->allocator.free = jconf_arena_free;
+    context->allocator.ctx = context;
+
+    for (i = 0; i < JCONF_CONTEXT_HINTS; i++)
+        context->hints[i] = context->next_sums[i] = context->next_counts[i] = 0;
+
+    // Allocate the first chunk up front.
+    if (jconf_arena_alloc(context, 0) == NULL)
+        return 0;
+
+    return 1;
+}
+
+/**
+ * JConf Destroy Context
+ *
+ * Description: Frees the memory of a parser context and every tree
+ *              parsed with it.
+ * @param[in] {context} // The context to destroy.
+ */
+void jconf_destroy_context(jParserContext* context)
+{
+    jArenaChunk *chunk, *next;
+
+    for (chunk = context->head; chunk != NULL; chunk = next)
+    {
+        next = chunk->next;
+        jconf_free(NULL, chunk);
+    }
+
+    context->head = context->current = NULL;
+    context->last = NULL;
+}
+
+/**
+ * JConf Context Reset
+ *
+ * Description: Releases every tree parsed with the context in constant time.
+ *              The arena chunks and array size hints are kept for reuse.
+ * @param[in] {context} // The context to reset.
+ */
+void jconf_context_reset(jParserContext* context)
+{
+    context->current = context->head;
+    context->last = NULL;
+
+    if (context->head != NULL)
+        context->head->used = 0;
+}
@@ -0,0 +1,663 @@
+/**
+ * JConf Diff Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/diff.h>
+#include <jconf/hash.h>
+#include <jconf/string.h>
+#include <string.h>
+#include <stdlib.h>
+
+// The longest edit script (insertions and deletions) searched for when
+// aligning arrays. Longer changes pair the elements by position.
+#define JCONF_DIFF_MAX_EDITS 512
+
+// The edit script entry of a trace (furthest x on diagonal k after d edits).
+#define JCONF_DIFF_TRACE(trace, d, k) (trace)[(d) * ((d) + 1) / 2 + ((k) + (d)) / 2]
+
+// Operation names.
+static const char* jconf_diff_ops[] = { "add", "remove", "replace" };
+
+// jDiffer struct definition.
+typedef struct _j_differ
+{
+    jDiffCallback callback;
+    void* data;
+    char* path;             // The pointer to the values being compared.
+    size_t len, cap;
+
+} jDiffer;
+
+// jDiffEdit struct definition (an insertion or deletion of an edit script,
+// with the position it starts from).
+typedef struct _j_diff_edit
+{
+    long x, y;
+    int insert;
+
+} jDiffEdit;
+
+// jDiffBuilder struct definition (builds the patch document).
+typedef struct _j_diff_builder
+{
+    jToken* patch;
+    const jAllocator* allocator;
+
+} jDiffBuilder;
+
+static int jconf_diff_value(jDiffer*, const jToken*, const jToken*);
+
+/**
+ * JConf Diff Same
+ *
+ * Description: Tests whether two values are equal. Containers whose hashes
+ *              differ are unequal without being visited; equal hashes are
+ *              confirmed with jconf_equal, since 64 bit hashes can collide.
+ * @param[out] {a} // The old value.
+ * @param[out] {b} // The new value.
+ * @returns        // '1' if the values are equal.
+ */
+static __inline int jconf_diff_same(const jToken* a, const jToken* b)
+{
+    // Shared containers (see jconf/merge.h) are the same.
+    if (a == b || (a->type == b->type && a->data == b->data))
+        return 1;
+
+    if (a->type == b->type && (a->type == JCONF_OBJECT || a->type == JCONF_ARRAY) &&
+        jconf_hash_token(a, 0) != jconf_hash_token(b, 0))
+        return 0;
+
+    return jconf_equal(a, b);
+}
+
+/**
+ * JConf Diff Reserve
+ *
+ * Description: Makes room to extend the path.
+ * @param[in]  {differ} // The differ.
+ * @param[out] {size}   // The number of characters to add.
+ * @returns             // '1' if successful, '0' if out of memory.
+ */
+static int jconf_diff_reserve(jDiffer* differ, size_t size)
+{
+    size_t cap;
+    char* path;
+
+    if (differ->len + size < differ->cap)
+        return 1;
+
+    for (cap = differ->cap * 2; differ->len + size >= cap; cap *= 2);
+    if ((path = (char*)jconf_realloc(NULL, differ->path, differ->cap, cap)) == NULL)
+        return 0;
+
+    differ->path = path;
+    differ->cap = cap;
+    return 1;
+}
+
+/**
+ * JConf Diff Push Key
+ *
+ * Description: Appends a reference to a member to the path.
+ * @param[in]  {differ} // The differ.
+ * @param[out] {key}    // The key.
+ * @param[out] {len}    // The length of the key.
+ * @returns             // '1' if successful, '0' if out of memory.
+ */
+static int jconf_diff_push_key(jDiffer* differ, const char* key, size_t len)
+{
+    size_t i;
+
+    if (!jconf_diff_reserve(differ, 2 * len + 1))
+        return 0;
+
+    differ->path[differ->len++] = '/';
+    for (i = 0; i < len; i++)
+    {
+        if (key[i] == '~' || key[i] == '/')
+        {
+            differ->path[differ->len++] = '~';
+            differ->path[differ->len++] = key[i] == '~' ? '0' : '1';
+        }
+        else
+            differ->path[differ->len++] = key[i];
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Diff Push Index
+ *
+ * Description: Appends a reference to an element to the path.
+ * @param[in]  {differ} // The differ.
+ * @param[out] {index}  // The index.
+ * @returns             // '1' if successful, '0' if out of memory.
+ */
+static int jconf_diff_push_index(jDiffer* differ, size_t index)
+{
+    char digits[24];
+    size_t n = 0;
+
+    do
+    {
+        digits[n++] = (char)('0' + index % 10);
+        index /= 10;
+    } while (index > 0);
+
+    if (!jconf_diff_reserve(differ, n + 1))
+        return 0;
+
+    differ->path[differ->len++] = '/';
+    while (n > 0)
+        differ->path[differ->len++] = digits[--n];
+
+    return 1;
+}
+
+/**
+ * JConf Diff Emit
+ *
+ * Description: Reports a change at the current path.
+ * @param[in]  {differ} // The differ.
+ * @param[out] {op}     // The operation.
+ * @param[out] {from}   // The old value.
+ * @param[out] {to}     // The new value.
+ * @returns             // '1' to continue, '0' to stop.
+ */
+static int jconf_diff_emit(jDiffer* differ, jDiffOp op, const jToken* from, const jToken* to)
+{
+    jDiffChange change;
+
+    differ->path[differ->len] = '\0';
+    change.op = op;
+    change.path = differ->path;
+    change.len = differ->len;
+    change.from = from;
+    change.to = to;
+
+    return differ->callback(&change, differ->data);
+}
+
+/**
+ * JConf Diff Object
+ *
+ * Description: Diffs two objects by key: members of the first are removed
+ *              or compared, then members only in the second are added.
+ * @param[in]  {differ} // The differ.
+ * @param[out] {a}      // The old object.
+ * @param[out] {b}      // The new object.
+ * @returns             // '1' to continue, '0' to stop.
+ */
+static int jconf_diff_object(jDiffer* differ, const jToken* a, const jToken* b)
+{
+    const jMap *m = (const jMap*)a->data, *n = (const jMap*)b->data;
+    size_t matched = 0, len = differ->len;
+    const jToken* value;
+    const jNode* node;
+    int result;
+
+    for (node = m != NULL ? m->first : NULL; node != NULL; node = node->after)
+    {
+        value = n != NULL ? (const jToken*)jconf_map_get_hashed(n, node->key, node->len, node->hash) : NULL;
+        matched += value != NULL;
+        if (value != NULL && jconf_diff_same((const jToken*)node->value, value))
+            continue;
+
+        if (!jconf_diff_push_key(differ, node->key, node->len))
+            return 0;
+
+        result = value == NULL ? jconf_diff_emit(differ, JCONF_DIFF_REMOVE, (const jToken*)node->value, NULL) :
+            jconf_diff_value(differ, (const jToken*)node->value, value);
+
+        differ->len = len;
+        if (!result)
+            return 0;
+    }
+
+    // Every member of the new object was matched.
+    if (n == NULL || matched == n->count)
+        return 1;
+
+    for (node = n->first; node != NULL; node = node->after)
+    {
+        if (m != NULL && jconf_map_get_hashed(m, node->key, node->len, node->hash) != NULL)
+            continue;
+
+        if (!jconf_diff_push_key(differ, node->key, node->len))
+            return 0;
+
+        result = jconf_diff_emit(differ, JCONF_DIFF_ADD, NULL, (const jToken*)node->value);
+        differ->len = len;
+        if (!result)
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Diff Start
+ *
+ * Description: Chooses the previous diagonal of an edit script entry, as in
+ *              Myers' algorithm, and returns where the entry starts.
+ *              Entries outside the arrays are -1 and are never chosen.
+ * @param[out] {trace} // The entries of the previous edits.
+ * @param[out] {d}     // The number of edits.
+ * @param[out] {k}     // The diagonal.
+ * @param[in]  {down}  // Set to '1' for an insertion, '0' for a deletion.
+ * @returns            // The x coordinate after the edit (-1 if none).
+ */
+static __inline long jconf_diff_start(const long* trace, long d, long k, int* down)
+{
+    long left = k > -d ? JCONF_DIFF_TRACE(trace, d - 1, k - 1) : -1;
+    long up = k < d ? JCONF_DIFF_TRACE(trace, d - 1, k + 1) : -1;
+
+    *down = left < up;
+    return *down ? up : (left < 0 ? -1 : left + 1);
+}
+
+/**
+ * JConf Diff Script
+ *
+ * Description: Finds the shortest edit script between two runs of elements
+ *              with Myers' greedy algorithm, in O((n + m) * d) time. Elements
+ *              match when their hashes are equal and jconf_equal agrees.
+ * @param[out] {xs}    // The old array.
+ * @param[out] {ha}    // The old hashes.
+ * @param[out] {n}     // The number of old elements.
+ * @param[out] {ys}    // The new array.
+ * @param[out] {hb}    // The new hashes.
+ * @param[out] {m}     // The number of new elements.
+ * @param[out] {p}     // The index of the first element of both runs.
+ * @param[in]  {edits} // Set to the edits in order (NULL if longer than JCONF_DIFF_MAX_EDITS).
+ * @param[in]  {count} // Set to the number of edits.
+ * @returns            // '1' if successful, '0' if out of memory.
+ */
+static int jconf_diff_script(const jArray* xs, const jHash* ha, long n, const jArray* ys, const jHash* hb, long m, size_t p,
+    jDiffEdit** edits, long* count)
+{
+    long d, k, x, y, start, dmax;
+    size_t size;
+    long* trace;
+    int down;
+
+    *edits = NULL;
+    *count = 0;
+    dmax = n + m < JCONF_DIFF_MAX_EDITS ? n + m : JCONF_DIFF_MAX_EDITS;
+    size = (size_t)(dmax + 1) * (dmax + 2) / 2 * sizeof(long);
+
+    if ((trace = (long*)jconf_malloc(NULL, size)) == NULL)
+        return 0;
+
+    for (d = 0; d <= dmax; d++)
+    {
+        for (k = -d; k <= d; k += 2)
+        {
+            x = d == 0 ? 0 : jconf_diff_start(trace, d, k, &down);
+            y = x - k;
+
+            if (x >= 0 && (x > n || y > m))
+                x = -1;
+
+            if (x >= 0)
+            {
+                while (x < n && y < m && ha[x] == hb[y] && jconf_equal((const jToken*)jconf_array_get(xs, p + (size_t)x),
+                    (const jToken*)jconf_array_get(ys, p + (size_t)y)))
+                    x++, y++;
+            }
+
+            JCONF_DIFF_TRACE(trace, d, k) = x;
+            if (x == n && y == m)
+                goto found;
+        }
+    }
+
+    jconf_free(NULL, trace);
+    return 1;
+
+found:
+    if (d > 0 && (*edits = (jDiffEdit*)jconf_malloc(NULL, d * sizeof(jDiffEdit))) == NULL)
+    {
+        jconf_free(NULL, trace);
+        return 0;
+    }
+
+    // Walk back from the end, filling the edits from the last.
+    *count = d;
+    for (x = n, y = m; d > 0; d--)
+    {
+        k = x - y;
+        start = jconf_diff_start(trace, d, k, &down);
+
+        x = down ? start : start - 1;
+        y = down ? start - k - 1 : start - k;
+        (*edits)[d - 1].x = x;
+        (*edits)[d - 1].y = y;
+        (*edits)[d - 1].insert = down;
+    }
+
+    jconf_free(NULL, trace);
+    return 1;
+}
+
+/**
+ * JConf Diff Gap
+ *
+ * Description: Reports the changes of a run of old elements replaced by a
+ *              run of new ones: pairs are compared, then the rest of the
+ *              longer run is removed or added.
+ * @param[in]  {differ} // The differ.
+ * @param[out] {x}      // The old array.
+ * @param[out] {i}      // The first old element.
+ * @param[out] {da}     // The number of old elements.
+ * @param[out] {y}      // The new array.
+ * @param[out] {j}      // The first new element.
+ * @param[out] {db}     // The number of new elements.
+ * @param[in]  {index}  // The index of the first element, after earlier changes.
+ * @returns             // '1' to continue, '0' to stop.
+ */
+static int jconf_diff_gap(jDiffer* differ, const jArray* x, size_t i, size_t da, const jArray* y, size_t j, size_t db, size_t* index)
+{
+    size_t t, len = differ->len;
+    int result;
+
+    for (t = 0; t < da || t < db; t++)
+    {
+        if (!jconf_diff_push_index(differ, *index))
+            return 0;
+
+        if (t < da && t < db)
+            result = jconf_diff_value(differ, (const jToken*)jconf_array_get(x, i + t), (const jToken*)jconf_array_get(y, j + t));
+        else if (t < da)
+            result = jconf_diff_emit(differ, JCONF_DIFF_REMOVE, (const jToken*)jconf_array_get(x, i + t), NULL);
+        else
+            result = jconf_diff_emit(differ, JCONF_DIFF_ADD, NULL, (const jToken*)jconf_array_get(y, j + t));
+
+        // Removed elements shift the next ones into their index.
+        *index += t < db;
+        differ->len = len;
+        if (!result)
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Diff Array
+ *
+ * Description: Diffs two arrays. The common prefix and suffix are skipped
+ *              and the elements between them are aligned by an edit script
+ *              of their hashes, confirmed with jconf_equal.
+ * @param[in]  {differ} // The differ.
+ * @param[out] {a}      // The old array.
+ * @param[out] {b}      // The new array.
+ * @returns             // '1' to continue, '0' to stop.
+ */
+static int jconf_diff_array(jDiffer* differ, const jToken* a, const jToken* b)
+{
+    const jArray *x = (const jArray*)a->data, *y = (const jArray*)b->data;
+    size_t i, j, n, m, p, s, da, db, index;
+    jDiffEdit* edits;
+    long e, count;
+    jHash* hashes;
+    int result;
+
+    n = x != NULL ? x->end : 0;
+    m = y != NULL ? y->end : 0;
+
+    for (p = 0; p < n && p < m &&
+        jconf_diff_same((const jToken*)jconf_array_get(x, p), (const jToken*)jconf_array_get(y, p)); p++);
+
+    for (s = 0; s < n - p && s < m - p &&
+        jconf_diff_same((const jToken*)jconf_array_get(x, n - 1 - s), (const jToken*)jconf_array_get(y, m - 1 - s)); s++);
+
+    n -= p + s;
+    m -= p + s;
+    index = p;
+
+    if (n == 0 || m == 0)
+        return jconf_diff_gap(differ, x, p, n, y, p, m, &index);
+
+    if ((hashes = (jHash*)jconf_malloc(NULL, (n + m) * sizeof(jHash))) == NULL)
+        return 0;
+
+    for (i = 0; i < n; i++)
+        hashes[i] = jconf_hash_token((const jToken*)jconf_array_get(x, p + i), 0);
+    for (i = 0; i < m; i++)
+        hashes[n + i] = jconf_hash_token((const jToken*)jconf_array_get(y, p + i), 0);
+
+    if (!jconf_diff_script(x, hashes, (long)n, y, hashes + n, (long)m, p, &edits, &count))
+    {
+        jconf_free(NULL, hashes);
+        return 0;
+    }
+
+    jconf_free(NULL, hashes);
+
+    // Too many edits: pair the elements by position.
+    if (edits == NULL)
+        return jconf_diff_gap(differ, x, p, n, y, p, m, &index);
+
+    // Each run of adjacent edits is a gap between matched elements.
+    result = 1;
+    for (e = 0, i = 0, j = 0; e < count && result; i += da, j += db)
+    {
+        index += (size_t)edits[e].x - i;
+        i = (size_t)edits[e].x;
+        j = (size_t)edits[e].y;
+
+        for (da = 0, db = 0; e < count && (size_t)edits[e].x == i + da && (size_t)edits[e].y == j + db; e++)
+        {
+            if (edits[e].insert)
+                db++;
+            else
+                da++;
+        }
+
+        result = jconf_diff_gap(differ, x, p + i, da, y, p + j, db, &index);
+    }
+
+    jconf_free(NULL, edits);
+    return result;
+}
+
+/**
+ * JConf Diff Value
+ *
+ * Description: Diffs two values at the current path.
+ * @param[in]  {differ} // The differ.
+ * @param[out] {a}      // The old value.
+ * @param[out] {b}      // The new value.
+ * @returns             // '1' to continue, '0' to stop.
+ */
+static int jconf_diff_value(jDiffer* differ, const jToken* a, const jToken* b)
+{
+    if (jconf_diff_same(a, b))
+        return 1;
+
+    if (a->type == JCONF_OBJECT && b->type == JCONF_OBJECT)
+        return jconf_diff_object(differ, a, b);
+
+    if (a->type == JCONF_ARRAY && b->type == JCONF_ARRAY)
+        return jconf_diff_array(differ, a, b);
+
+    return jconf_diff_emit(differ, JCONF_DIFF_REPLACE, a, b);
+}
+
+/**
+ * JConf Diff Each
+ *
+ * Description: Reports the changes that turn one tree into another, in the
+ *              order of a patch that applies them.
+ * @param[out] {a}        // The old tree.
+ * @param[out] {b}        // The new tree.
+ * @param[out] {callback} // Called with each change.
+ * @param[out] {data}     // Passed to the callback.
+ * @returns               // '1' if every change was reported, '0' if stopped or out of memory.
+ */
+int jconf_diff_each(const jToken* a, const jToken* b, jDiffCallback callback, void* data)
+{
+    jDiffer differ;
+    int result;
+
+    differ.callback = callback;
+    differ.data = data;
+    differ.len = 0;
+    differ.cap = 64;
+
+    if ((differ.path = (char*)jconf_malloc(NULL, differ.cap)) == NULL)
+        return 0;
+
+    result = jconf_diff_value(&differ, a, b);
+    jconf_free(NULL, differ.path);
+    return result;
+}
+
+/**
+ * JConf Diff String
+ *
+ * Description: Allocates a string token.
+ * @param[out] {allocator} // The allocator.
+ * @param[out] {text}      // The text.
+ * @param[out] {len}       // The length of the text.
+ * @returns                // The token (NULL if out of memory).
+ */
+static jToken* jconf_diff_string(const jAllocator* allocator, const char* text, size_t len)
+{
+    jToken* token;
+
+    if ((token = (jToken*)jconf_malloc(allocator, sizeof(jToken))) == NULL)
+        return NULL;
+
+    token->type = JCONF_STRING;
+    if ((token->data = jconf_malloc(allocator, len + 1)) == NULL)
+    {
+        jconf_free(allocator, token);
+        return NULL;
+    }
+
+    memcpy(token->data, text, len);
+    ((char*)token->data)[len] = '\0';
+    return token;
+}
+
+/**
+ * JConf Diff Member
+ *
+ * Description: Appends a member to an operation object, freeing the value
+ *              on error.
+ * @param[in]  {map}       // The object.
+ * @param[out] {key}       // The key.
+ * @param[out] {value}     // The value (NULL if it could not be allocated).
+ * @param[out] {allocator} // The allocator.
+ * @returns                // '1' if successful, '0' if out of memory.
+ */
+static int jconf_diff_member(jMap* map, const char* key, jToken* value, const jAllocator* allocator)
+{
+    size_t len = jconf_strlen(key);
+    char* copy;
+
+    if (value == NULL)
+        return 0;
+
+    if ((copy = (char*)jconf_malloc(allocator, len + 1)) == NULL)
+    {
+        jconf_free_token_with(value, allocator);
+        return 0;
+    }
+
+    memcpy(copy, key, len + 1);
+    if (!jconf_map_append(map, copy, len, value))
+    {
+        jconf_free(allocator, copy);
+        jconf_free_token_with(value, allocator);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Diff Build
+ *
+ * Description: Appends a change to the patch document as an operation.
+ * @param[out] {change} // The change.
+ * @param[out] {data}   // The builder.
+ * @returns             // '1' if successful, '0' if out of memory.
+ */
+static int jconf_diff_build(const jDiffChange* change, void* data)
+{
+    jDiffBuilder* builder = (jDiffBuilder*)data;
+    const jAllocator* allocator = builder->allocator;
+    const char* name = jconf_diff_ops[change->op];
+    jToken* op;
+    jMap* map;
+
+    if (builder->patch->data == NULL)
+    {
+        if ((builder->patch->data = jconf_malloc(allocator, sizeof(jArray))) == NULL)
+            return 0;
+
+        jconf_init_array_with((jArray*)builder->patch->data, 0, 2, allocator);
+    }
+
+    if ((op = (jToken*)jconf_malloc(allocator, sizeof(jToken))) == NULL)
+        return 0;
+
+    op->type = JCONF_OBJECT;
+    if ((op->data = map = (jMap*)jconf_malloc(allocator, sizeof(jMap))) == NULL)
+    {
+        jconf_free(allocator, op);
+        return 0;
+    }
+
+    jconf_init_map_with(map, allocator);
+    if (!jconf_array_push((jArray*)builder->patch->data, op))
+    {
+        jconf_free_token_with(op, allocator);
+        return 0;
+    }
+
+    // A partial operation is freed with the patch.
+    return jconf_diff_member(map, "op", jconf_diff_string(allocator, name, jconf_strlen(name)), allocator) &&
+        jconf_diff_member(map, "path", jconf_diff_string(allocator, change->path, change->len), allocator) &&
+        (change->to == NULL || jconf_diff_member(map, "value", jconf_copy_token_with(change->to, allocator), allocator));
+}
+
+/**
+ * JConf Diff
+ *
+ * Description: Builds the JSON Patch that turns one tree into another.
+ * @param[out] {a}         // The old tree.
+ * @param[out] {b}         // The new tree.
+ * @param[out] {allocator} // The allocator for the patch (NULL for the default).
+ * @returns                // The patch document (NULL if out of memory).
+ */
+jToken* jconf_diff(const jToken* a, const jToken* b, const jAllocator* allocator)
+{
+    jDiffBuilder builder;
+
+    if ((builder.patch = (jToken*)jconf_malloc(allocator, sizeof(jToken))) == NULL)
+        return NULL;
+
+    builder.patch->type = JCONF_ARRAY;
+    builder.patch->data = NULL;
+    builder.allocator = allocator;
+
+    if (!jconf_diff_each(a, b, &jconf_diff_build, &builder))
+    {
+        jconf_free_token_with(builder.patch, allocator);
+        return NULL;
+    }
+
+    return builder.patch;
+}
@@ -0,0 +1,234 @@
+/**
+ * JConf Document Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/document.h>
+#include <jconf/hash.h>
+#include <stdatomic.h>
+
+#if defined(_WIN32) || defined(WIN32)
+    #include <windows.h>
+    #define jconf_yield() SwitchToThread()
+#else
+    #include <sched.h>
+    #define jconf_yield() sched_yield()
+#endif
+
+// Reader counters are striped across cache lines to avoid contention.
+#define JCONF_DOC_STRIPES    16
+#define JCONF_DOC_CACHE_LINE 64
+
+// Reader counter stripe definition.
+typedef struct _j_doc_stripe
+{
+    atomic_ulong readers[2];
+    char padding[JCONF_DOC_CACHE_LINE - 2 * sizeof(atomic_ulong)];
+
+} jDocStripe;
+
+// jDocSlot struct definition.
+struct _j_doc_slot
+{
+    jDocStripe stripes[JCONF_DOC_STRIPES];
+    _Atomic(jDocument*) current;
+    atomic_uint parity;
+    atomic_flag lock;
+};
+
+// Stripe assignment for the calling thread.
+static atomic_uint jconf_doc_next_stripe = 0;
+static _Thread_local unsigned int jconf_doc_stripe = JCONF_DOC_STRIPES;
+
+/**
+ * JConf Doc Wait
+ *
+ * Description: Waits until no reader is counted under a parity.
+ * @param[out] {slot}   // The document slot.
+ * @param[out] {parity} // The parity to drain.
+ */
+static void jconf_doc_wait(jDocSlot* slot, unsigned int parity)
+{
+    int i;
+
+    for (i = 0; i < JCONF_DOC_STRIPES; i++)
+        while (atomic_load(&slot->stripes[i].readers[parity]) != 0)
+            jconf_yield();
+}
+
+/**
+ * JConf Doc Create
+ *
+ * Description: Freezes a parsed tree into a document. The document takes
+ *              ownership of the tree, which must not be modified afterwards.
+ *              The tree is hashed here so that readers comparing or diffing
+ *              it (see jconf/hash.h) only read its digests.
+ * @param[out] {root} // The root token.
+ * @returns           // The document (NULL if out of memory).
+ */
+jDocument* jconf_doc_create(jToken* root)
+{
+    jDocument* doc;
+
+    if ((doc = (jDocument*)jconf_malloc(NULL, sizeof(*doc))) == NULL)
+        return NULL;
+
+    if (root != NULL)
+        jconf_hash_token(root, 0);
+
+    doc->root = root;
+    return doc;
+}
+
+/**
+ * JConf Doc Free
+ *
+ * Description: Frees a document and its tree.
+ * @param[out] {doc} // The document to free.
+ */
+void jconf_doc_free(jDocument* doc)
+{
+    if (doc == NULL)
+        return;
+
+    jconf_free_token(doc->root);
+    jconf_free(NULL, doc);
+}
+
+/**
+ * JConf Doc Root
+ *
+ * Description: Returns the root token of a document.
+ * @param[out] {doc} // The document.
+ * @returns          // The root token.
+ */
+const jToken* jconf_doc_root(const jDocument* doc)
+{
+    return doc == NULL ? NULL : doc->root;
+}
+
+/**
+ * JConf Doc Slot Create
+ *
+ * Description: Creates a slot with an initial document, hashed as by
+ *              jconf_doc_publish.
+ * @param[out] {doc} // The initial document (may be NULL).
+ * @returns          // The slot (NULL if out of memory).
+ */
+jDocSlot* jconf_doc_slot_create(jDocument* doc)
+{
+    jDocSlot* slot;
+    int i;
+
+    if (doc != NULL && doc->root != NULL)
+        jconf_hash_token(doc->root, 0);
+
+    if ((slot = (jDocSlot*)jconf_malloc(NULL, sizeof(*slot))) == NULL)
+        return NULL;
+
+    for (i = 0; i < JCONF_DOC_STRIPES; i++)
+    {
+        atomic_init(&slot->stripes[i].readers[0], 0);
+        atomic_init(&slot->stripes[i].readers[1], 0);
+    }
+
+    atomic_init(&slot->current, doc);
+    atomic_init(&slot->parity, 0);
+    atomic_flag_clear(&slot->lock);
+    return slot;
+}
+
+/**
+ * JConf Doc Slot Destroy
+ *
+ * Description: Destroys a slot and its current document. No reader may be
+ *              inside the slot.
+ * @param[out] {slot} // The slot to destroy.
+ */
+void jconf_doc_slot_destroy(jDocSlot* slot)
+{
+    if (slot == NULL)
+        return;
+
+    jconf_doc_free(atomic_load(&slot->current));
+    jconf_free(NULL, slot);
+}
+
+/**
+ * JConf Doc Publish
+ *
+ * Description: Replaces the current document. Readers are never blocked;
+ *              the caller waits until all readers that may hold the previous
+ *              document have released it, then frees it. Publishers are
+ *              serialized with each other. The tree is hashed before readers
+ *              can see it, which costs nothing if jconf_doc_create did.
+ * @param[in]  {slot} // The slot.
+ * @param[out] {doc}  // The new document.
+ */
+void jconf_doc_publish(jDocSlot* slot, jDocument* doc)
+{
+    unsigned int parity;
+    jDocument* old;
+
+    if (doc != NULL && doc->root != NULL)
+        jconf_hash_token(doc->root, 0);
+
+    while (atomic_flag_test_and_set(&slot->lock))
+        jconf_yield();
+
+    old = atomic_exchange(&slot->current, doc);
+
+    // Flip the parity twice so that readers counted under either parity
+    // before the exchange have drained. New readers always enter under the
+    // current parity and see the new document, so neither wait can starve.
+    parity = atomic_load(&slot->parity);
+    atomic_store(&slot->parity, parity ^ 1);
+    jconf_doc_wait(slot, parity);
+
+    atomic_store(&slot->parity, parity);
+    jconf_doc_wait(slot, parity ^ 1);
+
+    atomic_flag_clear(&slot->lock);
+    jconf_doc_free(old);
+}
+
+/**
+ * JConf Doc Acquire
+ *
+ * Description: Enters a read-side critical section and returns the current
+ *              document, which remains valid until jconf_doc_release.
+ * @param[in]  {slot}   // The slot.
+ * @param[in]  {reader} // The reader state to fill.
+ * @returns             // The current document.
+ */
+const jDocument* jconf_doc_acquire(jDocSlot* slot, jDocReader* reader)
+{
+    if (jconf_doc_stripe == JCONF_DOC_STRIPES)
+        jconf_doc_stripe = atomic_fetch_add(&jconf_doc_next_stripe, 1) % JCONF_DOC_STRIPES;
+
+    reader->stripe = jconf_doc_stripe;
+    reader->parity = atomic_load(&slot->parity);
+    atomic_fetch_add(&slot->stripes[reader->stripe].readers[reader->parity], 1);
+
+    reader->doc = atomic_load(&slot->current);
+    return reader->doc;
+}
+
+/**
+ * JConf Doc Release
+ *
+ * Description: Leaves a read-side critical section.
+ * @param[in]  {slot}   // The slot.
+ * @param[in]  {reader} // The reader state filled by jconf_doc_acquire.
+ */
+void jconf_doc_release(jDocSlot* slot, jDocReader* reader)
+{
+    atomic_fetch_sub(&slot->stripes[reader->stripe].readers[reader->parity], 1);
+    reader->doc = NULL;
+}
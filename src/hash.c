@@ -0,0 +1,349 @@
+/**
+ * JConf Hash Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/hash.h>
+#include <jconf/string.h>
+#include <string.h>
+#include <stdlib.h>
+
+// Hash seeds for the kinds of values.
+#define JCONF_HASH_KEYWORD 0x2d358dccaa6c78a5ULL
+#define JCONF_HASH_NUMBER  0x8bb84b93962eacc9ULL
+#define JCONF_HASH_STRING  0x4b33a62ed433d4a3ULL
+#define JCONF_HASH_ARRAY   0x4d5a2da51de1aa47ULL
+#define JCONF_HASH_OBJECT  0xa0761d6478bd642fULL
+
+/**
+ * JConf Hash Mix
+ *
+ * Description: Combines two hashes (boost's hash_combine step followed by
+ *              the MurmurHash3 finalizer).
+ * @param[out] {a} // The first hash.
+ * @param[out] {b} // The second hash.
+ * @returns        // The combined hash.
+ */
+static __inline jHash jconf_hash_mix(jHash a, jHash b)
+{
+    a ^= b + 0x9e3779b97f4a7c15ULL + (a << 6) + (a >> 2);
+    a ^= a >> 33;
+    a *= 0xff51afd7ed558ccdULL;
+    a ^= a >> 33;
+    a *= 0xc4ceb9fe1a85ec53ULL;
+    a ^= a >> 33;
+    return a;
+}
+
+/**
+ * JConf Hash Digits
+ *
+ * Description: Skips the sign and the leading zeros of an integer, so that
+ *              equal integers have the same digits (-0 is 0).
+ * @param[out] {text}     // The integer.
+ * @param[in]  {negative} // Set to '1' if the integer is below 0.
+ * @returns               // The digits.
+ */
+static __inline const char* jconf_hash_digits(const char* text, int* negative)
+{
+    *negative = *text == '-';
+    if (*text == '-' || *text == '+')
+        text++;
+
+    while (*text == '0' && text[1] != '\0')
+        text++;
+
+    if (*text == '0')
+        *negative = 0;
+
+    return text;
+}
+
+/**
+ * JConf Hash Number
+ *
+ * Description: Converts a number to a double, or returns '0' if the token
+ *              is not a number or is an integer that no double holds
+ *              exactly. Integers are converted without strtod.
+ * @param[out] {token} // The token.
+ * @param[in]  {value} // Set to the value.
+ * @returns            // '1' if the value is exact.
+ */
+static __inline int jconf_hash_number(const jToken* token, double* value)
+{
+    const char* text;
+    uint64_t n = 0;
+    int negative;
+
+    if (token->type == JCONF_DOUBLE)
+    {
+        *value = strtod((const char*)token->data, NULL);
+        return 1;
+    }
+
+    if (token->type != JCONF_INT)
+        return 0;
+
+    for (text = jconf_hash_digits((const char*)token->data, &negative); *text != '\0'; text++)
+    {
+        if (n > (UINT64_MAX - (uint64_t)(*text - '0')) / 10)
+            return 0;
+
+        n = n * 10 + (uint64_t)(*text - '0');
+    }
+
+    // Doubles hold every integer up to 2^53 and some above it.
+    *value = (double)n;
+    if (n > (1ULL << 53) && (*value >= 18446744073709551616.0 || (uint64_t)*value != n))
+        return 0;
+
+    *value = negative ? -*value : *value;
+    return 1;
+}
+
+/**
+ * JConf Hash Integers
+ *
+ * Description: Compares two integers exactly, by their digits.
+ * @param[out] {a} // The first integer.
+ * @param[out] {b} // The second integer.
+ * @returns        // '1' if the integers are equal.
+ */
+static __inline int jconf_hash_integers(const jToken* a, const jToken* b)
+{
+    const char *x, *y;
+    int p, q;
+
+    x = jconf_hash_digits((const char*)a->data, &p);
+    y = jconf_hash_digits((const char*)b->data, &q);
+    return p == q && !jconf_strcmp(x, y);
+}
+
+/**
+ * JConf Digest
+ *
+ * Description: Reads and writes memoized hashes. Threads that hash a tree
+ *              at once store the same values, so relaxed atomics keep the
+ *              memo free of data races without ordering anything.
+ */
+static __inline jHash jconf_digest_load(const JCONF_ATOMIC(jHash)* digest)
+{
+    return atomic_load_explicit(digest, memory_order_relaxed);
+}
+
+static __inline void jconf_digest_store(JCONF_ATOMIC(jHash)* digest, jHash hash)
+{
+    atomic_store_explicit(digest, hash, memory_order_relaxed);
+}
+
+static __inline int jconf_digest_differ(const JCONF_ATOMIC(jHash)* a, const JCONF_ATOMIC(jHash)* b)
+{
+    jHash x = jconf_digest_load(a), y = jconf_digest_load(b);
+    return x != 0 && y != 0 && x != y;
+}
+
+/**
+ * JConf Hash Content
+ *
+ * Description: Hashes a value, memoizing the hashes of containers. Objects
+ *              hash by the sum of the hashes of their members.
+ * @param[out] {token} // The value.
+ * @returns            // The hash (never 0).
+ */
+static jHash jconf_hash_content(const jToken* token)
+{
+    const jNode* node;
+    jArray* arr;
+    jMap* map;
+    const char* text;
+    jHash hash;
+    double value;
+    uint64_t bits;
+    size_t i;
+    int negative;
+
+    switch (token->type)
+    {
+        case JCONF_OBJECT:
+            if ((map = (jMap*)token->data) != NULL && (hash = jconf_digest_load(&map->digest)) != 0)
+                return hash;
+
+            hash = 0;
+            for (node = map != NULL ? map->first : NULL; node != NULL; node = node->after)
+                hash += jconf_hash_mix(jconf_map_hash(node->key, node->len), jconf_hash_content((const jToken*)node->value));
+
+            hash = jconf_hash_mix(JCONF_HASH_OBJECT ^ (map != NULL ? map->count : 0), hash);
+            hash += hash == 0;
+            if (map != NULL)
+                jconf_digest_store(&map->digest, hash);
+            return hash;
+
+        case JCONF_ARRAY:
+            if ((arr = (jArray*)token->data) != NULL && (hash = jconf_digest_load(&arr->digest)) != 0)
+                return hash;
+
+            hash = JCONF_HASH_ARRAY ^ (arr != NULL ? arr->end : 0);
+            for (i = 0; arr != NULL && i < arr->end; i++)
+                hash = jconf_hash_mix(hash, jconf_hash_content((const jToken*)jconf_array_get(arr, i)));
+
+            hash = jconf_hash_mix(hash, 0);
+            hash += hash == 0;
+            if (arr != NULL)
+                jconf_digest_store(&arr->digest, hash);
+            return hash;
+
+        case JCONF_STRING:
+            hash = jconf_hash_mix(JCONF_HASH_STRING, jconf_map_hash((const char*)token->data, jconf_strlen((const char*)token->data)));
+            break;
+
+        case JCONF_INT:
+        case JCONF_DOUBLE:
+            // Integers that no double holds hash by their digits.
+            if (!jconf_hash_number(token, &value))
+            {
+                text = jconf_hash_digits((const char*)token->data, &negative);
+                hash = jconf_hash_mix(JCONF_HASH_NUMBER ^ (jHash)negative, jconf_map_hash(text, jconf_strlen(text)));
+                break;
+            }
+
+            // -0 equals 0.
+            if (value == 0)
+                value = 0;
+
+            memcpy(&bits, &value, sizeof(bits));
+            hash = jconf_hash_mix(JCONF_HASH_NUMBER, bits);
+            break;
+
+        default:
+            hash = jconf_hash_mix(JCONF_HASH_KEYWORD, token->type);
+            break;
+    }
+
+    return hash + (hash == 0);
+}
+
+/**
+ * JConf Hash Token
+ *
+ * Description: Hashes a tree, memoizing the hashes of its containers. Equal
+ *              trees (see jconf_equal) hash equally.
+ * @param[out] {token} // The tree.
+ * @param[out] {seed}  // The seed.
+ * @returns            // The hash.
+ */
+jHash jconf_hash_token(const jToken* token, uint64_t seed)
+{
+    return jconf_hash_mix(seed, jconf_hash_content(token));
+}
+
+/**
+ * JConf Hash Clear
+ *
+ * Description: Clears the memoized hashes of a tree after it was edited.
+ * @param[in] {token} // The tree.
+ */
+void jconf_hash_clear(jToken* token)
+{
+    const jNode* node;
+    jArray* arr;
+    size_t i;
+
+    if (token->type == JCONF_OBJECT && token->data != NULL)
+    {
+        jconf_digest_store(&((jMap*)token->data)->digest, 0);
+        for (node = ((jMap*)token->data)->first; node != NULL; node = node->after)
+            jconf_hash_clear((jToken*)node->value);
+    }
+    else if (token->type == JCONF_ARRAY && (arr = (jArray*)token->data) != NULL)
+    {
+        jconf_digest_store(&arr->digest, 0);
+        for (i = 0; i < arr->end; i++)
+            jconf_hash_clear((jToken*)jconf_array_get(arr, i));
+    }
+}
+
+/**
+ * JConf Equal
+ *
+ * Description: Compares two trees. Numbers are equal by value (integers
+ *              exactly), strings by their text and objects regardless of
+ *              the order of their members. Containers whose memoized hashes differ are unequal
+ *              and shared containers are equal without being visited;
+ *              hashes are not computed.
+ * @param[out] {a} // The first tree.
+ * @param[out] {b} // The second tree.
+ * @returns        // '1' if the trees are equal.
+ */
+int jconf_equal(const jToken* a, const jToken* b)
+{
+    const jArray *x, *y;
+    const jMap *m, *n;
+    const jNode* node;
+    const jToken* value;
+    double p, q;
+    size_t i;
+
+    if (a == b || (a->type == b->type && a->data == b->data))
+        return 1;
+
+    // Numbers with the same text are equal without converting them.
+    if (a->type == b->type && (a->type == JCONF_INT || a->type == JCONF_DOUBLE) &&
+        !jconf_strcmp((const char*)a->data, (const char*)b->data))
+        return 1;
+
+    // Integers compare exactly, a double only with the integers it holds.
+    if (a->type == JCONF_INT && b->type == JCONF_INT)
+        return jconf_hash_integers(a, b);
+
+    if ((a->type == JCONF_INT || a->type == JCONF_DOUBLE) && (b->type == JCONF_INT || b->type == JCONF_DOUBLE))
+        return jconf_hash_number(a, &p) && jconf_hash_number(b, &q) && p == q;
+
+    if (a->type != b->type)
+        return 0;
+
+    switch (a->type)
+    {
+        case JCONF_STRING:
+            return !jconf_strcmp((const char*)a->data, (const char*)b->data);
+
+        case JCONF_ARRAY:
+            x = (const jArray*)a->data;
+            y = (const jArray*)b->data;
+            if ((x != NULL ? x->end : 0) != (y != NULL ? y->end : 0))
+                return 0;
+
+            if (x != NULL && y != NULL && jconf_digest_differ(&x->digest, &y->digest))
+                return 0;
+
+            for (i = 0; x != NULL && i < x->end; i++)
+                if (!jconf_equal((const jToken*)jconf_array_get(x, i), (const jToken*)jconf_array_get(y, i)))
+                    return 0;
+            return 1;
+
+        case JCONF_OBJECT:
+            m = (const jMap*)a->data;
+            n = (const jMap*)b->data;
+            if ((m != NULL ? m->count : 0) != (n != NULL ? n->count : 0))
+                return 0;
+
+            if (m != NULL && n != NULL && jconf_digest_differ(&m->digest, &n->digest))
+                return 0;
+
+            for (node = m != NULL ? m->first : NULL; node != NULL; node = node->after)
+            {
+                value = (const jToken*)jconf_map_get_hashed(n, node->key, node->len, node->hash);
+                if (value == NULL || !jconf_equal((const jToken*)node->value, value))
+                    return 0;
+            }
+            return 1;
+
+        default:
+            return 1;
+    }
+}
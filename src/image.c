@@ -0,0 +1,493 @@
+/**
+ * JConf Image Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/image.h>
+#include <string.h>
+
+/**
+ * Image layout (all fields are 32-bit words in host byte order, every record
+ * is 4-byte aligned and every reference is an offset from the image base):
+ *
+ *   header  : jImageHeader
+ *   keyword : type, 0
+ *   scalar  : type, length, bytes[length], '\0', padding
+ *   array   : type, count, ref[count]
+ *   object  : type, count, slots, entry[count], index[slots], keys...
+ *             entry = { hash, key offset, key length, value ref }
+ *             index = entry number + 1 (0 for an empty slot), linear probing.
+ */
+
+#define JCONF_IMAGE_PAD(n) (((n) + 3) & ~(size_t)3)
+
+// Image object entry definition.
+typedef struct _j_image_entry
+{
+    uint32_t hash;
+    uint32_t key;
+    uint32_t len;
+    jImageRef value;
+
+} jImageEntry;
+
+/**
+ * JConf Image Hash
+ *
+ * Description: Generates the hash stored in the object indexes (FNV-1a). The
+ *              function is part of the image format and must remain stable.
+ * @param[out] {key}    // The key to hash.
+ * @param[out] {length} // The length of the key.
+ * @returns             // The hash value.
+ */
+static uint32_t jconf_image_hash(const char* key, uint32_t length)
+{
+    uint32_t hash = 2166136261u;
+
+    while (length--)
+    {
+        hash ^= (unsigned char)*key++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * JConf Image Slots
+ *
+ * Description: Returns the number of index slots used for an object.
+ * @param[out] {count} // The number of keys in the object.
+ * @returns            // A power of two at least twice the key count.
+ */
+static uint32_t jconf_image_slots(uint32_t count)
+{
+    uint32_t slots = 2;
+
+    while (slots < count * 2)
+        slots <<= 1;
+
+    return slots;
+}
+
+/**
+ * JConf Image Token Size
+ *
+ * Description: Computes the number of bytes required to encode a token.
+ * @param[out] {token} // The token to measure.
+ * @returns            // The encoded size in bytes.
+ */
+static size_t jconf_image_token_size(jToken* token)
+{
+    size_t size = 2 * sizeof(uint32_t);
+    jArray* arr;
+    jNode* node;
+    jMap* map;
+    size_t i;
+
+    switch (token->type)
+    {
+        case JCONF_STRING:
+        case JCONF_INT:
+        case JCONF_DOUBLE:
+            size += JCONF_IMAGE_PAD(jconf_strlen((char*)token->data) + 1);
+            break;
+
+        case JCONF_ARRAY:
+            if ((arr = (jArray*)token->data) == NULL)
+                break;
+
+            for (i = 0; i < arr->end; i++)
+                size += sizeof(jImageRef) + jconf_image_token_size((jToken*)jconf_array_get(arr, i));
+            break;
+
+        case JCONF_OBJECT:
+            if ((map = (jMap*)token->data) == NULL)
+            {
+                size += sizeof(uint32_t) + 2 * sizeof(uint32_t);
+                break;
+            }
+
+            size += sizeof(uint32_t) + jconf_image_slots(map->count) * sizeof(uint32_t);
+            for (node = map->first; node; node = node->after)
+            {
+                size += sizeof(jImageEntry) + JCONF_IMAGE_PAD(node->len + 1);
+                size += jconf_image_token_size((jToken*)node->value);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return size;
+}
+
+/**
+ * JConf Image Emit
+ *
+ * Description: Encodes a token at the provided position.
+ * @param[out] {token} // The token to encode.
+ * @param[in]  {base}  // The image buffer.
+ * @param[in]  {pos}   // The write position (advanced past the encoding).
+ * @returns            // The reference to the encoded token.
+ */
+static jImageRef jconf_image_emit(jToken* token, unsigned char* base, size_t* pos)
+{
+    uint32_t *node, *index, count, slots, j, k;
+    jImageEntry* entries;
+    jImageRef ref;
+    jArray* arr;
+    jNode* item;
+    jMap* map;
+    size_t len;
+    size_t i;
+
+    ref = (jImageRef)*pos;
+    node = (uint32_t*)(base + *pos);
+    node[0] = (uint32_t)token->type;
+    node[1] = 0;
+    *pos += 2 * sizeof(uint32_t);
+
+    switch (token->type)
+    {
+        case JCONF_STRING:
+        case JCONF_INT:
+        case JCONF_DOUBLE:
+            len = jconf_strlen((char*)token->data);
+            node[1] = (uint32_t)len;
+            memcpy(base + *pos, token->data, len);
+            memset(base + *pos + len, 0, JCONF_IMAGE_PAD(len + 1) - len);
+            *pos += JCONF_IMAGE_PAD(len + 1);
+            break;
+
+        case JCONF_ARRAY:
+            if ((arr = (jArray*)token->data) == NULL)
+                break;
+
+            node[1] = (uint32_t)arr->end;
+            *pos += arr->end * sizeof(jImageRef);
+
+            // Children are written after the reference table.
+            for (i = 0; i < arr->end; i++)
+                node[2 + i] = jconf_image_emit((jToken*)jconf_array_get(arr, i), base, pos);
+            break;
+
+        case JCONF_OBJECT:
+            map = (jMap*)token->data;
+            count = map == NULL ? 0 : (uint32_t)map->count;
+            slots = jconf_image_slots(count);
+
+            node[1] = count;
+            node[2] = slots;
+            entries = (jImageEntry*)(node + 3);
+            index = (uint32_t*)(entries + count);
+            *pos += sizeof(uint32_t) + count * sizeof(jImageEntry) + slots * sizeof(uint32_t);
+
+            for (j = 0; j < slots; j++)
+                index[j] = 0;
+
+            if (map == NULL)
+                break;
+
+            for (item = map->first, j = 0; item; item = item->after, j++)
+            {
+                // Store the key and precompute its hash.
+                entries[j].key = (uint32_t)*pos;
+                entries[j].len = (uint32_t)item->len;
+                entries[j].hash = jconf_image_hash(item->key, entries[j].len);
+                memcpy(base + *pos, item->key, item->len);
+                memset(base + *pos + item->len, 0, JCONF_IMAGE_PAD(item->len + 1) - item->len);
+                *pos += JCONF_IMAGE_PAD(item->len + 1);
+
+                // Insert the entry into the index.
+                for (k = entries[j].hash & (slots - 1); index[k] != 0; k = (k + 1) & (slots - 1));
+                index[k] = j + 1;
+
+                entries[j].value = jconf_image_emit((jToken*)item->value, base, pos);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return ref;
+}
+
+/**
+ * JConf Image Node
+ *
+ * Description: Returns a pointer to the node at the provided reference.
+ * @param[out] {image} // The image.
+ * @param[out] {ref}   // The node reference.
+ * @returns            // The node words (NULL if the reference is invalid).
+ */
+static __inline const uint32_t* jconf_image_node(const jImage* image, jImageRef ref)
+{
+    if (ref < sizeof(jImageHeader) || (ref & 3) || ref > image->size - 2 * sizeof(uint32_t))
+        return NULL;
+
+    return (const uint32_t*)(image->base + ref);
+}
+
+/**
+ * JConf Image Size
+ *
+ * Description: Computes the size of the image for a jToken tree.
+ * @param[out] {root} // The root token.
+ * @returns           // The size in bytes ('0' if the tree is too large).
+ */
+size_t jconf_image_size(jToken* root)
+{
+    size_t size;
+
+    if (root == NULL)
+        return 0;
+
+    size = sizeof(jImageHeader) + jconf_image_token_size(root);
+    return size > UINT32_MAX ? 0 : size;
+}
+
+/**
+ * JConf Image Write
+ *
+ * Description: Encodes a jToken tree into the provided buffer.
+ * @param[out] {root}   // The root token.
+ * @param[in]  {buffer} // The destination buffer (4-byte aligned).
+ * @param[out] {size}   // The size of the destination buffer.
+ * @returns             // The number of bytes written ('0' on failure).
+ */
+size_t jconf_image_write(jToken* root, void* buffer, size_t size)
+{
+    jImageHeader* header;
+    size_t required, pos;
+
+    required = jconf_image_size(root);
+    if (required == 0 || required > size || ((uintptr_t)buffer & 3))
+        return 0;
+
+    header = (jImageHeader*)buffer;
+    header->magic = JCONF_IMAGE_MAGIC;
+    header->version = JCONF_IMAGE_VERSION;
+    header->order = JCONF_IMAGE_ORDER;
+    header->size = (uint32_t)required;
+    header->reserved = 0;
+
+    pos = sizeof(jImageHeader);
+    header->root = jconf_image_emit(root, (unsigned char*)buffer, &pos);
+    return pos;
+}
+
+/**
+ * JConf Image Open
+ *
+ * Description: Initializes a view over an image. Only the header is checked,
+ *              so opening an image is constant time; accessors bounds check
+ *              every reference they follow.
+ * @param[in]  {image}  // The image view to initialize.
+ * @param[out] {buffer} // The image buffer (4-byte aligned, e.g mmapped).
+ * @param[out] {size}   // The size of the buffer.
+ * @returns             // '1' if successful, '0' if the buffer is not a valid image.
+ */
+int jconf_image_open(jImage* image, const void* buffer, size_t size)
+{
+    const jImageHeader* header = (const jImageHeader*)buffer;
+
+    image->base = NULL;
+    image->size = 0;
+
+    if (buffer == NULL || ((uintptr_t)buffer & 3) || size < sizeof(jImageHeader))
+        return 0;
+
+    if (header->magic != JCONF_IMAGE_MAGIC || header->version != JCONF_IMAGE_VERSION ||
+        header->order != JCONF_IMAGE_ORDER || header->size > size || header->size < sizeof(jImageHeader))
+        return 0;
+
+    image->base = (const unsigned char*)buffer;
+    image->size = header->size;
+
+    if (jconf_image_node(image, header->root) == NULL)
+    {
+        image->base = NULL;
+        image->size = 0;
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Image Root
+ *
+ * Description: Returns the reference to the root value of an image.
+ * @param[out] {image} // The image.
+ * @returns            // The root reference.
+ */
+jImageRef jconf_image_root(const jImage* image)
+{
+    return ((const jImageHeader*)image->base)->root;
+}
+
+/**
+ * JConf Image Type
+ *
+ * Description: Returns the type of the referenced value.
+ * @param[out] {image} // The image.
+ * @param[out] {ref}   // The value reference.
+ * @returns            // The type (JCONF_NULL if the reference is invalid).
+ */
+jType jconf_image_type(const jImage* image, jImageRef ref)
+{
+    const uint32_t* node = jconf_image_node(image, ref);
+    return node == NULL ? JCONF_NULL : (jType)node[0];
+}
+
+/**
+ * JConf Image Count
+ *
+ * Description: Returns the number of elements in an array or object, or the
+ *              length of a string or number.
+ * @param[out] {image} // The image.
+ * @param[out] {ref}   // The value reference.
+ * @returns            // The count.
+ */
+uint32_t jconf_image_count(const jImage* image, jImageRef ref)
+{
+    const uint32_t* node = jconf_image_node(image, ref);
+    return node == NULL ? 0 : node[1];
+}
+
+/**
+ * JConf Image String
+ *
+ * Description: Returns the nul-terminated text of a string or number.
+ * @param[out] {image}  // The image.
+ * @param[out] {ref}    // The value reference.
+ * @param[in]  {length} // Receives the length of the string (optional).
+ * @returns             // The string (NULL if the value is not textual).
+ */
+const char* jconf_image_string(const jImage* image, jImageRef ref, uint32_t* length)
+{
+    const uint32_t* node = jconf_image_node(image, ref);
+
+    if (node == NULL || (node[0] != JCONF_STRING && node[0] != JCONF_INT && node[0] != JCONF_DOUBLE))
+        return NULL;
+
+    if (node[1] >= image->size - ref - 2 * sizeof(uint32_t))
+        return NULL;
+
+    if (length != NULL)
+        *length = node[1];
+
+    return (const char*)(node + 2);
+}
+
+/**
+ * JConf Image Index
+ *
+ * Description: Returns the element of an array at the provided index.
+ * @param[out] {image} // The image.
+ * @param[out] {ref}   // The array reference.
+ * @param[out] {i}     // The index of the element.
+ * @returns            // The element reference ('0' if not found).
+ */
+jImageRef jconf_image_index(const jImage* image, jImageRef ref, uint32_t i)
+{
+    const uint32_t* node = jconf_image_node(image, ref);
+
+    if (node == NULL || node[0] != JCONF_ARRAY || i >= node[1])
+        return 0;
+
+    if ((size_t)(i + 1) * sizeof(jImageRef) > image->size - ref - 2 * sizeof(uint32_t))
+        return 0;
+
+    return node[2 + i];
+}
+
+/**
+ * JConf Image Key
+ *
+ * Description: Looks up a key in an object using its precomputed index.
+ * @param[out] {image}  // The image.
+ * @param[out] {ref}    // The object reference.
+ * @param[out] {key}    // The key.
+ * @param[out] {length} // The length of the key.
+ * @returns             // The value reference ('0' if not found).
+ */
+jImageRef jconf_image_key(const jImage* image, jImageRef ref, const char* key, uint32_t length)
+{
+    const uint32_t* node = jconf_image_node(image, ref);
+    const jImageEntry* entries;
+    const uint32_t* index;
+    uint32_t hash, slots, i, n;
+
+    if (node == NULL || node[0] != JCONF_OBJECT || (size_t)ref + 3 * sizeof(uint32_t) > image->size)
+        return 0;
+
+    slots = node[2];
+    if (slots == 0 || (slots & (slots - 1)) ||
+        ((size_t)node[1] * sizeof(jImageEntry) + (size_t)slots * sizeof(uint32_t)) > image->size - ref - 3 * sizeof(uint32_t))
+        return 0;
+
+    entries = (const jImageEntry*)(node + 3);
+    index = (const uint32_t*)(entries + node[1]);
+    hash = jconf_image_hash(key, length);
+
+    // Probe the index until an empty slot is found.
+    for (i = hash & (slots - 1), n = 0; n < slots && index[i] != 0; i = (i + 1) & (slots - 1), n++)
+    {
+        if (index[i] > node[1])
+            return 0;
+
+        entries = (const jImageEntry*)(node + 3) + (index[i] - 1);
+        if (entries->hash == hash && entries->len == length && length <= image->size &&
+            entries->key <= image->size - length && memcmp(image->base + entries->key, key, length) == 0)
+            return entries->value;
+    }
+
+    return 0;
+}
+
+/**
+ * JConf Image Get
+ *
+ * Description: Accesses a value in an image with the same format string as
+ *              jconf_get ('o' for an object key, 'a' for an array index).
+ * @param[out] {image}  // The image.
+ * @param[out] {head}   // The starting reference.
+ * @param[out] {format} // The access format.
+ * @returns             // The destination reference ('0' if not found).
+ */
+jImageRef jconf_image_get(const jImage* image, jImageRef head, const char* format, ...)
+{
+    jImageRef ref = head;
+    const char* key;
+    va_list args;
+
+    va_start(args, format);
+
+    for (; *format != '\0' && ref != 0; format++)
+    {
+        // Index the object.
+        if (*format == 'o' || *format == 'O')
+        {
+            key = va_arg(args, const char*);
+            ref = jconf_image_key(image, ref, key, (uint32_t)jconf_strlen(key));
+        }
+        // Index the array.
+        else if (*format == 'a' || *format == 'A')
+            ref = jconf_image_index(image, ref, (uint32_t)va_arg(args, int));
+        else
+            ref = 0;
+    }
+
+    va_end(args);
+    return ref;
+}
@@ -10,33 +10,302 @@
  */
 
 #include <jconf/map.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__linux__)
+    #include <sys/random.h>
+#endif
+
+// Hash constants (the default wyhash secret).
+#define JCONF_HASH_P0 0x2d358dccaa6c78a5ull
+#define JCONF_HASH_P1 0x8bb84b93962eacc9ull
+#define JCONF_HASH_P2 0x4b33a62ed433d4a3ull
+#define JCONF_HASH_P3 0x4d5a2da51de1aa47ull
+
+// The per-process bucket seed (0 until the first map is used).
+static atomic_ullong jconf_map_seed_value = 0;
+
+/**
+ * JConf Mum
+ *
+ * Description: Multiplies two 64 bit words into a 128 bit product and folds
+ *              the low and high halves into the factors. Keeping the factors
+ *              (wyhash's "condom" variant) stops a zero factor from erasing
+ *              the other one, which would let keys that cancel a secret in
+ *              one block collide whatever their other bytes are.
+ * @param[in] {a} // The first factor, receives it xor the low half.
+ * @param[in] {b} // The second factor, receives it xor the high half.
+ */
+static __inline void jconf_mum(uint64_t* a, uint64_t* b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a ^= (uint64_t)r;
+    *b ^= (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), lo, c = t < rl;
+
+    lo = t + (rm1 << 32);
+    c += lo < t;
+    *a ^= lo;
+    *b ^= rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/**
+ * JConf Mix
+ *
+ * Description: Folds the 128 bit product of two words into 64 bits.
+ */
+static __inline uint64_t jconf_mix(uint64_t a, uint64_t b)
+{
+    jconf_mum(&a, &b);
+    return a ^ b;
+}
 
 /**
- * JConf Hash Function
+ * JConf Read
  *
- * Description : Generates a hash from the provided key.
- * Algorithm by Bob Jenkins obtained from https://en.wikipedia.org/wiki/Jenkins_hash_function
- * @param[out] {key} // The key to use to generate the hash.
+ * Description: Reads little endian words regardless of alignment or host
+ *              byte order (compilers emit a single load on x86 and ARM).
+ */
+static __inline uint64_t jconf_read8(const unsigned char* p)
+{
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24 |
+        (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 | (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+static __inline uint64_t jconf_read4(const unsigned char* p)
+{
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24;
+}
+
+/**
+ * JConf Wyhash
+ *
+ * Description : Generates a 64 bit hash from the provided key and seed,
+ *               reading eight bytes at a time. The seed enters the state
+ *               before any byte is read, so keys that collide under one seed
+ *               do not collide under another.
+ * Algorithm by Wang Yi obtained from https://github.com/wangyi-fudan/wyhash (public domain)
+ * @param[out] {key}    // The key to use to generate the hash.
+ * @param[out] {length} // The length of the key.
+ * @param[out] {seed}   // The seed.
  * @returns // The hash value.
  */
-static unsigned int jconf_hash(const char* key, unsigned int length)
+static __inline jHash jconf_wyhash(const char* key, size_t length, uint64_t seed)
 {
-    unsigned int hash, i;
+    const unsigned char* p = (const unsigned char*)key;
+    uint64_t see1, see2, a, b;
+    size_t i, len = length;
 
-    // Bit shift the hash using the key.
-    for (hash = i = 0; i < length; ++i)
+    seed ^= jconf_mix(seed ^ JCONF_HASH_P0, JCONF_HASH_P1);
+
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            a = (jconf_read4(p) << 32) | jconf_read4(p + ((len >> 3) << 2));
+            b = (jconf_read4(p + len - 4) << 32) | jconf_read4(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (len > 0)
+        {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
     {
-        hash += key[i];
-        hash += (hash << 10);
-        hash ^= (hash >> 6);
+        i = len;
+        if (i > 48)
+        {
+            see1 = see2 = seed;
+            do
+            {
+                seed = jconf_mix(jconf_read8(p) ^ JCONF_HASH_P1, jconf_read8(p + 8) ^ seed);
+                see1 = jconf_mix(jconf_read8(p + 16) ^ JCONF_HASH_P2, jconf_read8(p + 24) ^ see1);
+                see2 = jconf_mix(jconf_read8(p + 32) ^ JCONF_HASH_P3, jconf_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            }
+            while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+
+        for (; i > 16; i -= 16, p += 16)
+            seed = jconf_mix(jconf_read8(p) ^ JCONF_HASH_P1, jconf_read8(p + 8) ^ seed);
+
+        a = jconf_read8(p + i - 16);
+        b = jconf_read8(p + i - 8);
     }
 
-    hash += (hash << 3);
-    hash ^= (hash >> 11);
-    hash += (hash << 15);
+    a ^= JCONF_HASH_P1;
+    b ^= seed;
+    jconf_mum(&a, &b);
+    return jconf_mix(a ^ JCONF_HASH_P0 ^ len, b ^ JCONF_HASH_P1);
+}
 
-    // Return a number from 0 to JCONF_BUCKET_SIZE - 1.
-    return hash % (JCONF_BUCKET_SIZE - 1);
+/**
+ * JConf Map Hash
+ *
+ * Description : Hashes a key without the process seed, so the hash is the
+ *               same in every process and can be computed ahead of time
+ *               (jconf::hash in jconf/jconf.hpp is a constexpr copy that must
+ *               be kept identical). Content hashes (see jconf/hash.h) use it;
+ *               maps do not, since colliding keys would collide everywhere.
+ * @param[out] {key}    // The key to use to generate the hash.
+ * @param[out] {length} // The length of the key.
+ * @returns // The hash value.
+ */
+jHash jconf_map_hash(const char* key, size_t length)
+{
+    return jconf_wyhash(key, length, 0);
+}
+
+/**
+ * JConf Map Key Hash
+ *
+ * Description : Hashes a key with the process seed (see jconf_map_seed). Nodes
+ *               cache this hash, which picks their bucket and lets lookups
+ *               reject most entries without comparing keys.
+ * @param[out] {key}    // The key to use to generate the hash.
+ * @param[out] {length} // The length of the key.
+ * @returns // The hash value.
+ */
+jHash jconf_map_key_hash(const char* key, size_t length)
+{
+    return jconf_wyhash(key, length, jconf_map_seed());
+}
+
+/**
+ * JConf Map Random Seed
+ *
+ * Description: Draws a seed from the operating system, falling back to the
+ *              clock and addresses randomized by the loader.
+ * @returns // A non-zero seed.
+ */
+static uint64_t jconf_map_random_seed(void)
+{
+    uint64_t seed = 0;
+
+#if defined(__linux__)
+    if (getrandom(&seed, sizeof(seed), GRND_NONBLOCK) != sizeof(seed))
+        seed = 0;
+#endif
+
+    if (seed == 0)
+    {
+        seed = jconf_mix((uint64_t)time(NULL) ^ JCONF_HASH_P2, (uint64_t)clock() ^ JCONF_HASH_P3);
+        seed = jconf_mix(seed ^ (uint64_t)(size_t)&seed, (uint64_t)(size_t)&jconf_map_seed_value ^ JCONF_HASH_P0);
+    }
+
+    return seed != 0 ? seed : JCONF_HASH_P0;
+}
+
+/**
+ * JConf Map Seed
+ *
+ * Description: Returns the per-process seed that randomizes bucket placement,
+ *              so keys chosen by an attacker cannot be aimed at one bucket.
+ * @returns // The seed.
+ */
+uint64_t jconf_map_seed(void)
+{
+    unsigned long long seed, expected = 0;
+
+    if ((seed = atomic_load_explicit(&jconf_map_seed_value, memory_order_relaxed)) != 0)
+        return seed;
+
+    // Threads racing on the first map agree on whichever seed is stored first.
+    seed = jconf_map_random_seed();
+    if (!atomic_compare_exchange_strong(&jconf_map_seed_value, &expected, seed))
+        seed = expected;
+
+    return seed;
+}
+
+/**
+ * JConf Map Set Seed
+ *
+ * Description: Replaces the seed (e.g for reproducible benchmarks). It must be
+ *              called before any map is used or key hash is computed.
+ * @param[out] {seed} // The seed ('0' draws a new random seed).
+ */
+void jconf_map_set_seed(uint64_t seed)
+{
+    atomic_store(&jconf_map_seed_value, seed != 0 ? seed : jconf_map_random_seed());
+}
+
+/**
+ * JConf Bucket
+ *
+ * Description: Maps a key hash to a bucket of a power of two table.
+ * @param[out] {map}  // The map.
+ * @param[out] {hash} // The hash of the key.
+ * @returns           // The bucket index.
+ */
+static __inline size_t jconf_bucket(const jMap* map, jHash hash)
+{
+    return (size_t)(hash & (uint64_t)(map->size - 1));
+}
+
+/**
+ * JConf Map Match
+ *
+ * Description: Compares an entry with a key by hash and length before
+ *              comparing the bytes.
+ * @param[out] {entry}  // The map entry.
+ * @param[out] {key}    // The key.
+ * @param[out] {length} // The length of the key.
+ * @param[out] {hash}   // The hash of the key.
+ * @returns             // '1' if the entry has the key.
+ */
+static __inline int jconf_map_match(const jNode* entry, const char* key, size_t length, jHash hash)
+{
+    return entry->hash == hash && entry->len == length && memcmp(entry->key, key, length) == 0;
+}
+
+/**
+ * JConf Map Grow
+ *
+ * Description: Doubles the number of buckets and relinks the entries using
+ *              their cached hashes.
+ * @param[in] {map} // The map to grow.
+ * @returns         // '1' if successful, '0' if out of memory.
+ */
+static int jconf_map_grow(jMap* map)
+{
+    jNode **buckets, *entry, *next;
+    size_t i, index, size;
+
+    size = map->size > 0 ? map->size * 2 : JCONF_MAP_MIN_SIZE;
+    if (size > SIZE_MAX / sizeof(jNode*) || (buckets = (jNode**)jconf_malloc(map->allocator, size * sizeof(jNode*))) == NULL)
+        return 0;
+
+    for (i = 0; i < size; i++)
+        buckets[i] = NULL;
+
+    for (i = 0; i < map->size; i++)
+    {
+        for (entry = map->buckets[i]; entry != NULL; entry = next)
+        {
+            next = entry->next;
+            index = (size_t)(entry->hash & (uint64_t)(size - 1));
+            entry->next = buckets[index];
+            buckets[index] = entry;
+        }
+    }
+
+    jconf_free(map->allocator, map->buckets);
+    map->buckets = buckets;
+    map->size = size;
+    return 1;
 }
 
 /**
@@ -47,12 +316,26 @@ static unsigned int jconf_hash(const char* key, unsigned int length)
  */
 void jconf_init_map(jMap* map)
 {
-    int i;
-    map->count = 0;
+    jconf_init_map_with(map, NULL);
+}
 
-    // Zero initialize the map buckets.
-    for (i = 0; i < JCONF_BUCKET_SIZE; i++)
-        map->buckets[i] = NULL;
+/**
+ * Jconf Map Init With
+ *
+ * Description: Initializes the provided map with an allocator. Buckets are
+ *              allocated on the first insertion.
+ * @param[in]  {map}       // A pointer to the map to initialize.
+ * @param[out] {allocator} // The allocator for the nodes (NULL for malloc).
+ */
+void jconf_init_map_with(jMap* map, const jAllocator* allocator)
+{
+    map->buckets = NULL;
+    map->first = map->last = NULL;
+    map->size = 0;
+    map->count = 0;
+    map->allocator = allocator;
+    atomic_init(&map->digest, 0);
+    atomic_init(&map->refs, 0);
 }
 
 /**
@@ -64,90 +347,160 @@ void jconf_init_map(jMap* map)
 void jconf_destroy_map(jMap* map)
 {
     jNode *entry, *temp;
-    int i;
 
-    for (i = 0; i < JCONF_BUCKET_SIZE; i++)
+    // Free each dynamically allocated jNode.
+    for (entry = map->first; entry != NULL; entry = temp)
     {
-        if ((entry = map->buckets[i]) != NULL)
-        {
-            // Free each dynamically allocated jNode.
-            while (entry)
-            {
-                temp = entry->next;
-                free(entry);
-                entry = temp;
-            }
-        }
+        temp = entry->after;
+        jconf_free(map->allocator, entry);
     }
+
+    jconf_free(map->allocator, map->buckets);
 }
 
 /**
- * JConf Map Set
+ * JConf Map Link
  *
- * Description: Add an entry to the map with the associated key.
+ * Description: Links a new entry into its bucket and the insertion order
+ *              without looking for an existing one.
  * @param[in]  {map}    // The map to append the entry to.
  * @param[out] {key}    // The associated key.
  * @param[out] {length} // The length of the key.
+ * @param[out] {hash}   // The hash of the key.
  * @param[out] {value}  // The value to store.
- * @param[in]  {prev}   // A pointer to a void pointer for the previous value.
  * @returns             // '1' if successful, '0' if out of memory.
  */
-int jconf_map_set(jMap* map, const char* key, int length, void* value, void** prev)
+static int jconf_map_link(jMap* map, const char* key, size_t length, jHash hash, void* value)
 {
-    jNode **head, *node, *last, *temp;
-    unsigned int index;
+    jNode **head, *node;
 
-    index = jconf_hash(key, length);
-    head = &map->buckets[index];
+    // Keep at most one entry per bucket on average. A full table that cannot
+    // grow still accepts the entry in a longer chain.
+    if (map->count >= map->size && !jconf_map_grow(map) && map->size == 0)
+        return 0;
 
-    // Append a node to the linked list for the bucket.
-    if (*head == NULL)
-    {
-        // Create a new list.
-        *head = (jNode*)malloc(sizeof(*node));
-        if (*head == NULL)
-            return 0;
-
-        (*head)->key = key;
-        (*head)->value = value;
-        (*head)->len = length;
-        (*head)->next = NULL;
-    }
+    if ((node = (jNode*)jconf_malloc(map->allocator, sizeof(*node))) == NULL)
+        return 0;
+
+    // Prepend the node to the bucket.
+    head = &map->buckets[jconf_bucket(map, hash)];
+    node->key = key;
+    node->value = value;
+    node->len = length;
+    node->hash = hash;
+    node->next = *head;
+    node->after = NULL;
+    node->before = map->last;
+    *head = node;
+
+    // Append the node to the insertion order.
+    if (map->last != NULL)
+        map->last->after = node;
     else
-    {
-        temp = last = (*head);
-        while (temp != NULL)
-        {
-            // If the node exists, set the new value and return the old one.
-            if (jconf_strncmp(temp->key, key, temp->len) == 0)
-            {
-                if (prev != NULL)
-                    *prev = temp->value;
+        map->first = node;
+    map->last = node;
 
-                temp->value = value;
-                return 1;
-            }
+    map->count++;
+    return 1;
+}
 
-            last = temp;
-            temp = temp->next;
-        }
+/**
+ * JConf Map Find
+ *
+ * Description: Returns the most recently inserted entry with a key.
+ * @param[out] {map}    // The map.
+ * @param[out] {key}    // The key.
+ * @param[out] {length} // The length of the key.
+ * @param[out] {hash}   // The hash of the key.
+ * @returns             // The entry (NULL if the key is not in the map).
+ */
+static __inline jNode* jconf_map_find(const jMap* map, const char* key, size_t length, jHash hash)
+{
+    jNode* node;
+
+    if (map->size == 0)
+        return NULL;
+
+    for (node = map->buckets[jconf_bucket(map, hash)]; node != NULL; node = node->next)
+        if (jconf_map_match(node, key, length, hash))
+            return node;
 
-        // Append a new node once we've reached the end.
-        node = (jNode*)malloc(sizeof(*node));
-        if (node == NULL)
-            return 0;
+    return NULL;
+}
+
+/**
+ * JConf Map Set
+ *
+ * Description: Add an entry to the map with the associated key.
+ * @param[in]  {map}    // The map to append the entry to.
+ * @param[out] {key}    // The associated key.
+ * @param[out] {length} // The length of the key.
+ * @param[out] {value}  // The value to store.
+ * @param[in]  {prev}   // A pointer to a void pointer for the previous value.
+ * @returns             // '1' if successful, '0' if out of memory.
+ */
+int jconf_map_set(jMap* map, const char* key, size_t length, void* value, void** prev)
+{
+    jNode* node;
+    jHash hash;
+
+    hash = jconf_map_key_hash(key, length);
+
+    // If the node exists, set the new value and return the old one.
+    if ((node = jconf_map_find(map, key, length, hash)) != NULL)
+    {
+        if (prev != NULL)
+            *prev = node->value;
 
-        node->key = key;
         node->value = value;
-        node->len = length;
-        node->next = NULL;
-        last->next = node;
+        return 1;
     }
 
-    map->count++;
     if (prev != NULL)
         *prev = NULL;
-    return 1;
+    return jconf_map_link(map, key, length, hash, value);
+}
+
+/**
+ * JConf Map Add
+ *
+ * Description: Adds an entry unless the key is already in the map, in which
+ *              case the map is left unchanged and the existing entry is
+ *              returned. The same probe detects the duplicate and finds the
+ *              insertion point.
+ * @param[in]  {map}      // The map to append the entry to.
+ * @param[out] {key}      // The associated key.
+ * @param[out] {length}   // The length of the key.
+ * @param[out] {value}    // The value to store.
+ * @param[in]  {existing} // Receives the existing entry (NULL if added).
+ * @returns               // '1' if successful, '0' if out of memory.
+ */
+int jconf_map_add(jMap* map, const char* key, size_t length, void* value, jNode** existing)
+{
+    jHash hash;
+
+    hash = jconf_map_key_hash(key, length);
+    if ((*existing = jconf_map_find(map, key, length, hash)) != NULL)
+        return 1;
+
+    return jconf_map_link(map, key, length, hash, value);
+}
+
+/**
+ * JConf Map Append
+ *
+ * Description: Adds an entry without looking for an existing one. Repeated
+ *              keys are all kept (as a multimap): lookups return the most
+ *              recent entry, and the insertion order holds every entry.
+ * @param[in]  {map}    // The map to append the entry to.
+ * @param[out] {key}    // The associated key.
+ * @param[out] {length} // The length of the key.
+ * @param[out] {value}  // The value to store.
+ * @returns             // '1' if successful, '0' if out of memory.
+ */
+int jconf_map_append(jMap* map, const char* key, size_t length, void* value)
+{
+    return jconf_map_link(map, key, length, jconf_map_key_hash(key, length), value);
 }
 
 /**
@@ -158,25 +511,69 @@ int jconf_map_set(jMap* map, const char* key, int length, void* value, void** pr
  * @param[out] {key} // The key used to search the map.
  * @returns          // The value (NULL if not found).
  */
-void* jconf_map_get(jMap* map, const char* key)
+void* jconf_map_get(const jMap* map, const char* key)
 {
-    unsigned int index;
-    jNode *entry;
+    return jconf_map_get_n(map, key, jconf_strlen(key));
+}
 
-    index = jconf_hash(key, jconf_strlen(key));
-    entry = map->buckets[index];
+/**
+ * JConf Map Get N
+ *
+ * Description: Get the value from the map with a key of known length, which
+ *              need not be null terminated.
+ * @param[in]  {map}    // The map to get the entry from.
+ * @param[out] {key}    // The key used to search the map.
+ * @param[out] {length} // The length of the key.
+ * @returns             // The value (NULL if not found).
+ */
+void* jconf_map_get_n(const jMap* map, const char* key, size_t length)
+{
+    return jconf_map_get_hashed(map, key, length, jconf_map_key_hash(key, length));
+}
 
-    // Search the linked list.
-    while (entry)
-    {
-        // If the keys match, return the value.
-        if (jconf_strncmp(entry->key, key, entry->len) == 0)
-            return entry->value;
+/**
+ * JConf Map Get Hashed
+ *
+ * Description: Get the value from the map with a key whose hash was computed
+ *              ahead of time with jconf_map_key_hash (e.g for keys looked up often).
+ * @param[in]  {map}    // The map to get the entry from.
+ * @param[out] {key}    // The key used to search the map.
+ * @param[out] {length} // The length of the key.
+ * @param[out] {hash}   // The hash of the key.
+ * @returns             // The value (NULL if not found).
+ */
+void* jconf_map_get_hashed(const jMap* map, const char* key, size_t length, jHash hash)
+{
+    jNode* entry;
 
-        entry = entry->next;
-    }
+    entry = jconf_map_find(map, key, length, hash);
+    return entry != NULL ? entry->value : NULL;
+}
 
-    return NULL;
+/**
+ * JConf Map Probe
+ *
+ * Description: Counts the entries jconf_map_set compares before it finds the
+ *              key or the end of its bucket (e.g for collision statistics).
+ * @param[out] {map}    // The map.
+ * @param[out] {key}    // The key.
+ * @param[out] {length} // The length of the key.
+ * @returns             // The number of entries compared.
+ */
+int jconf_map_probe(const jMap* map, const char* key, size_t length)
+{
+    jHash hash = jconf_map_key_hash(key, length);
+    jNode *entry;
+    int probes = 0;
+
+    if (map->size == 0)
+        return 0;
+
+    for (entry = map->buckets[jconf_bucket(map, hash)]; entry != NULL; entry = entry->next, probes++)
+        if (jconf_map_match(entry, key, length, hash))
+            break;
+
+    return probes;
 }
 
 /**
@@ -189,49 +586,90 @@ void* jconf_map_get(jMap* map, const char* key)
  */
 void jconf_map_delete(jMap* map, jNode* node, const char* key)
 {
-    jNode *entry, *temp;
-    int index;
+    jNode* entry;
+    size_t length;
 
-    index = jconf_hash(key, jconf_strlen(key));
-    entry = map->buckets[index];
+    length = jconf_strlen(key);
+    if ((entry = jconf_map_find(map, key, length, jconf_map_key_hash(key, length))) == NULL)
+        return;
 
-    temp = NULL;
-    while (entry)
-    {
-        // If the entry is found, delete the node from the list.
-        if (jconf_strncmp(entry->key, key, entry->len) == 0)
-        {
-            node->key   = entry->key;
-            node->value = entry->value;
-            node->next  = entry->next;
+    jconf_map_unlink(map, entry);
+    *node = *entry;
+    node->next = node->after = node->before = NULL;
+    jconf_free(map->allocator, entry);
+}
 
-            if (entry->next == NULL)
-            {
-                free(entry);
+/**
+ * JConf Map Find Node
+ *
+ * Description: Returns the most recently inserted entry with a key whose
+ *              hash was computed ahead of time (see jconf_map_key_hash).
+ * @param[out] {map}    // The map.
+ * @param[out] {key}    // The key.
+ * @param[out] {length} // The length of the key.
+ * @param[out] {hash}   // The hash of the key.
+ * @returns             // The entry (NULL if the key is not in the map).
+ */
+jNode* jconf_map_find_node(const jMap* map, const char* key, size_t length, jHash hash)
+{
+    return jconf_map_find(map, key, length, hash);
+}
 
-                if (temp == NULL) // Only one entry in the list
-                    map->buckets[index] = NULL;
-                else
-                    temp->next = NULL;
-            }
-            else
-            {
-                // Point the previous entry to the deleted node's proceeding element.
-                entry->key = node->next->key;
-                entry->value = node->next->value;
-                entry->next = node->next->next;
-                free(node->next);
-                node->next = NULL;
-            }
+/**
+ * JConf Map Unlink
+ *
+ * Description: Removes an entry from its bucket and the insertion order
+ *              without freeing it. The entry keeps its neighbours, so it can
+ *              be put back with jconf_map_relink as long as the map has not
+ *              changed since.
+ * @param[in] {map}  // The map.
+ * @param[in] {node} // The entry.
+ */
+void jconf_map_unlink(jMap* map, jNode* node)
+{
+    jNode** link;
 
-            map->count--;
-            return;
-        }
+    for (link = &map->buckets[jconf_bucket(map, node->hash)]; *link != node; link = &(*link)->next);
+    *link = node->next;
 
-        temp = entry;
-        entry = entry->next;
-    }
+    if (node->before != NULL)
+        node->before->after = node->after;
+    else
+        map->first = node->after;
+
+    if (node->after != NULL)
+        node->after->before = node->before;
+    else
+        map->last = node->before;
+
+    map->count--;
+}
+
+/**
+ * JConf Map Relink
+ *
+ * Description: Puts back an entry removed by jconf_map_unlink, at its place
+ *              in the insertion order. Never allocates.
+ * @param[in] {map}  // The map.
+ * @param[in] {node} // The entry.
+ */
+void jconf_map_relink(jMap* map, jNode* node)
+{
+    jNode** head;
 
-    // Return if not found.
-    return;
-}
\ No newline at end of file
+    head = &map->buckets[jconf_bucket(map, node->hash)];
+    node->next = *head;
+    *head = node;
+
+    if (node->before != NULL)
+        node->before->after = node;
+    else
+        map->first = node;
+
+    if (node->after != NULL)
+        node->after->before = node;
+    else
+        map->last = node;
+
+    map->count++;
+}
@@ -0,0 +1,451 @@
+/**
+ * JConf Merge Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/merge.h>
+#include <jconf/hash.h>
+#include <string.h>
+#include <stdlib.h>
+
+// jMerger struct definition (the state of one merge).
+typedef struct _j_merger
+{
+    jMergePolicy policy;
+    const jAllocator* allocator;
+
+} jMerger;
+
+static jToken* jconf_merge_value(const jMerger*, const jToken*, const jToken*);
+
+/**
+ * JConf Merge Share
+ *
+ * Description: Makes a token for a value of an input. Objects and arrays
+ *              are shared with the input; scalars are copied.
+ * @param[out] {merger} // The merger.
+ * @param[out] {value}  // The value.
+ * @returns             // The token (NULL if out of memory).
+ */
+static jToken* jconf_merge_share(const jMerger* merger, const jToken* value)
+{
+    jToken* token;
+
+    if (value->type != JCONF_OBJECT && value->type != JCONF_ARRAY)
+        return jconf_copy_token_with(value, merger->allocator);
+
+    if ((token = (jToken*)jconf_malloc(merger->allocator, sizeof(*token))) == NULL)
+        return NULL;
+
+    token->type = value->type;
+    token->data = value->data;
+
+    // The counts are atomic so that an input can be merged from several
+    // threads at once; the container itself is not written.
+    if (value->type == JCONF_OBJECT && value->data != NULL)
+        atomic_fetch_add_explicit(&((jMap*)value->data)->refs, 1, memory_order_relaxed);
+    else if (value->type == JCONF_ARRAY && value->data != NULL)
+        atomic_fetch_add_explicit(&((jArray*)value->data)->refs, 1, memory_order_relaxed);
+
+    return token;
+}
+
+/**
+ * JConf Merge Clean
+ *
+ * Description: Checks that no object in an overlay value has a null member,
+ *              in which case merging it into nothing gives the value itself.
+ * @param[out] {value} // The overlay value.
+ * @returns            // '1' if the value has no null members.
+ */
+static int jconf_merge_clean(const jToken* value)
+{
+    const jNode* node;
+
+    if (value->type != JCONF_OBJECT || value->data == NULL)
+        return 1;
+
+    for (node = ((const jMap*)value->data)->first; node != NULL; node = node->after)
+        if (((const jToken*)node->value)->type == JCONF_NULL || !jconf_merge_clean((const jToken*)node->value))
+            return 0;
+
+    return 1;
+}
+
+/**
+ * JConf Merge Contains
+ *
+ * Description: Looks for an element equal to a value in an array.
+ * @param[out] {arr}   // The array (NULL if empty).
+ * @param[out] {end}   // The number of elements to search.
+ * @param[out] {value} // The value.
+ * @returns            // '1' if the array contains the value.
+ */
+static int jconf_merge_contains(const jArray* arr, size_t end, const jToken* value)
+{
+    size_t i;
+
+    for (i = 0; i < end; i++)
+        if (jconf_equal((const jToken*)jconf_array_get(arr, i), value))
+            return 1;
+
+    return 0;
+}
+
+/**
+ * JConf Merge Same
+ *
+ * Description: Checks whether merging an overlay value leaves a base value
+ *              unchanged, so that the base can be shared whole. Scalars and
+ *              replaced arrays are unchanged when they are equal.
+ * @param[out] {merger}  // The merger.
+ * @param[out] {base}    // The base value.
+ * @param[out] {overlay} // The overlay value.
+ * @returns              // '1' if the merge keeps the base.
+ */
+static int jconf_merge_same(const jMerger* merger, const jToken* base, const jToken* overlay)
+{
+    const jArray *x, *y;
+    const jNode* node;
+    const jToken* value;
+    size_t i;
+
+    if (overlay->type == JCONF_OBJECT)
+    {
+        if (base->type != JCONF_OBJECT)
+            return 0;
+
+        for (node = overlay->data != NULL ? ((const jMap*)overlay->data)->first : NULL; node != NULL; node = node->after)
+        {
+            value = base->data != NULL ? (const jToken*)jconf_map_get_hashed((const jMap*)base->data, node->key, node->len, node->hash) : NULL;
+            if (((const jToken*)node->value)->type == JCONF_NULL ? value != NULL :
+                value == NULL || !jconf_merge_same(merger, value, (const jToken*)node->value))
+                return 0;
+        }
+
+        return 1;
+    }
+
+    if (overlay->type != JCONF_ARRAY || base->type != JCONF_ARRAY || merger->policy == JCONF_MERGE_REPLACE)
+        return jconf_equal(base, overlay);
+
+    x = (const jArray*)base->data;
+    y = (const jArray*)overlay->data;
+    if (y == NULL)
+        return 1;
+
+    switch (merger->policy)
+    {
+        case JCONF_MERGE_UNION:
+            for (i = 0; i < y->end; i++)
+                if (!jconf_merge_contains(x, x != NULL ? x->end : 0, (const jToken*)jconf_array_get(y, i)))
+                    return 0;
+            return 1;
+
+        case JCONF_MERGE_INDEX:
+            if (x == NULL || y->end > x->end)
+                return 0;
+
+            for (i = 0; i < y->end; i++)
+                if (!jconf_merge_same(merger, (const jToken*)jconf_array_get(x, i), (const jToken*)jconf_array_get(y, i)))
+                    return 0;
+            return 1;
+
+        default:
+            return y->end == 0;
+    }
+}
+
+/**
+ * JConf Merge Member
+ *
+ * Description: Appends a member to a merged object, copying its key.
+ * @param[out] {merger} // The merger.
+ * @param[in]  {map}    // The merged object.
+ * @param[out] {node}   // The member of an input.
+ * @param[out] {value}  // The merged value (freed on failure).
+ * @returns             // '1' if successful, '0' if out of memory.
+ */
+static int jconf_merge_member(const jMerger* merger, jMap* map, const jNode* node, jToken* value)
+{
+    char* key;
+
+    if (value == NULL)
+        return 0;
+
+    if ((key = (char*)jconf_malloc(merger->allocator, node->len + 1)) == NULL)
+    {
+        jconf_free_token_with(value, merger->allocator);
+        return 0;
+    }
+
+    memcpy(key, node->key, node->len + 1);
+    if (!jconf_map_append(map, key, node->len, value))
+    {
+        jconf_free(merger->allocator, key);
+        jconf_free_token_with(value, merger->allocator);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Merge Object
+ *
+ * Description: Merges an overlay object into a base object (or into
+ *              nothing). The members of the base keep their order and new
+ *              members follow in the order of the overlay.
+ * @param[out] {merger}  // The merger.
+ * @param[out] {base}    // The base object (NULL if absent).
+ * @param[out] {overlay} // The overlay object.
+ * @returns              // The merged object (NULL if out of memory).
+ */
+static jToken* jconf_merge_object(const jMerger* merger, const jToken* base, const jToken* overlay)
+{
+    const jMap *m, *n;
+    const jNode* node;
+    const jToken* value;
+    jToken* token;
+    jMap* map;
+
+    m = base != NULL ? (const jMap*)base->data : NULL;
+    n = (const jMap*)overlay->data;
+
+    if ((token = (jToken*)jconf_malloc(merger->allocator, sizeof(*token))) == NULL)
+        return NULL;
+
+    token->type = JCONF_OBJECT;
+    if ((token->data = map = (jMap*)jconf_malloc(merger->allocator, sizeof(jMap))) == NULL)
+    {
+        jconf_free(merger->allocator, token);
+        return NULL;
+    }
+
+    jconf_init_map_with(map, merger->allocator);
+
+    // Members of the base, merged with the overlay.
+    for (node = m != NULL ? m->first : NULL; node != NULL; node = node->after)
+    {
+        value = n != NULL ? (const jToken*)jconf_map_get_hashed(n, node->key, node->len, node->hash) : NULL;
+        if (value != NULL && value->type == JCONF_NULL)
+            continue;
+
+        if (!jconf_merge_member(merger, map, node, value == NULL ? jconf_merge_share(merger, (const jToken*)node->value) :
+            jconf_merge_value(merger, (const jToken*)node->value, value)))
+            goto failure;
+    }
+
+    // Members only in the overlay.
+    for (node = n != NULL ? n->first : NULL; node != NULL; node = node->after)
+    {
+        if (((const jToken*)node->value)->type == JCONF_NULL ||
+            (m != NULL && jconf_map_get_hashed(m, node->key, node->len, node->hash) != NULL))
+            continue;
+
+        if (!jconf_merge_member(merger, map, node, jconf_merge_value(merger, NULL, (const jToken*)node->value)))
+            goto failure;
+    }
+
+    // Empty objects have no map.
+    if (map->count == 0)
+    {
+        jconf_destroy_map(map);
+        jconf_free(merger->allocator, map);
+        token->data = NULL;
+    }
+
+    return token;
+
+failure:
+    jconf_free_token_with(token, merger->allocator);
+    return NULL;
+}
+
+/**
+ * JConf Merge Array
+ *
+ * Description: Merges an overlay array into a base array by the policy.
+ * @param[out] {merger}  // The merger.
+ * @param[out] {base}    // The base array.
+ * @param[out] {overlay} // The overlay array.
+ * @returns              // The merged array (NULL if out of memory).
+ */
+static jToken* jconf_merge_array(const jMerger* merger, const jToken* base, const jToken* overlay)
+{
+    const jArray *x, *y;
+    const jToken* element;
+    jToken *token, *value;
+    size_t i, m, n;
+    jArray* arr;
+
+    x = (const jArray*)base->data;
+    y = (const jArray*)overlay->data;
+    m = x != NULL ? x->end : 0;
+    n = y != NULL ? y->end : 0;
+
+    if ((token = (jToken*)jconf_malloc(merger->allocator, sizeof(*token))) == NULL)
+        return NULL;
+
+    token->type = JCONF_ARRAY;
+    if ((token->data = arr = (jArray*)jconf_malloc(merger->allocator, sizeof(jArray))) == NULL)
+    {
+        jconf_free(merger->allocator, token);
+        return NULL;
+    }
+
+    if (!jconf_init_array_with(arr, m + n, 2, merger->allocator))
+    {
+        jconf_free(merger->allocator, arr);
+        jconf_free(merger->allocator, token);
+        return NULL;
+    }
+
+    // Elements of the base, merged by index.
+    for (i = 0; i < m; i++)
+    {
+        element = (const jToken*)jconf_array_get(x, i);
+        value = merger->policy == JCONF_MERGE_INDEX && i < n ?
+            jconf_merge_value(merger, element, (const jToken*)jconf_array_get(y, i)) : jconf_merge_share(merger, element);
+
+        if (value == NULL)
+            goto failure;
+
+        jconf_array_push(arr, value);
+    }
+
+    // Elements of the overlay, appended.
+    for (i = merger->policy == JCONF_MERGE_INDEX ? m : 0; i < n; i++)
+    {
+        element = (const jToken*)jconf_array_get(y, i);
+        if (merger->policy == JCONF_MERGE_UNION && jconf_merge_contains(arr, arr->end, element))
+            continue;
+
+        if ((value = jconf_merge_share(merger, element)) == NULL)
+            goto failure;
+
+        jconf_array_push(arr, value);
+    }
+
+    return token;
+
+failure:
+    jconf_free_token_with(token, merger->allocator);
+    return NULL;
+}
+
+/**
+ * JConf Merge Value
+ *
+ * Description: Merges an overlay value into a base value (RFC 7396
+ *              MergePatch, with the array policy).
+ * @param[out] {merger}  // The merger.
+ * @param[out] {base}    // The base value (NULL if absent).
+ * @param[out] {overlay} // The overlay value.
+ * @returns              // The merged value (NULL if out of memory).
+ */
+static jToken* jconf_merge_value(const jMerger* merger, const jToken* base, const jToken* overlay)
+{
+    if (base != NULL && jconf_merge_same(merger, base, overlay))
+        return jconf_merge_share(merger, base);
+
+    if (overlay->type == JCONF_OBJECT)
+    {
+        if (base != NULL && base->type == JCONF_OBJECT)
+            return jconf_merge_object(merger, base, overlay);
+
+        // Merged into nothing, an overlay object loses its null members.
+        return jconf_merge_clean(overlay) ? jconf_merge_share(merger, overlay) : jconf_merge_object(merger, NULL, overlay);
+    }
+
+    if (overlay->type == JCONF_ARRAY && base != NULL && base->type == JCONF_ARRAY && merger->policy != JCONF_MERGE_REPLACE)
+        return jconf_merge_array(merger, base, overlay);
+
+    return jconf_merge_share(merger, overlay);
+}
+
+/**
+ * JConf Merge
+ *
+ * Description: Merges an overlay into a base into a new tree that shares
+ *              the unchanged objects and arrays of both.
+ * @param[out] {base}    // The base tree (NULL if absent).
+ * @param[out] {overlay} // The overlay tree.
+ * @param[out] {policy}  // The array merge policy.
+ * @returns              // The merged tree (NULL if out of memory).
+ */
+jToken* jconf_merge(const jToken* base, const jToken* overlay, jMergePolicy policy)
+{
+    return jconf_merge_with(base, overlay, policy, NULL);
+}
+
+/**
+ * JConf Merge With
+ *
+ * Description: Merges an overlay into a base with an allocator, which must
+ *              be the allocator of both inputs.
+ * @param[out] {base}      // The base tree (NULL if absent).
+ * @param[out] {overlay}   // The overlay tree.
+ * @param[out] {policy}    // The array merge policy.
+ * @param[out] {allocator} // The allocator.
+ * @returns                // The merged tree (NULL if out of memory).
+ */
+jToken* jconf_merge_with(const jToken* base, const jToken* overlay, jMergePolicy policy, const jAllocator* allocator)
+{
+    jMerger merger;
+
+    merger.policy = policy;
+    merger.allocator = allocator;
+    return jconf_merge_value(&merger, base, overlay);
+}
+
+/**
+ * JConf Shared
+ *
+ * Description: Tells whether the object or array of a token is shared with
+ *              another tree.
+ * @param[out] {token} // The token.
+ * @returns            // '1' if the container is shared.
+ */
+int jconf_shared(const jToken* token)
+{
+    if (token->type == JCONF_OBJECT && token->data != NULL)
+        return atomic_load_explicit(&((const jMap*)token->data)->refs, memory_order_acquire) > 0;
+    else if (token->type == JCONF_ARRAY && token->data != NULL)
+        return atomic_load_explicit(&((const jArray*)token->data)->refs, memory_order_acquire) > 0;
+
+    return 0;
+}
+
+/**
+ * JConf Unshare With
+ *
+ * Description: Copies an object or array for a tree that edits it: the
+ *              members or elements of the copy share their objects and
+ *              arrays with the original instead of copying them (as a merge
+ *              with an empty overlay would).
+ * @param[out] {token}     // The object or array.
+ * @param[out] {allocator} // The allocator of the tree.
+ * @returns                // The copy (NULL if out of memory).
+ */
+jToken* jconf_unshare_with(const jToken* token, const jAllocator* allocator)
+{
+    jMerger merger;
+    jToken empty;
+
+    merger.policy = JCONF_MERGE_APPEND;
+    merger.allocator = allocator;
+    empty.type = token->type;
+    empty.data = NULL;
+
+    if (token->type == JCONF_OBJECT)
+        return jconf_merge_object(&merger, token, &empty);
+
+    return jconf_merge_array(&merger, token, &empty);
+}
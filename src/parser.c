@@ -10,38 +10,236 @@
  */
 
 #include <jconf/parser.h>
+#include <jconf/context.h>
+#include <jconf/hash.h>
+#include <string.h>
+
+#ifdef JCONF_STATS
+    #include <string.h>
+    #if defined(_WIN32) || defined(WIN32)
+        #include <windows.h>
+    #else
+        #include <time.h>
+    #endif
+#endif
+
+// Parser state shared by the scanning functions.
+typedef struct _j_parser
+{
+    const char* buffer;
+    size_t size;
+    jArgs* args;
+    const jAllocator* allocator;
+    jParserContext* context;
+    jDupPolicy duplicates;
+    jParseMode mode;
+    int hash;
+    int depth;
+#ifdef JCONF_STATS
+    jParseStats* stats;
+#endif
+
+} jParser;
+
+// Scanner features. Each parse mode is a constant set of features, and the
+// scanner is specialized for each mode so that the checks for features the
+// mode does not have are compiled out.
+#define JCONF_FEATURE_COMMENTS        0x01
+#define JCONF_FEATURE_TRAILING_COMMAS 0x02
+#define JCONF_FEATURE_SINGLE_QUOTES   0x04
+#define JCONF_FEATURE_UNQUOTED_KEYS   0x08
+#define JCONF_FEATURE_SCALAR_ROOT     0x10
+#define JCONF_FEATURE_STRICT          0x20
+#define JCONF_FEATURE_VALIDATE        0x40
+
+#define JCONF_SCAN_DEFAULT (JCONF_FEATURE_COMMENTS)
+#define JCONF_SCAN_STRICT  (JCONF_FEATURE_SCALAR_ROOT | JCONF_FEATURE_STRICT)
+#define JCONF_SCAN_RELAXED (JCONF_FEATURE_COMMENTS | JCONF_FEATURE_TRAILING_COMMAS | \
+                            JCONF_FEATURE_SINGLE_QUOTES | JCONF_FEATURE_UNQUOTED_KEYS)
+
+// Validation scans values without storing them.
+#define JCONF_VALIDATE_DEFAULT (JCONF_SCAN_DEFAULT | JCONF_FEATURE_VALIDATE)
+#define JCONF_VALIDATE_STRICT  (JCONF_SCAN_STRICT | JCONF_FEATURE_VALIDATE)
+#define JCONF_VALIDATE_RELAXED (JCONF_SCAN_RELAXED | JCONF_FEATURE_VALIDATE)
+
+// Functions taking constant features are inlined into each scanner.
+#if defined(_MSC_VER)
+    #define jconf_specialize __forceinline
+#elif defined(__GNUC__)
+    #define jconf_specialize __inline __attribute__((always_inline))
+#else
+    #define jconf_specialize __inline
+#endif
+
+// Characters of unquoted keys.
+#define jconf_isident(c) (((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z') || \
+                          ((c) >= '0' && (c) <= '9') || (c) == '_' || (c) == '$')
+
+// Parse statistics are compiled out unless JCONF_STATS is defined.
+#ifdef JCONF_STATS
+    #define jconf_stat(parser, expr) do { jParseStats* stats = (parser)->stats; if (stats != NULL) { expr; } } while (0)
+#else
+    #define jconf_stat(parser, expr)
+#endif
+
+#ifdef JCONF_STATS
+/**
+ * JConf Now
+ *
+ * Description: Returns a monotonic timestamp in seconds for phase timings.
+ */
+static double jconf_now(void)
+{
+#if defined(_WIN32) || defined(WIN32)
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart / frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+#endif
 
 /**
  * JConf Alloc
  *
- * Description: Dynamically allocates memory using malloc.
+ * Description: Dynamically allocates memory using the parser's allocator.
  *
+ * @param[out] {parser} // The parser state.
  * @param[in]  {memory} // The destination pointer for allocated memory.
  * @param[out] {size}   // The amount to allocate
- * @param[out] {args}   // The args struct to fill out.
  * @returns             // '1' if successful, '0' if out of memory
  */
-static __inline int jconf_alloc(void** memory, int size, jArgs* args)
+static __inline int jconf_alloc(jParser* parser, void** memory, size_t size)
 {
-    if ((*memory = malloc(size)) == NULL)
+    if ((*memory = jconf_malloc(parser->allocator, size)) == NULL)
     {
-        args->e = JCONF_OUT_OF_MEMORY;
+        parser->args->e = JCONF_OUT_OF_MEMORY;
         return 0;
     }
+
+    jconf_stat(parser, stats->allocs++; stats->alloc_bytes += size);
     return 1;
 }
 
+/**
+ * JConf Discard Token
+ *
+ * Description: Frees a partially built token. Tokens allocated from a parser
+ *              context are released when the context is reset.
+ *
+ * @param[out] {parser} // The parser state.
+ * @param[out] {token}  // The token to free.
+ */
+static __inline void jconf_discard_token(jParser* parser, jToken* token)
+{
+    if (parser->context == NULL)
+        jconf_free_token_with(token, parser->allocator);
+}
+
+/**
+ * JConf Array Hint
+ *
+ * Description: Returns the initial capacity for a new array whose size
+ *              cannot be estimated. With a parser context, arrays start at
+ *              the size hinted for their depth by earlier parses, but never
+ *              above the elements the rest of the input could hold (each
+ *              takes at least two bytes with its separator).
+ *
+ * @param[out] {parser} // The parser state.
+ * @param[out] {pos}    // The position of the first element.
+ * @returns             // The initial capacity.
+ */
+static __inline size_t jconf_array_hint(jParser* parser, size_t pos)
+{
+    size_t hint, limit;
+    int depth;
+
+    if (parser->context == NULL)
+        return 1;
+
+    depth = parser->depth < JCONF_CONTEXT_HINTS ? parser->depth : JCONF_CONTEXT_HINTS - 1;
+    hint = parser->context->hints[depth];
+    limit = pos < parser->size ? (parser->size - pos) / 2 + 1 : 1;
+
+    return hint == 0 ? 1 : (hint < limit ? hint : limit);
+}
+
+/**
+ * JConf Array Estimate
+ *
+ * Description: Estimates the number of elements in a flat array by counting
+ *              the separators up to the closing bracket. Arrays containing
+ *              containers or comments are not scanned (their elements are
+ *              sized by the parser context instead), which keeps the scan
+ *              linear over the whole document.
+ *
+ * @param[out] {parser}   // The parser state.
+ * @param[out] {pos}      // The position of the first element.
+ * @param[out] {features} // The scanner features.
+ * @returns               // The estimated count ('0' if unknown).
+ */
+static jconf_specialize size_t jconf_array_estimate(jParser* parser, size_t pos, const int features)
+{
+    const char* buffer = parser->buffer;
+    size_t count = 1;
+    char c, quote;
+
+    for (; pos < parser->size; pos++)
+    {
+        c = buffer[pos];
+
+        if (c == ',')
+            count++;
+        else if (c == ']')
+            return count;
+        else if (c == '[' || c == '{' || c == '/')
+            return 0;
+        else if (c == '"' || ((features & JCONF_FEATURE_SINGLE_QUOTES) && c == '\''))
+        {
+            for (quote = c, pos++; pos < parser->size && buffer[pos] != quote; pos++)
+                if (buffer[pos] == '\\')
+                    pos++;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * JConf Array Record
+ *
+ * Description: Records the size of a completed array for the next parse.
+ *
+ * @param[in]  {parser} // The parser state.
+ * @param[out] {arr}    // The completed array.
+ */
+static __inline void jconf_array_record(jParser* parser, jArray* arr)
+{
+    int depth;
+
+    if (parser->context == NULL)
+        return;
+
+    depth = parser->depth < JCONF_CONTEXT_HINTS ? parser->depth : JCONF_CONTEXT_HINTS - 1;
+    parser->context->next_sums[depth] += arr->end;
+    parser->context->next_counts[depth]++;
+}
+
 /**
  * JConf Parse Number
  *
- * Description: Scans the next number.
+ * Description: Scans the next number. Strict mode also requires digits after
+ *              a sign, a decimal point and an exponent.
  *
- * @param[out] {buffer} // The string to scan.
- * @param[out] {size}   // The size of the buffer.
- * @param[in]  {token}  // The token to store the number.
- * @param[in]  {args}   // The args struct to fill.
+ * @param[in]  {parser}   // The parser state.
+ * @param[in]  {token}    // The token to store the number.
+ * @param[out] {features} // The scanner features.
  */
-static void jconf_parse_number(const char* buffer, jToken* token, int size, jArgs* args)
+static jconf_specialize void jconf_parse_number(jParser* parser, jToken* token, const int features)
 {
     // JSON number states
     static const int
@@ -53,9 +251,17 @@ static void jconf_parse_number(const char* buffer, jToken* token, int size, jArg
         EXP = 5,
         DECIMAL_DIGIT = 6;
 
-    int init_pos = args->pos, state = 0, length;
+    const char* buffer = parser->buffer;
+    size_t size = parser->size;
+    jArgs* args = parser->args;
+    size_t init_pos = args->pos, length;
+    int state = 0;
     char c;
 
+#ifdef JCONF_STATS
+    double start = parser->stats != NULL ? jconf_now() : 0;
+#endif
+
     token->type = JCONF_INT;
     args->e = JCONF_INVALID_NUMBER;
 
@@ -77,18 +283,18 @@ static void jconf_parse_number(const char* buffer, jToken* token, int size, jArg
                 break;
 
             case 2: // ZERO
-                if (c == '.') { state = DECIMAL; token->type = JCONF_DOUBLE; }
-                else if (c == 'e' || c == 'E') state = EXP;
-                else return;
-                break;
-
             case 3: // DIGIT_PLUS_ZERO
                 if (c == '.') { state = DECIMAL; token->type = JCONF_DOUBLE; }
-                else if (!jconf_isdigit(c)) return;
+                else if (c == 'e' || c == 'E') { state = EXP; token->type = JCONF_DOUBLE; }
+                else if (state == ZERO || !jconf_isdigit(c)) return;
                 break;
 
             case 4: // DECIMAL
-                if (c == 'e' || c == 'E') state = EXP;
+                if (c == 'e' || c == 'E')
+                {
+                    if ((features & JCONF_FEATURE_STRICT) && buffer[args->pos - 1] == '.') return;
+                    state = EXP;
+                }
                 else if (!jconf_isdigit(c)) return;
                 break;
 
@@ -103,40 +309,61 @@ static void jconf_parse_number(const char* buffer, jToken* token, int size, jArg
     }
 
     if (state == INIT || state == EXP) return;
+    if ((features & JCONF_FEATURE_STRICT) && !(jconf_isdigit(buffer[args->pos - 1]))) return;
 
     length = args->pos - init_pos;
-    if (!jconf_alloc(&token->data, length + 1, args)) return;
+    if (!(features & JCONF_FEATURE_VALIDATE))
+    {
+        if (!jconf_alloc(parser, &token->data, length + 1)) return;
 
-    // Copy the string into the destination.
-    jconf_strncpy(token->data, buffer + init_pos, length);
-    ((char*)token->data)[length] = 0;
+        // Copy the string into the destination.
+        jconf_strncpy(token->data, buffer + init_pos, length);
+        ((char*)token->data)[length] = 0;
+    }
     args->e = JCONF_NO_ERROR;
 
     args->pos--;
+    jconf_stat(parser, stats->time_numbers += jconf_now() - start);
 }
 
 /**
  * JConf Parse String
  *
- * Description: Scans the next string.
+ * Description: Scans the next string, which ends with the quote it starts
+ *              with. Strict mode rejects unescaped control characters.
  *
- * @param[out] {buffer} // The string to scan.
- * @param[in]  {dest}   // The destination buffer for the string.
- * @param[out] {size}   // The size of the buffer.
- * @param[in]  {args}   // The args struct to fill.
+ * @param[in]  {parser}   // The parser state.
+ * @param[in]  {dest}     // The destination buffer for the string.
+ * @param[out] {features} // The scanner features.
  */
-static void jconf_parse_string(const char* buffer, char** dest, int size, jArgs* args)
+static jconf_specialize void jconf_parse_string(jParser* parser, char** dest, const int features)
 {
-    int j, init_pos, length;
-    char c;
-
+    const char* buffer = parser->buffer;
+    size_t size = parser->size;
+    jArgs* args = parser->args;
+    size_t init_pos, length;
+    int j;
+    char c, quote;
+
+#ifdef JCONF_STATS
+    double start = parser->stats != NULL ? jconf_now() : 0;
+#endif
+
+    quote = buffer[args->pos];
     init_pos = args->pos + 1;
-    while (++args->pos < size && (c = buffer[args->pos]) != '\"')
+    while (++args->pos < size && (c = buffer[args->pos]) != quote)
     {
+        if ((features & JCONF_FEATURE_STRICT) && (unsigned char)c < 0x20) {
+            args->e = JCONF_UNEXPECTED_TOK; return;
+        }
+
         if (c == '\\')
         {
+            jconf_stat(parser, stats->escapes++);
+
             // Unrecognized control sequence.
-            if (++args->pos >= size || !jconf_isctrl((c = buffer[args->pos]))) {
+            if (++args->pos >= size || (!(jconf_isctrl((c = buffer[args->pos]))) &&
+                !((features & JCONF_FEATURE_SINGLE_QUOTES) && c == '\''))) {
                 args->e = JCONF_INVALID_CTRL_SEQUENCE; return;
             }
 
@@ -165,12 +392,65 @@ static void jconf_parse_string(const char* buffer, char** dest, int size, jArgs*
     }
 
     length = args->pos -init_pos;
-    if (!jconf_alloc((void**)dest, length + 1, args)) return;
+    if (!(features & JCONF_FEATURE_VALIDATE))
+    {
+        if (!jconf_alloc(parser, (void**)dest, length + 1)) return;
+
+        // Copy the string into the destination.
+        jconf_strncpy(*dest, buffer + init_pos, length);
+        (*dest)[length] = 0;
+    }
+    args->e = JCONF_NO_ERROR;
+
+    jconf_stat(parser, stats->string_bytes += length; stats->time_strings += jconf_now() - start);
+}
+
+/**
+ * JConf Parse Identifier
+ *
+ * Description: Scans an unquoted key.
+ *
+ * @param[in]  {parser}   // The parser state.
+ * @param[in]  {dest}     // The destination buffer for the key.
+ * @param[out] {features} // The scanner features.
+ */
+static jconf_specialize void jconf_parse_identifier(jParser* parser, char** dest, const int features)
+{
+    const char* buffer = parser->buffer;
+    jArgs* args = parser->args;
+    size_t init_pos, length;
 
-    // Copy the string into the destination.
-    jconf_strncpy(*dest, buffer + init_pos, length);
-    (*dest)[length] = 0;
+    init_pos = args->pos;
+    while (args->pos + 1 < parser->size && jconf_isident(buffer[args->pos + 1]))
+        args->pos++;
+
+    length = args->pos - init_pos + 1;
+    if (!(features & JCONF_FEATURE_VALIDATE))
+    {
+        if (!jconf_alloc(parser, (void**)dest, length + 1)) return;
+
+        jconf_strncpy(*dest, buffer + init_pos, length);
+        (*dest)[length] = 0;
+    }
     args->e = JCONF_NO_ERROR;
+
+    jconf_stat(parser, stats->string_bytes += length);
+}
+
+/**
+ * JConf Keyword
+ *
+ * Description: Checks for a keyword at the current position.
+ *
+ * @param[out] {parser}  // The parser state.
+ * @param[out] {keyword} // The keyword.
+ * @param[out] {length}  // The length of the keyword.
+ * @returns              // '1' if the keyword is present.
+ */
+static __inline int jconf_keyword(jParser* parser, const char* keyword, size_t length)
+{
+    size_t pos = parser->args->pos;
+    return pos + length <= parser->size && !jconf_strncmp(keyword, parser->buffer + pos, length);
 }
 
 /**
@@ -178,40 +458,42 @@ static void jconf_parse_string(const char* buffer, char** dest, int size, jArgs*
  *
  * Description: Parses the provided JSON value.
  *
- * @param[out] {buffer} // The string to parse.
- * @param[out] {token}  // The token used to store the value.
- * @param[out] {size}   // The size of the buffer.
- * @param[in]  {args}   // The args struct to fill.
+ * @param[in]  {parser}   // The parser state.
+ * @param[out] {token}    // The token used to store the value.
+ * @param[out] {features} // The scanner features.
  */
-static void jconf_parse_value(const char* buffer, jToken* token, int size, jArgs* args)
+static jconf_specialize void jconf_parse_value(jParser* parser, jToken* token, const int features)
 {
+    const char* buffer = parser->buffer;
+    jArgs* args = parser->args;
     char c;
 
     token->data = NULL;
 
     // Parse string
-    if((c = buffer[args->pos]) == '\"')
+    if((c = buffer[args->pos]) == '\"' || ((features & JCONF_FEATURE_SINGLE_QUOTES) && c == '\''))
     {
         token->type = JCONF_STRING;
-        jconf_parse_string(buffer, (char**)&token->data, size, args);
+        jconf_parse_string(parser, (char**)&token->data, features);
         if (args->e != JCONF_NO_ERROR)
         {
-            free(token);
+            if (!(features & JCONF_FEATURE_VALIDATE))
+                jconf_free(parser->allocator, token);
             return;
         }
     }
     // Compare the string to static JSON keywords.
-    else if (!jconf_strncmp("false", buffer + args->pos, 5))
+    else if (jconf_keyword(parser, "false", 5))
     {
         token->type = JCONF_FALSE;
         args->pos += 4;
     }
-    else if (!jconf_strncmp("true", buffer + args->pos, 4))
+    else if (jconf_keyword(parser, "true", 4))
     {
         token->type = JCONF_TRUE;
         args->pos += 3;
     }
-    else if (!jconf_strncmp("null", buffer + args->pos, 4))
+    else if (jconf_keyword(parser, "null", 4))
     {
         token->type = JCONF_NULL;
         args->pos += 3;
@@ -219,28 +501,219 @@ static void jconf_parse_value(const char* buffer, jToken* token, int size, jArgs
     else
     {
         // Parse number.
-        jconf_parse_number(buffer, token, size, args);
+        jconf_parse_number(parser, token, features);
         if (args->e != JCONF_NO_ERROR)
         {
-            free(token);
+            if (!(features & JCONF_FEATURE_VALIDATE))
+                jconf_free(parser->allocator, token);
             return;
         }
     }
 }
 
+#ifdef JCONF_STATS
+/**
+ * JConf Stat Insert
+ *
+ * Description: Records a completed token and the cost of adding it to its
+ *              container. Called before the insertion.
+ *
+ * @param[in]  {stats}  // The statistics.
+ * @param[out] {tokens} // The container.
+ * @param[out] {token}  // The completed token.
+ * @param[out] {key}    // The key (objects only).
+ * @param[out] {keylen} // The length of the key.
+ * @param[out] {probe}  // '1' if the key is looked up, '0' if appended.
+ */
+static void jconf_stat_insert(jParseStats* stats, jToken* tokens, jToken* token, const char* key, size_t keylen, int probe)
+{
+    jArray* arr;
+    jMap* map;
+    int probes;
+
+    stats->tokens[token->type]++;
+
+    if (tokens->type == JCONF_ARRAY)
+    {
+        // Pushing onto a full array reallocates it.
+        arr = (jArray*)tokens->data;
+        if (arr->end == arr->size)
+        {
+            stats->allocs++;
+            stats->alloc_bytes += arr->size * 2 * sizeof(void*);
+        }
+        return;
+    }
+
+    map = (jMap*)tokens->data;
+    probes = probe ? jconf_map_probe(map, key, keylen) : 0;
+
+    stats->map_inserts++;
+    stats->map_probes += probes;
+    if (probes > 0)
+        stats->map_collisions++;
+    if (probes > stats->map_max_probe)
+        stats->map_max_probe = probes;
+
+    // New keys allocate a node, and the buckets double when full.
+    if (!probe || jconf_map_get_n(map, key, keylen) == NULL)
+    {
+        stats->allocs++;
+        stats->alloc_bytes += sizeof(jNode);
+
+        if (map->count >= map->size)
+        {
+            stats->allocs++;
+            stats->alloc_bytes += (map->size > 0 ? map->size * 2 : JCONF_MAP_MIN_SIZE) * sizeof(jNode*);
+        }
+    }
+}
+#endif
+
+/**
+ * JConf Parse Member
+ *
+ * Description: Inserts a parsed member into an object according to the
+ *              duplicate key policy. The map takes ownership of the key and
+ *              the value, or they are freed when the member is dropped.
+ *
+ * @param[in]  {parser} // The parser state.
+ * @param[in]  {map}    // The object.
+ * @param[out] {key}    // The key.
+ * @param[out] {keylen} // The length of the key.
+ * @param[out] {token}  // The value.
+ * @returns             // '1' if successful, '0' on error (the key is not freed).
+ */
+static int jconf_parse_member(jParser* parser, jMap* map, char* key, size_t keylen, jToken* token)
+{
+    jToken* prev = NULL;
+    jNode* existing;
+    int status;
+
+    switch (parser->duplicates)
+    {
+        case JCONF_DUP_FIRST_WINS:
+        case JCONF_DUP_ERROR:
+            if ((status = jconf_map_add(map, key, keylen, token, &existing)) && existing != NULL)
+            {
+                prev = token;
+                if (parser->duplicates == JCONF_DUP_ERROR)
+                {
+                    jconf_discard_token(parser, prev);
+                    parser->args->e = JCONF_DUPLICATE_KEY;
+                    return 0;
+                }
+            }
+            break;
+
+        case JCONF_DUP_KEEP_ALL:
+        case JCONF_DUP_TRUSTED:
+            status = jconf_map_append(map, key, keylen, token);
+            break;
+
+        default:
+            status = jconf_map_set(map, key, keylen, token, (void**)&prev);
+            break;
+    }
+
+    if (!status)
+    {
+        jconf_discard_token(parser, token);
+        parser->args->e = JCONF_OUT_OF_MEMORY;
+        return 0;
+    }
+
+    // The map keeps the original key when a key is repeated.
+    if (prev != NULL)
+        jconf_free(parser->allocator, key);
+
+    jconf_discard_token(parser, prev);
+    return 1;
+}
+
+/**
+ * JConf Skip Comment
+ *
+ * Description: Skips the comment at the current position, counting the lines
+ *              it spans.
+ *
+ * @param[in]  {parser} // The parser state.
+ * @returns             // '1' if successful, '0' on error.
+ */
+static __inline int jconf_skip_comment(jParser* parser)
+{
+    const char* buffer = parser->buffer;
+    size_t size = parser->size;
+    jArgs* args = parser->args;
+    char c;
+
+    c = ++args->pos < size ? buffer[args->pos] : 0;
+    if (c == '*')
+    {
+        for (args->pos++; args->pos + 1 < size && !(buffer[args->pos] == '*' && buffer[args->pos + 1] == '/'); args->pos++)
+            if (buffer[args->pos] == '\n') args->line++;
+
+        args->pos++;
+    }
+    else if (c == '/')
+    {
+        // Stop before the new line so that it is counted.
+        while (args->pos + 1 < size && buffer[args->pos + 1] != '\n')
+            args->pos++;
+    }
+    else if (c != 0)
+    {
+        args->e = JCONF_UNEXPECTED_TOK;
+        return 0;
+    }
+
+    // If the end of the buffer is reached before an object is parsed, return an error.
+    if (args->pos >= size)
+    {
+        args->e = JCONF_UNEXPECTED_EOF;
+        return 0;
+    }
+
+    return 1;
+}
+
+// Scanners specialized for each parse mode.
+static int jconf_scan_default(jParser*, jToken*);
+static int jconf_scan_strict(jParser*, jToken*);
+static int jconf_scan_relaxed(jParser*, jToken*);
+
+/**
+ * JConf Scan
+ *
+ * Description: Parses a nested value with the scanner for a set of features.
+ *
+ * @param[in]  {parser}   // The parser state.
+ * @param[in]  {tokens}   // The token of the nested value.
+ * @param[out] {features} // The scanner features.
+ * @returns               // The state of the DFA.
+ */
+static __inline int jconf_scan(jParser* parser, jToken* tokens, const int features)
+{
+    if (features == JCONF_SCAN_STRICT)
+        return jconf_scan_strict(parser, tokens);
+    if (features == JCONF_SCAN_RELAXED)
+        return jconf_scan_relaxed(parser, tokens);
+
+    return jconf_scan_default(parser, tokens);
+}
+
 /**
  * JConf Parse JSON
  *
  * Description: Parses the provided buffer and stores the tokens via
  *              the root token of the JSON tree.
  *
- * @param[in]  {tokens} // The root token of the JSON tree.
- * @param[out] {buffer} // The string to parse.
- * @param[out] {size}   // The size of the buffer.
- * @param[in]  {args}   // The object to store parsing related information
- * @returns             // The state of the DFA.
+ * @param[in]  {parser}   // The parser state.
+ * @param[in]  {tokens}   // The root token of the JSON tree.
+ * @param[out] {features} // The scanner features (a constant).
+ * @returns               // The state of the DFA.
  */
-static int jconf_parse_json(jToken* tokens, const char* buffer, int size, jArgs* args)
+static jconf_specialize int jconf_parse_json(jParser* parser, jToken* tokens, const int features)
 {
     // JSON parse states.
     static const int
@@ -255,8 +728,12 @@ static int jconf_parse_json(jToken* tokens, const char* buffer, int size, jArgs*
         ERROR = -1;
 
     // Local variables.
-    int state = START, keylen = 0, j = 0;
-    jToken *token, *prev_token;
+    const char* buffer = parser->buffer;
+    size_t size = parser->size;
+    jArgs* args = parser->args;
+    size_t keylen = 0, keyline = 0, keypos = 0, capacity;
+    int state = START;
+    jToken* token;
     char c, *key = NULL;
     jArray* arr;
     jMap* map;
@@ -272,21 +749,9 @@ static int jconf_parse_json(jToken* tokens, const char* buffer, int size, jArgs*
 
 
         // Ignore comments from the JSON string.
-        if (c == '/')
+        if ((features & JCONF_FEATURE_COMMENTS) && c == '/')
         {
-            c = buffer[++args->pos];
-            if (c == '*')
-                while (args->pos < size && !(buffer[++args->pos] == '*' && buffer[++args->pos] == '/'));
-
-            else if (c == '/')
-                while (args->pos < size && buffer[++args->pos] != '\n');
-
-            // If the end of the buffer is reached before an object is parsed, return an error.
-            if (args->pos == size)
-            {
-                args->e = JCONF_UNEXPECTED_EOF;
-                goto cleanup;
-            }
+            if (!jconf_skip_comment(parser)) goto cleanup;
             continue;
         }
 
@@ -306,6 +771,12 @@ static int jconf_parse_json(jToken* tokens, const char* buffer, int size, jArgs*
                     state = ARRAY_INIT;
                     tokens->type = JCONF_ARRAY;
                 }
+                else if (features & JCONF_FEATURE_SCALAR_ROOT)
+                {
+                    // Any value at the root (the token is freed on error).
+                    jconf_parse_value(parser, tokens, features);
+                    return args->e == JCONF_NO_ERROR ? END : ERROR;
+                }
                 else
                 {
                     // Unexpected token at start state.
@@ -318,21 +789,31 @@ static int jconf_parse_json(jToken* tokens, const char* buffer, int size, jArgs*
                 if (c == '}')
                     return END;
 
-                if (!jconf_alloc(&tokens->data, sizeof(*map), args))
+                if (!jconf_alloc(parser, &tokens->data, sizeof(*map)))
                     goto cleanup;
 
-                jconf_init_map((jMap*)tokens->data);
+                jconf_init_map_with((jMap*)tokens->data, parser->allocator);
 
             case 2: // OBJECT_KEY
-                if (c == '\"')
-                {
-                    j = args->pos + 1;
+                keypos = args->pos;
+                keyline = args->line;
 
+                if (c == '\"' || ((features & JCONF_FEATURE_SINGLE_QUOTES) && c == '\''))
+                {
                     // Parse the JSON string.
-                    jconf_parse_string(buffer, &key, size, args);
+                    jconf_parse_string(parser, &key, features);
+                    if (args->e != JCONF_NO_ERROR) goto cleanup;
+                    keylen = args->pos - keypos - 1;
+                }
+                else if ((features & JCONF_FEATURE_UNQUOTED_KEYS) && jconf_isident(c) && !(jconf_isdigit(c)))
+                {
+                    // Parse an unquoted key.
+                    jconf_parse_identifier(parser, &key, features);
                     if (args->e != JCONF_NO_ERROR) goto cleanup;
-                    keylen = args->pos - j;
+                    keylen = args->pos - keypos + 1;
                 }
+                else if ((features & JCONF_FEATURE_TRAILING_COMMAS) && c == '}')
+                    return END;
                 else
                 {
                     // Unexpected quote character.
@@ -356,40 +837,75 @@ static int jconf_parse_json(jToken* tokens, const char* buffer, int size, jArgs*
                 if (c == ']')
                     return END;
 
-                if (!jconf_alloc(&tokens->data, sizeof(*arr), args) || !jconf_init_array((jArray*)tokens->data, 1, 2))
+                // Size the array from the input when it is flat, otherwise
+                // from the context.
+                if ((capacity = jconf_array_estimate(parser, args->pos, features)) == 0)
+                    capacity = jconf_array_hint(parser, args->pos);
+
+                if (!jconf_alloc(parser, &tokens->data, sizeof(*arr)) ||
+                    !jconf_init_array_with((jArray*)tokens->data, capacity, 2, parser->allocator))
                 {
                     args->e = JCONF_OUT_OF_MEMORY;
                     goto cleanup;
                 }
+
+                jconf_stat(parser, if (capacity > JCONF_ARRAY_INLINE) { stats->allocs++; stats->alloc_bytes += capacity * sizeof(void*); });
                 state = VALUE;
 
             case 5: // VALUE
-                if (!jconf_alloc((void**)&token, sizeof(*token), args))
+                if ((features & JCONF_FEATURE_TRAILING_COMMAS) && c == ']' && tokens->type == JCONF_ARRAY)
+                {
+                    jconf_array_record(parser, (jArray*)tokens->data);
+                    return END;
+                }
+
+                if (!jconf_alloc(parser, (void**)&token, sizeof(*token)))
                     goto cleanup;
 
                 if (c == '{' || c == '[')
                 {
                     // Recurse on the nested object.
-                    if (jconf_parse_json(token, buffer, size, args) == ERROR)
+                    parser->depth++;
+                    jconf_stat(parser, if (parser->depth > stats->max_depth) stats->max_depth = parser->depth);
+
+                    if (jconf_scan(parser, token, features) == ERROR)
                         goto cleanup;
+                    parser->depth--;
+
+                    // Memoize the hash while the children are in cache.
+                    if (parser->hash)
+                        jconf_hash_token(token, 0);
                 }
                 else
                 {
                     // Parse value.
-                    jconf_parse_value(buffer, token, size, args);
+                    jconf_parse_value(parser, token, features);
                     if (args->e != JCONF_NO_ERROR) goto cleanup;
                 }
 
-                prev_token = NULL;
-                if (!(tokens->type == JCONF_ARRAY ?
-                        jconf_array_push((jArray*)tokens->data, token) :
-                        jconf_map_set((jMap*)tokens->data, key, keylen, token, (void**)&prev_token)))
+                jconf_stat(parser, jconf_stat_insert(stats, tokens, token, key, keylen, parser->duplicates < JCONF_DUP_KEEP_ALL));
+
+                if (tokens->type == JCONF_ARRAY)
                 {
-                    args->e = JCONF_OUT_OF_MEMORY;
+                    if (!jconf_array_push((jArray*)tokens->data, token))
+                    {
+                        jconf_discard_token(parser, token);
+                        args->e = JCONF_OUT_OF_MEMORY;
+                        goto cleanup;
+                    }
+                }
+                else if (!jconf_parse_member(parser, (jMap*)tokens->data, key, keylen, token))
+                {
+                    // Report a repeated key where it starts.
+                    if (args->e == JCONF_DUPLICATE_KEY)
+                    {
+                        args->line = keyline;
+                        args->pos = keypos;
+                    }
                     goto cleanup;
                 }
 
-                jconf_free_token(prev_token);
+                key = NULL;
                 state = NEXT;
                 break;
 
@@ -401,7 +917,13 @@ static int jconf_parse_json(jToken* tokens, const char* buffer, int size, jArgs*
                     break;
                 }
 
-                if ((c == ']' && tokens->type == JCONF_ARRAY) || (c == '}' && tokens->type == JCONF_OBJECT))
+                if (c == ']' && tokens->type == JCONF_ARRAY)
+                {
+                    jconf_array_record(parser, (jArray*)tokens->data);
+                    return END;
+                }
+
+                if (c == '}' && tokens->type == JCONF_OBJECT)
                     return END;
 
                 args->e = JCONF_UNEXPECTED_TOK;
@@ -413,84 +935,631 @@ static int jconf_parse_json(jToken* tokens, const char* buffer, int size, jArgs*
     args->e = JCONF_UNEXPECTED_EOF;
 
     cleanup:
-        jconf_free_token(tokens);
+        jconf_free(parser->allocator, key);
+        jconf_discard_token(parser, tokens);
         return ERROR;
 }
 
 /**
- * JConf json2c
+ * JConf Scan Default, Strict and Relaxed
  *
- * Description: Converts a JSON string to a jToken tree structure.
+ * Description: The scanner specialized for each parse mode.
  *
- * @param[out] {buffer} // The string to parse.
- * @param[out] {size}   // The size of the buffer.
- * @param[in]  {args}   // The object to store parsing related information
- * @returns             // The collection of tokens.
+ * @param[in]  {parser} // The parser state.
+ * @param[in]  {tokens} // The root token of the JSON tree.
+ * @returns             // The state of the DFA.
  */
-jToken* jconf_json2c(const char* buffer, int size, jArgs* args)
+static int jconf_scan_default(jParser* parser, jToken* tokens)
 {
-    jToken* collection;
-
-    args->e = JCONF_NO_ERROR;
-    args->line = 1;
-    args->pos = 0;
-
-    // Create a new collection.
-    if (!jconf_alloc((void**)&collection, sizeof(*collection), args))
-        return NULL;
+    return jconf_parse_json(parser, tokens, JCONF_SCAN_DEFAULT);
+}
 
-    // Attempt to parse the buffer.
-    if (jconf_parse_json(collection, buffer, size, args) < 0)
-        return NULL;
+static int jconf_scan_strict(jParser* parser, jToken* tokens)
+{
+    return jconf_parse_json(parser, tokens, JCONF_SCAN_STRICT);
+}
 
-    return collection;
+static int jconf_scan_relaxed(jParser* parser, jToken* tokens)
+{
+    return jconf_parse_json(parser, tokens, JCONF_SCAN_RELAXED);
 }
 
 /**
- * JConf Free Token
+ * JConf Parse End
  *
- * Description: Recursively free's a dynamically allocated Token
+ * Description: Checks that only space follows the root value (strict mode).
  *
- * @param[out] {root} // The collection of tokens.
+ * @param[in]  {parser} // The parser state.
+ * @returns             // '1' if the rest of the buffer is space.
  */
-void jconf_free_token(jToken* root)
+static int jconf_parse_end(jParser* parser)
 {
-    jNode *node;
-    jArray *arr;
-    jMap* map;
-    int i;
-
-    // Null check.
-    if (root == NULL)
-        return;
+    jArgs* args = parser->args;
+    char c;
 
-    // Recursively free the collection.
-    if (root->type == JCONF_OBJECT && root->data != NULL)
+    while (++args->pos < parser->size)
     {
-        map = (jMap*)root->data;
-        for (i = 0; i < JCONF_BUCKET_SIZE; i++)
+        if (!(jconf_isspace((c = parser->buffer[args->pos]))))
         {
-            node = (jNode*)map->buckets[i];
-            while (node)
-            {
-                jconf_free_token((jToken*)node->value);
-                node = node->next;
-            }
+            args->e = JCONF_EXPECTED_EOF;
+            return 0;
         }
 
-        jconf_destroy_map(map);
-        free(map);
+        if (c == '\n') args->line++;
     }
-    else if (root->type == JCONF_ARRAY && root->data != NULL)
-    {
-        arr = (jArray*)root->data;
+
+    return 1;
+}
+
+/**
+ * JConf Parse
+ *
+ * Description: Parses a buffer with the provided parser state.
+ *
+ * @param[in]  {parser} // The parser state.
+ * @returns             // The collection of tokens (NULL on error).
+ */
+static jToken* jconf_parse(jParser* parser)
+{
+    jToken* collection;
+    int status;
+
+#ifdef JCONF_STATS
+    double start = parser->stats != NULL ? jconf_now() : 0;
+    jconf_stat(parser, memset(stats, 0, sizeof(*stats)));
+#endif
+
+    parser->args->e = JCONF_NO_ERROR;
+    parser->args->line = 1;
+    parser->args->pos = 0;
+    parser->depth = 0;
+
+    // Create a new collection.
+    if (!jconf_alloc(parser, (void**)&collection, sizeof(*collection)))
+        return NULL;
+
+    // Attempt to parse the buffer with the scanner for the mode.
+    switch (parser->mode)
+    {
+        case JCONF_MODE_STRICT:  status = jconf_scan_strict(parser, collection); break;
+        case JCONF_MODE_RELAXED: status = jconf_scan_relaxed(parser, collection); break;
+        default:                 status = jconf_scan_default(parser, collection); break;
+    }
+
+    if (status < 0)
+        return NULL;
+
+    if (parser->mode == JCONF_MODE_STRICT && !jconf_parse_end(parser))
+    {
+        jconf_discard_token(parser, collection);
+        return NULL;
+    }
+
+    if (parser->hash)
+        jconf_hash_token(collection, 0);
+
+    jconf_stat(parser, stats->tokens[collection->type]++; stats->time_total = jconf_now() - start);
+    return collection;
+}
+
+/**
+ * JConf json2c
+ *
+ * Description: Converts a JSON string to a jToken tree structure.
+ *
+ * @param[out] {buffer} // The string to parse.
+ * @param[out] {size}   // The size of the buffer.
+ * @param[in]  {args}   // The object to store parsing related information
+ * @returns             // The collection of tokens.
+ */
+jToken* jconf_json2c(const char* buffer, size_t size, jArgs* args)
+{
+    return jconf_json2c_ex(buffer, size, NULL, args);
+}
+
+/**
+ * JConf json2c Ex
+ *
+ * Description: Converts a JSON string to a jToken tree structure with parse
+ *              options. A tree built with an allocator must be freed with
+ *              jconf_free_token_with and the same allocator.
+ *
+ * @param[out] {buffer}  // The string to parse.
+ * @param[out] {size}    // The size of the buffer.
+ * @param[out] {options} // The parse options (NULL for the defaults).
+ * @param[in]  {args}    // The object to store parsing related information
+ * @returns              // The collection of tokens.
+ */
+jToken* jconf_json2c_ex(const char* buffer, size_t size, const jParseOptions* options, jArgs* args)
+{
+    jParser parser;
+
+    parser.buffer = buffer;
+    parser.size = size;
+    parser.args = args;
+    parser.allocator = options != NULL ? options->allocator : NULL;
+    parser.duplicates = options != NULL ? options->duplicates : JCONF_DUP_LAST_WINS;
+    parser.mode = options != NULL ? options->mode : JCONF_MODE_DEFAULT;
+    parser.hash = options != NULL && options->hash;
+    parser.context = NULL;
+#ifdef JCONF_STATS
+    parser.stats = options != NULL ? options->stats : NULL;
+#endif
+
+    return jconf_parse(&parser);
+}
+
+/**
+ * JConf Context json2c
+ *
+ * Description: Converts a JSON string to a jToken tree structure allocated
+ *              from a parser context. The tree is valid until the context is
+ *              reset or destroyed.
+ *
+ * @param[in]  {context} // The parser context.
+ * @param[out] {buffer}  // The string to parse.
+ * @param[out] {size}    // The size of the buffer.
+ * @param[in]  {args}    // The object to store parsing related information
+ * @returns              // The collection of tokens.
+ */
+jToken* jconf_context_json2c(jParserContext* context, const char* buffer, size_t size, jArgs* args)
+{
+    return jconf_context_json2c_ex(context, buffer, size, NULL, args);
+}
+
+/**
+ * JConf Context json2c Ex
+ *
+ * Description: Converts a JSON string to a jToken tree structure allocated
+ *              from a parser context with parse options. The allocator in
+ *              the options is not used.
+ *
+ * @param[in]  {context} // The parser context.
+ * @param[out] {buffer}  // The string to parse.
+ * @param[out] {size}    // The size of the buffer.
+ * @param[out] {options} // The parse options (NULL for the defaults).
+ * @param[in]  {args}    // The object to store parsing related information
+ * @returns              // The collection of tokens.
+ */
+jToken* jconf_context_json2c_ex(jParserContext* context, const char* buffer, size_t size, const jParseOptions* options, jArgs* args)
+{
+    jParser parser;
+    jToken* root;
+    size_t average;
+    int i;
+
+    parser.buffer = buffer;
+    parser.size = size;
+    parser.args = args;
+    parser.allocator = &context->allocator;
+    parser.context = context;
+    parser.duplicates = options != NULL ? options->duplicates : JCONF_DUP_LAST_WINS;
+    parser.mode = options != NULL ? options->mode : JCONF_MODE_DEFAULT;
+    parser.hash = options != NULL && options->hash;
+#ifdef JCONF_STATS
+    parser.stats = options != NULL ? options->stats : NULL;
+#endif
+
+    for (i = 0; i < JCONF_CONTEXT_HINTS; i++)
+        context->next_sums[i] = context->next_counts[i] = 0;
+
+    // Blend the average array sizes into the hints for the next document,
+    // so that an outlier fades instead of sizing every later array.
+    if ((root = jconf_parse(&parser)) != NULL)
+    {
+        for (i = 0; i < JCONF_CONTEXT_HINTS; i++)
+        {
+            average = context->next_counts[i] > 0 ?
+                (context->next_sums[i] + context->next_counts[i] - 1) / context->next_counts[i] : 0;
+            context->hints[i] = context->hints[i] == 0 ? average : (context->hints[i] + average + 1) / 2;
+        }
+    }
+
+    return root;
+}
+
+/**
+ * JConf Validate JSON
+ *
+ * Description: Runs the parser DFA over the buffer without building a tree.
+ *              Nesting is kept in a bitstack (1 for objects, 0 for arrays)
+ *              instead of the call stack, and values are scanned by the same
+ *              functions as the parser without being stored, so errors are
+ *              reported with the same code, line and position.
+ *
+ * @param[in]  {parser}   // The parser state.
+ * @param[out] {features} // The scanner features (a constant).
+ * @returns               // '1' if the buffer is valid, '0' on error.
+ */
+static jconf_specialize int jconf_validate_json(jParser* parser, const int features)
+{
+    // JSON parse states.
+    static const int
+        START = 0,
+        OBJECT_INIT = 1,
+        OBJECT_KEY = 2,
+        OBJECT_COLON = 3,
+        ARRAY_INIT = 4,
+        VALUE = 5,
+        NEXT = 6;
+
+    // Local variables.
+    uint64_t stack[JCONF_VALIDATE_MAX_DEPTH / 64];
+    const char* buffer = parser->buffer;
+    size_t size = parser->size, depth = 0;
+    jArgs* args = parser->args;
+    int state = START, object = 0;
+    jToken token;
+    char c, *key;
+
+    for (; args->pos < size; args->pos++)
+    {
+        // Ignore space characters and update the line number.
+        if (jconf_isspace((c = buffer[args->pos])))
+        {
+            if (c == '\n') args->line++;
+            continue;
+        }
+
+        // Ignore comments from the JSON string.
+        if ((features & JCONF_FEATURE_COMMENTS) && c == '/')
+        {
+            if (!jconf_skip_comment(parser)) return 0;
+            continue;
+        }
+
+        // JSON Scanner DFA (the states of jconf_parse_json).
+        switch (state)
+        {
+            case 0: // START
+                if (c != '{' && c != '[')
+                {
+                    if (!(features & JCONF_FEATURE_SCALAR_ROOT))
+                    {
+                        // Unexpected token at start state.
+                        args->e = JCONF_UNEXPECTED_TOK;
+                        return 0;
+                    }
+
+                    // Any value at the root.
+                    jconf_parse_value(parser, &token, features);
+                    if (args->e != JCONF_NO_ERROR) return 0;
+                    goto end;
+                }
+
+            push:
+                if (depth == JCONF_VALIDATE_MAX_DEPTH)
+                {
+                    args->e = JCONF_MAX_DEPTH;
+                    return 0;
+                }
+
+                // New JSON object or array.
+                object = c == '{';
+                if (object)
+                    stack[depth / 64] |= (uint64_t)1 << (depth % 64);
+                else
+                    stack[depth / 64] &= ~((uint64_t)1 << (depth % 64));
+
+                depth++;
+                state = object ? OBJECT_INIT : ARRAY_INIT;
+                break;
+
+            case 1: // OBJECT_INIT
+                if (c == '}')
+                    goto pop;
+
+            case 2: // OBJECT_KEY
+                if (c == '\"' || ((features & JCONF_FEATURE_SINGLE_QUOTES) && c == '\''))
+                {
+                    jconf_parse_string(parser, &key, features);
+                    if (args->e != JCONF_NO_ERROR) return 0;
+                }
+                else if ((features & JCONF_FEATURE_UNQUOTED_KEYS) && jconf_isident(c) && !(jconf_isdigit(c)))
+                {
+                    jconf_parse_identifier(parser, &key, features);
+                    if (args->e != JCONF_NO_ERROR) return 0;
+                }
+                else if ((features & JCONF_FEATURE_TRAILING_COMMAS) && c == '}')
+                    goto pop;
+                else
+                {
+                    // Unexpected quote character.
+                    args->e = JCONF_UNEXPECTED_TOK;
+                    return 0;
+                }
+                state = OBJECT_COLON;
+                break;
+
+            case 3: // OBJECT_COLON
+                if (c != ':')
+                {
+                    args->e = JCONF_UNEXPECTED_TOK;
+                    return 0;
+                }
+
+                state = VALUE;
+                break;
+
+            case 4: // ARRAY_INIT
+                if (c == ']')
+                    goto pop;
+
+            case 5: // VALUE
+                if ((features & JCONF_FEATURE_TRAILING_COMMAS) && c == ']' && !object)
+                    goto pop;
+
+                if (c == '{' || c == '[')
+                    goto push;
+
+                jconf_parse_value(parser, &token, features);
+                if (args->e != JCONF_NO_ERROR) return 0;
+
+                state = NEXT;
+                break;
+
+            case 6: // NEXT
+                // Process the next value, or the container is complete.
+                if (c == ',')
+                {
+                    state = object ? OBJECT_KEY : VALUE;
+                    break;
+                }
+
+                if ((c == ']' && !object) || (c == '}' && object))
+                    goto pop;
+
+                args->e = JCONF_UNEXPECTED_TOK;
+                return 0;
+        }
+        continue;
+
+    pop:
+        // The container is complete; continue with its parent.
+        if (--depth == 0)
+            goto end;
+
+        object = (stack[(depth - 1) / 64] >> ((depth - 1) % 64)) & 1;
+        state = NEXT;
+    }
+
+    // Valid JSON files should not reach this point.
+    args->e = JCONF_UNEXPECTED_EOF;
+    return 0;
+
+end:
+    return !(features & JCONF_FEATURE_STRICT) || jconf_parse_end(parser);
+}
+
+/**
+ * JConf Validate
+ *
+ * Description: Checks that a buffer is well formed without building a tree.
+ *              No memory is allocated, and errors are reported with the same
+ *              code, line and position as jconf_json2c_ex in the same mode.
+ *              Duplicate keys are not detected, and containers nested deeper
+ *              than JCONF_VALIDATE_MAX_DEPTH fail with JCONF_MAX_DEPTH.
+ *
+ * @param[out] {buffer} // The string to validate.
+ * @param[out] {size}   // The size of the buffer.
+ * @param[out] {mode}   // The parse mode.
+ * @param[in]  {args}   // The object to store parsing related information
+ * @returns             // '1' if the buffer is valid, '0' on error.
+ */
+int jconf_validate(const char* buffer, size_t size, jParseMode mode, jArgs* args)
+{
+    jParser parser;
+
+    parser.buffer = buffer;
+    parser.size = size;
+    parser.args = args;
+    parser.allocator = NULL;
+    parser.context = NULL;
+    parser.duplicates = JCONF_DUP_TRUSTED;
+    parser.mode = mode;
+    parser.hash = 0;
+    parser.depth = 0;
+#ifdef JCONF_STATS
+    parser.stats = NULL;
+#endif
+
+    args->e = JCONF_NO_ERROR;
+    args->line = 1;
+    args->pos = 0;
+
+    switch (mode)
+    {
+        case JCONF_MODE_STRICT:  return jconf_validate_json(&parser, JCONF_VALIDATE_STRICT);
+        case JCONF_MODE_RELAXED: return jconf_validate_json(&parser, JCONF_VALIDATE_RELAXED);
+        default:                 return jconf_validate_json(&parser, JCONF_VALIDATE_DEFAULT);
+    }
+}
+
+/**
+ * JConf Release
+ *
+ * Description: Drops a tree's reference to a shared object or array. The
+ *              count is read first so that trees which own their containers
+ *              (the common case) skip the atomic decrement.
+ *
+ * @param[in] {refs} // The number of other trees sharing the container.
+ * @returns          // '1' if the caller was the last tree and frees it.
+ */
+static __inline int jconf_release(JCONF_ATOMIC(size_t)* refs)
+{
+    return atomic_load_explicit(refs, memory_order_acquire) == 0 ||
+        atomic_fetch_sub_explicit(refs, 1, memory_order_acq_rel) == 0;
+}
+
+/**
+ * JConf Free Token
+ *
+ * Description: Recursively free's a dynamically allocated Token
+ *
+ * @param[out] {root} // The collection of tokens.
+ */
+void jconf_free_token(jToken* root)
+{
+    jconf_free_token_with(root, NULL);
+}
+
+/**
+ * JConf Free Token With
+ *
+ * Description: Recursively frees a token allocated with an allocator. An
+ *              object or array shared with other trees (see jconf/merge.h)
+ *              loses a reference and is freed by its last tree.
+ *
+ * @param[out] {root}      // The collection of tokens.
+ * @param[out] {allocator} // The allocator used to parse the tree.
+ */
+void jconf_free_token_with(jToken* root, const jAllocator* allocator)
+{
+    jNode *node;
+    jArray *arr;
+    jMap* map;
+    size_t i;
+
+    // Null check.
+    if (root == NULL)
+        return;
+
+    // Recursively free the collection.
+    if (root->type == JCONF_OBJECT && root->data != NULL)
+    {
+        map = (jMap*)root->data;
+        if (!jconf_release(&map->refs))
+        {
+            jconf_free(allocator, root);
+            return;
+        }
+
+        for (node = map->first; node != NULL; node = node->after)
+        {
+            // Keys are owned by the tree.
+            jconf_free(allocator, (void*)node->key);
+            jconf_free_token_with((jToken*)node->value, allocator);
+        }
+
+        jconf_destroy_map(map);
+        jconf_free(allocator, map);
+    }
+    else if (root->type == JCONF_ARRAY && root->data != NULL)
+    {
+        arr = (jArray*)root->data;
+        if (!jconf_release(&arr->refs))
+        {
+            jconf_free(allocator, root);
+            return;
+        }
+
         for (i = 0; i < arr->end; i++)
-            jconf_free_token((jToken*)jconf_array_get(arr, i));
+            jconf_free_token_with((jToken*)jconf_array_get(arr, i), allocator);
 
         jconf_destroy_array(arr);
-        free(arr);
+        jconf_free(allocator, arr);
     }
-    free(root);
+    else if (root->type == JCONF_STRING || root->type == JCONF_INT || root->type == JCONF_DOUBLE)
+        jconf_free(allocator, root->data);
+
+    jconf_free(allocator, root);
+}
+
+/**
+ * JConf Copy Token
+ *
+ * Description: Recursively copies a token.
+ *
+ * @param[out] {root} // The collection of tokens.
+ * @returns           // The copy (NULL if out of memory).
+ */
+jToken* jconf_copy_token(const jToken* root)
+{
+    return jconf_copy_token_with(root, NULL);
+}
+
+/**
+ * JConf Copy Token With
+ *
+ * Description: Recursively copies a token with an allocator. Members keep
+ *              their order, repeated keys included.
+ *
+ * @param[out] {root}      // The collection of tokens.
+ * @param[out] {allocator} // The allocator for the copy.
+ * @returns                // The copy (NULL if out of memory).
+ */
+jToken* jconf_copy_token_with(const jToken* root, const jAllocator* allocator)
+{
+    const jArray* arr;
+    const jMap* map;
+    const jNode* node;
+    jToken *copy, *value;
+    size_t i, length;
+    char* key;
+
+    if ((copy = (jToken*)jconf_malloc(allocator, sizeof(*copy))) == NULL)
+        return NULL;
+
+    copy->type = root->type;
+    copy->data = NULL;
+
+    if (root->type == JCONF_OBJECT && root->data != NULL)
+    {
+        map = (const jMap*)root->data;
+        if ((copy->data = jconf_malloc(allocator, sizeof(jMap))) == NULL)
+            goto failure;
+
+        jconf_init_map_with((jMap*)copy->data, allocator);
+        for (node = map->first; node != NULL; node = node->after)
+        {
+            if ((key = (char*)jconf_malloc(allocator, node->len + 1)) == NULL)
+                goto failure;
+
+            memcpy(key, node->key, node->len + 1);
+            if ((value = jconf_copy_token_with((const jToken*)node->value, allocator)) == NULL ||
+                !jconf_map_append((jMap*)copy->data, key, node->len, value))
+            {
+                jconf_free_token_with(value, allocator);
+                jconf_free(allocator, key);
+                goto failure;
+            }
+        }
+    }
+    else if (root->type == JCONF_ARRAY && root->data != NULL)
+    {
+        arr = (const jArray*)root->data;
+        if ((copy->data = jconf_malloc(allocator, sizeof(jArray))) == NULL)
+            goto failure;
+
+        if (!jconf_init_array_with((jArray*)copy->data, arr->end, 2, allocator))
+        {
+            jconf_free(allocator, copy->data);
+            copy->data = NULL;
+            goto failure;
+        }
+
+        for (i = 0; i < arr->end; i++)
+        {
+            if ((value = jconf_copy_token_with((const jToken*)jconf_array_get(arr, i), allocator)) == NULL)
+                goto failure;
+
+            jconf_array_push((jArray*)copy->data, value);
+        }
+    }
+    else if (root->type == JCONF_STRING || root->type == JCONF_INT || root->type == JCONF_DOUBLE)
+    {
+        length = jconf_strlen((const char*)root->data) + 1;
+        if ((copy->data = jconf_malloc(allocator, length)) == NULL)
+            goto failure;
+
+        memcpy(copy->data, root->data, length);
+    }
+
+    return copy;
+
+failure:
+    jconf_free_token_with(copy, allocator);
+    return NULL;
 }
 
 /**
@@ -502,7 +1571,7 @@ void jconf_free_token(jToken* root)
  * @param[out] {format} // The access format.
  * @returns             // The desitination token.
  */
-jToken* jconf_get(jToken* head, const char* format, ...)
+jToken* jconf_get(const jToken* head, const char* format, ...)
 {
     va_list args;
     jToken* token;
@@ -511,7 +1580,7 @@ jToken* jconf_get(jToken* head, const char* format, ...)
     char* p;
 
     p = (char*)format;
-    token = head;
+    token = (jToken*)head;
 
     va_start(args, format);
 
@@ -520,7 +1589,8 @@ jToken* jconf_get(jToken* head, const char* format, ...)
         // Index the object.
         if (*p == 'o' || *p == 'O')
         {
-            if (token->type != JCONF_OBJECT)
+            // Empty objects have no map.
+            if (token->type != JCONF_OBJECT || token->data == NULL)
                 return NULL;
 
             map = (jMap*)token->data;
@@ -534,7 +1604,7 @@ jToken* jconf_get(jToken* head, const char* format, ...)
         // Index the array.
         else if (*p == 'a' || *p == 'A')
         {
-            if (token->type != JCONF_ARRAY)
+            if (token->type != JCONF_ARRAY || token->data == NULL)
                 return NULL;
 
             arr = (jArray*)token->data;
@@ -552,4 +1622,88 @@ jToken* jconf_get(jToken* head, const char* format, ...)
     }
 
     return token;
-}
\ No newline at end of file
+}
+
+/**
+ * JConf Object Iter Begin
+ *
+ * Description: Starts iterating the members of an object in the order they
+ *              appear in the document. Anything other than an object has no
+ *              members.
+ *
+ * @param[out] {object} // The object token.
+ * @param[in]  {iter}   // The iterator to initialize.
+ */
+void jconf_object_iter_begin(const jToken* object, jObjectIter* iter)
+{
+    if (object == NULL || object->type != JCONF_OBJECT || object->data == NULL)
+        iter->node = NULL;
+    else
+        iter->node = ((const jMap*)object->data)->first;
+}
+
+/**
+ * JConf Object Iter Next
+ *
+ * Description: Returns the next member of an object.
+ *
+ * @param[in] {iter}  // The iterator.
+ * @param[in] {key}   // Receives the key (may be NULL).
+ * @param[in] {len}   // Receives the length of the key (may be NULL).
+ * @param[in] {value} // Receives the value (may be NULL).
+ * @returns           // '1' if a member was returned, '0' at the end.
+ */
+int jconf_object_iter_next(jObjectIter* iter, const char** key, size_t* len, jToken** value)
+{
+    const jNode* node;
+
+    if ((node = iter->node) == NULL)
+        return 0;
+
+    if (key != NULL)
+        *key = node->key;
+    if (len != NULL)
+        *len = node->len;
+    if (value != NULL)
+        *value = (jToken*)node->value;
+
+    iter->node = node->after;
+    return 1;
+}
+
+/**
+ * JConf Array Iter Begin
+ *
+ * Description: Starts iterating the elements of an array. Anything other
+ *              than an array has no elements.
+ *
+ * @param[out] {array} // The array token.
+ * @param[in]  {iter}  // The iterator to initialize.
+ */
+void jconf_array_iter_begin(const jToken* array, jArrayIter* iter)
+{
+    iter->index = 0;
+
+    if (array == NULL || array->type != JCONF_ARRAY)
+        iter->arr = NULL;
+    else
+        iter->arr = (const jArray*)array->data;
+}
+
+/**
+ * JConf Array Iter Next
+ *
+ * Description: Returns the next element of an array.
+ *
+ * @param[in] {iter}  // The iterator.
+ * @param[in] {value} // Receives the element.
+ * @returns           // '1' if an element was returned, '0' at the end.
+ */
+int jconf_array_iter_next(jArrayIter* iter, jToken** value)
+{
+    if (iter->arr == NULL || iter->index >= iter->arr->end)
+        return 0;
+
+    *value = (jToken*)iter->arr->values[iter->index++];
+    return 1;
+}
@@ -0,0 +1,942 @@
+/**
+ * JConf Patch Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/patch.h>
+#include <jconf/hash.h>
+#include <jconf/merge.h>
+#include <string.h>
+#include <stdlib.h>
+
+// Patch operations.
+typedef enum _j_patch_op
+{
+    JCONF_PATCH_ADD = 0,
+    JCONF_PATCH_REMOVE,
+    JCONF_PATCH_REPLACE,
+    JCONF_PATCH_MOVE,
+    JCONF_PATCH_COPY,
+    JCONF_PATCH_TEST
+
+} jPatchOp;
+
+// Operation names.
+static const char* jconf_patch_ops[] = { "add", "remove", "replace", "move", "copy", "test" };
+
+// jPatchStep struct definition (one compiled operation).
+typedef struct _j_patch_step
+{
+    jPatchOp op;
+    jPointer path, from;
+    const jToken* value;
+
+} jPatchStep;
+
+// jPatch struct definition.
+struct _j_patch
+{
+    jPatchStep* steps;
+    size_t count;
+};
+
+// Changes recorded while applying a patch.
+typedef enum _j_undo_kind
+{
+    JCONF_UNDO_LINK = 0,    // A member was added.
+    JCONF_UNDO_UNLINK,      // A member was removed (the node is kept).
+    JCONF_UNDO_INSERT,      // An element was inserted.
+    JCONF_UNDO_REMOVE,      // An element was removed.
+    JCONF_UNDO_SET_NODE,    // A member's value was replaced.
+    JCONF_UNDO_SET_INDEX,   // An element was replaced.
+    JCONF_UNDO_SET_ROOT     // The document was replaced.
+
+} jUndoKind;
+
+// jUndo struct definition. Values taken out of the tree (old) are freed when
+// the patch is committed if they are not used elsewhere, and values copied
+// into it (added) are freed when it is rolled back.
+typedef struct _j_undo
+{
+    jUndoKind kind;
+    void* container;                // The jMap or jArray.
+    jNode* node;
+    size_t index;
+    jToken *old, *added;
+    int free_old, free_added;
+
+} jUndo;
+
+// jPatcher struct definition (the state of one application).
+typedef struct _j_patcher
+{
+    jToken** root;
+    const jAllocator* allocator;
+    jUndo* log;
+    size_t count, cap;
+
+} jPatcher;
+
+/**
+ * JConf Pointer Compile
+ *
+ * Description: Compiles a JSON pointer ("" or "/a/0/b~1c").
+ * @param[in]  {pointer} // The pointer to initialize.
+ * @param[out] {text}    // The pointer text.
+ * @param[out] {length}  // The length of the text.
+ * @returns              // '1' if successful, '0' if malformed or out of memory.
+ */
+int jconf_pointer_compile(jPointer* pointer, const char* text, size_t length)
+{
+    jPointerRef* ref;
+    size_t i, n;
+    char* key;
+
+    pointer->refs = NULL;
+    pointer->keys = NULL;
+    pointer->count = 0;
+
+    if (length == 0)
+        return 1;
+
+    if (text[0] != '/')
+        return 0;
+
+    for (i = 0, n = 0; i < length; i++)
+        n += text[i] == '/';
+
+    if ((pointer->refs = (jPointerRef*)jconf_malloc(NULL, n * sizeof(jPointerRef))) == NULL ||
+        (pointer->keys = (char*)jconf_malloc(NULL, length)) == NULL)
+    {
+        jconf_pointer_free(pointer);
+        return 0;
+    }
+
+    for (i = 1, key = pointer->keys; pointer->count < n; i++)
+    {
+        ref = &pointer->refs[pointer->count++];
+        ref->key = key;
+
+        // Decode ~1 and ~0 up to the next '/'.
+        for (; i < length && text[i] != '/'; i++)
+        {
+            if (text[i] != '~')
+                *key++ = text[i];
+            else if (i + 1 < length && (text[i + 1] == '0' || text[i + 1] == '1'))
+                *key++ = text[++i] == '0' ? '~' : '/';
+            else
+            {
+                jconf_pointer_free(pointer);
+                return 0;
+            }
+        }
+
+        ref->len = key - ref->key;
+        ref->hash = jconf_map_key_hash(ref->key, ref->len);
+        ref->index = JCONF_POINTER_NONE;
+
+        // Array indices are 0 or digits without a leading zero.
+        if (ref->len == 1 && ref->key[0] == '-')
+            ref->index = JCONF_POINTER_END;
+        else if (ref->len > 0 && (ref->key[0] != '0' || ref->len == 1))
+        {
+            size_t index = 0, j;
+
+            for (j = 0; j < ref->len && (jconf_isdigit(ref->key[j])) && index <= (JCONF_POINTER_END - 10) / 10; j++)
+                index = index * 10 + (ref->key[j] - '0');
+
+            if (j == ref->len)
+                ref->index = index;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Pointer Free
+ *
+ * Description: Frees a compiled pointer.
+ * @param[in] {pointer} // The pointer.
+ */
+void jconf_pointer_free(jPointer* pointer)
+{
+    jconf_free(NULL, pointer->refs);
+    jconf_free(NULL, pointer->keys);
+    pointer->refs = NULL;
+    pointer->keys = NULL;
+    pointer->count = 0;
+}
+
+/**
+ * JConf Pointer Step
+ *
+ * Description: Follows one reference token.
+ * @param[out] {token} // The container.
+ * @param[out] {ref}   // The reference token.
+ * @returns            // The value (NULL if it does not exist).
+ */
+static __inline jToken* jconf_pointer_step(const jToken* token, const jPointerRef* ref)
+{
+    if (token->data == NULL)
+        return NULL;
+
+    if (token->type == JCONF_OBJECT)
+        return (jToken*)jconf_map_get_hashed((const jMap*)token->data, ref->key, ref->len, ref->hash);
+    else if (token->type == JCONF_ARRAY && ref->index < JCONF_POINTER_END)
+        return (jToken*)jconf_array_get((const jArray*)token->data, ref->index);
+
+    return NULL;
+}
+
+/**
+ * JConf Pointer Walk
+ *
+ * Description: Resolves the first references of a pointer.
+ * @param[out] {token}   // The document.
+ * @param[out] {pointer} // The pointer.
+ * @param[out] {count}   // The number of references to follow.
+ * @returns              // The value (NULL if it does not exist).
+ */
+static jToken* jconf_pointer_walk(const jToken* token, const jPointer* pointer, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count && token != NULL; i++)
+        token = jconf_pointer_step(token, &pointer->refs[i]);
+
+    return (jToken*)token;
+}
+
+/**
+ * JConf Patch Touch
+ *
+ * Description: Clears the memoized hashes (see jconf/hash.h) of the
+ *              containers that hold a path, before it changes.
+ * @param[in]  {token}   // The document.
+ * @param[out] {pointer} // The path.
+ * @param[out] {count}   // The number of references to the parent.
+ */
+static void jconf_patch_touch(jToken* token, const jPointer* pointer, size_t count)
+{
+    size_t i;
+
+    for (i = 0; token != NULL && token->data != NULL; i++)
+    {
+        if (token->type == JCONF_OBJECT)
+            atomic_store_explicit(&((jMap*)token->data)->digest, 0, memory_order_relaxed);
+        else if (token->type == JCONF_ARRAY)
+            atomic_store_explicit(&((jArray*)token->data)->digest, 0, memory_order_relaxed);
+
+        if (i == count)
+            break;
+
+        token = jconf_pointer_step(token, &pointer->refs[i]);
+    }
+}
+
+/**
+ * JConf Pointer Get
+ *
+ * Description: Resolves a compiled pointer.
+ * @param[out] {token}   // The document.
+ * @param[out] {pointer} // The pointer.
+ * @returns              // The value (NULL if it does not exist).
+ */
+jToken* jconf_pointer_get(const jToken* token, const jPointer* pointer)
+{
+    return jconf_pointer_walk(token, pointer, pointer->count);
+}
+
+/**
+ * JConf Pointer Resolve
+ *
+ * Description: Resolves a pointer given as text (compile it with
+ *              jconf_pointer_compile to resolve it more than once).
+ * @param[out] {token} // The document.
+ * @param[out] {text}  // The null terminated pointer.
+ * @returns            // The value (NULL if it does not exist or is malformed).
+ */
+jToken* jconf_pointer_resolve(const jToken* token, const char* text)
+{
+    jPointer pointer;
+    jToken* value;
+
+    if (!jconf_pointer_compile(&pointer, text, jconf_strlen(text)))
+        return NULL;
+
+    value = jconf_pointer_get(token, &pointer);
+    jconf_pointer_free(&pointer);
+    return value;
+}
+
+/**
+ * JConf Patch Fail
+ *
+ * Description: Records an error.
+ * @param[in]  {result} // The result.
+ * @param[out] {e}      // The error code.
+ * @param[out] {op}     // The index of the operation.
+ * @returns             // '0'.
+ */
+static int jconf_patch_fail(jPatchResult* result, jPatchError e, size_t op)
+{
+    result->e = e;
+    result->op = op;
+    return 0;
+}
+
+/**
+ * JConf Patch Pointer
+ *
+ * Description: Compiles a pointer member of an operation.
+ * @param[in]  {pointer} // The pointer to initialize.
+ * @param[out] {op}      // The operation.
+ * @param[out] {name}    // The member name.
+ * @returns              // '1' if successful, '0' if missing or malformed.
+ */
+static int jconf_patch_pointer(jPointer* pointer, const jToken* op, const char* name)
+{
+    const jToken* text = (const jToken*)jconf_map_get((const jMap*)op->data, name);
+
+    if (text == NULL || text->type != JCONF_STRING)
+        return 0;
+
+    return jconf_pointer_compile(pointer, (const char*)text->data, jconf_strlen((const char*)text->data));
+}
+
+/**
+ * JConf Patch Compile
+ *
+ * Description: Compiles a patch document (an array of operations).
+ * @param[out] {root}   // The patch document.
+ * @param[in]  {result} // Receives the error, if any (may be NULL).
+ * @returns             // The compiled patch (NULL on error).
+ */
+jPatch* jconf_patch_compile(const jToken* root, jPatchResult* result)
+{
+    const jToken *op, *name;
+    jPatchResult local;
+    jPatchStep* step;
+    jArrayIter ops;
+    jPatch* patch;
+    size_t count;
+
+    if (result == NULL)
+        result = &local;
+
+    result->e = JCONF_PATCH_OK;
+    result->op = 0;
+
+    if (root == NULL || root->type != JCONF_ARRAY)
+    {
+        jconf_patch_fail(result, JCONF_PATCH_INVALID, 0);
+        return NULL;
+    }
+
+    count = root->data != NULL ? ((const jArray*)root->data)->end : 0;
+    if ((patch = (jPatch*)jconf_malloc(NULL, sizeof(*patch))) == NULL ||
+        (patch->steps = (jPatchStep*)jconf_malloc(NULL, (count > 0 ? count : 1) * sizeof(jPatchStep))) == NULL)
+    {
+        jconf_free(NULL, patch);
+        jconf_patch_fail(result, JCONF_PATCH_OUT_OF_MEMORY, 0);
+        return NULL;
+    }
+
+    patch->count = 0;
+    jconf_array_iter_begin(root, &ops);
+    while (jconf_array_iter_next(&ops, (jToken**)&op))
+    {
+        step = &patch->steps[patch->count];
+        memset(step, 0, sizeof(*step));
+
+        if (op->type != JCONF_OBJECT || op->data == NULL ||
+            (name = (const jToken*)jconf_map_get((const jMap*)op->data, "op")) == NULL || name->type != JCONF_STRING)
+            goto failure;
+
+        for (step->op = JCONF_PATCH_ADD; step->op <= JCONF_PATCH_TEST; step->op++)
+            if (!jconf_strcmp((const char*)name->data, jconf_patch_ops[step->op]))
+                break;
+
+        if (step->op > JCONF_PATCH_TEST || !jconf_patch_pointer(&step->path, op, "path"))
+            goto failure;
+
+        // Each step owns its pointers from here on.
+        patch->count++;
+
+        if ((step->op == JCONF_PATCH_MOVE || step->op == JCONF_PATCH_COPY) && !jconf_patch_pointer(&step->from, op, "from"))
+            goto failure;
+
+        if ((step->op == JCONF_PATCH_ADD || step->op == JCONF_PATCH_REPLACE || step->op == JCONF_PATCH_TEST) &&
+            (step->value = (const jToken*)jconf_map_get((const jMap*)op->data, "value")) == NULL)
+            goto failure;
+    }
+
+    return patch;
+
+failure:
+    jconf_patch_fail(result, JCONF_PATCH_INVALID, ops.index - 1);
+    jconf_patch_free(patch);
+    return NULL;
+}
+
+/**
+ * JConf Patch Free
+ *
+ * Description: Frees a compiled patch.
+ * @param[in] {patch} // The compiled patch.
+ */
+void jconf_patch_free(jPatch* patch)
+{
+    size_t i;
+
+    if (patch == NULL)
+        return;
+
+    for (i = 0; i < patch->count; i++)
+    {
+        jconf_pointer_free(&patch->steps[i].path);
+        jconf_pointer_free(&patch->steps[i].from);
+    }
+
+    jconf_free(NULL, patch->steps);
+    jconf_free(NULL, patch);
+}
+
+/**
+ * JConf Patch Log
+ *
+ * Description: Makes room for the changes of one operation, before it
+ *              changes anything.
+ * @param[in]  {patcher} // The patcher.
+ * @param[out] {count}   // The number of changes.
+ * @returns              // '1' if successful, '0' if out of memory.
+ */
+static int jconf_patch_log(jPatcher* patcher, size_t count)
+{
+    size_t cap;
+    jUndo* log;
+
+    if (patcher->count + count <= patcher->cap)
+        return 1;
+
+    for (cap = patcher->cap > 0 ? patcher->cap * 2 : 16; cap < patcher->count + count; cap *= 2);
+    if ((log = (jUndo*)jconf_realloc(NULL, patcher->log, patcher->cap * sizeof(jUndo), cap * sizeof(jUndo))) == NULL)
+        return 0;
+
+    patcher->log = log;
+    patcher->cap = cap;
+    return 1;
+}
+
+/**
+ * JConf Patch Record
+ *
+ * Description: Records a change (room was made by jconf_patch_log).
+ * @param[in]  {patcher}   // The patcher.
+ * @param[out] {kind}      // The kind of change.
+ * @param[out] {container} // The jMap or jArray.
+ * @param[out] {node}      // The member.
+ * @param[out] {index}     // The element index.
+ * @param[out] {old}       // The value taken out.
+ * @param[out] {added}     // The value put in.
+ * @returns                // The change.
+ */
+static jUndo* jconf_patch_record(jPatcher* patcher, jUndoKind kind, void* container, jNode* node, size_t index, jToken* old, jToken* added)
+{
+    jUndo* undo = &patcher->log[patcher->count++];
+
+    undo->kind = kind;
+    undo->container = container;
+    undo->node = node;
+    undo->index = index;
+    undo->old = old;
+    undo->added = added;
+    undo->free_old = undo->free_added = 0;
+    return undo;
+}
+
+/**
+ * JConf Patch Container
+ *
+ * Description: Allocates the map or array of an empty object or array.
+ * @param[in]  {patcher} // The patcher.
+ * @param[in]  {token}   // The object or array.
+ * @returns              // '1' if successful, '0' if out of memory.
+ */
+static int jconf_patch_container(jPatcher* patcher, jToken* token)
+{
+    if (token->data != NULL)
+        return 1;
+
+    if (token->type == JCONF_OBJECT)
+    {
+        if ((token->data = jconf_malloc(patcher->allocator, sizeof(jMap))) == NULL)
+            return 0;
+
+        jconf_init_map_with((jMap*)token->data, patcher->allocator);
+        return 1;
+    }
+
+    if ((token->data = jconf_malloc(patcher->allocator, sizeof(jArray))) == NULL)
+        return 0;
+
+    jconf_init_array_with((jArray*)token->data, 0, 2, patcher->allocator);
+    return 1;
+}
+
+/**
+ * JConf Patch Own
+ *
+ * Description: Replaces the objects and arrays that hold a path and are
+ *              shared with other trees (see jconf/merge.h) with copies whose
+ *              members are shared instead, so that editing the path leaves
+ *              the other trees unchanged. The copies are recorded as changes
+ *              and room is made for one more.
+ * @param[in]  {patcher} // The patcher.
+ * @param[out] {path}    // The path (which exists).
+ * @param[out] {count}   // The number of references to the parent.
+ * @returns              // The parent (NULL if out of memory).
+ */
+static jToken* jconf_patch_own(jPatcher* patcher, const jPointer* path, size_t count)
+{
+    const jPointerRef* ref = NULL;
+    jToken *token, *parent = NULL, *copy;
+    jUndo* undo;
+    jNode* node;
+    size_t i;
+
+    if (!jconf_patch_log(patcher, count + 2))
+        return NULL;
+
+    for (i = 0, token = *patcher->root; ; i++)
+    {
+        if (jconf_shared(token))
+        {
+            if ((copy = jconf_unshare_with(token, patcher->allocator)) == NULL)
+                return NULL;
+
+            if (parent == NULL)
+            {
+                undo = jconf_patch_record(patcher, JCONF_UNDO_SET_ROOT, NULL, NULL, 0, token, copy);
+                *patcher->root = copy;
+            }
+            else if (parent->type == JCONF_OBJECT)
+            {
+                node = jconf_map_find_node((jMap*)parent->data, ref->key, ref->len, ref->hash);
+                undo = jconf_patch_record(patcher, JCONF_UNDO_SET_NODE, parent->data, node, 0, token, copy);
+                node->value = copy;
+            }
+            else
+            {
+                undo = jconf_patch_record(patcher, JCONF_UNDO_SET_INDEX, parent->data, NULL, ref->index, token, copy);
+                ((jArray*)parent->data)->values[ref->index] = copy;
+            }
+
+            // Committing drops the reference of the old token.
+            undo->free_old = undo->free_added = 1;
+            token = copy;
+        }
+
+        if (i == count)
+            return token;
+
+        parent = token;
+        ref = &path->refs[i];
+        token = jconf_pointer_step(token, ref);
+    }
+}
+
+/**
+ * JConf Patch Add
+ *
+ * Description: Adds a value at a path: replaces the document or an existing
+ *              member, adds a member or inserts an element. Containers
+ *              copied before an error are undone with the patch.
+ * @param[in]  {patcher} // The patcher.
+ * @param[out] {path}    // The path.
+ * @param[out] {value}   // The value.
+ * @param[out] {copied}  // '1' if the value was copied for the patch.
+ * @returns              // JCONF_PATCH_OK or the error.
+ */
+static jPatchError jconf_patch_add(jPatcher* patcher, const jPointer* path, jToken* value, int copied)
+{
+    const jPointerRef* ref;
+    jToken* parent;
+    jUndo* undo;
+    jNode* node;
+    jArray* arr;
+    jMap* map;
+    size_t index;
+    char* key;
+
+    if (!jconf_patch_log(patcher, 1))
+        return JCONF_PATCH_OUT_OF_MEMORY;
+
+    if (path->count == 0)
+    {
+        undo = jconf_patch_record(patcher, JCONF_UNDO_SET_ROOT, NULL, NULL, 0, *patcher->root, value);
+        *patcher->root = value;
+        undo->free_old = 1;
+        undo->free_added = copied;
+        return JCONF_PATCH_OK;
+    }
+
+    ref = &path->refs[path->count - 1];
+    if ((parent = jconf_pointer_walk(*patcher->root, path, path->count - 1)) == NULL ||
+        (parent->type != JCONF_OBJECT && parent->type != JCONF_ARRAY))
+        return JCONF_PATCH_NOT_FOUND;
+
+    if ((parent = jconf_patch_own(patcher, path, path->count - 1)) == NULL || !jconf_patch_container(patcher, parent))
+        return JCONF_PATCH_OUT_OF_MEMORY;
+
+    jconf_patch_touch(*patcher->root, path, path->count - 1);
+
+    if (parent->type == JCONF_OBJECT)
+    {
+        map = (jMap*)parent->data;
+
+        // An existing member is replaced.
+        if ((node = jconf_map_find_node(map, ref->key, ref->len, ref->hash)) != NULL)
+        {
+            undo = jconf_patch_record(patcher, JCONF_UNDO_SET_NODE, map, node, 0, (jToken*)node->value, value);
+            node->value = value;
+            undo->free_old = 1;
+            undo->free_added = copied;
+            return JCONF_PATCH_OK;
+        }
+
+        if ((key = (char*)jconf_malloc(patcher->allocator, ref->len + 1)) == NULL)
+            return JCONF_PATCH_OUT_OF_MEMORY;
+
+        memcpy(key, ref->key, ref->len);
+        key[ref->len] = 0;
+
+        if (!jconf_map_append(map, key, ref->len, value))
+        {
+            jconf_free(patcher->allocator, key);
+            return JCONF_PATCH_OUT_OF_MEMORY;
+        }
+
+        jconf_patch_record(patcher, JCONF_UNDO_LINK, map, map->last, 0, NULL, value)->free_added = copied;
+        return JCONF_PATCH_OK;
+    }
+
+    arr = (jArray*)parent->data;
+    index = ref->index == JCONF_POINTER_END ? arr->end : ref->index;
+    if (index > arr->end)
+        return JCONF_PATCH_NOT_FOUND;
+
+    if (!jconf_array_insert(arr, index, value))
+        return JCONF_PATCH_OUT_OF_MEMORY;
+
+    jconf_patch_record(patcher, JCONF_UNDO_INSERT, arr, NULL, index, NULL, value)->free_added = copied;
+    return JCONF_PATCH_OK;
+}
+
+/**
+ * JConf Patch Take
+ *
+ * Description: Removes or replaces the value at a path. Containers copied
+ *              before an error are undone with the patch.
+ * @param[in]  {patcher}  // The patcher.
+ * @param[out] {path}     // The path.
+ * @param[out] {value}    // The replacement (NULL to remove).
+ * @param[out] {copied}   // '1' if the replacement was copied for the patch.
+ * @param[out] {discard}  // '1' if the old value is freed on commit.
+ * @param[in]  {old}      // Receives the old value (may be NULL).
+ * @returns               // JCONF_PATCH_OK or the error.
+ */
+static jPatchError jconf_patch_take(jPatcher* patcher, const jPointer* path, jToken* value, int copied, int discard, jToken** old)
+{
+    const jPointerRef* ref;
+    jToken *parent, *taken;
+    jUndo* undo;
+    jNode* node;
+    jArray* arr;
+    jMap* map;
+
+    if (!jconf_patch_log(patcher, 1))
+        return JCONF_PATCH_OUT_OF_MEMORY;
+
+    // The document can be replaced but not removed.
+    if (path->count == 0)
+    {
+        if (value == NULL)
+            return JCONF_PATCH_NOT_FOUND;
+
+        taken = *patcher->root;
+        undo = jconf_patch_record(patcher, JCONF_UNDO_SET_ROOT, NULL, NULL, 0, taken, value);
+        *patcher->root = value;
+    }
+    else
+    {
+        ref = &path->refs[path->count - 1];
+        if ((parent = jconf_pointer_walk(*patcher->root, path, path->count - 1)) == NULL || parent->data == NULL)
+            return JCONF_PATCH_NOT_FOUND;
+
+        if ((parent = jconf_patch_own(patcher, path, path->count - 1)) == NULL)
+            return JCONF_PATCH_OUT_OF_MEMORY;
+
+        jconf_patch_touch(*patcher->root, path, path->count - 1);
+
+        if (parent->type == JCONF_OBJECT)
+        {
+            map = (jMap*)parent->data;
+            if ((node = jconf_map_find_node(map, ref->key, ref->len, ref->hash)) == NULL)
+                return JCONF_PATCH_NOT_FOUND;
+
+            taken = (jToken*)node->value;
+            if (value != NULL)
+            {
+                undo = jconf_patch_record(patcher, JCONF_UNDO_SET_NODE, map, node, 0, taken, value);
+                node->value = value;
+            }
+            else
+            {
+                undo = jconf_patch_record(patcher, JCONF_UNDO_UNLINK, map, node, 0, taken, NULL);
+                jconf_map_unlink(map, node);
+            }
+        }
+        else if (parent->type == JCONF_ARRAY)
+        {
+            arr = (jArray*)parent->data;
+            if (ref->index >= arr->end)
+                return JCONF_PATCH_NOT_FOUND;
+
+            taken = (jToken*)jconf_array_get(arr, ref->index);
+            if (value != NULL)
+            {
+                undo = jconf_patch_record(patcher, JCONF_UNDO_SET_INDEX, arr, NULL, ref->index, taken, value);
+                arr->values[ref->index] = value;
+            }
+            else
+            {
+                undo = jconf_patch_record(patcher, JCONF_UNDO_REMOVE, arr, NULL, ref->index, taken, NULL);
+                jconf_array_remove(arr, ref->index);
+            }
+        }
+        else
+            return JCONF_PATCH_NOT_FOUND;
+    }
+
+    undo->free_old = discard;
+    undo->free_added = copied;
+    if (old != NULL)
+        *old = taken;
+    return JCONF_PATCH_OK;
+}
+
+/**
+ * JConf Patch Prefix
+ *
+ * Description: Checks whether the references of a pointer begin another's.
+ * @param[out] {a} // The prefix.
+ * @param[out] {b} // The pointer.
+ * @returns        // '1' if a is b or a prefix of it.
+ */
+static int jconf_patch_prefix(const jPointer* a, const jPointer* b)
+{
+    size_t i;
+
+    if (a->count > b->count)
+        return 0;
+
+    for (i = 0; i < a->count; i++)
+        if (a->refs[i].len != b->refs[i].len || memcmp(a->refs[i].key, b->refs[i].key, a->refs[i].len))
+            return 0;
+
+    return 1;
+}
+
+/**
+ * JConf Patch Step
+ *
+ * Description: Applies one operation.
+ * @param[in]  {patcher} // The patcher.
+ * @param[out] {step}    // The operation.
+ * @returns              // JCONF_PATCH_OK or the error.
+ */
+static jPatchError jconf_patch_step(jPatcher* patcher, const jPatchStep* step)
+{
+    jToken *value, *copy;
+    jPatchError e;
+
+    switch (step->op)
+    {
+        case JCONF_PATCH_REMOVE:
+            return jconf_patch_take(patcher, &step->path, NULL, 0, 1, NULL);
+
+        case JCONF_PATCH_TEST:
+            if ((value = jconf_pointer_get(*patcher->root, &step->path)) == NULL)
+                return JCONF_PATCH_NOT_FOUND;
+            return jconf_equal(value, step->value) ? JCONF_PATCH_OK : JCONF_PATCH_TEST_FAILED;
+
+        case JCONF_PATCH_MOVE:
+            if (jconf_pointer_get(*patcher->root, &step->from) == NULL)
+                return JCONF_PATCH_NOT_FOUND;
+
+            // A value cannot be moved into itself, and moving it to where it
+            // is changes nothing.
+            if (jconf_patch_prefix(&step->from, &step->path))
+                return step->from.count < step->path.count ? JCONF_PATCH_INVALID : JCONF_PATCH_OK;
+
+            // Remove then add the same value (neither frees it).
+            if ((e = jconf_patch_take(patcher, &step->from, NULL, 0, 0, &value)) != JCONF_PATCH_OK)
+                return e;
+            return jconf_patch_add(patcher, &step->path, value, 0);
+
+        default:
+            break;
+    }
+
+    // add, replace and copy put a copy of a value in the tree.
+    if ((value = step->op == JCONF_PATCH_COPY ? jconf_pointer_get(*patcher->root, &step->from) : (jToken*)step->value) == NULL)
+        return JCONF_PATCH_NOT_FOUND;
+
+    if ((copy = jconf_copy_token_with(value, patcher->allocator)) == NULL)
+        return JCONF_PATCH_OUT_OF_MEMORY;
+
+    if (step->op == JCONF_PATCH_REPLACE)
+        e = jconf_patch_take(patcher, &step->path, copy, 1, 1, NULL);
+    else
+        e = jconf_patch_add(patcher, &step->path, copy, 1);
+
+    if (e != JCONF_PATCH_OK)
+        jconf_free_token_with(copy, patcher->allocator);
+
+    return e;
+}
+
+/**
+ * JConf Patch Rollback
+ *
+ * Description: Undoes the recorded changes, newest first, and frees the
+ *              values copied into the tree.
+ * @param[in] {patcher} // The patcher.
+ */
+static void jconf_patch_rollback(jPatcher* patcher)
+{
+    jUndo* undo;
+    jMap* map;
+
+    while (patcher->count > 0)
+    {
+        undo = &patcher->log[--patcher->count];
+        switch (undo->kind)
+        {
+            case JCONF_UNDO_LINK:
+                map = (jMap*)undo->container;
+                jconf_map_unlink(map, undo->node);
+                jconf_free(patcher->allocator, (void*)undo->node->key);
+                jconf_free(map->allocator, undo->node);
+                break;
+
+            case JCONF_UNDO_UNLINK:
+                jconf_map_relink((jMap*)undo->container, undo->node);
+                break;
+
+            case JCONF_UNDO_INSERT:
+                jconf_array_remove((jArray*)undo->container, undo->index);
+                break;
+
+            case JCONF_UNDO_REMOVE:
+                // The array kept its capacity, so this does not allocate.
+                jconf_array_insert((jArray*)undo->container, undo->index, undo->old);
+                break;
+
+            case JCONF_UNDO_SET_NODE:
+                undo->node->value = undo->old;
+                break;
+
+            case JCONF_UNDO_SET_INDEX:
+                ((jArray*)undo->container)->values[undo->index] = undo->old;
+                break;
+
+            case JCONF_UNDO_SET_ROOT:
+                *patcher->root = undo->old;
+                break;
+        }
+
+        if (undo->free_added)
+            jconf_free_token_with(undo->added, patcher->allocator);
+    }
+}
+
+/**
+ * JConf Patch Commit
+ *
+ * Description: Frees the values and members taken out of the tree.
+ * @param[in] {patcher} // The patcher.
+ */
+static void jconf_patch_commit(jPatcher* patcher)
+{
+    jUndo* undo;
+    size_t i;
+
+    for (i = 0; i < patcher->count; i++)
+    {
+        undo = &patcher->log[i];
+        if (undo->kind == JCONF_UNDO_UNLINK)
+        {
+            jconf_free(patcher->allocator, (void*)undo->node->key);
+            jconf_free(((jMap*)undo->container)->allocator, undo->node);
+        }
+
+        if (undo->free_old)
+            jconf_free_token_with(undo->old, patcher->allocator);
+    }
+
+    patcher->count = 0;
+}
+
+/**
+ * JConf Patch Apply
+ *
+ * Description: Applies a compiled patch to a tree in place. The operations
+ *              are applied in order and the patch is atomic: if one fails,
+ *              the changes of the ones before it are undone.
+ * @param[out] {patch}     // The compiled patch.
+ * @param[in]  {root}      // The document (replaced if a path is "").
+ * @param[out] {allocator} // The allocator of the tree (NULL for the default).
+ * @param[in]  {result}    // Receives the error, if any (may be NULL).
+ * @returns                // '1' if successful, '0' on error.
+ */
+int jconf_patch_apply(const jPatch* patch, jToken** root, const jAllocator* allocator, jPatchResult* result)
+{
+    jPatchResult local;
+    jPatcher patcher;
+    jPatchError e;
+    size_t i;
+
+    if (result == NULL)
+        result = &local;
+
+    result->e = JCONF_PATCH_OK;
+    result->op = 0;
+
+    patcher.root = root;
+    patcher.allocator = allocator;
+    patcher.log = NULL;
+    patcher.count = patcher.cap = 0;
+
+    for (i = 0; i < patch->count; i++)
+    {
+        if ((e = jconf_patch_step(&patcher, &patch->steps[i])) != JCONF_PATCH_OK)
+        {
+            jconf_patch_rollback(&patcher);
+            jconf_free(NULL, patcher.log);
+            return jconf_patch_fail(result, e, i);
+        }
+    }
+
+    jconf_patch_commit(&patcher);
+    jconf_free(NULL, patcher.log);
+    return 1;
+}
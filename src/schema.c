@@ -0,0 +1,835 @@
+/**
+ * JConf Schema Implementation
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/schema.h>
+#include <jconf/hash.h>
+#include <string.h>
+#include <stdio.h>
+
+// Types accepted by a schema node.
+#define JCONF_SCHEMA_T_NULL    0x01
+#define JCONF_SCHEMA_T_BOOLEAN 0x02
+#define JCONF_SCHEMA_T_OBJECT  0x04
+#define JCONF_SCHEMA_T_ARRAY   0x08
+#define JCONF_SCHEMA_T_NUMBER  0x10
+#define JCONF_SCHEMA_T_STRING  0x20
+#define JCONF_SCHEMA_T_INTEGER 0x40
+#define JCONF_SCHEMA_T_ANY     0x7F
+
+// Checks made by a schema node.
+#define JCONF_SCHEMA_C_MINIMUM           0x001
+#define JCONF_SCHEMA_C_MAXIMUM           0x002
+#define JCONF_SCHEMA_C_EXCLUSIVE_MINIMUM 0x004
+#define JCONF_SCHEMA_C_EXCLUSIVE_MAXIMUM 0x008
+#define JCONF_SCHEMA_C_MIN_LENGTH        0x010
+#define JCONF_SCHEMA_C_MAX_LENGTH        0x020
+#define JCONF_SCHEMA_C_MIN_ITEMS         0x040
+#define JCONF_SCHEMA_C_MAX_ITEMS         0x080
+#define JCONF_SCHEMA_C_MIN_PROPERTIES    0x100
+#define JCONF_SCHEMA_C_MAX_PROPERTIES    0x200
+#define JCONF_SCHEMA_C_ENUM              0x400
+#define JCONF_SCHEMA_C_CONST             0x800
+
+#define JCONF_SCHEMA_C_NUMBER (JCONF_SCHEMA_C_MINIMUM | JCONF_SCHEMA_C_MAXIMUM | \
+                               JCONF_SCHEMA_C_EXCLUSIVE_MINIMUM | JCONF_SCHEMA_C_EXCLUSIVE_MAXIMUM)
+
+// No schema node.
+#define JCONF_SCHEMA_NONE ((size_t)-1)
+
+// Schema keywords.
+enum
+{
+    JCONF_SCHEMA_K_IGNORED = 0,
+    JCONF_SCHEMA_K_UNSUPPORTED,
+    JCONF_SCHEMA_K_TYPE,
+    JCONF_SCHEMA_K_ENUM,
+    JCONF_SCHEMA_K_CONST,
+    JCONF_SCHEMA_K_PROPERTIES,
+    JCONF_SCHEMA_K_REQUIRED,
+    JCONF_SCHEMA_K_ITEMS,
+    JCONF_SCHEMA_K_MINIMUM,
+    JCONF_SCHEMA_K_MAXIMUM,
+    JCONF_SCHEMA_K_EXCLUSIVE_MINIMUM,
+    JCONF_SCHEMA_K_EXCLUSIVE_MAXIMUM,
+    JCONF_SCHEMA_K_MIN_LENGTH,
+    JCONF_SCHEMA_K_MAX_LENGTH,
+    JCONF_SCHEMA_K_MIN_ITEMS,
+    JCONF_SCHEMA_K_MAX_ITEMS,
+    JCONF_SCHEMA_K_MIN_PROPERTIES,
+    JCONF_SCHEMA_K_MAX_PROPERTIES
+};
+
+// Keyword table (draft 7 validation keywords outside the subset are rejected).
+static const struct
+{
+    const char* name;
+    int keyword;
+
+} jconf_schema_keywords[] = {
+    { "type", JCONF_SCHEMA_K_TYPE },
+    { "enum", JCONF_SCHEMA_K_ENUM },
+    { "const", JCONF_SCHEMA_K_CONST },
+    { "properties", JCONF_SCHEMA_K_PROPERTIES },
+    { "required", JCONF_SCHEMA_K_REQUIRED },
+    { "items", JCONF_SCHEMA_K_ITEMS },
+    { "minimum", JCONF_SCHEMA_K_MINIMUM },
+    { "maximum", JCONF_SCHEMA_K_MAXIMUM },
+    { "exclusiveMinimum", JCONF_SCHEMA_K_EXCLUSIVE_MINIMUM },
+    { "exclusiveMaximum", JCONF_SCHEMA_K_EXCLUSIVE_MAXIMUM },
+    { "minLength", JCONF_SCHEMA_K_MIN_LENGTH },
+    { "maxLength", JCONF_SCHEMA_K_MAX_LENGTH },
+    { "minItems", JCONF_SCHEMA_K_MIN_ITEMS },
+    { "maxItems", JCONF_SCHEMA_K_MAX_ITEMS },
+    { "minProperties", JCONF_SCHEMA_K_MIN_PROPERTIES },
+    { "maxProperties", JCONF_SCHEMA_K_MAX_PROPERTIES },
+    { "$ref", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "multipleOf", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "pattern", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "additionalItems", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "uniqueItems", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "contains", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "additionalProperties", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "patternProperties", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "dependencies", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "propertyNames", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "if", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "allOf", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "anyOf", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "oneOf", JCONF_SCHEMA_K_UNSUPPORTED },
+    { "not", JCONF_SCHEMA_K_UNSUPPORTED }
+};
+
+// Type names.
+static const struct
+{
+    const char* name;
+    unsigned int type;
+
+} jconf_schema_types[] = {
+    { "null", JCONF_SCHEMA_T_NULL },
+    { "boolean", JCONF_SCHEMA_T_BOOLEAN },
+    { "object", JCONF_SCHEMA_T_OBJECT },
+    { "array", JCONF_SCHEMA_T_ARRAY },
+    { "number", JCONF_SCHEMA_T_NUMBER },
+    { "string", JCONF_SCHEMA_T_STRING },
+    { "integer", JCONF_SCHEMA_T_INTEGER }
+};
+
+// A property of an object schema, hashed with jconf_map_key_hash.
+typedef struct _j_schema_name
+{
+    const char* name;
+    size_t len;
+    jHash hash;
+    size_t node;        // The schema of the value (JCONF_SCHEMA_NONE for any).
+    int required;
+
+} jSchemaName;
+
+// A compiled schema node.
+typedef struct _j_schema_node
+{
+    unsigned int types, checks;
+    double minimum, maximum, exclusive_minimum, exclusive_maximum;
+    size_t min_length, max_length, min_items, max_items, min_properties, max_properties;
+    const jToken* values;   // The enum array or const value.
+    size_t items;
+    jSchemaName* names;
+    size_t count;
+
+} jSchemaNode;
+
+// jSchema struct definition.
+struct _j_schema
+{
+    jSchemaNode* nodes;
+    size_t count, cap;
+
+};
+
+/**
+ * JConf Schema Fail
+ *
+ * Description: Records an error.
+ * @param[in]  {result} // The result.
+ * @param[out] {e}      // The error code.
+ * @param[out] {token}  // The failing token.
+ * @returns             // '0'
+ */
+static int jconf_schema_fail(jSchemaResult* result, jSchemaError e, const jToken* token)
+{
+    result->e = e;
+    result->token = token;
+    result->path[0] = 0;
+    return 0;
+}
+
+/**
+ * JConf Schema Prefix
+ *
+ * Description: Prepends a segment to the path of an error. Paths are built
+ *              while an error unwinds, so valid trees pay nothing for them.
+ *              The segment is escaped as in a JSON pointer.
+ * @param[in]  {result}  // The result.
+ * @param[out] {segment} // The segment (a key or index).
+ * @param[out] {length}  // The length of the segment.
+ */
+static void jconf_schema_prefix(jSchemaResult* result, const char* segment, size_t length)
+{
+    char escaped[JCONF_SCHEMA_PATH];
+    size_t i, n, old;
+
+    escaped[0] = '/';
+    for (i = 0, n = 1; i < length && n + 2 < JCONF_SCHEMA_PATH; i++)
+    {
+        if (segment[i] == '~' || segment[i] == '/')
+        {
+            escaped[n++] = '~';
+            escaped[n++] = segment[i] == '~' ? '0' : '1';
+        }
+        else
+            escaped[n++] = segment[i];
+    }
+
+    // Keep as much of the rest of the path as fits.
+    old = strlen(result->path);
+    if (n + old >= JCONF_SCHEMA_PATH)
+        old = JCONF_SCHEMA_PATH - 1 - n;
+
+    memmove(result->path + n, result->path, old);
+    memcpy(result->path, escaped, n);
+    result->path[n + old] = 0;
+}
+
+/**
+ * JConf Schema Prefix Index
+ *
+ * Description: Prepends an array index to the path of an error.
+ * @param[in]  {result} // The result.
+ * @param[out] {index}  // The index.
+ */
+static void jconf_schema_prefix_index(jSchemaResult* result, size_t index)
+{
+    char segment[24];
+    jconf_schema_prefix(result, segment, (size_t)sprintf(segment, "%zu", index));
+}
+
+/**
+ * JConf Schema Number
+ *
+ * Description: Reads a number token.
+ * @param[out] {token} // The token.
+ * @param[in]  {value} // Receives the number.
+ * @returns            // '1' if the token is a number.
+ */
+static __inline int jconf_schema_number(const jToken* token, double* value)
+{
+    if (token->type != JCONF_INT && token->type != JCONF_DOUBLE)
+        return 0;
+
+    *value = strtod((const char*)token->data, NULL);
+    return 1;
+}
+
+/**
+ * JConf Schema Size
+ *
+ * Description: Reads a non-negative integer token.
+ * @param[out] {token} // The token.
+ * @param[in]  {value} // Receives the integer.
+ * @returns            // '1' if the token is a non-negative integer.
+ */
+static int jconf_schema_size(const jToken* token, size_t* value)
+{
+    double number;
+
+    if (!jconf_schema_number(token, &number) || number < 0 || number != (double)(size_t)number)
+        return 0;
+
+    *value = (size_t)number;
+    return 1;
+}
+
+/**
+ * JConf Schema Length
+ *
+ * Description: Counts the characters of a string as stored by the parser,
+ *              where each escape sequence (or surrogate pair) is one
+ *              character and UTF-8 continuation bytes are not counted.
+ * @param[out] {str} // The string.
+ * @returns          // The number of characters.
+ */
+static size_t jconf_schema_length(const char* str)
+{
+    size_t n;
+
+    for (n = 0; *str; n++)
+    {
+        if (*str != '\\')
+        {
+            for (str++; ((unsigned char)*str & 0xC0) == 0x80; str++);
+            continue;
+        }
+
+        if (str[1] != 'u')
+        {
+            str += 2;
+            continue;
+        }
+
+        // A high surrogate followed by a low surrogate is one character.
+        if ((str[2] == 'd' || str[2] == 'D') && strchr("89abAB", str[3]) != NULL &&
+            str[6] == '\\' && str[7] == 'u')
+            str += 6;
+        str += 6;
+    }
+
+    return n;
+}
+
+/**
+ * JConf Schema Keyword
+ *
+ * Description: Looks up a schema keyword.
+ * @param[out] {key}    // The key.
+ * @param[out] {length} // The length of the key.
+ * @returns             // The keyword.
+ */
+static int jconf_schema_keyword(const char* key, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(jconf_schema_keywords) / sizeof(jconf_schema_keywords[0]); i++)
+        if (jconf_strlen(jconf_schema_keywords[i].name) == length && !jconf_strncmp(jconf_schema_keywords[i].name, key, length))
+            return jconf_schema_keywords[i].keyword;
+
+    return JCONF_SCHEMA_K_IGNORED;
+}
+
+/**
+ * JConf Schema Type
+ *
+ * Description: Reads a type name or an array of type names.
+ * @param[out] {token} // The type token.
+ * @param[in]  {types} // Receives the types.
+ * @returns            // '1' if the token names types.
+ */
+static int jconf_schema_type(const jToken* token, unsigned int* types)
+{
+    const jArray* arr;
+    unsigned int type;
+    size_t i;
+
+    if (token->type == JCONF_ARRAY)
+    {
+        arr = (const jArray*)token->data;
+        for (i = 0, *types = 0; arr != NULL && i < arr->end; i++)
+        {
+            if (!jconf_schema_type((const jToken*)jconf_array_get(arr, i), &type))
+                return 0;
+            *types |= type;
+        }
+        return 1;
+    }
+
+    if (token->type != JCONF_STRING)
+        return 0;
+
+    for (i = 0; i < sizeof(jconf_schema_types) / sizeof(jconf_schema_types[0]); i++)
+    {
+        if (!jconf_strcmp(jconf_schema_types[i].name, (const char*)token->data))
+        {
+            *types = jconf_schema_types[i].type;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Forward declarations.
+static int jconf_schema_compile_node(jSchema*, const jToken*, jSchemaResult*, size_t*);
+
+/**
+ * JConf Schema Compile Names
+ *
+ * Description: Compiles the properties and required names of an object
+ *              schema into one table, so that each is probed once.
+ * @param[in]  {schema}     // The schema.
+ * @param[out] {index}      // The node.
+ * @param[out] {properties} // The properties keyword (or NULL).
+ * @param[out] {required}   // The required keyword (or NULL).
+ * @param[in]  {result}     // The result.
+ * @returns                 // '1' if successful, '0' on error.
+ */
+static int jconf_schema_compile_names(jSchema* schema, size_t index, const jToken* properties, const jToken* required, jSchemaResult* result)
+{
+    const jMap* map = properties != NULL ? (const jMap*)properties->data : NULL;
+    const jArray* arr = required != NULL ? (const jArray*)required->data : NULL;
+    const jToken* name;
+    jSchemaName* names;
+    const jNode* node;
+    size_t i, j, n, child;
+
+    n = (map != NULL ? map->count : 0) + (arr != NULL ? arr->end : 0);
+    if (n == 0)
+        return 1;
+
+    if ((names = (jSchemaName*)jconf_malloc(NULL, n * sizeof(*names))) == NULL)
+        return jconf_schema_fail(result, JCONF_SCHEMA_OUT_OF_MEMORY, properties);
+
+    schema->nodes[index].names = names;
+
+    for (node = map != NULL ? map->first : NULL; node != NULL; node = node->after)
+    {
+        if (!jconf_schema_compile_node(schema, (const jToken*)node->value, result, &child))
+        {
+            jconf_schema_prefix(result, node->key, node->len);
+            jconf_schema_prefix(result, "properties", 10);
+            return 0;
+        }
+
+        // Object keys are hashed by the parser.
+        i = schema->nodes[index].count++;
+        names[i].name = node->key;
+        names[i].len = node->len;
+        names[i].hash = node->hash;
+        names[i].node = child;
+        names[i].required = 0;
+    }
+
+    for (j = 0; arr != NULL && j < arr->end; j++)
+    {
+        name = (const jToken*)jconf_array_get(arr, j);
+        n = jconf_strlen((const char*)name->data);
+
+        for (i = 0; i < schema->nodes[index].count; i++)
+            if (names[i].len == n && !jconf_strncmp(names[i].name, (const char*)name->data, n))
+                break;
+
+        if (i == schema->nodes[index].count)
+        {
+            schema->nodes[index].count++;
+            names[i].name = (const char*)name->data;
+            names[i].len = n;
+            names[i].hash = jconf_map_key_hash(names[i].name, n);
+            names[i].node = JCONF_SCHEMA_NONE;
+        }
+        names[i].required = 1;
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Schema Compile Node
+ *
+ * Description: Compiles a schema into a node and the nodes it refers to.
+ * @param[in]  {schema} // The schema.
+ * @param[out] {token}  // The schema value.
+ * @param[in]  {result} // The result.
+ * @param[in]  {index}  // Receives the index of the node.
+ * @returns             // '1' if successful, '0' on error.
+ */
+static int jconf_schema_compile_node(jSchema* schema, const jToken* token, jSchemaResult* result, size_t* index)
+{
+    const jToken *properties = NULL, *required = NULL, *value;
+    jSchemaNode* nodes;
+    const jArray* arr;
+    const jNode* member;
+    unsigned int types;
+    jSchemaNode* node;
+    size_t i, cap;
+    int ok;
+
+    // Grow the node table.
+    if (schema->count == schema->cap)
+    {
+        cap = schema->cap ? schema->cap * 2 : 16;
+        if ((nodes = (jSchemaNode*)jconf_realloc(NULL, schema->nodes, schema->cap * sizeof(*nodes), cap * sizeof(*nodes))) == NULL)
+            return jconf_schema_fail(result, JCONF_SCHEMA_OUT_OF_MEMORY, token);
+
+        schema->nodes = nodes;
+        schema->cap = cap;
+    }
+
+    *index = schema->count++;
+    node = &schema->nodes[*index];
+    memset(node, 0, sizeof(*node));
+    node->types = JCONF_SCHEMA_T_ANY;
+    node->items = JCONF_SCHEMA_NONE;
+
+    // Boolean schemas accept everything or nothing.
+    if (token->type == JCONF_TRUE || token->type == JCONF_FALSE)
+    {
+        node->types = token->type == JCONF_TRUE ? JCONF_SCHEMA_T_ANY : 0;
+        return 1;
+    }
+
+    if (token->type != JCONF_OBJECT)
+        return jconf_schema_fail(result, JCONF_SCHEMA_INVALID, token);
+
+    for (member = token->data != NULL ? ((const jMap*)token->data)->first : NULL; member != NULL; member = member->after)
+    {
+        value = (const jToken*)member->value;
+        node = &schema->nodes[*index];
+        ok = 1;
+
+        switch (jconf_schema_keyword(member->key, member->len))
+        {
+            case JCONF_SCHEMA_K_UNSUPPORTED:
+                jconf_schema_fail(result, JCONF_SCHEMA_UNSUPPORTED, value);
+                ok = 0;
+                break;
+
+            case JCONF_SCHEMA_K_TYPE:
+                if ((ok = jconf_schema_type(value, &types)))
+                    node->types = types;
+                break;
+
+            case JCONF_SCHEMA_K_ENUM:
+                if ((ok = value->type == JCONF_ARRAY))
+                {
+                    node->checks |= JCONF_SCHEMA_C_ENUM;
+                    node->values = value;
+                }
+                break;
+
+            case JCONF_SCHEMA_K_CONST:
+                node->checks |= JCONF_SCHEMA_C_CONST;
+                node->values = value;
+                break;
+
+            case JCONF_SCHEMA_K_PROPERTIES:
+                ok = value->type == JCONF_OBJECT;
+                properties = value;
+                break;
+
+            case JCONF_SCHEMA_K_REQUIRED:
+                ok = value->type == JCONF_ARRAY;
+                arr = (const jArray*)value->data;
+                for (i = 0; ok && arr != NULL && i < arr->end; i++)
+                    ok = ((const jToken*)jconf_array_get(arr, i))->type == JCONF_STRING;
+                required = value;
+                break;
+
+            case JCONF_SCHEMA_K_ITEMS:
+                // Tuple validation is outside the subset.
+                if (value->type == JCONF_ARRAY)
+                {
+                    jconf_schema_fail(result, JCONF_SCHEMA_UNSUPPORTED, value);
+                    ok = 0;
+                }
+                else if (!jconf_schema_compile_node(schema, value, result, &i))
+                    ok = 0;
+                else
+                    schema->nodes[*index].items = i;
+                break;
+
+            case JCONF_SCHEMA_K_MINIMUM:
+                node->checks |= JCONF_SCHEMA_C_MINIMUM;
+                ok = jconf_schema_number(value, &node->minimum);
+                break;
+
+            case JCONF_SCHEMA_K_MAXIMUM:
+                node->checks |= JCONF_SCHEMA_C_MAXIMUM;
+                ok = jconf_schema_number(value, &node->maximum);
+                break;
+
+            case JCONF_SCHEMA_K_EXCLUSIVE_MINIMUM:
+                node->checks |= JCONF_SCHEMA_C_EXCLUSIVE_MINIMUM;
+                ok = jconf_schema_number(value, &node->exclusive_minimum);
+                break;
+
+            case JCONF_SCHEMA_K_EXCLUSIVE_MAXIMUM:
+                node->checks |= JCONF_SCHEMA_C_EXCLUSIVE_MAXIMUM;
+                ok = jconf_schema_number(value, &node->exclusive_maximum);
+                break;
+
+            case JCONF_SCHEMA_K_MIN_LENGTH:
+                node->checks |= JCONF_SCHEMA_C_MIN_LENGTH;
+                ok = jconf_schema_size(value, &node->min_length);
+                break;
+
+            case JCONF_SCHEMA_K_MAX_LENGTH:
+                node->checks |= JCONF_SCHEMA_C_MAX_LENGTH;
+                ok = jconf_schema_size(value, &node->max_length);
+                break;
+
+            case JCONF_SCHEMA_K_MIN_ITEMS:
+                node->checks |= JCONF_SCHEMA_C_MIN_ITEMS;
+                ok = jconf_schema_size(value, &node->min_items);
+                break;
+
+            case JCONF_SCHEMA_K_MAX_ITEMS:
+                node->checks |= JCONF_SCHEMA_C_MAX_ITEMS;
+                ok = jconf_schema_size(value, &node->max_items);
+                break;
+
+            case JCONF_SCHEMA_K_MIN_PROPERTIES:
+                node->checks |= JCONF_SCHEMA_C_MIN_PROPERTIES;
+                ok = jconf_schema_size(value, &node->min_properties);
+                break;
+
+            case JCONF_SCHEMA_K_MAX_PROPERTIES:
+                node->checks |= JCONF_SCHEMA_C_MAX_PROPERTIES;
+                ok = jconf_schema_size(value, &node->max_properties);
+                break;
+        }
+
+        if (!ok)
+        {
+            // Errors from nested schemas are already recorded.
+            if (result->e == JCONF_SCHEMA_OK)
+                jconf_schema_fail(result, JCONF_SCHEMA_INVALID, value);
+
+            jconf_schema_prefix(result, member->key, member->len);
+            return 0;
+        }
+    }
+
+    return jconf_schema_compile_names(schema, *index, properties, required, result);
+}
+
+/**
+ * JConf Schema Compile
+ *
+ * Description: Compiles a schema tree. The compiled schema refers to the
+ *              schema tree, which must outlive it.
+ * @param[out] {root}   // The schema tree.
+ * @param[in]  {result} // Receives the error (may be NULL).
+ * @returns             // The compiled schema (NULL on error).
+ */
+jSchema* jconf_schema_compile(const jToken* root, jSchemaResult* result)
+{
+    jSchemaResult local;
+    jSchema* schema;
+    size_t index;
+
+    if (result == NULL)
+        result = &local;
+
+    result->e = JCONF_SCHEMA_OK;
+    result->token = NULL;
+    result->path[0] = 0;
+
+    if (root == NULL)
+    {
+        jconf_schema_fail(result, JCONF_SCHEMA_INVALID, root);
+        return NULL;
+    }
+
+    if ((schema = (jSchema*)jconf_malloc(NULL, sizeof(*schema))) == NULL)
+    {
+        jconf_schema_fail(result, JCONF_SCHEMA_OUT_OF_MEMORY, root);
+        return NULL;
+    }
+
+    schema->nodes = NULL;
+    schema->count = schema->cap = 0;
+
+    if (!jconf_schema_compile_node(schema, root, result, &index))
+    {
+        jconf_schema_free(schema);
+        return NULL;
+    }
+
+    return schema;
+}
+
+/**
+ * JConf Schema Free
+ *
+ * Description: Frees a compiled schema.
+ * @param[in] {schema} // The compiled schema.
+ */
+void jconf_schema_free(jSchema* schema)
+{
+    size_t i;
+
+    if (schema == NULL)
+        return;
+
+    for (i = 0; i < schema->count; i++)
+        jconf_free(NULL, schema->nodes[i].names);
+
+    jconf_free(NULL, schema->nodes);
+    jconf_free(NULL, schema);
+}
+
+/**
+ * JConf Schema Check Node
+ *
+ * Description: Checks a value against a compiled node.
+ * @param[out] {schema} // The compiled schema.
+ * @param[out] {index}  // The node.
+ * @param[out] {token}  // The value.
+ * @param[in]  {result} // The result.
+ * @returns             // '1' if the value is valid.
+ */
+static int jconf_schema_check_node(const jSchema* schema, size_t index, const jToken* token, jSchemaResult* result)
+{
+    const jSchemaNode* node = &schema->nodes[index];
+    const jToken* value;
+    const jArray* arr;
+    const jMap* map;
+    unsigned int type;
+    double number;
+    size_t i, n;
+
+    // Types.
+    switch (token->type)
+    {
+        case JCONF_NULL:   type = JCONF_SCHEMA_T_NULL; break;
+        case JCONF_OBJECT: type = JCONF_SCHEMA_T_OBJECT; break;
+        case JCONF_ARRAY:  type = JCONF_SCHEMA_T_ARRAY; break;
+        case JCONF_STRING: type = JCONF_SCHEMA_T_STRING; break;
+        case JCONF_INT:    type = JCONF_SCHEMA_T_NUMBER | JCONF_SCHEMA_T_INTEGER; break;
+        case JCONF_DOUBLE:
+            // Numbers with a zero fraction are integers.
+            number = strtod((const char*)token->data, NULL);
+            type = JCONF_SCHEMA_T_NUMBER;
+            if (number > -9.2e18 && number < 9.2e18 && number == (double)(long long)number)
+                type |= JCONF_SCHEMA_T_INTEGER;
+            break;
+        default:           type = JCONF_SCHEMA_T_BOOLEAN; break;
+    }
+
+    if (!(node->types & type))
+        return jconf_schema_fail(result, JCONF_SCHEMA_TYPE, token);
+
+    // Enum and const.
+    if (node->checks & JCONF_SCHEMA_C_CONST)
+    {
+        if (!jconf_equal(token, node->values))
+            return jconf_schema_fail(result, JCONF_SCHEMA_ENUM, token);
+    }
+    else if (node->checks & JCONF_SCHEMA_C_ENUM)
+    {
+        arr = (const jArray*)node->values->data;
+        for (i = 0, n = arr != NULL ? arr->end : 0; i < n; i++)
+            if (jconf_equal(token, (const jToken*)jconf_array_get(arr, i)))
+                break;
+
+        if (i == n)
+            return jconf_schema_fail(result, JCONF_SCHEMA_ENUM, token);
+    }
+
+    switch (token->type)
+    {
+        case JCONF_INT:
+        case JCONF_DOUBLE:
+            if (!(node->checks & JCONF_SCHEMA_C_NUMBER))
+                break;
+
+            number = strtod((const char*)token->data, NULL);
+            if (((node->checks & JCONF_SCHEMA_C_MINIMUM) && number < node->minimum) ||
+                ((node->checks & JCONF_SCHEMA_C_EXCLUSIVE_MINIMUM) && number <= node->exclusive_minimum))
+                return jconf_schema_fail(result, JCONF_SCHEMA_MINIMUM, token);
+
+            if (((node->checks & JCONF_SCHEMA_C_MAXIMUM) && number > node->maximum) ||
+                ((node->checks & JCONF_SCHEMA_C_EXCLUSIVE_MAXIMUM) && number >= node->exclusive_maximum))
+                return jconf_schema_fail(result, JCONF_SCHEMA_MAXIMUM, token);
+            break;
+
+        case JCONF_STRING:
+            if (!(node->checks & (JCONF_SCHEMA_C_MIN_LENGTH | JCONF_SCHEMA_C_MAX_LENGTH)))
+                break;
+
+            n = jconf_schema_length((const char*)token->data);
+            if ((node->checks & JCONF_SCHEMA_C_MIN_LENGTH) && n < node->min_length)
+                return jconf_schema_fail(result, JCONF_SCHEMA_MIN_LENGTH, token);
+            if ((node->checks & JCONF_SCHEMA_C_MAX_LENGTH) && n > node->max_length)
+                return jconf_schema_fail(result, JCONF_SCHEMA_MAX_LENGTH, token);
+            break;
+
+        case JCONF_ARRAY:
+            arr = (const jArray*)token->data;
+            n = arr != NULL ? arr->end : 0;
+
+            if ((node->checks & JCONF_SCHEMA_C_MIN_ITEMS) && n < node->min_items)
+                return jconf_schema_fail(result, JCONF_SCHEMA_MIN_ITEMS, token);
+            if ((node->checks & JCONF_SCHEMA_C_MAX_ITEMS) && n > node->max_items)
+                return jconf_schema_fail(result, JCONF_SCHEMA_MAX_ITEMS, token);
+
+            for (i = 0; node->items != JCONF_SCHEMA_NONE && i < n; i++)
+            {
+                if (!jconf_schema_check_node(schema, node->items, (const jToken*)jconf_array_get(arr, i), result))
+                {
+                    jconf_schema_prefix_index(result, i);
+                    return 0;
+                }
+            }
+            break;
+
+        case JCONF_OBJECT:
+            map = (const jMap*)token->data;
+            n = map != NULL ? map->count : 0;
+
+            if ((node->checks & JCONF_SCHEMA_C_MIN_PROPERTIES) && n < node->min_properties)
+                return jconf_schema_fail(result, JCONF_SCHEMA_MIN_PROPERTIES, token);
+            if ((node->checks & JCONF_SCHEMA_C_MAX_PROPERTIES) && n > node->max_properties)
+                return jconf_schema_fail(result, JCONF_SCHEMA_MAX_PROPERTIES, token);
+
+            // One pre-hashed probe per property.
+            for (i = 0; i < node->count; i++)
+            {
+                value = map != NULL ? (const jToken*)jconf_map_get_hashed(map, node->names[i].name, node->names[i].len, node->names[i].hash) : NULL;
+
+                if (value == NULL)
+                {
+                    if (!node->names[i].required)
+                        continue;
+
+                    // The path names the missing member.
+                    jconf_schema_fail(result, JCONF_SCHEMA_REQUIRED, token);
+                }
+                else if (node->names[i].node == JCONF_SCHEMA_NONE ||
+                         jconf_schema_check_node(schema, node->names[i].node, value, result))
+                    continue;
+
+                jconf_schema_prefix(result, node->names[i].name, node->names[i].len);
+                return 0;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return 1;
+}
+
+/**
+ * JConf Schema Check
+ *
+ * Description: Checks a tree against a compiled schema.
+ * @param[out] {schema} // The compiled schema.
+ * @param[out] {root}   // The tree.
+ * @param[in]  {result} // Receives the first error (may be NULL).
+ * @returns             // '1' if the tree is valid, '0' otherwise.
+ */
+int jconf_schema_check(const jSchema* schema, const jToken* root, jSchemaResult* result)
+{
+    jSchemaResult local;
+
+    if (result == NULL)
+        result = &local;
+
+    result->e = JCONF_SCHEMA_OK;
+    result->token = NULL;
+    result->path[0] = 0;
+
+    if (root == NULL)
+        return jconf_schema_fail(result, JCONF_SCHEMA_TYPE, root);
+
+    return jconf_schema_check_node(schema, 0, root, result);
+}
@@ -20,7 +20,7 @@
  * @param[out] {length} // The number of characters to compare.
  * @returns // 0 if equal, -1 if lhs is smaller, 1 if rhs is smaller.
  */
-int jconf_strncmp(const char* a, const char* b, int length)
+int jconf_strncmp(const char* a, const char* b, size_t length)
 {
     const char *p, *q;
 
@@ -54,7 +54,7 @@ int jconf_strncmp(const char* a, const char* b, int length)
  */
 int jconf_strcmp(const char* a, const char* b)
 {
-    return jconf_strncmp(a, b, -1);
+    return jconf_strncmp(a, b, (size_t)-1);
 }
 
 /**
@@ -66,7 +66,7 @@ int jconf_strcmp(const char* a, const char* b)
  * @param[out] {src}    // The source string.
  * @param[out] {length} // The length of the source buffer.
  */
-void jconf_strncpy(char* dest, const char* src, int length)
+void jconf_strncpy(char* dest, const char* src, size_t length)
 {
     char* p = (char*)src;
     while (length > 0 && *p != '\0')
@@ -83,9 +83,9 @@ void jconf_strncpy(char* dest, const char* src, int length)
  * @param[out] {src}         // The source string.
  * @returns[out]             // The length of the source buffer.
  */
-int jconf_strlen(const char* src)
+size_t jconf_strlen(const char* src)
 {
     char* p = (char*)src;
     while (*p != '\0') p++;
-    return p - src;
+    return (size_t)(p - src);
 }
\ No newline at end of file
@@ -10,13 +10,30 @@
  */
 
 #include <jconf/parser.h>
+#include <jconf/image.h>
+#include <jconf/cbor.h>
+#include <jconf/document.h>
+#include <jconf/context.h>
+#include <jconf/batch.h>
+#include <jconf/schema.h>
+#include <jconf/bind.h>
+#include <jconf/cursor.h>
+#include <jconf/patch.h>
+#include <jconf/diff.h>
+#include <jconf/hash.h>
+#include <jconf/merge.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 #if defined(_WIN32) || defined(WIN32)
     #include <windows.h>
 #elif defined(__unix__)
     #include <unistd.h>
+    #include <pthread.h>
+    #include <sys/mman.h>
     #define Sleep(x) usleep((x)*1000)
 #endif
 
@@ -30,6 +47,19 @@ enum JCONF_TESTS
     TEST_JCONF_ARRAY,
     TEST_JCONF_MAP,
     TEST_JCONF_PARSER,
+    TEST_JCONF_IMAGE,
+    TEST_JCONF_CBOR,
+    TEST_JCONF_DOCUMENT,
+    TEST_JCONF_CONTEXT,
+    TEST_JCONF_ALLOC,
+    TEST_JCONF_LARGE,
+    TEST_JCONF_VALIDATE,
+    TEST_JCONF_SCHEMA,
+    TEST_JCONF_BIND,
+    TEST_JCONF_PATCH,
+    TEST_JCONF_DIFF,
+    TEST_JCONF_HASH,
+    TEST_JCONF_MERGE,
     TEST_JCONF_COUNT
 };
 
@@ -38,6 +68,19 @@ int test_string(void);
 int test_array(void);
 int test_map(void);
 int test_parser(void);
+int test_image(void);
+int test_cbor(void);
+int test_document(void);
+int test_context(void);
+int test_alloc(void);
+int test_large(void);
+int test_validate(void);
+int test_schema(void);
+int test_bind(void);
+int test_patch(void);
+int test_diff(void);
+int test_hash(void);
+int test_merge(void);
 
 // Result string array.
 const char* jconf_test_result[] = {
@@ -49,7 +92,20 @@ const char* jconf_tests_str[] = {
     "Test JConf String Functions",
     "Test JConf Array",
     "Test JConf Map",
-    "Test JConf Parser"
+    "Test JConf Parser",
+    "Test JConf Image",
+    "Test JConf CBOR",
+    "Test JConf Document",
+    "Test JConf Parser Context",
+    "Test JConf Allocators",
+    "Test JConf Large Documents",
+    "Test JConf Validate",
+    "Test JConf Schema",
+    "Test JConf Bind",
+    "Test JConf Patch",
+    "Test JConf Diff",
+    "Test JConf Hash",
+    "Test JConf Merge"
 };
 
 // Array of function pointers for tests.
@@ -57,7 +113,20 @@ int(*jconf_tests[])() = {
     &test_string,
     &test_array,
     &test_map,
-    &test_parser
+    &test_parser,
+    &test_image,
+    &test_cbor,
+    &test_document,
+    &test_context,
+    &test_alloc,
+    &test_large,
+    &test_validate,
+    &test_schema,
+    &test_bind,
+    &test_patch,
+    &test_diff,
+    &test_hash,
+    &test_merge
 };
 
 /**
@@ -238,9 +307,12 @@ failure:
 // ARRAY TEST CASE
 int test_array(void)
 {
+    const char* json = "[0, 1, 2, 3, 4, 5, \"6,\\\"7\", 8, 9, 10]";
     int i, *rtn, size, expand;
     int values[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
-    jArray arr;
+    jArray arr, *parsed;
+    jToken* head;
+    jArgs args;
 
     rtn = NULL;
     expand = 2;
@@ -317,8 +389,45 @@ int test_array(void)
         )) goto failure;
 
     logger(PASS, "Test popping elements\n");
+    jconf_destroy_array(&arr);
+
+    /**
+    * Test inline storage and reserving capacity.
+    */
+    jconf_init_array(&arr, 1, expand);
+
+    for (i = 0; i < JCONF_ARRAY_INLINE; i++)
+        jconf_array_push(&arr, (void*)&values[i]);
+
+    // Assert that small arrays do not allocate.
+    if (!assert(
+        arr.values == arr.inline_values && arr.end == JCONF_ARRAY_INLINE && jconf_array_get(&arr, i) == NULL,
+        "Assert 6: Small array was not stored inline."
+        )) goto failure;
+
+    jconf_array_reserve(&arr, 1000);
+    rtn = (int*)jconf_array_get(&arr, JCONF_ARRAY_INLINE - 1);
+
+    // Assert that reserving moves the elements to a buffer of the requested size.
+    if (!assert(
+        arr.values != arr.inline_values && arr.size == 1000 && rtn != NULL && *rtn == values[JCONF_ARRAY_INLINE - 1],
+        "Assert 7: Failed to reserve capacity."
+        )) goto failure;
 
     jconf_destroy_array(&arr);
+
+    head = jconf_json2c(json, jconf_strlen(json), &args);
+    parsed = head != NULL ? (jArray*)head->data : NULL;
+
+    // Assert that flat arrays are sized from the input.
+    if (!assert(
+        parsed != NULL && parsed->size == 10 && parsed->end == 10,
+        "Assert 8: Parsed array was not pre-sized."
+        )) goto failure;
+
+    jconf_free_token(head);
+    logger(PASS, "Test inline storage and reserving capacity\n");
+
     tear_down();
     return PASS;
 
@@ -332,8 +441,12 @@ int test_map(void)
 {
     const char *key1, *key2, *key3, *key4;
     const char *value1, *value2, *temp;
-    jNode entry;
+    static char keys[1000][24], flood[256][32];
+    jNode entry, *node;
+    jHash hashes[2];
+    uint64_t seed;
     jMap map;
+    int i, j, probes;
 
     key1 = "Key1";
     key2 = "Key2";
@@ -379,8 +492,105 @@ int test_map(void)
 
     logger(PASS, "Test deleting map entries.\n");
 
+    /**
+    * Test exact and hashed lookups.
+    */
+
+    jconf_map_set(&map, "name", 4, (void*)value1, NULL);
+    jconf_map_set(&map, "na", 2, (void*)value2, NULL);
+
+    if (!assert(jconf_map_get(&map, "na") == value2 && jconf_map_get(&map, "name") == value1 && map.count == 4,
+        "Assert 7: A key matched a prefix of another key.")) goto failure;
+    if (!assert(jconf_map_get(&map, "n") == NULL && jconf_map_get(&map, "names") == NULL,
+        "Assert 8: A missing key was found.")) goto failure;
+
+    if (!assert(jconf_map_get_n(&map, "name\"", 4) == value1 && jconf_map_get_n(&map, "names", 2) == value2,
+        "Assert 9: Lookup with a key length failed.")) goto failure;
+    if (!assert(jconf_map_get_hashed(&map, "name", 4, jconf_map_key_hash("name", 4)) == value1,
+        "Assert 10: Lookup with a precomputed hash failed.")) goto failure;
+
+    logger(PASS, "Test exact and hashed lookups.\n");
+
+    /**
+    * Test growing the buckets.
+    */
+
+    for (i = 0; i < 1000; i++)
+    {
+        sprintf(keys[i], "generated key %d", i);
+        jconf_map_set(&map, keys[i], jconf_strlen(keys[i]), (void*)keys[i], NULL);
+    }
+
+    for (i = 0; i < 1000; i++)
+        if (!assert(jconf_map_get(&map, keys[i]) == keys[i], "Assert 11: Key %d was lost when the buckets grew.", i)) goto failure;
+
+    if (!assert(map.count == 1004 && map.size >= map.count && (map.size & (map.size - 1)) == 0,
+        "Assert 12: The buckets are not a power of two sized for the count.")) goto failure;
+    if (!assert(jconf_map_hash(keys[1], 15) == jconf_map_hash("generated key 1", 15) && jconf_map_seed() != 0,
+        "Assert 13: The hash is not stable.")) goto failure;
+
+    jconf_map_delete(&map, &entry, keys[999]);
+    jconf_map_delete(&map, &entry, key1);
+
+    for (i = 0, node = map.first; node != NULL; node = node->after, i++)
+        if (!assert(node->value == (i < 2 ? (void*)value1 : (i == 2 ? (void*)value2 : (void*)keys[i - 3])),
+            "Assert 14: Entry %d is out of insertion order.", i)) goto failure;
+
+    if (!assert(i == map.count && map.last->value == keys[998], "Assert 15: Deleting broke the insertion order.")) goto failure;
+
+    logger(PASS, "Test growing the buckets [%zu buckets].\n", map.size);
+
+    jconf_destroy_map(&map);
+
+    /**
+    * Test keys whose first block cancels a hash secret.
+    */
+    jconf_init_map(&map);
+
+    for (i = 0; i < 256; i++)
+    {
+        // The first eight bytes are the secret P1 in little endian order.
+        memcpy(flood[i], "\xC9\xAC\x2E\x96\x93\x4B\xB8\x8B", 8);
+        sprintf(flood[i] + 8, "%08d", i);
+        memcpy(flood[i] + 16, "flooded tail key", 16);
+        jconf_map_set(&map, flood[i], 32, (void*)flood[i], NULL);
+    }
+
+    for (i = 0; i < 256; i++)
+        for (j = 0; j < i; j++)
+            if (!assert(jconf_map_hash(flood[i], 32) != jconf_map_hash(flood[j], 32),
+                "Assert 16: Keys %d and %d collided.", i, j)) goto failure;
+
+    for (i = 0, probes = 0; i < 256; i++)
+        if (jconf_map_probe(&map, flood[i], 32) > probes)
+            probes = jconf_map_probe(&map, flood[i], 32);
+
+    if (!assert(probes < 12 && jconf_map_get_n(&map, flood[255], 32) == flood[255],
+        "Assert 17: The keys share a chain [%d entries].", probes)) goto failure;
+
+    logger(PASS, "Test keys that cancel a secret [%d probes].\n", probes);
+
+    /**
+    * Test that the seed enters the key hash.
+    */
+    i = map.first->hash == jconf_map_key_hash(flood[0], 32);
     jconf_destroy_map(&map);
 
+    // Keys that collide under one seed are hashed apart under another.
+    seed = jconf_map_seed();
+    jconf_map_set_seed(1);
+    hashes[0] = jconf_map_key_hash(flood[0], 32);
+    hashes[1] = jconf_map_key_hash(flood[1], 32);
+    jconf_map_set_seed(2);
+    i = i && hashes[0] != jconf_map_key_hash(flood[0], 32) &&
+        (hashes[0] ^ hashes[1]) != (jconf_map_key_hash(flood[0], 32) ^ jconf_map_key_hash(flood[1], 32)) &&
+        jconf_map_hash(flood[0], 32) != hashes[0];
+    jconf_map_set_seed(seed);
+
+    if (!assert(i, "Assert 18: The key hash does not depend on the seed.")) goto failure;
+
+    logger(PASS, "Test seeded key hashes.\n");
+
     tear_down();
     return PASS;
 
@@ -392,7 +602,13 @@ failure:
 // PARSER TEST CASE
 int test_parser(void)
 {
+    jParseOptions options;
     jToken *head, *token;
+    jObjectIter members;
+    jArrayIter elements;
+    jParseStats stats;
+    const char* key;
+    size_t keylen;
     jArgs args;
     jArray *arr;
     int length;
@@ -453,7 +669,7 @@ int test_parser(void)
     free(json);
     jconf_free_token(head);
 
-    logger(PASS, "Test parsing test_one.json [%d lines] (simple valid example).\n", args.line);
+    logger(PASS, "Test parsing test_one.json [%zu lines] (simple valid example).\n", args.line);
 
     /**
     * Test large valid JSON.
@@ -470,7 +686,7 @@ int test_parser(void)
     free(json);
     jconf_free_token(head);
 
-    logger(PASS, "Test parsing test_two.json [%d lines] (large valid example).\n", args.line);
+    logger(PASS, "Test parsing test_two.json [%zu lines] (large valid example).\n", args.line);
 
     /**
     * Test simple invalid JSON.
@@ -484,7 +700,9 @@ int test_parser(void)
         "Assert 17: Unexpected token error not caught while parsing."
         )) goto failure;
 
-    logger(PASS, "Test parsing test_three.json [error on line %d] (large invalid example).\n", args.line);
+    free(json);
+
+    logger(PASS, "Test parsing test_three.json [error on line %zu] (large invalid example).\n", args.line);
 
     /**
      * Test large invalid JSON.
@@ -494,14 +712,2646 @@ int test_parser(void)
 
     head = jconf_json2c(json, length, &args);
     if (!assert(
-        head == NULL && args.e == JCONF_UNEXPECTED_TOK && args.line == 12800,
-        "Assert 19: Unexpected token error not caught while parsing."
+        head == NULL && args.e == JCONF_UNEXPECTED_TOK && args.line == 12801,
+        "Assert 19: Unexpected token error not caught while parsing [error %d, line %zu].", args.e, args.line
+        )) goto failure;
+
+    free(json);
+    jconf_free_token(head);
+
+    logger(PASS, "Test parsing test_four.json [error on line %zu] (large invalid example).\n", args.line);
+
+    /**
+     * Test iterating in document order.
+     */
+    json = "{\"z\": 1, \"a\": [true, null, \"s\"], \"m\": {}, \"b\": 2, \"a\": [0]}";
+    head = jconf_json2c(json, jconf_strlen(json), &args);
+
+    length = 0;
+    jconf_object_iter_begin(head, &members);
+    while (jconf_object_iter_next(&members, &key, &keylen, &token))
+    {
+        if (!assert(keylen == 1 && key[0] == "zamb"[length] && token != NULL,
+            "Assert 20: Member %d was not visited in document order.", length)) goto failure;
+        length++;
+    }
+
+    if (!assert(length == 4, "Assert 21: Expected 4 members, visited %d.", length)) goto failure;
+
+    length = 0;
+    jconf_array_iter_begin(jconf_get(head, "o", "a"), &elements);
+    while (jconf_array_iter_next(&elements, &token))
+        length++;
+
+    jconf_array_iter_begin(head, &elements);
+    jconf_object_iter_begin(jconf_get(head, "o", "m"), &members);
+    if (!assert(length == 1 && !jconf_array_iter_next(&elements, &token) && !jconf_object_iter_next(&members, NULL, NULL, NULL) &&
+        jconf_get(head, "oo", "m", "x") == NULL, "Assert 22: Array elements were not iterated.")) goto failure;
+
+    jconf_free_token(head);
+    logger(PASS, "Test iterating in document order.\n");
+
+    /**
+     * Test parse statistics.
+     */
+    json = "{\"a\": [1, 2.5, \"x\\ny\"], \"b\": {\"c\": [true, false, null, [\"\"]]}}";
+    memset(&stats, 0xFF, sizeof(stats));
+    options.allocator = NULL;
+    options.stats = &stats;
+    options.duplicates = JCONF_DUP_LAST_WINS;
+    options.mode = JCONF_MODE_DEFAULT;
+    options.hash = 0;
+
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    if (!assert(head != NULL, "Assert 23: The document was not parsed with options.")) goto failure;
+
+#ifdef JCONF_STATS
+    if (!assert(
+        stats.tokens[JCONF_OBJECT] == 2 && stats.tokens[JCONF_ARRAY] == 3 && stats.tokens[JCONF_STRING] == 2 &&
+        stats.tokens[JCONF_INT] == 1 && stats.tokens[JCONF_DOUBLE] == 1 && stats.tokens[JCONF_TRUE] == 1 &&
+        stats.max_depth == 3 && stats.escapes == 1 && stats.string_bytes == 7 && stats.map_inserts == 3 &&
+        stats.allocs > 0 && stats.time_total > 0,
+        "Assert 24: Parse statistics were not collected."
         )) goto failure;
 
+    logger(PASS, "Test parse statistics [%d allocations, %d bytes].\n", (int)stats.allocs, (int)stats.alloc_bytes);
+#else
+    if (!assert(stats.max_depth == -1, "Assert 24: Parse statistics were collected without JCONF_STATS.")) goto failure;
+
+    logger(PASS, "Test parse statistics are compiled out.\n");
+#endif
+
+    jconf_free_token(head);
+
+    /**
+     * Test duplicate key policies.
+     */
+    json = "{\"a\": 1, \"b\": 2,\n \"a\": \"x\", \"a\": [3]}";
+    options.stats = NULL;
+
+    options.duplicates = JCONF_DUP_FIRST_WINS;
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    token = jconf_get(head, "o", "a");
+    if (!assert(head != NULL && token != NULL && token->type == JCONF_INT && ((jMap*)head->data)->count == 2,
+        "Assert 25: The first value was not kept.")) goto failure;
+    jconf_free_token(head);
+
+    options.duplicates = JCONF_DUP_LAST_WINS;
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    token = jconf_get(head, "o", "a");
+    if (!assert(head != NULL && token != NULL && token->type == JCONF_ARRAY && ((jMap*)head->data)->count == 2,
+        "Assert 26: The last value was not kept.")) goto failure;
+    jconf_free_token(head);
+
+    options.duplicates = JCONF_DUP_ERROR;
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    if (!assert(head == NULL && args.e == JCONF_DUPLICATE_KEY && args.line == 2 && args.pos == 18,
+        "Assert 27: Duplicate key not reported [line %zu, pos %zu].", args.line, args.pos)) goto failure;
+
+    options.duplicates = JCONF_DUP_KEEP_ALL;
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    token = jconf_get(head, "o", "a");
+    if (!assert(head != NULL && token != NULL && token->type == JCONF_ARRAY && ((jMap*)head->data)->count == 4,
+        "Assert 28: Repeated members were not kept.")) goto failure;
+
+    length = 0;
+    jconf_object_iter_begin(head, &members);
+    while (jconf_object_iter_next(&members, &key, NULL, &token))
+        if (key[0] == 'a' && token->type == "\7\5\3"[length])
+            length++;
+
+    if (!assert(length == 3, "Assert 29: Repeated members were not visited in document order.")) goto failure;
+    jconf_free_token(head);
+
+    json = "{\"a\": 1, \"b\": {\"c\": null}}";
+    options.duplicates = JCONF_DUP_TRUSTED;
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    token = jconf_get(head, "oo", "b", "c");
+    if (!assert(token != NULL && token->type == JCONF_NULL, "Assert 30: Trusted input was not parsed.")) goto failure;
+    jconf_free_token(head);
+
+    logger(PASS, "Test duplicate key policies.\n");
+
+    /**
+     * Test strict mode.
+     */
+    options.duplicates = JCONF_DUP_LAST_WINS;
+    options.mode = JCONF_MODE_STRICT;
+
+    json = " 42\n";
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    if (!assert(head != NULL && head->type == JCONF_INT && !jconf_strcmp((char*)head->data, "42"),
+        "Assert 31: A scalar root was not parsed in strict mode.")) goto failure;
+    jconf_free_token(head);
+
+    json = "[1e3, -0.5E+2, 0, \"\\u00e9\"]";
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    token = jconf_get(head, "a", 0);
+    if (!assert(head != NULL && token->type == JCONF_DOUBLE && jconf_get(head, "a", 1)->type == JCONF_DOUBLE,
+        "Assert 32: Valid numbers were rejected in strict mode.")) goto failure;
+    jconf_free_token(head);
+
+    {
+        static const char* invalid[] = {
+            "[1.]", "[-]", "[1.e5]", "[1e+]", "[\"a\tb\"]", "{\"a\": 1} // c", "/* c */ {}", "[tru", "{\"a\": 1,}", "[1] 2"
+        };
+        static const J_ERROR_CODE errors[] = {
+            JCONF_INVALID_NUMBER, JCONF_INVALID_NUMBER, JCONF_INVALID_NUMBER, JCONF_INVALID_NUMBER, JCONF_UNEXPECTED_TOK,
+            JCONF_EXPECTED_EOF, JCONF_INVALID_NUMBER, JCONF_INVALID_NUMBER, JCONF_UNEXPECTED_TOK, JCONF_EXPECTED_EOF
+        };
+        int i;
+
+        for (i = 0; i < (int)(sizeof(invalid) / sizeof(invalid[0])); i++)
+        {
+            head = jconf_json2c_ex(invalid[i], jconf_strlen(invalid[i]), &options, &args);
+            if (!assert(head == NULL && args.e == errors[i],
+                "Assert 33: Strict mode accepted %s [error %d].", invalid[i], args.e)) goto failure;
+        }
+    }
+
+    // The default mode keeps accepting comments and loose numbers.
+    options.mode = JCONF_MODE_DEFAULT;
+    json = "/* c */ [1., \"a\tb\"] // c";
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    if (!assert(head != NULL, "Assert 34: The default mode rejected comments.")) goto failure;
+    jconf_free_token(head);
+
+    logger(PASS, "Test strict mode.\n");
+
+    /**
+     * Test relaxed mode.
+     */
+    options.mode = JCONF_MODE_RELAXED;
+    json = "{\n  // Service.\n  name: 'web', \"port\": 80,\n  hosts: ['a', \"b\",],\n  $tls: {'on': true, note: 'it\\'s \"on\"',},\n}";
+
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    if (!assert(head != NULL, "Assert 35: The config was not parsed in relaxed mode [error %d, line %zu].", args.e, args.line)) goto failure;
+
+    token = jconf_get(head, "oa", "hosts", 1);
+    if (!assert(
+        !jconf_strcmp((char*)jconf_get(head, "o", "name")->data, "web") && token != NULL &&
+        !jconf_strcmp((char*)token->data, "b") && ((jArray*)jconf_get(head, "o", "hosts")->data)->end == 2 &&
+        jconf_get(head, "oo", "$tls", "on")->type == JCONF_TRUE && jconf_get(head, "o", "port")->type == JCONF_INT &&
+        !jconf_strcmp((char*)jconf_get(head, "oo", "$tls", "note")->data, "it\\'s \"on\""),
+        "Assert 36: The relaxed config was not parsed correctly.")) goto failure;
+    jconf_free_token(head);
+
+    options.mode = JCONF_MODE_DEFAULT;
+    head = jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+    if (!assert(head == NULL && args.e == JCONF_UNEXPECTED_TOK && args.line == 3,
+        "Assert 37: The default mode accepted an unquoted key [error %d, line %zu].", args.e, args.line)) goto failure;
+
+    logger(PASS, "Test relaxed mode.\n");
+
+    tear_down();
+    return PASS;
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+// IMAGE TEST CASE
+int test_image(void)
+{
+    jToken *head;
+    jImageRef ref;
+    jImage image;
+    char *json, *copy;
+    uint32_t* words;
+    const char* str;
+    size_t size;
+    uint32_t len;
+    int length;
+    void* data;
+    jArgs args;
+
+    set_up(TEST_JCONF_IMAGE);
+
+    json = load_file("test/test_one.json", &length);
+    if (!assert(json != NULL, "Assert 1: Error reading test_one.json.")) goto failure;
+
+    head = jconf_json2c(json, length, &args);
+    if (!assert(head != NULL, "Assert 2: The valid JSON file was not parsed correctly.")) goto failure;
+
+    /**
+    * Test writing an image.
+    */
+    size = jconf_image_size(head);
+    data = malloc(size);
+
+    if (!assert(size > 0 && jconf_image_write(head, data, size) == size, "Assert 3: The image was not written.")) goto failure;
+    if (!assert(jconf_image_write(head, data, size - 4) == 0, "Assert 4: Writing to a small buffer should fail.")) goto failure;
+
+    free(json);
+    jconf_free_token(head);
+
+    logger(PASS, "Test writing an image.\n");
+
+    /**
+    * Test querying a relocated image.
+    */
+    copy = (char*)malloc(size);
+    memcpy(copy, data, size);
+    memset(data, 0, size);
+    free(data);
+
+    if (!assert(jconf_image_open(&image, copy, size), "Assert 5: The image was not opened.")) goto failure;
+
+    ref = jconf_image_get(&image, jconf_image_root(&image), "oo", "glossary", "title");
+    str = jconf_image_string(&image, ref, &len);
+    if (!assert(str != NULL && len == 16 && jconf_strcmp(str, "example glossary") == 0, "Assert 6: String value not correctly obtained.")) goto failure;
+
+    ref = jconf_image_get(&image, jconf_image_root(&image), "oooooo", "glossary", "GlossDiv", "GlossList", "GlossEntry", "GlossDef", "GlossSeeAlso");
+    if (!assert(jconf_image_type(&image, ref) == JCONF_ARRAY && jconf_image_count(&image, ref) == 2, "Assert 7: Nested array not encoded correctly.")) goto failure;
+
+    str = jconf_image_string(&image, jconf_image_index(&image, ref, 1), NULL);
+    if (!assert(str != NULL && jconf_strcmp(str, "XML") == 0, "Assert 8: Array values not encoded correctly.")) goto failure;
+
+    ref = jconf_image_get(&image, jconf_image_root(&image), "oo", "glossary", "titl");
+    if (!assert(ref == 0, "Assert 9: Missing keys should not be found.")) goto failure;
+
+    if (!assert(jconf_image_index(&image, jconf_image_root(&image), 0) == 0, "Assert 10: Objects should not be indexed.")) goto failure;
+
+    logger(PASS, "Test querying a relocated image.\n");
+
+    /**
+    * Test opening invalid images.
+    */
+    if (!assert(!jconf_image_open(&image, copy, sizeof(jImageHeader) - 4), "Assert 11: Truncated images should not open.")) goto failure;
+
+    copy[0] ^= 0xFF;
+    if (!assert(!jconf_image_open(&image, copy, size), "Assert 12: Images with a bad magic should not open.")) goto failure;
+
+    free(copy);
+
+    // An object cut off after its count, at the end of the image.
+    words = (uint32_t*)malloc(sizeof(jImageHeader) + 2 * sizeof(uint32_t));
+    memset(words, 0, sizeof(jImageHeader));
+    ((jImageHeader*)words)->magic = JCONF_IMAGE_MAGIC;
+    ((jImageHeader*)words)->version = JCONF_IMAGE_VERSION;
+    ((jImageHeader*)words)->order = JCONF_IMAGE_ORDER;
+    ((jImageHeader*)words)->size = sizeof(jImageHeader) + 2 * sizeof(uint32_t);
+    ((jImageHeader*)words)->root = sizeof(jImageHeader);
+    words[sizeof(jImageHeader) / sizeof(uint32_t)] = JCONF_OBJECT;
+    words[sizeof(jImageHeader) / sizeof(uint32_t) + 1] = 1;
+
+    len = jconf_image_open(&image, words, sizeof(jImageHeader) + 2 * sizeof(uint32_t)) &&
+        jconf_image_count(&image, jconf_image_root(&image)) == 1 &&
+        jconf_image_key(&image, jconf_image_root(&image), "a", 1) == 0;
+    free(words);
+
+    if (!assert(len, "Assert 13: A truncated object was read past the image.")) goto failure;
+
+    logger(PASS, "Test opening invalid images.\n");
+
+    /**
+    * Test encoding a large document.
+    */
+    json = load_file("test/test_two.json", &length);
+    if (!assert(json != NULL, "Assert 14: Error reading test_two.json.")) goto failure;
+
+    head = jconf_json2c(json, length, &args);
+    if (!assert(head != NULL, "Assert 15: The valid JSON file was not parsed correctly.")) goto failure;
+
+    size = jconf_image_size(head);
+    data = malloc(size);
+    jconf_image_write(head, data, size);
+
+    if (!assert(jconf_image_open(&image, data, size), "Assert 16: The image was not opened.")) goto failure;
+
+    ref = jconf_image_get(&image, jconf_image_root(&image), "aoao", 616, "friends", 2, "name");
+    str = jconf_image_string(&image, ref, NULL);
+    if (!assert(jconf_image_count(&image, jconf_image_root(&image)) == 617 && str != NULL &&
+        jconf_strcmp(str, (char*)jconf_get(head, "aoao", 616, "friends", 2, "name")->data) == 0,
+        "Assert 17: Large image not encoded correctly.")) goto failure;
+
+    free(data);
     free(json);
     jconf_free_token(head);
 
-    logger(PASS, "Test parsing test_four.json [error on line %d] (large invalid example).\n", args.line);
+    logger(PASS, "Test encoding test_two.json [%d bytes].\n", (int)size);
+
+    tear_down();
+    return PASS;
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+// CBOR TEST CASE
+int test_cbor(void)
+{
+    jToken *head, *copy, *token;
+    unsigned char* cbor;
+    const char* json;
+    char* file;
+    size_t size;
+    jArgs args;
+    int length;
+
+    set_up(TEST_JCONF_CBOR);
+
+    /**
+    * Test encoding and decoding scalars.
+    */
+    json = "{ \"int\" : -5, \"big\" : 18446744073709551615, \"min\" : -9223372036854775809,"
+           "  \"dbl\" : 1.5, \"frac\" : 0.1, \"exp\" : 2.5e3, \"tiny\" : -1.5e-9, \"str\" : \"a\\\"b\", \"arr\" : [true, false, null, []] }";
+
+    head = jconf_json2c(json, jconf_strlen(json), &args);
+    if (!assert(head != NULL, "Assert 1: The valid JSON string was not parsed correctly.")) goto failure;
+
+    cbor = jconf_c2cbor(head, &size);
+    if (!assert(cbor != NULL && (cbor[0] >> 5) == 5 && (cbor[0] & 0x1F) == 9, "Assert 2: The object was not encoded.")) goto failure;
+
+    copy = jconf_cbor2c(cbor, size, &args);
+    if (!assert(copy != NULL && copy->type == JCONF_OBJECT && args.e == JCONF_NO_ERROR, "Assert 3: The object was not decoded.")) goto failure;
+
+    token = jconf_get(copy, "o", "int");
+    if (!assert(token != NULL && token->type == JCONF_INT && jconf_strcmp(token->data, "-5") == 0, "Assert 4: Integer not decoded.")) goto failure;
+
+    token = jconf_get(copy, "o", "big");
+    if (!assert(token != NULL && token->type == JCONF_INT && jconf_strcmp(token->data, "18446744073709551615") == 0, "Assert 5: Integer not decoded.")) goto failure;
+
+    token = jconf_get(copy, "o", "min");
+    if (!assert(token != NULL && token->type == JCONF_INT && jconf_strcmp(token->data, "-9223372036854775809") == 0, "Assert 6: Integer not decoded.")) goto failure;
+
+    token = jconf_get(copy, "o", "dbl");
+    if (!assert(token != NULL && token->type == JCONF_DOUBLE && jconf_strcmp(token->data, "1.5") == 0, "Assert 7: Double not decoded.")) goto failure;
+
+    token = jconf_get(copy, "o", "frac");
+    if (!assert(token != NULL && token->type == JCONF_DOUBLE && jconf_strcmp(token->data, "0.1") == 0, "Assert 8: Double not decoded.")) goto failure;
+
+    token = jconf_get(copy, "o", "exp");
+    if (!assert(token != NULL && token->type == JCONF_DOUBLE && jconf_strcmp(token->data, "2500.0") == 0, "Assert 9: Exponent not decoded.")) goto failure;
+
+    token = jconf_get(copy, "o", "tiny");
+    if (!assert(token != NULL && token->type == JCONF_DOUBLE && jconf_strcmp(token->data, "-1.5e-9") == 0, "Assert 9: Exponent not decoded.")) goto failure;
+
+    token = jconf_get(copy, "o", "str");
+    if (!assert(token != NULL && token->type == JCONF_STRING && jconf_strcmp(token->data, "a\\\"b") == 0, "Assert 10: String not decoded.")) goto failure;
+
+    token = jconf_get(copy, "o", "arr");
+    if (!assert(token != NULL && token->type == JCONF_ARRAY && ((jArray*)token->data)->end == 4 &&
+        jconf_get(copy, "oa", "arr", 0)->type == JCONF_TRUE && jconf_get(copy, "oa", "arr", 2)->type == JCONF_NULL &&
+        jconf_get(copy, "oa", "arr", 3)->type == JCONF_ARRAY, "Assert 11: Array not decoded.")) goto failure;
+
+    jconf_free_token(copy);
+
+    logger(PASS, "Test encoding and decoding values.\n");
+
+    /**
+    * Test decoding malformed CBOR.
+    */
+    copy = jconf_cbor2c(cbor, size - 1, &args);
+    if (!assert(copy == NULL && args.e == JCONF_UNEXPECTED_EOF, "Assert 12: Truncated CBOR not detected.")) goto failure;
+
+    copy = jconf_cbor2c((const unsigned char*)"\x82\xF5\xFF", 3, &args);
+    if (!assert(copy == NULL && args.e == JCONF_UNEXPECTED_TOK && args.pos == 2, "Assert 13: Invalid item not detected.")) goto failure;
+
+    copy = jconf_cbor2c((const unsigned char*)"\xF6\xF6", 2, &args);
+    if (!assert(copy == NULL && args.e == JCONF_EXPECTED_EOF, "Assert 14: Trailing data not detected.")) goto failure;
+
+    copy = jconf_cbor2c((const unsigned char*)"\x9B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", 9, &args);
+    if (!assert(copy == NULL && args.e == JCONF_UNEXPECTED_EOF, "Assert 15: Oversized array not rejected.")) goto failure;
+
+    copy = jconf_cbor2c((const unsigned char*)"\xBF\x61\x61\x01\xFF", 5, &args);
+    if (!assert(copy != NULL && jconf_strcmp(jconf_get(copy, "o", "a")->data, "1") == 0, "Assert 16: Indefinite map not decoded.")) goto failure;
+
+    jconf_free_token(copy);
+    jconf_free_token(head);
+    jconf_free(NULL, cbor);
+
+    logger(PASS, "Test decoding malformed CBOR.\n");
+
+    /**
+    * Test text strings from other encoders, which are not JSON escaped.
+    */
+    json = "\xA1\x62q\"\x66\"\\\n\x01\xC3\xA9";
+    copy = jconf_cbor2c((const unsigned char*)json, 11, &args);
+
+    token = copy != NULL ? jconf_get(copy, "o", "q\\\"") : NULL;
+    if (!assert(token != NULL && jconf_strcmp(token->data, "\\\"\\\\\\n\\u0001\xC3\xA9") == 0,
+        "Assert 17: Text was not escaped as JSON.")) goto failure;
+
+    // Encoding decodes the escapes again.
+    cbor = jconf_c2cbor(copy, &size);
+    jconf_free_token(copy);
+
+    length = cbor != NULL && size == 11 && memcmp(cbor, json, 11) == 0;
+    jconf_free(NULL, cbor);
+    if (!assert(length, "Assert 18: Escaped text was not encoded as CBOR text.")) goto failure;
+
+    logger(PASS, "Test escaping text strings.\n");
+
+    /**
+    * Test a large document round trip.
+    */
+    file = load_file("test/test_two.json", &length);
+    if (!assert(file != NULL, "Assert 18: Error reading test_two.json.")) goto failure;
+
+    head = jconf_json2c(file, length, &args);
+    cbor = jconf_c2cbor(head, &size);
+    copy = jconf_cbor2c(cbor, size, &args);
+
+    if (!assert(copy != NULL && ((jArray*)copy->data)->end == 617, "Assert 19: Large document not decoded.")) goto failure;
+
+    token = jconf_get(copy, "aoao", 616, "friends", 2, "name");
+    if (!assert(token != NULL && jconf_strcmp(token->data, jconf_get(head, "aoao", 616, "friends", 2, "name")->data) == 0,
+        "Assert 20: String values differ after a round trip.")) goto failure;
+
+    token = jconf_get(copy, "aoaoa", 12, "friends", 1, "numbers", 0);
+    if (!assert(token != NULL && strtod(token->data, NULL) == strtod(jconf_get(head, "aoaoa", 12, "friends", 1, "numbers", 0)->data, NULL),
+        "Assert 21: Number values differ after a round trip.")) goto failure;
+
+    logger(PASS, "Test test_two.json round trip [%d bytes of JSON, %d bytes of CBOR].\n", length, (int)size);
+
+    jconf_free_token(copy);
+    jconf_free_token(head);
+    jconf_free(NULL, cbor);
+    free(file);
+
+    tear_down();
+    return PASS;
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+/**
+ * Document Reader
+ *
+ * Description: Repeatedly reads the published document until told to stop.
+ *
+ * @param {arg}[out] // The reader state.
+ * @returns          // NULL if every read was consistent.
+ */
+typedef struct _doc_test_state
+{
+    jDocSlot* slot;
+    volatile int done;
+    volatile int reads[4];
+
+} doc_test_state;
+
+typedef struct _doc_test_reader
+{
+    doc_test_state* state;
+    int id;
+
+} doc_test_reader;
+
+void* document_reader(void* arg)
+{
+    doc_test_state* state = ((doc_test_reader*)arg)->state;
+    int id = ((doc_test_reader*)arg)->id;
+    const jDocument* doc;
+    jToken *a, *b;
+    jDocReader reader;
+
+    while (!state->done)
+    {
+        doc = jconf_doc_acquire(state->slot, &reader);
+
+        // Both keys of a document always hold the same version. Published
+        // trees are hashed, so comparing them only reads their digests.
+        a = jconf_get(jconf_doc_root(doc), "o", "version");
+        b = jconf_get(jconf_doc_root(doc), "oa", "copy", 0);
+        if (a == NULL || b == NULL || jconf_strcmp(a->data, b->data) != 0 ||
+            !jconf_equal(jconf_doc_root(doc), jconf_doc_root(doc)) || jconf_hash_token(jconf_doc_root(doc), 0) == 0)
+        {
+            jconf_doc_release(state->slot, &reader);
+            return arg;
+        }
+
+        jconf_doc_release(state->slot, &reader);
+        state->reads[id]++;
+    }
+
+    return NULL;
+}
+
+/**
+ * Make Document
+ *
+ * Description: Creates a small versioned document.
+ *
+ * @param {version}[out] // The version number.
+ * @returns              // The document.
+ */
+jDocument* make_document(int version)
+{
+    char json[64];
+    jArgs args;
+
+    sprintf(json, "{ \"version\" : %d, \"copy\" : [%d] }", version, version);
+    return jconf_doc_create(jconf_json2c(json, jconf_strlen(json), &args));
+}
+
+// DOCUMENT TEST CASE
+int test_document(void)
+{
+    const jDocument* doc;
+    doc_test_state state;
+    jDocReader reader;
+    jDocument* fresh;
+    jArgs args;
+    int i, reads = 0, failed = 0;
+#if defined(__unix__)
+    doc_test_reader readers[4];
+    pthread_t threads[4];
+    void* result;
+#endif
+
+    set_up(TEST_JCONF_DOCUMENT);
+
+    /**
+    * Test acquiring and publishing documents.
+    */
+    state.slot = jconf_doc_slot_create(make_document(0));
+    state.done = 0;
+
+    doc = jconf_doc_acquire(state.slot, &reader);
+    if (!assert(doc != NULL && jconf_strcmp(jconf_get(jconf_doc_root(doc), "o", "version")->data, "0") == 0,
+        "Assert 1: The initial document was not acquired.")) goto failure;
+    jconf_doc_release(state.slot, &reader);
+
+    jconf_doc_publish(state.slot, make_document(1));
+    doc = jconf_doc_acquire(state.slot, &reader);
+    if (!assert(doc != NULL && jconf_strcmp(jconf_get(jconf_doc_root(doc), "o", "version")->data, "1") == 0,
+        "Assert 2: The published document was not acquired.")) goto failure;
+    jconf_doc_release(state.slot, &reader);
+
+    // Documents not made with jconf_doc_create are hashed when published.
+    if ((fresh = (jDocument*)jconf_malloc(NULL, sizeof(*fresh))) != NULL)
+        fresh->root = jconf_json2c("{ \"version\" : 2, \"copy\" : [2] }", 31, &args);
+
+    jconf_doc_publish(state.slot, fresh);
+    doc = jconf_doc_acquire(state.slot, &reader);
+    if (!assert(doc != NULL && doc->root != NULL && ((jMap*)doc->root->data)->digest != 0 &&
+        ((jArray*)jconf_get(doc->root, "o", "copy")->data)->digest != 0,
+        "Assert 3: The published document was not hashed.")) goto failure;
+    jconf_doc_release(state.slot, &reader);
+
+    logger(PASS, "Test acquiring and publishing documents.\n");
+
+#if defined(__unix__)
+    /**
+    * Test publishing while readers are active.
+    */
+    for (i = 0; i < 4; i++)
+    {
+        state.reads[i] = 0;
+        readers[i].state = &state;
+        readers[i].id = i;
+        pthread_create(&threads[i], NULL, document_reader, &readers[i]);
+    }
+
+    for (i = 2; i < 200; i++)
+    {
+        jconf_doc_publish(state.slot, make_document(i));
+        Sleep(1);
+    }
+
+    state.done = 1;
+    for (i = 0; i < 4; i++)
+    {
+        pthread_join(threads[i], &result);
+        failed |= result != NULL;
+        reads += state.reads[i];
+    }
+
+    if (!assert(!failed, "Assert 4: A reader observed an inconsistent document.")) goto failure;
+
+    logger(PASS, "Test publishing while readers are active [%d reads].\n", reads);
+#endif
+
+    jconf_doc_slot_destroy(state.slot);
+
+    tear_down();
+    return PASS;
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+/**
+ * Count Chunks
+ *
+ * Description: Counts the arena chunks of a parser context.
+ *
+ * @param {context}[out] // The parser context.
+ * @returns              // The number of chunks.
+ */
+int count_chunks(jParserContext* context)
+{
+    jArenaChunk* chunk;
+    int count = 0;
+
+    for (chunk = context->head; chunk != NULL; chunk = chunk->next)
+        count++;
+
+    return count;
+}
+
+/**
+ * Arena Bytes
+ *
+ * Description: Returns the size of the arena chunks of a context.
+ */
+static size_t arena_bytes(const jParserContext* context)
+{
+    jArenaChunk* chunk;
+    size_t bytes = 0;
+
+    for (chunk = context->head; chunk != NULL; chunk = chunk->next)
+        bytes += chunk->size;
+
+    return bytes;
+}
+
+#if defined(__unix__)
+// A counting allocator shared between threads, serialized by a lock.
+static pthread_mutex_t locked_mutex = PTHREAD_MUTEX_INITIALIZER;
+static jAllocator locked_counting;
+
+void* locked_alloc(void* ctx, size_t size)
+{
+    void* ptr;
+
+    pthread_mutex_lock(&locked_mutex);
+    ptr = locked_counting.alloc(locked_counting.ctx, size);
+    pthread_mutex_unlock(&locked_mutex);
+    return ptr;
+}
+
+void* locked_realloc(void* ctx, void* ptr, size_t old_size, size_t size)
+{
+    pthread_mutex_lock(&locked_mutex);
+    ptr = locked_counting.realloc(locked_counting.ctx, ptr, old_size, size);
+    pthread_mutex_unlock(&locked_mutex);
+    return ptr;
+}
+
+void locked_free(void* ctx, void* ptr)
+{
+    pthread_mutex_lock(&locked_mutex);
+    locked_counting.free(locked_counting.ctx, ptr);
+    pthread_mutex_unlock(&locked_mutex);
+}
+#endif
+
+// PARSER CONTEXT TEST CASE
+int test_context(void)
+{
+    jParserContext context, contexts[3];
+    jDocument docs[100], copies[100];
+    jArgs args, errs[100], copy_errs[100];
+    char messages[100][64];
+    jBatchOptions batch;
+    jToken *head, *token;
+    char *one, *two, *four;
+    int len_one, len_two, len_four, chunks, i;
+    jInput inputs[100];
+    size_t parsed, length, bytes;
+    char* skewed;
+#if defined(__unix__)
+    jAllocator locked = { locked_alloc, locked_realloc, locked_free, NULL };
+    jAllocCounter counter;
+#endif
+
+    set_up(TEST_JCONF_CONTEXT);
+
+    one = load_file("test/test_one.json", &len_one);
+    two = load_file("test/test_two.json", &len_two);
+    four = load_file("test/test_four.json", &len_four);
+    if (!assert(one != NULL && two != NULL && four != NULL, "Assert 1: Error reading test files.")) goto failure;
+
+    if (!assert(jconf_init_context(&context, 0), "Assert 2: The context was not initialized.")) goto failure;
+
+    /**
+    * Test parsing with a context.
+    */
+    head = jconf_context_json2c(&context, one, len_one, &args);
+    token = jconf_get(head, "oooooo", "glossary", "GlossDiv", "GlossList", "GlossEntry", "GlossDef", "GlossSeeAlso");
+    if (!assert(token != NULL && token->type == JCONF_ARRAY && jconf_strcmp(jconf_get(token, "a", 1)->data, "XML") == 0,
+        "Assert 3: The document was not parsed correctly.")) goto failure;
+
+    head = jconf_context_json2c(&context, two, len_two, &args);
+    if (!assert(head != NULL && ((jArray*)head->data)->end == 617, "Assert 4: The large document was not parsed correctly.")) goto failure;
+
+    logger(PASS, "Test parsing with a context.\n");
+
+    /**
+    * Test reusing warm memory.
+    */
+    jconf_context_reset(&context);
+    chunks = count_chunks(&context);
+
+    if (!assert(context.hints[0] == 617 && context.hints[2] >= 2, "Assert 5: Array sizes were not remembered.")) goto failure;
+
+    head = jconf_context_json2c(&context, two, len_two, &args);
+    if (!assert(head != NULL && ((jArray*)head->data)->size == 617, "Assert 6: The array hint was not used.")) goto failure;
+
+    // Arrays sized by the hints can take slightly more than the cold parse,
+    // so compare against the warm parse once the arena has settled.
+    jconf_context_reset(&context);
+    chunks = count_chunks(&context);
+    head = jconf_context_json2c(&context, two, len_two, &args);
+    if (!assert(head != NULL && count_chunks(&context) <= chunks, "Assert 7: Arena chunks were not reused after a reset.")) goto failure;
+
+    logger(PASS, "Test reusing warm memory [%d chunks].\n", chunks);
+
+    /**
+    * Test errors with a context.
+    */
+    jconf_context_reset(&context);
+    head = jconf_context_json2c(&context, four, len_four, &args);
+    if (!assert(head == NULL && args.e == JCONF_UNEXPECTED_TOK && args.line == 12801, "Assert 8: The error was not reported.")) goto failure;
+    if (!assert(context.hints[0] == 617, "Assert 9: A failed parse should not change the hints.")) goto failure;
+
+    logger(PASS, "Test errors with a context.\n");
+
+    /**
+    * Test parsing a batch of messages.
+    */
+    for (i = 0; i < 100; i++)
+    {
+        inputs[i].size = sprintf(messages[i], "{\"id\": %d, \"tags\": [\"a\", \"b\"], \"ok\": true}", i);
+        inputs[i].buffer = messages[i];
+    }
+
+    // One message is truncated.
+    inputs[50].size -= 1;
+
+    jconf_context_reset(&context);
+    batch.parse.allocator = NULL;
+    batch.parse.stats = NULL;
+    batch.parse.duplicates = JCONF_DUP_LAST_WINS;
+    batch.parse.mode = JCONF_MODE_STRICT;
+    batch.parse.hash = 0;
+    batch.contexts = &context;
+    batch.threads = 1;
+
+    parsed = jconf_parse_batch(inputs, 100, docs, errs, &batch);
+    if (!assert(parsed == 99 && docs[50].root == NULL && errs[50].e == JCONF_UNEXPECTED_EOF && errs[49].e == JCONF_NO_ERROR,
+        "Assert 10: The batch was not parsed [%zu documents].", parsed)) goto failure;
+
+    for (i = 0; i < 100; i++)
+    {
+        token = i == 50 ? NULL : jconf_get(docs[i].root, "o", "id");
+        if (!assert(i == 50 || (token != NULL && atoi((char*)token->data) == i),
+            "Assert 11: Message %d was not parsed correctly.", i)) goto failure;
+    }
+
+    logger(PASS, "Test parsing a batch into a context.\n");
+
+    // Threads each parse a range into their own context.
+    for (i = 0; i < 3; i++)
+        if (!assert(jconf_init_context(&contexts[i], 0), "Assert 12: The context was not initialized.")) goto failure;
+
+    batch.contexts = contexts;
+    batch.threads = 3;
+
+    parsed = jconf_parse_batch(inputs, 100, copies, copy_errs, &batch);
+    for (i = 0; i < 100; i++)
+    {
+        token = copies[i].root == NULL ? NULL : jconf_get(copies[i].root, "oa", "tags", 1);
+        if (!assert(parsed == 99 && (copies[i].root == NULL) == (docs[i].root == NULL) && copy_errs[i].e == errs[i].e &&
+            (i == 50 || (token != NULL && !jconf_strcmp((char*)token->data, "b"))),
+            "Assert 13: Message %d differs when parsed with threads.", i)) goto failure;
+    }
+
+    for (i = 0; i < 3; i++)
+        jconf_destroy_context(&contexts[i]);
+
+    // Without contexts every tree is freed separately.
+    batch.contexts = NULL;
+    parsed = jconf_parse_batch(inputs, 100, copies, NULL, &batch);
+    if (!assert(parsed == 99 && copies[50].root == NULL && jconf_get(copies[99].root, "o", "ok")->type == JCONF_TRUE,
+        "Assert 14: The batch was not parsed without contexts.")) goto failure;
+
+    for (i = 0; i < 100; i++)
+        jconf_free_token(copies[i].root);
+
+#if defined(__unix__)
+    // The threads share the allocator of the parse options.
+    jconf_init_counting_allocator(&locked_counting, &counter, NULL);
+    batch.parse.allocator = &locked;
+
+    parsed = jconf_parse_batch(inputs, 100, copies, NULL, &batch);
+    if (!assert(parsed == 99 && counter.allocs > 0 && jconf_get(copies[99].root, "oa", "tags", 1) != NULL,
+        "Assert 15: The batch was not parsed with a shared allocator.")) goto failure;
+
+    for (i = 0; i < 100; i++)
+        jconf_free_token_with(copies[i].root, &locked);
+
+    if (!assert(counter.live == 0,
+        "Assert 16: Trees parsed with a shared allocator leaked [%zu bytes].", counter.live)) goto failure;
+#endif
+
+    logger(PASS, "Test parsing a batch with threads.\n");
+
+    /**
+    * Test a document with one outlier array per depth.
+    */
+    skewed = (char*)malloc(256 * 1024);
+    length = sprintf(skewed, "[[");
+    for (i = 0; i < 20000; i++)
+        length += sprintf(skewed + length, i > 0 ? ",[1]" : "[1]");
+    length += sprintf(skewed + length, "]");
+    for (i = 0; i < 20000; i++)
+        length += sprintf(skewed + length, ",[[1]]");
+    length += sprintf(skewed + length, "]");
+
+    // The outliers must not size every array of the next parse.
+    jconf_destroy_context(&context);
+    jconf_init_context(&context, 0);
+    head = jconf_context_json2c(&context, skewed, length, &args);
+    bytes = arena_bytes(&context);
+
+    for (i = 0; i < 2 && head != NULL; i++)
+    {
+        jconf_context_reset(&context);
+        head = jconf_context_json2c(&context, skewed, length, &args);
+    }
+
+    free(skewed);
+    if (!assert(head != NULL && ((jArray*)head->data)->end == 20001 && arena_bytes(&context) <= 2 * bytes,
+        "Assert 17: The arena grew from %zu to %zu bytes.", bytes, arena_bytes(&context))) goto failure;
+
+    logger(PASS, "Test reparsing a skewed document [%zu arena bytes].\n", arena_bytes(&context));
+
+    jconf_destroy_context(&context);
+    free(one);
+    free(two);
+    free(four);
+
+    tear_down();
+    return PASS;
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+// Number of allocations the limited allocator allows.
+static int alloc_budget;
+
+void* limited_alloc(void* ctx, size_t size)
+{
+    return alloc_budget-- > 0 ? malloc(size) : NULL;
+}
+
+void* limited_realloc(void* ctx, void* ptr, size_t old_size, size_t size)
+{
+    return alloc_budget-- > 0 ? realloc(ptr, size) : NULL;
+}
+
+void limited_free(void* ctx, void* ptr)
+{
+    free(ptr);
+}
+
+// ALLOCATOR TEST CASE
+int test_alloc(void)
+{
+    jAllocator counting, limited = { limited_alloc, limited_realloc, limited_free, NULL };
+    jParseOptions options;
+    jAllocCounter counter;
+    unsigned char* cbor;
+    jDocument* doc;
+    jToken* head;
+    size_t size;
+    int length, i;
+    jArgs args;
+    char* json;
+
+    set_up(TEST_JCONF_ALLOC);
+
+    json = load_file("test/test_one.json", &length);
+    if (!assert(json != NULL, "Assert 1: Error reading test_one.json.")) goto failure;
+
+    /**
+    * Test a per call allocator.
+    */
+    jconf_init_counting_allocator(&counting, &counter, NULL);
+    options.allocator = &counting;
+    options.stats = NULL;
+    options.duplicates = JCONF_DUP_LAST_WINS;
+    options.mode = JCONF_MODE_DEFAULT;
+    options.hash = 0;
+
+    head = jconf_json2c_ex(json, length, &options, &args);
+    if (!assert(head != NULL && counter.allocs > 0 && counter.live > 0, "Assert 2: The allocator was not used by the parser.")) goto failure;
+
+    i = (int)counter.allocs;
+    jconf_free_token(jconf_json2c(json, length, &args));
+    if (!assert(counter.allocs == (size_t)i && counter.frees == 0, "Assert 3: The allocator was used outside of its parse call.")) goto failure;
+
+    jconf_free_token_with(head, &counting);
+    if (!assert(counter.frees == (size_t)i && counter.live == 0, "Assert 4: The tree was not released to its allocator.")) goto failure;
+
+    logger(PASS, "Test a per call allocator [%d allocations].\n", i);
+
+    /**
+    * Test the default allocator.
+    */
+    jconf_init_counting_allocator(&counting, &counter, NULL);
+    jconf_set_allocator(&counting);
+
+    head = jconf_json2c(json, length, &args);
+    cbor = jconf_c2cbor(head, &size);
+    doc = jconf_doc_create(jconf_cbor2c(cbor, size, &args));
+    jconf_free(NULL, cbor);
+    jconf_free_token(head);
+    jconf_doc_free(doc);
+
+    jconf_set_allocator(NULL);
+    if (!assert(counter.allocs > 0 && counter.frees == counter.allocs && counter.live == 0,
+        "Assert 5: Allocations were not routed through the default allocator.")) goto failure;
+
+    logger(PASS, "Test the default allocator [%d allocations, peak %d bytes].\n", (int)counter.allocs, (int)counter.peak);
+
+    /**
+    * Test running out of memory at every allocation.
+    */
+    jconf_init_counting_allocator(&counting, &counter, &limited);
+    options.allocator = &counting;
+
+    for (i = 0; ; i++)
+    {
+        alloc_budget = i;
+        if ((head = jconf_json2c_ex(json, length, &options, &args)) != NULL)
+            break;
+
+        if (!assert(args.e == JCONF_OUT_OF_MEMORY && counter.live == 0,
+            "Assert 6: Failed allocation %d was not reported or leaked memory.", i)) goto failure;
+    }
+
+    jconf_free_token_with(head, &counting);
+    if (!assert(counter.live == 0, "Assert 7: The tree was not released to its allocator.")) goto failure;
+
+    logger(PASS, "Test running out of memory [%d failure points].\n", i);
+
+    free(json);
+    tear_down();
+    return PASS;
+
+failure:
+    jconf_set_allocator(NULL);
+    tear_down();
+    return FAILURE;
+}
+
+// LARGE DOCUMENT TEST CASE
+int test_large(void)
+{
+#if defined(__unix__) && SIZE_MAX > UINT32_MAX
+    static const char head[] = "{\"head\": [1, 2], /*";
+    static const char tail[] = "*/\n\"tail\": \"end\"}";
+    size_t size = ((size_t)1 << 32) + 8192;
+    jToken *root, *token;
+    clock_t start;
+    double elapsed;
+    char* buffer;
+    jArgs args;
+
+    set_up(TEST_JCONF_LARGE);
+
+    // The scan takes seconds, so it only runs on request (make test-large).
+    if (getenv("JCONF_TEST_LARGE") == NULL)
+    {
+        logger(PASS, "Test skipped (set JCONF_TEST_LARGE to run it).\n");
+        tear_down();
+        return PASS;
+    }
+
+    /**
+     * Test a document larger than 4 GB. The input is a private anonymous
+     * mapping with a comment spanning the untouched (zero) pages between the
+     * members, so it does not need the memory or disk space it addresses.
+     */
+    buffer = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (!assert(buffer != MAP_FAILED, "Assert 1: Could not map %zu bytes.", size)) goto failure;
+
+    memcpy(buffer, head, sizeof(head) - 1);
+    memcpy(buffer + size - (sizeof(tail) - 1), tail, sizeof(tail) - 1);
+
+    start = clock();
+    root = jconf_json2c(buffer, size, &args);
+    elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    token = jconf_get(root, "o", "tail");
+    if (!assert(root != NULL && token != NULL && !jconf_strcmp((char*)token->data, "end") &&
+        jconf_get(root, "oa", "head", 1) != NULL && args.line == 2 && args.pos == size - 1,
+        "Assert 2: The large document was not parsed [error %d, line %zu, pos %zu].", args.e, args.line, args.pos))
+    {
+        munmap(buffer, size);
+        goto failure;
+    }
+
+    jconf_free_token(root);
+    munmap(buffer, size);
+
+    logger(PASS, "Test parsing a %.1f GB document [%.0f MB/s].\n", size / (1024.0 * 1024.0 * 1024.0),
+        elapsed > 0 ? size / elapsed / (1024.0 * 1024.0) : 0.0);
+
+    tear_down();
+    return PASS;
+
+failure:
+    tear_down();
+    return FAILURE;
+#else
+    set_up(TEST_JCONF_LARGE);
+    logger(PASS, "Test skipped (requires 64-bit sizes and mmap).\n");
+    tear_down();
+    return PASS;
+#endif
+}
+
+/**
+ * Validate Matches
+ *
+ * Description: Validates a buffer and parses it in the same mode.
+ *
+ * @param {json}[out] // The buffer.
+ * @param {size}[out] // The size of the buffer.
+ * @param {mode}[out] // The parse mode.
+ * @param {args}[in]  // Receives the result of the validation.
+ * @returns           // '1' if both report the same result.
+ */
+int validate_matches(const char* json, size_t size, jParseMode mode, jArgs* args)
+{
+    jParseOptions options;
+    jToken* head;
+    jArgs parsed;
+    int valid;
+
+    options.allocator = NULL;
+    options.stats = NULL;
+    options.duplicates = JCONF_DUP_LAST_WINS;
+    options.mode = mode;
+    options.hash = 0;
+
+    valid = jconf_validate(json, size, mode, args);
+    head = jconf_json2c_ex(json, size, &options, &parsed);
+    jconf_free_token(head);
+
+    return valid == (head != NULL) && args->e == parsed.e && args->line == parsed.line && args->pos == parsed.pos;
+}
+
+/**
+ * Test Validate
+ *
+ * Description: Tests validation without building a tree.
+ */
+int test_validate(void)
+{
+    static const char mutations[] = "{}[]:,\"'/\\* \na1-.eE+u";
+    static const char* files[] = {
+        "test/test_one.json", "test/test_two.json", "test/test_three.json", "test/test_four.json"
+    };
+    static const jParseMode modes[] = { JCONF_MODE_DEFAULT, JCONF_MODE_STRICT, JCONF_MODE_RELAXED };
+    int length, i, j, m, checked = 0;
+    size_t k, depth;
+    char *json, c;
+    jArgs args;
+
+    set_up(TEST_JCONF_VALIDATE);
+
+    /**
+     * Test that the sample files are validated like they are parsed.
+     */
+    for (i = 0; i < (int)(sizeof(files) / sizeof(files[0])); i++)
+    {
+        json = load_file(files[i], &length);
+        if (!assert(json != NULL, "Assert 1: Error reading %s.", files[i])) goto failure;
+
+        for (m = 0; m < 3; m++)
+        {
+            if (!assert(validate_matches(json, length, modes[m], &args),
+                "Assert 2: %s was not validated like it is parsed in mode %d.", files[i], m))
+            {
+                free(json);
+                goto failure;
+            }
+        }
+
+        free(json);
+    }
+
+    json = load_file("test/test_one.json", &length);
+    if (!assert(json != NULL, "Assert 3: Error reading test_one.json.")) goto failure;
+    if (!assert(jconf_validate(json, length, JCONF_MODE_DEFAULT, &args) && args.e == JCONF_NO_ERROR,
+        "Assert 4: A valid file was not validated [error %d].", args.e))
+    {
+        free(json);
+        goto failure;
+    }
+
+    logger(PASS, "Test validating the sample files.\n");
+
+    /**
+     * Test every truncation and single character change of a valid file,
+     * which covers each error the DFA and the value scanners report.
+     */
+    for (m = 0; m < 3; m++)
+    {
+        for (k = 0; k <= (size_t)length; k++, checked++)
+        {
+            if (!assert(validate_matches(json, k, modes[m], &args),
+                "Assert 5: A truncation to %zu bytes was not validated like it is parsed in mode %d.", k, m))
+            {
+                free(json);
+                goto failure;
+            }
+        }
+
+        for (k = 0; k < (size_t)length; k++)
+        {
+            c = json[k];
+            for (j = 0; j < (int)sizeof(mutations) - 1; j++, checked++)
+            {
+                json[k] = mutations[j];
+                if (!assert(validate_matches(json, length, modes[m], &args),
+                    "Assert 6: Changing byte %zu to '%c' was not validated like it is parsed in mode %d.", k, mutations[j], m))
+                {
+                    free(json);
+                    goto failure;
+                }
+            }
+            json[k] = c;
+        }
+    }
+
+    free(json);
+    logger(PASS, "Test %d invalid documents report the errors of the parser.\n", checked);
+
+    /**
+     * Test the nesting limit.
+     */
+    depth = JCONF_VALIDATE_MAX_DEPTH;
+    json = (char*)malloc(2 * depth + 2);
+    if (!assert(json != NULL, "Assert 7: Out of memory.")) goto failure;
+
+    memset(json, '[', depth);
+    memset(json + depth, ']', depth);
+
+    if (!assert(jconf_validate(json, 2 * depth, JCONF_MODE_DEFAULT, &args) && args.pos == 2 * depth - 1,
+        "Assert 8: Nesting to the limit was not validated [error %d, pos %zu].", args.e, args.pos))
+    {
+        free(json);
+        goto failure;
+    }
+
+    json[0] = '[';
+    memmove(json + 1, json, 2 * depth);
+    json[2 * depth + 1] = ']';
+    if (!assert(!jconf_validate(json, 2 * depth + 2, JCONF_MODE_DEFAULT, &args) && args.e == JCONF_MAX_DEPTH && args.pos == depth,
+        "Assert 9: Nesting past the limit was not reported [error %d, pos %zu].", args.e, args.pos))
+    {
+        free(json);
+        goto failure;
+    }
+
+    free(json);
+    logger(PASS, "Test nesting up to %d levels.\n", JCONF_VALIDATE_MAX_DEPTH);
+
+    tear_down();
+    return PASS;
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+/**
+ * Schema Check
+ *
+ * Description: Parses a document and checks it against a compiled schema.
+ *
+ * @param {schema}[out] // The compiled schema.
+ * @param {json}[out]   // The document.
+ * @param {result}[in]  // Receives the result.
+ * @returns             // '1' if the document is valid.
+ */
+int schema_check(const jSchema* schema, const char* json, jSchemaResult* result)
+{
+    jToken* root;
+    jArgs args;
+    int valid;
+
+    root = jconf_json2c(json, jconf_strlen(json), &args);
+    valid = root != NULL && jconf_schema_check(schema, root, result);
+    jconf_free_token(root);
+    return valid;
+}
+
+/**
+ * Test Schema
+ *
+ * Description: Tests compiling schemas and checking trees against them.
+ */
+int test_schema(void)
+{
+    static const char config[] =
+        "{\"type\": \"object\", \"required\": [\"name\", \"servers\"], \"properties\": {"
+        "  \"name\": {\"type\": \"string\", \"minLength\": 1, \"maxLength\": 4},"
+        "  \"mode\": {\"enum\": [\"fast\", \"safe\", 3, [1, {\"a\": null}]]},"
+        "  \"version\": {\"const\": 2},"
+        "  \"ratio\": {\"type\": [\"number\", \"null\"], \"exclusiveMinimum\": 0, \"maximum\": 1},"
+        "  \"a/b\": {\"type\": \"boolean\"},"
+        "  \"servers\": {\"type\": \"array\", \"minItems\": 1, \"maxItems\": 3, \"items\": {"
+        "    \"type\": \"object\", \"required\": [\"port\"], \"maxProperties\": 2, \"properties\": {"
+        "      \"port\": {\"type\": \"integer\", \"minimum\": 1, \"maximum\": 65535}}}}}}";
+
+    static const struct
+    {
+        const char* json;
+        jSchemaError e;
+        const char* path;
+
+    } cases[] = {
+        { "{\"name\": \"web\", \"servers\": [{\"port\": 80}, {\"port\": 8080.0, \"host\": 1}]}", JCONF_SCHEMA_OK, "" },
+        { "{\"name\": \"\\u00e9\\ud83d\\ude00\\nx\", \"servers\": [{\"port\": 1}], \"x\": {}}", JCONF_SCHEMA_OK, "" },
+        { "{\"name\": \"w\", \"servers\": [{\"port\": 1}], \"mode\": [1, {\"a\": null}], \"version\": 2.0, \"ratio\": null}", JCONF_SCHEMA_OK, "" },
+        { "{\"servers\": [{\"port\": 80}]}", JCONF_SCHEMA_REQUIRED, "/name" },
+        { "{\"name\": \"web\", \"servers\": [{\"port\": 80}, {\"port\": \"80\"}]}", JCONF_SCHEMA_TYPE, "/servers/1/port" },
+        { "{\"name\": \"web\", \"servers\": [{\"port\": 80.5}]}", JCONF_SCHEMA_TYPE, "/servers/0/port" },
+        { "{\"name\": \"web\", \"servers\": [{\"port\": 0}]}", JCONF_SCHEMA_MINIMUM, "/servers/0/port" },
+        { "{\"name\": \"web\", \"servers\": [{\"port\": 65536}]}", JCONF_SCHEMA_MAXIMUM, "/servers/0/port" },
+        { "{\"name\": \"web\", \"servers\": [{}]}", JCONF_SCHEMA_REQUIRED, "/servers/0/port" },
+        { "{\"name\": \"web\", \"servers\": [{\"port\": 1, \"a\": 1, \"b\": 2}]}", JCONF_SCHEMA_MAX_PROPERTIES, "/servers/0" },
+        { "{\"name\": \"web\", \"servers\": []}", JCONF_SCHEMA_MIN_ITEMS, "/servers" },
+        { "{\"name\": \"web\", \"servers\": [{\"port\": 1}, {\"port\": 1}, {\"port\": 1}, {\"port\": 1}]}", JCONF_SCHEMA_MAX_ITEMS, "/servers" },
+        { "{\"name\": \"\", \"servers\": [{\"port\": 1}]}", JCONF_SCHEMA_MIN_LENGTH, "/name" },
+        { "{\"name\": \"\\u00e9\\t\\u00e9\\u00e9\\u00e9\", \"servers\": [{\"port\": 1}]}", JCONF_SCHEMA_MAX_LENGTH, "/name" },
+        { "{\"name\": \"w\", \"servers\": [{\"port\": 1}], \"mode\": \"slow\"}", JCONF_SCHEMA_ENUM, "/mode" },
+        { "{\"name\": \"w\", \"servers\": [{\"port\": 1}], \"mode\": [1, {\"a\": 0}]}", JCONF_SCHEMA_ENUM, "/mode" },
+        { "{\"name\": \"w\", \"servers\": [{\"port\": 1}], \"version\": \"2\"}", JCONF_SCHEMA_ENUM, "/version" },
+        { "{\"name\": \"w\", \"servers\": [{\"port\": 1}], \"ratio\": 0}", JCONF_SCHEMA_MINIMUM, "/ratio" },
+        { "{\"name\": \"w\", \"servers\": [{\"port\": 1}], \"ratio\": 1.5}", JCONF_SCHEMA_MAXIMUM, "/ratio" },
+        { "{\"name\": \"w\", \"servers\": [{\"port\": 1}], \"a/b\": 1}", JCONF_SCHEMA_TYPE, "/a~1b" },
+        { "[]", JCONF_SCHEMA_TYPE, "" }
+    };
+
+    static const struct
+    {
+        const char* json;
+        jSchemaError e;
+        const char* path;
+
+    } invalid[] = {
+        { "{\"properties\": {\"a\": {\"pattern\": \"^a\"}}}", JCONF_SCHEMA_UNSUPPORTED, "/properties/a/pattern" },
+        { "{\"items\": [{}, {}]}", JCONF_SCHEMA_UNSUPPORTED, "/items" },
+        { "{\"items\": {\"minLength\": -1}}", JCONF_SCHEMA_INVALID, "/items/minLength" },
+        { "{\"type\": \"text\"}", JCONF_SCHEMA_INVALID, "/type" },
+        { "{\"required\": [\"a\", 1]}", JCONF_SCHEMA_INVALID, "/required" },
+        { "[]", JCONF_SCHEMA_INVALID, "" }
+    };
+
+    jSchemaResult result;
+    jToken *root, *head;
+    const char* json;
+    jSchema* schema;
+    jArgs args;
+    int i, n;
+
+    set_up(TEST_JCONF_SCHEMA);
+
+    /**
+     * Test checking documents against a schema.
+     */
+    root = jconf_json2c(config, jconf_strlen(config), &args);
+    if (!assert(root != NULL, "Assert 1: The schema was not parsed [error %d].", args.e)) goto failure;
+
+    schema = jconf_schema_compile(root, &result);
+    if (!assert(schema != NULL && result.e == JCONF_SCHEMA_OK, "Assert 2: The schema was not compiled [error %d at '%s'].", result.e, result.path))
+    {
+        jconf_free_token(root);
+        goto failure;
+    }
+
+    n = (int)(sizeof(cases) / sizeof(cases[0]));
+    for (i = 0; i < n; i++)
+    {
+        if (!assert(schema_check(schema, cases[i].json, &result) == (cases[i].e == JCONF_SCHEMA_OK) &&
+            result.e == cases[i].e && !jconf_strcmp(result.path, cases[i].path),
+            "Assert 3: Case %d reported error %d at '%s' instead of %d at '%s'.", i, result.e, result.path, cases[i].e, cases[i].path))
+        {
+            jconf_schema_free(schema);
+            jconf_free_token(root);
+            goto failure;
+        }
+    }
+
+    // The failing token is reported.
+    json = "{\"name\": \"web\", \"servers\": [{\"port\": true}]}";
+    head = jconf_json2c(json, jconf_strlen(json), &args);
+    if (!assert(head != NULL && !jconf_schema_check(schema, head, &result) && result.token == jconf_get(head, "oao", "servers", 0, "port"),
+        "Assert 4: The failing token was not reported."))
+    {
+        jconf_free_token(head);
+        jconf_schema_free(schema);
+        jconf_free_token(root);
+        goto failure;
+    }
+
+    jconf_free_token(head);
+    jconf_schema_free(schema);
+    jconf_free_token(root);
+    logger(PASS, "Test %d documents against a schema.\n", n + 1);
+
+    /**
+     * Test schemas outside the subset.
+     */
+    n = (int)(sizeof(invalid) / sizeof(invalid[0]));
+    for (i = 0; i < n; i++)
+    {
+        root = jconf_json2c(invalid[i].json, jconf_strlen(invalid[i].json), &args);
+        if (!assert(root != NULL, "Assert 5: Schema %d was not parsed.", i)) goto failure;
+
+        schema = jconf_schema_compile(root, &result);
+        jconf_free_token(root);
+
+        if (!assert(schema == NULL && result.e == invalid[i].e && !jconf_strcmp(result.path, invalid[i].path),
+            "Assert 6: Schema %d reported error %d at '%s' instead of %d at '%s'.", i, result.e, result.path, invalid[i].e, invalid[i].path))
+        {
+            jconf_schema_free(schema);
+            goto failure;
+        }
+    }
+
+    /**
+     * Test boolean schemas.
+     */
+    json = "{\"items\": false, \"properties\": {\"a\": true}}";
+    root = jconf_json2c(json, jconf_strlen(json), &args);
+    schema = jconf_schema_compile(root, &result);
+    if (!assert(schema != NULL && schema_check(schema, "[]", &result) && schema_check(schema, "{\"a\": [1]}", &result) &&
+        !schema_check(schema, "[1]", &result) && result.e == JCONF_SCHEMA_TYPE && !jconf_strcmp(result.path, "/0"),
+        "Assert 7: Boolean schemas were not applied [error %d at '%s'].", result.e, result.path))
+    {
+        jconf_schema_free(schema);
+        jconf_free_token(root);
+        goto failure;
+    }
+
+    jconf_schema_free(schema);
+    jconf_free_token(root);
+    logger(PASS, "Test %d schemas outside the subset and boolean schemas.\n", n);
+
+    tear_down();
+    return PASS;
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+// Structs bound by test_bind.
+typedef struct
+{
+    char* host;
+    int port;
+    int64_t weight;
+    int tls;
+
+} BindServer;
+
+typedef struct
+{
+    int level;
+    double ratio;
+
+} BindLimits;
+
+typedef struct
+{
+    char* name;
+    int debug;
+    double ratio;
+    BindLimits limits;
+    BindServer* servers;
+    size_t server_count;
+    int* ports;
+    size_t port_count;
+    char** tags;
+    size_t tag_count;
+    int64_t big;
+
+} BindConfig;
+
+typedef struct _bind_node
+{
+    int value;
+    struct _bind_node* children;
+    size_t child_count;
+
+} BindNode;
+
+static jBindField bind_server_fields[] = {
+    JCONF_BIND_FIELD(BindServer, host, JCONF_BIND_STRING),
+    JCONF_BIND_FIELD(BindServer, port, JCONF_BIND_INT),
+    JCONF_BIND_FIELD(BindServer, weight, JCONF_BIND_INT64),
+    JCONF_BIND_FIELD_KEY(BindServer, tls, "use-tls", JCONF_BIND_BOOL)
+};
+static jBindDesc bind_server_desc = JCONF_BIND_DESC(BindServer, bind_server_fields);
+
+static jBindField bind_limits_fields[] = {
+    JCONF_BIND_FIELD(BindLimits, level, JCONF_BIND_INT),
+    JCONF_BIND_FIELD(BindLimits, ratio, JCONF_BIND_DOUBLE)
+};
+static jBindDesc bind_limits_desc = JCONF_BIND_DESC(BindLimits, bind_limits_fields);
+
+static jBindField bind_config_fields[] = {
+    JCONF_BIND_FIELD(BindConfig, name, JCONF_BIND_STRING),
+    JCONF_BIND_FIELD(BindConfig, debug, JCONF_BIND_BOOL),
+    JCONF_BIND_FIELD(BindConfig, ratio, JCONF_BIND_DOUBLE),
+    JCONF_BIND_OBJECT_FIELD(BindConfig, limits, &bind_limits_desc),
+    JCONF_BIND_ARRAY_FIELD(BindConfig, servers, server_count, JCONF_BIND_OBJECT, &bind_server_desc),
+    JCONF_BIND_ARRAY_FIELD(BindConfig, ports, port_count, JCONF_BIND_INT, NULL),
+    JCONF_BIND_ARRAY_FIELD(BindConfig, tags, tag_count, JCONF_BIND_STRING, NULL),
+    JCONF_BIND_FIELD(BindConfig, big, JCONF_BIND_INT64)
+};
+static jBindDesc bind_config_desc = JCONF_BIND_DESC(BindConfig, bind_config_fields);
+
+static jBindDesc bind_node_desc;
+static jBindField bind_node_fields[] = {
+    JCONF_BIND_FIELD(BindNode, value, JCONF_BIND_INT),
+    JCONF_BIND_ARRAY_FIELD(BindNode, children, child_count, JCONF_BIND_OBJECT, &bind_node_desc)
+};
+static jBindDesc bind_node_desc = JCONF_BIND_DESC(BindNode, bind_node_fields);
+
+/**
+ * Bind Config Equal
+ *
+ * Description: Compares two decoded configs.
+ *
+ * @param {a}[out] // The first config.
+ * @param {b}[out] // The second config.
+ * @returns        // '1' if the configs are equal.
+ */
+int bind_config_equal(const BindConfig* a, const BindConfig* b)
+{
+    size_t i;
+
+    if (jconf_strcmp(a->name, b->name) || a->debug != b->debug || a->ratio != b->ratio || a->big != b->big ||
+        a->limits.level != b->limits.level || a->limits.ratio != b->limits.ratio ||
+        a->server_count != b->server_count || a->port_count != b->port_count || a->tag_count != b->tag_count)
+        return 0;
+
+    for (i = 0; i < a->server_count; i++)
+        if (jconf_strcmp(a->servers[i].host, b->servers[i].host) || a->servers[i].port != b->servers[i].port ||
+            a->servers[i].weight != b->servers[i].weight || a->servers[i].tls != b->servers[i].tls)
+            return 0;
+
+    for (i = 0; i < a->port_count; i++)
+        if (a->ports[i] != b->ports[i])
+            return 0;
+
+    for (i = 0; i < a->tag_count; i++)
+        if (jconf_strcmp(a->tags[i], b->tags[i]))
+            return 0;
+
+    return 1;
+}
+
+/**
+ * Test Bind
+ *
+ * Description: Tests decoding JSON into structs and encoding them back.
+ */
+int test_bind(void)
+{
+    static const char config[] =
+        "{\n"
+        "  // Comments and unknown keys are skipped.\n"
+        "  \"name\": \"w\\u00e9b\\n\\ud83d\\ude00\\\"\",\n"
+        "  \"unknown\": {\"a\": [1, {\"b\": \"}\"}], /* ] */ \"c\": null},\n"
+        "  \"debug\": true, \"ratio\": null, \"big\": -9223372036854775808,\n"
+        "  \"limits\": {\"level\": -3, \"extra\": [[]], \"ratio\": 0.100000000000000000000000000000000000000000000000000"
+        "00000000000000000000000000000000000000000000000000"
+        "00000000000000000000000000000000000000000000000000"
+        "00000000000000000000000000000000000000000000000000e0},\n"
+        "  \"servers\": [{\"host\": \"a\", \"port\": 80, \"use-tls\": false, \"weight\": null},\n"
+        "              {\"host\": \"b\", \"port\": 443, \"use-tls\": true, \"weight\": 9007199254740993, \"x\": 1}],\n"
+        "  \"ports\": [1, 2, 3, 4, 5, 6], \"tags\": [\"x\", \"\", \"y\\tz\"], \"name\": \"last\"\n"
+        "}";
+
+    // Malformed documents are reported like the parser.
+    static const char* malformed[] = {
+        "{\"x\": [1, 2,, 3]}",
+        "{\"host\": \"a\\q\"}",
+        "{\"host\": \"\\u12",
+        "{\"host\": \"\\u12x4\"}",
+        "{\"port\": 1,}",
+        "{\n\"x\": {\"a\" 1}}",
+        "{\"port\": 1 /* c",
+        "{\"port\": 01}",
+        "{\"por",
+        "{\"port\" 1}",
+        "  \n"
+    };
+
+    static const struct
+    {
+        const char* json;
+        J_ERROR_CODE e;
+        size_t pos;
+
+    } errors[] = {
+        { "{\"port\": \"80\"}", JCONF_TYPE_MISMATCH, 9 },
+        { "{\"port\": 1.5}", JCONF_TYPE_MISMATCH, 9 },
+        { "{\"port\": 2147483648}", JCONF_INVALID_NUMBER, 9 },
+        { "{\"weight\": 9223372036854775808}", JCONF_INVALID_NUMBER, 11 },
+        { "{\"host\": 1}", JCONF_TYPE_MISMATCH, 9 },
+        { "{\"host\": \"a\", \"use-tls\": 1}", JCONF_TYPE_MISMATCH, 25 },
+        { "[{\"port\": 1}]", JCONF_UNEXPECTED_TOK, 0 }
+    };
+
+    char keys[JCONF_BIND_MAX_FIELDS + 1][8], json[8192], *text;
+    jBindField fields[JCONF_BIND_MAX_FIELDS + 1];
+    int values[JCONF_BIND_MAX_FIELDS + 1];
+    jAllocCounter counter;
+    jAllocator counting;
+    BindConfig a, b;
+    BindServer server;
+    BindNode node;
+    jBindDesc desc;
+    jArgs args, expected;
+    const char* source;
+    size_t size, length;
+    int i, n;
+
+    set_up(TEST_JCONF_BIND);
+
+    /**
+     * Test decoding a config.
+     */
+    jconf_init_counting_allocator(&counting, &counter, NULL);
+
+    if (!assert(jconf_bind_decode(&bind_config_desc, config, sizeof(config) - 1, &a, &counting, &args),
+        "Assert 1: The config was not decoded [error %d at line %d, pos %d].", args.e, (int)args.line, (int)args.pos)) goto failure;
+
+    if (!assert(!jconf_strcmp(a.name, "last") && a.debug == 1 && a.ratio == 0 && a.big == INT64_MIN &&
+        a.limits.level == -3 && a.limits.ratio == 0.1 && a.server_count == 2 && a.port_count == 6 && a.tag_count == 3 &&
+        !jconf_strcmp(a.servers[0].host, "a") && a.servers[0].port == 80 && a.servers[0].weight == 0 && a.servers[0].tls == 0 &&
+        !jconf_strcmp(a.servers[1].host, "b") && a.servers[1].port == 443 && a.servers[1].weight == 9007199254740993LL &&
+        a.servers[1].tls == 1 && a.ports[5] == 6 && !jconf_strcmp(a.tags[1], "") && !jconf_strcmp(a.tags[2], "y\tz"),
+        "Assert 2: The config was not decoded correctly."))
+    {
+        jconf_bind_free(&bind_config_desc, &a, &counting);
+        goto failure;
+    }
+
+    logger(PASS, "Test decoding a config [%d allocations].\n", (int)counter.allocs);
+
+    /**
+     * Test encoding structs.
+     */
+    text = jconf_bind_encode(&bind_config_desc, &a, &size);
+    if (!assert(text != NULL && size == jconf_strlen(text) && jconf_bind_decode(&bind_config_desc, text, size, &b, &counting, &args) &&
+        bind_config_equal(&a, &b), "Assert 3: The config did not survive a round trip:\n%s", text))
+    {
+        jconf_free(NULL, text);
+        jconf_bind_free(&bind_config_desc, &a, &counting);
+        goto failure;
+    }
+
+    jconf_free(NULL, text);
+    jconf_bind_free(&bind_config_desc, &b, &counting);
+
+    // Escapes are decoded and encoded again; a lone surrogate is replaced.
+    source = "{\"name\": \"w\\u00e9b\\n\\ud83d\\ude00\\\"\\ud800\\u0001\"}";
+    jconf_bind_decode(&bind_config_desc, source, jconf_strlen(source), &b, &counting, &args);
+    text = jconf_bind_encode(&bind_config_desc, &b, &size);
+    source = "{\"name\":\"w\xC3\xA9" "b\\n\xF0\x9F\x98\x80\\\"\xEF\xBF\xBD\\u0001\",\"debug\":false,";
+    if (!assert(b.name != NULL && !jconf_strcmp(b.name, "w\xC3\xA9" "b\n\xF0\x9F\x98\x80\"\xEF\xBF\xBD\x01") && text != NULL &&
+        !jconf_strncmp(text, source, jconf_strlen(source)),
+        "Assert 4: Escapes were not decoded and encoded [%s].", text))
+    {
+        jconf_free(NULL, text);
+        jconf_bind_free(&bind_config_desc, &a, &counting);
+        jconf_bind_free(&bind_config_desc, &b, &counting);
+        goto failure;
+    }
+
+    jconf_free(NULL, text);
+    jconf_bind_free(&bind_config_desc, &b, &counting);
+    jconf_bind_free(&bind_config_desc, &a, &counting);
+
+    server.host = "a\"b";
+    server.port = 80;
+    server.weight = -5;
+    server.tls = 1;
+    text = jconf_bind_encode(&bind_server_desc, &server, &size);
+    if (!assert(text != NULL && !jconf_strcmp(text, "{\"host\":\"a\\\"b\",\"port\":80,\"weight\":-5,\"use-tls\":true}"),
+        "Assert 5: The server was not encoded [%s].", text))
+    {
+        jconf_free(NULL, text);
+        goto failure;
+    }
+
+    jconf_free(NULL, text);
+    if (!assert(counter.live == 0, "Assert 6: %d allocations were not freed.", (int)(counter.allocs - counter.frees))) goto failure;
+
+    logger(PASS, "Test encoding structs.\n");
+
+    /**
+     * Test errors.
+     */
+    n = (int)(sizeof(malformed) / sizeof(malformed[0]));
+    for (i = 0; i < n; i++)
+    {
+        length = jconf_strlen(malformed[i]);
+        jconf_free_token(jconf_json2c(malformed[i], length, &expected));
+
+        if (!assert(!jconf_bind_decode(&bind_server_desc, malformed[i], length, &server, &counting, &args) &&
+            args.e == expected.e && args.line == expected.line && args.pos == expected.pos,
+            "Assert 7: Document %d reported error %d at %d:%d instead of %d at %d:%d.", i,
+            args.e, (int)args.line, (int)args.pos, expected.e, (int)expected.line, (int)expected.pos)) goto failure;
+    }
+
+    for (i = 0; i < (int)(sizeof(errors) / sizeof(errors[0])); i++)
+    {
+        if (!assert(!jconf_bind_decode(&bind_server_desc, errors[i].json, jconf_strlen(errors[i].json), &server, &counting, &args) &&
+            args.e == errors[i].e && args.pos == errors[i].pos,
+            "Assert 8: Case %d reported error %d at %d instead of %d at %d.", i, args.e, (int)args.pos, errors[i].e, (int)errors[i].pos)) goto failure;
+    }
+
+    // Failed decodes free what they allocated and zero the struct.
+    source = "{\"name\": \"n\", \"debug\": true, \"ratio\": 2.5, \"tags\": [\"a\", \"b\", 1]}";
+    i = jconf_bind_decode(&bind_config_desc, source, jconf_strlen(source), &a, &counting, &args);
+    if (!assert(!i && args.e == JCONF_TYPE_MISMATCH && a.name == NULL && a.tags == NULL && a.tag_count == 0 && counter.live == 0 &&
+        a.debug == 0 && a.ratio == 0,
+        "Assert 9: A failed decode leaked memory.")) goto failure;
+
+    logger(PASS, "Test %d errors.\n", n + (int)(sizeof(errors) / sizeof(errors[0])) + 1);
+
+    /**
+     * Test descriptors.
+     */
+    for (i = 0; i <= JCONF_BIND_MAX_FIELDS; i++)
+    {
+        snprintf(keys[i], sizeof(keys[i]), "f%d", i);
+        fields[i].key = keys[i];
+        fields[i].type = JCONF_BIND_INT;
+        fields[i].offset = i * sizeof(int);
+        fields[i].desc = NULL;
+        fields[i].element = JCONF_BIND_BOOL;
+        fields[i].count = 0;
+    }
+
+    // Every key of the largest table is found; keys are given in reverse order.
+    json[0] = '{';
+    length = 1;
+    for (i = JCONF_BIND_MAX_FIELDS - 1; i >= 0; i--)
+        length += snprintf(json + length, sizeof(json) - length, "\"f%d\": %d, ", i, i * 7);
+    length += snprintf(json + length, sizeof(json) - length, "\"f%d\": 1, \"f\": 2}", JCONF_BIND_MAX_FIELDS);
+
+    for (n = 1; n <= JCONF_BIND_MAX_FIELDS; n++)
+    {
+        memset(&desc, 0, sizeof(desc));
+        desc.fields = fields;
+        desc.count = n;
+        desc.size = n * sizeof(int);
+
+        if (!assert(jconf_bind_decode(&desc, json, length, values, NULL, &args), "Assert 10: %d fields were not decoded.", n)) goto failure;
+
+        for (i = 0; i < n; i++)
+            if (!assert(values[i] == i * 7, "Assert 11: Field %d of %d was not decoded.", i, n)) goto failure;
+    }
+
+    // Too many fields and duplicate keys are rejected.
+    desc.ready = 0;
+    desc.count = JCONF_BIND_MAX_FIELDS + 1;
+    if (!assert(!jconf_bind_init(&desc) && !jconf_bind_decode(&desc, "{}", 2, values, NULL, &args) && args.e == JCONF_UNEXPECTED_EXPR,
+        "Assert 12: A descriptor with too many fields was accepted.")) goto failure;
+
+    keys[3][1] = '1';
+    desc.count = 4;
+    if (!assert(!jconf_bind_init(&desc), "Assert 13: A descriptor with duplicate keys was accepted.")) goto failure;
+
+    // Recursive descriptors.
+    source = "{\"value\": 1, \"children\": [{\"value\": 2}, {\"children\": [{\"value\": 4, \"children\": []}]}]}";
+    if (!assert(jconf_bind_decode(&bind_node_desc, source, jconf_strlen(source), &node, NULL, &args) && node.child_count == 2 && node.children[0].value == 2 && node.children[1].child_count == 1 &&
+        node.children[1].children[0].value == 4 && node.children[1].children[0].children == NULL,
+        "Assert 14: The tree was not decoded [error %d at %d].", args.e, (int)args.pos)) goto failure;
+
+    jconf_bind_free(&bind_node_desc, &node, NULL);
+
+    for (length = 0, i = 0; i <= JCONF_CURSOR_MAX_DEPTH; i++)
+        length += snprintf(json + length, sizeof(json) - length, "{\"children\":[");
+    if (!assert(length < sizeof(json) && !jconf_bind_decode(&bind_node_desc, json, length, &node, NULL, &args) && args.e == JCONF_MAX_DEPTH,
+        "Assert 15: The depth was not limited [error %d].", args.e)) goto failure;
+
+    logger(PASS, "Test descriptors of up to %d fields.\n", JCONF_BIND_MAX_FIELDS);
+
+    tear_down();
+    return PASS;
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+/**
+ * Test Patch
+ *
+ * Description: Tests JSON pointers and applying JSON patches, including
+ *              rolling back failed patches.
+ */
+int test_patch(void)
+{
+    static const char pointer_doc[] =
+        "{\"foo\": [\"bar\", \"baz\"], \"\": 0, \"a/b\": 1, \"c%d\": 2, \"e^f\": 3, \"g|h\": 4, \" \": 7, \"m~n\": 8, \"o\": {}}";
+
+    static const struct
+    {
+        const char* pointer;
+        const char* value;      // The value's text (NULL if it does not resolve).
+
+    } pointers[] = {
+        { "/foo/0", "bar" }, { "/foo/1", "baz" }, { "/", "0" }, { "/a~1b", "1" }, { "/c%d", "2" }, { "/e^f", "3" },
+        { "/g|h", "4" }, { "/ ", "7" }, { "/m~0n", "8" }, { "/foo/2", NULL }, { "/foo/01", NULL }, { "/foo/-", NULL },
+        { "/foo/0/x", NULL }, { "/o/x", NULL }, { "/m~2n", NULL }, { "foo", NULL }, { "/x", NULL }
+    };
+
+    static const struct
+    {
+        const char* doc;
+        const char* patch;
+        jPatchError e;
+        size_t op;
+        const char* expected;   // The document after the patch.
+
+    } cases[] = {
+        // RFC 6902 appendix A.
+        { "{\"foo\": \"bar\"}", "[{\"op\": \"add\", \"path\": \"/baz\", \"value\": \"qux\"}]", JCONF_PATCH_OK, 0,
+          "{\"baz\": \"qux\", \"foo\": \"bar\"}" },
+        { "{\"foo\": [\"bar\", \"baz\"]}", "[{\"op\": \"add\", \"path\": \"/foo/1\", \"value\": \"qux\"}]", JCONF_PATCH_OK, 0,
+          "{\"foo\": [\"bar\", \"qux\", \"baz\"]}" },
+        { "{\"baz\": \"qux\", \"foo\": \"bar\"}", "[{\"op\": \"remove\", \"path\": \"/baz\"}]", JCONF_PATCH_OK, 0,
+          "{\"foo\": \"bar\"}" },
+        { "{\"foo\": [\"bar\", \"qux\", \"baz\"]}", "[{\"op\": \"remove\", \"path\": \"/foo/1\"}]", JCONF_PATCH_OK, 0,
+          "{\"foo\": [\"bar\", \"baz\"]}" },
+        { "{\"baz\": \"qux\", \"foo\": \"bar\"}", "[{\"op\": \"replace\", \"path\": \"/baz\", \"value\": \"boo\"}]", JCONF_PATCH_OK, 0,
+          "{\"baz\": \"boo\", \"foo\": \"bar\"}" },
+        { "{\"foo\": {\"bar\": \"baz\", \"waldo\": \"fred\"}, \"qux\": {\"corge\": \"grault\"}}",
+          "[{\"op\": \"move\", \"from\": \"/foo/waldo\", \"path\": \"/qux/thud\"}]", JCONF_PATCH_OK, 0,
+          "{\"foo\": {\"bar\": \"baz\"}, \"qux\": {\"corge\": \"grault\", \"thud\": \"fred\"}}" },
+        { "{\"foo\": [\"all\", \"grass\", \"cows\", \"eat\"]}", "[{\"op\": \"move\", \"from\": \"/foo/1\", \"path\": \"/foo/3\"}]",
+          JCONF_PATCH_OK, 0, "{\"foo\": [\"all\", \"cows\", \"eat\", \"grass\"]}" },
+        { "{\"baz\": \"qux\", \"foo\": [\"a\", 2, \"c\"]}",
+          "[{\"op\": \"test\", \"path\": \"/baz\", \"value\": \"qux\"}, {\"op\": \"test\", \"path\": \"/foo/1\", \"value\": 2.0}]",
+          JCONF_PATCH_OK, 0, "{\"baz\": \"qux\", \"foo\": [\"a\", 2, \"c\"]}" },
+        { "{\"baz\": \"qux\"}", "[{\"op\": \"test\", \"path\": \"/baz\", \"value\": \"bar\"}]", JCONF_PATCH_TEST_FAILED, 0,
+          "{\"baz\": \"qux\"}" },
+        { "{\"foo\": \"bar\"}", "[{\"op\": \"add\", \"path\": \"/child\", \"value\": {\"grandchild\": {}}}]", JCONF_PATCH_OK, 0,
+          "{\"foo\": \"bar\", \"child\": {\"grandchild\": {}}}" },
+        { "{\"foo\": \"bar\"}", "[{\"op\": \"add\", \"path\": \"/baz/bat\", \"value\": \"qux\"}]", JCONF_PATCH_NOT_FOUND, 0,
+          "{\"foo\": \"bar\"}" },
+        { "{\"/\": 9, \"~1\": 10}", "[{\"op\": \"test\", \"path\": \"/~01\", \"value\": 10}]", JCONF_PATCH_OK, 0,
+          "{\"/\": 9, \"~1\": 10}" },
+        { "{\"foo\": [\"bar\"]}", "[{\"op\": \"add\", \"path\": \"/foo/-\", \"value\": [\"abc\", \"def\"]}]", JCONF_PATCH_OK, 0,
+          "{\"foo\": [\"bar\", [\"abc\", \"def\"]]}" },
+
+        // Documents, empty containers, copies and moves.
+        { "{\"a\": 1}", "[{\"op\": \"add\", \"path\": \"\", \"value\": [1]}, {\"op\": \"add\", \"path\": \"/0\", \"value\": 0}]",
+          JCONF_PATCH_OK, 0, "[0, 1]" },
+        { "{\"a\": 1}", "[{\"op\": \"remove\", \"path\": \"\"}]", JCONF_PATCH_NOT_FOUND, 0, "{\"a\": 1}" },
+        { "{\"o\": {}, \"l\": []}", "[{\"op\": \"add\", \"path\": \"/o/x\", \"value\": 1}, {\"op\": \"add\", \"path\": \"/l/0\", \"value\": 2}]",
+          JCONF_PATCH_OK, 0, "{\"o\": {\"x\": 1}, \"l\": [2]}" },
+        { "{\"a\": {\"b\": 1}}", "[{\"op\": \"copy\", \"from\": \"/a\", \"path\": \"/c\"}, {\"op\": \"add\", \"path\": \"/c/d\", \"value\": 2}]",
+          JCONF_PATCH_OK, 0, "{\"a\": {\"b\": 1}, \"c\": {\"b\": 1, \"d\": 2}}" },
+        { "{\"a\": {\"b\": 1}}", "[{\"op\": \"move\", \"from\": \"/a\", \"path\": \"/a/c\"}]", JCONF_PATCH_INVALID, 0, "{\"a\": {\"b\": 1}}" },
+        { "{\"a\": {\"b\": 1}}", "[{\"op\": \"move\", \"from\": \"/a\", \"path\": \"/a\"}]", JCONF_PATCH_OK, 0, "{\"a\": {\"b\": 1}}" },
+        { "{\"a\": {\"b\": [1, 2]}}", "[{\"op\": \"move\", \"from\": \"/a/b\", \"path\": \"/a\"}]", JCONF_PATCH_OK, 0, "{\"a\": [1, 2]}" },
+        { "{\"a\": {\"b\": [1, 2]}}", "[{\"op\": \"move\", \"from\": \"/a/b/1\", \"path\": \"\"}]", JCONF_PATCH_OK, 0, "2" },
+        { "{\"a\": [1]}", "[{\"op\": \"replace\", \"path\": \"/a/1\", \"value\": 2}]", JCONF_PATCH_NOT_FOUND, 0, "{\"a\": [1]}" },
+        { "{\"a\": [1]}", "[{\"op\": \"add\", \"path\": \"/a/2\", \"value\": 2}]", JCONF_PATCH_NOT_FOUND, 0, "{\"a\": [1]}" },
+
+        // Failed patches roll back every operation before the failure.
+        { "{\"a\": 1, \"b\": [1, 2, 3], \"c\": {\"d\": \"e\"}, \"f\": null}",
+          "[{\"op\": \"add\", \"path\": \"/g\", \"value\": {\"h\": 1}}, {\"op\": \"remove\", \"path\": \"/a\"},"
+          " {\"op\": \"replace\", \"path\": \"/b/0\", \"value\": 5}, {\"op\": \"remove\", \"path\": \"/b/1\"},"
+          " {\"op\": \"add\", \"path\": \"/b/0\", \"value\": 0}, {\"op\": \"move\", \"from\": \"/c/d\", \"path\": \"/g/i\"},"
+          " {\"op\": \"move\", \"from\": \"/c\", \"path\": \"/b/-\"}, {\"op\": \"copy\", \"from\": \"/g\", \"path\": \"/f\"},"
+          " {\"op\": \"remove\", \"path\": \"/g\"}, {\"op\": \"add\", \"path\": \"\", \"value\": {\"z\": 1}},"
+          " {\"op\": \"add\", \"path\": \"/y\", \"value\": 2}, {\"op\": \"test\", \"path\": \"/y\", \"value\": 3}]",
+          JCONF_PATCH_TEST_FAILED, 11, "{\"a\": 1, \"b\": [1, 2, 3], \"c\": {\"d\": \"e\"}, \"f\": null}" },
+        { "{\"a\": 1, \"b\": [1, 2, 3], \"c\": {\"d\": \"e\"}}",
+          "[{\"op\": \"remove\", \"path\": \"/a\"}, {\"op\": \"add\", \"path\": \"/a\", \"value\": 2}, {\"op\": \"remove\", \"path\": \"/b/0\"},"
+          " {\"op\": \"move\", \"from\": \"/c/d\", \"path\": \"/c/e\"}, {\"op\": \"remove\", \"path\": \"/x\"}]",
+          JCONF_PATCH_NOT_FOUND, 4, "{\"a\": 1, \"b\": [1, 2, 3], \"c\": {\"d\": \"e\"}}" },
+
+        // Malformed patches.
+        { "{}", "[{\"path\": \"/a\"}]", JCONF_PATCH_INVALID, 0, "{}" },
+        { "{}", "[{\"op\": \"test\", \"path\": \"\", \"value\": {}}, {\"op\": \"append\", \"path\": \"/a\"}]", JCONF_PATCH_INVALID, 1, "{}" },
+        { "{}", "[{\"op\": \"add\", \"path\": \"a\", \"value\": 1}]", JCONF_PATCH_INVALID, 0, "{}" },
+        { "{}", "[{\"op\": \"add\", \"path\": \"/~2\", \"value\": 1}]", JCONF_PATCH_INVALID, 0, "{}" },
+        { "{}", "[{\"op\": \"add\", \"path\": \"/a\"}]", JCONF_PATCH_INVALID, 0, "{}" },
+        { "{}", "[{\"op\": \"copy\", \"path\": \"/a\"}]", JCONF_PATCH_INVALID, 0, "{}" },
+        { "{}", "{\"op\": \"remove\", \"path\": \"/a\"}", JCONF_PATCH_INVALID, 0, "{}" }
+    };
+
+    static const char order_doc[] = "{\"a\": 1, \"b\": 2, \"c\": 3, \"d\": 4}";
+    static const char order_patch[] =
+        "[{\"op\": \"remove\", \"path\": \"/b\"}, {\"op\": \"remove\", \"path\": \"/d\"}, {\"op\": \"add\", \"path\": \"/e\", \"value\": 5},"
+        " {\"op\": \"remove\", \"path\": \"/a\"}, {\"op\": \"test\", \"path\": \"/e\", \"value\": 0}]";
+
+    jToken *root, *head, *expected, *value;
+    jAllocator counting, limited = { limited_alloc, limited_realloc, limited_free, NULL };
+    jPatch *patch, *check;
+    jAllocCounter counter;
+    jParseOptions options;
+    jPatchResult result;
+    jObjectIter members;
+    const char* key;
+    char json[256];
+    jArgs args;
+    size_t len;
+    int i, n;
+
+    set_up(TEST_JCONF_PATCH);
+
+    /**
+     * Test resolving pointers (RFC 6901 section 5).
+     */
+    root = jconf_json2c(pointer_doc, jconf_strlen(pointer_doc), &args);
+    if (!assert(root != NULL && jconf_pointer_resolve(root, "") == root &&
+        jconf_pointer_resolve(root, "/foo")->type == JCONF_ARRAY, "Assert 1: The document was not resolved.")) goto failure;
+
+    n = (int)(sizeof(pointers) / sizeof(pointers[0]));
+    for (i = 0; i < n; i++)
+    {
+        value = jconf_pointer_resolve(root, pointers[i].pointer);
+        if (!assert(pointers[i].value != NULL ? value != NULL && !jconf_strcmp((const char*)value->data, pointers[i].value) : value == NULL,
+            "Assert 2: Pointer %d ('%s') was not resolved.", i, pointers[i].pointer))
+        {
+            jconf_free_token(root);
+            goto failure;
+        }
+    }
+
+    jconf_free_token(root);
+    logger(PASS, "Test resolving %d pointers.\n", n);
+
+    /**
+     * Test applying patches (RFC 6902 appendix A and more).
+     */
+    n = (int)(sizeof(cases) / sizeof(cases[0]));
+    for (i = 0; i < n; i++)
+    {
+        root = jconf_json2c_ex(cases[i].doc, jconf_strlen(cases[i].doc), NULL, &args);
+        head = jconf_json2c(cases[i].patch, jconf_strlen(cases[i].patch), &args);
+
+        // Compare the documents with a test of the whole document.
+        snprintf(json, sizeof(json), "[{\"op\": \"test\", \"path\": \"\", \"value\": %s}]", cases[i].expected);
+        expected = jconf_json2c(json, jconf_strlen(json), &args);
+        check = jconf_patch_compile(expected, NULL);
+
+        if ((patch = jconf_patch_compile(head, &result)) != NULL)
+            jconf_patch_apply(patch, &root, NULL, &result);
+
+        if (!assert(result.e == cases[i].e && result.op == cases[i].op &&
+            jconf_patch_apply(check, &root, NULL, NULL),
+            "Assert 3: Patch %d was not applied [error %d at %d].", i, result.e, (int)result.op))
+        {
+            jconf_patch_free(check);
+            jconf_patch_free(patch);
+            jconf_free_token(expected);
+            jconf_free_token(head);
+            jconf_free_token(root);
+            goto failure;
+        }
+
+        jconf_patch_free(check);
+        jconf_patch_free(patch);
+        jconf_free_token(expected);
+        jconf_free_token(head);
+        jconf_free_token(root);
+    }
+
+    logger(PASS, "Test %d patches.\n", n);
+
+    /**
+     * Test that rolling back keeps the order of members.
+     */
+    root = jconf_json2c(order_doc, jconf_strlen(order_doc), &args);
+    head = jconf_json2c(order_patch, jconf_strlen(order_patch), &args);
+    patch = jconf_patch_compile(head, NULL);
+
+    if (!assert(!jconf_patch_apply(patch, &root, NULL, &result) && result.e == JCONF_PATCH_TEST_FAILED && result.op == 4,
+        "Assert 4: The patch did not fail [error %d].", result.e)) goto order_failure;
+
+    jconf_object_iter_begin(root, &members);
+    for (i = 0; jconf_object_iter_next(&members, &key, &len, &value); i++)
+        if (!assert(len == 1 && key[0] == "abcd"[i] && ((jMap*)root->data)->last->key[0] == 'd',
+            "Assert 5: Member %d is out of order after the rollback.", i)) goto order_failure;
+
+    if (!assert(i == 4, "Assert 6: The rollback left %d members.", i)) goto order_failure;
+
+    jconf_patch_free(patch);
+    jconf_free_token(head);
+    logger(PASS, "Test the order of members after a rollback.\n");
+
+    /**
+     * Test running out of memory at every allocation of a patch.
+     */
+    head = jconf_json2c(cases[23].patch, jconf_strlen(cases[23].patch), &args);
+    patch = jconf_patch_compile(head, NULL);
+    jconf_free_token(root);
+
+    jconf_init_counting_allocator(&counting, &counter, &limited);
+    options.allocator = &counting;
+    options.stats = NULL;
+    options.duplicates = JCONF_DUP_LAST_WINS;
+    options.mode = JCONF_MODE_DEFAULT;
+    options.hash = 0;
+
+    for (i = 0; ; i++)
+    {
+        alloc_budget = 1 << 30;
+        root = jconf_json2c_ex(cases[23].doc, jconf_strlen(cases[23].doc), &options, &args);
+        n = (int)counter.live;
+
+        alloc_budget = i;
+        if (jconf_patch_apply(patch, &root, &counting, &result) || result.e != JCONF_PATCH_OUT_OF_MEMORY)
+            break;
+
+        if (!assert((int)counter.live == n, "Assert 7: Failed allocation %d leaked memory.", i)) goto memory_failure;
+        jconf_free_token_with(root, &counting);
+    }
+
+    jconf_free_token_with(root, &counting);
+    if (!assert(result.e == JCONF_PATCH_TEST_FAILED && counter.live == 0, "Assert 8: The patch did not fail its test [error %d].", result.e))
+    {
+        root = NULL;
+        goto memory_failure;
+    }
+
+    jconf_patch_free(patch);
+    jconf_free_token(head);
+    logger(PASS, "Test running out of memory [%d failure points].\n", i);
+
+    tear_down();
+    return PASS;
+
+memory_failure:
+    jconf_free_token_with(root, &counting);
+    jconf_patch_free(patch);
+    jconf_free_token(head);
+    tear_down();
+    return FAILURE;
+
+order_failure:
+    jconf_patch_free(patch);
+    jconf_free_token(head);
+    jconf_free_token(root);
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+/**
+ * Diff Changes
+ *
+ * Description: Appends each change to a string as "op path;".
+ */
+static int diff_changes(const jDiffChange* change, void* data)
+{
+    static const char* ops[] = { "add", "remove", "replace" };
+    char* text = (char*)data;
+
+    sprintf(text + strlen(text), "%s %s;", ops[change->op], change->path);
+    return 1;
+}
+
+/**
+ * Diff Stop
+ *
+ * Description: Stops a diff at the first change.
+ */
+static int diff_stop(const jDiffChange* change, void* data)
+{
+    (*(int*)data)++;
+    return change == NULL;
+}
+
+/**
+ * Diff Matches
+ *
+ * Description: Applies the diff of two documents to the first and tests
+ *              that it became the second.
+ *
+ * @returns // The number of operations (-1 if the patch did not apply).
+ */
+static int diff_matches(const char* a, const char* b)
+{
+    jToken *x, *y, *patch, *test;
+    jPatch *compiled, *check;
+    int count = -1;
+    char json[4096];
+    jArgs args;
+
+    x = jconf_json2c(a, jconf_strlen(a), &args);
+    y = jconf_json2c(b, jconf_strlen(b), &args);
+    patch = jconf_diff(x, y, NULL);
+
+    snprintf(json, sizeof(json), "[{\"op\": \"test\", \"path\": \"\", \"value\": %s}]", b);
+    test = jconf_json2c(json, jconf_strlen(json), &args);
+    check = jconf_patch_compile(test, NULL);
+
+    if (patch != NULL && (compiled = jconf_patch_compile(patch, NULL)) != NULL)
+    {
+        if (jconf_patch_apply(compiled, &x, NULL, NULL) && jconf_patch_apply(check, &x, NULL, NULL))
+            count = patch->data != NULL ? (int)((jArray*)patch->data)->end : 0;
+        jconf_patch_free(compiled);
+    }
+
+    jconf_patch_free(check);
+    jconf_free_token(test);
+    jconf_free_token(patch);
+    jconf_free_token(y);
+    jconf_free_token(x);
+    return count;
+}
+
+/**
+ * Test Diff
+ *
+ * Description: Tests diffing trees into JSON patches.
+ */
+int test_diff(void)
+{
+    static const struct
+    {
+        const char *a, *b;
+        const char* changes;    // The changes, as reported to the callback.
+
+    } cases[] = {
+        { "{\"a\": 1, \"b\": [1, 2]}", "{\"b\": [1, 2], \"a\": 1.0}", "" },
+        { "{\"a\": 1}", "[\"1\"]", "replace ;" },
+        { "{\"a\": {\"b\": {\"c\": 1, \"d\": 2}}, \"e\": 3}", "{\"a\": {\"b\": {\"c\": 1, \"d\": 5}}, \"e\": 3}", "replace /a/b/d;" },
+        { "{\"a\": 1, \"b\": 2}", "{\"b\": 2, \"c\": 3}", "remove /a;add /c;" },
+        { "{\"a/b\": 1, \"m~n\": 2}", "{\"a/b\": 2, \"m~n\": 3}", "replace /a~1b;replace /m~0n;" },
+        { "{}", "{\"a\": []}", "add /a;" },
+        { "{\"a\": {}}", "{\"a\": []}", "replace /a;" },
+        { "[1, 2, 3, 4, 5]", "[1, 2, 9, 3, 4, 5]", "add /2;" },
+        { "[1, 2, 3, 4, 5]", "[1, 3, 5]", "remove /1;remove /2;" },
+        { "[1, 2, 3]", "[0, 1, 2, 3, 4]", "add /0;add /4;" },
+        { "[1, 2, 3]", "[]", "remove /0;remove /0;remove /0;" },
+        { "[1, 2, 3]", "[3, 2, 1]", "remove /0;remove /0;add /1;add /2;" },
+        { "[{\"id\": 1, \"v\": 1}, {\"id\": 2, \"v\": 2}, {\"id\": 3}]", "[{\"id\": 1, \"v\": 1}, {\"id\": 2, \"v\": 5}, {\"id\": 3}]", "replace /1/v;" },
+        { "[\"a\", \"b\", \"c\", \"d\"]", "[\"a\", \"x\", \"c\", \"y\", \"d\"]", "replace /1;add /3;" },
+        { "{\"a\": [1, [2, 3]], \"b\": null}", "{\"a\": [1, [2, 4]], \"b\": false}", "replace /a/1/1;replace /b;" },
+        { "{\"id\": 9007199254740992, \"n\": [1, 12345678901234567890]}", "{\"id\": 9007199254740993, \"n\": [1, 12345678901234567891]}", "replace /id;replace /n/1;" }
+    };
+
+    jToken *a, *b, *patch;
+    jAllocator counting, limited = { limited_alloc, limited_realloc, limited_free, NULL };
+    jAllocCounter counter;
+    char x[4096], y[4096];
+    char changes[256];
+    jPatch* compiled;
+    jArgs args;
+    int i, j, n, count, stops;
+    unsigned seed = 12345;
+
+    set_up(TEST_JCONF_DIFF);
+
+    /**
+     * Test the changes between documents.
+     */
+    n = (int)(sizeof(cases) / sizeof(cases[0]));
+    for (i = 0; i < n; i++)
+    {
+        a = jconf_json2c(cases[i].a, jconf_strlen(cases[i].a), &args);
+        b = jconf_json2c(cases[i].b, jconf_strlen(cases[i].b), &args);
+        changes[0] = '\0';
+        j = jconf_diff_each(a, b, &diff_changes, changes);
+
+        jconf_free_token(a);
+        jconf_free_token(b);
+        if (!assert(j && !strcmp(changes, cases[i].changes), "Assert 1: Case %d reported '%s'.", i, changes)) goto failure;
+        if (!assert(diff_matches(cases[i].a, cases[i].b) >= 0, "Assert 2: The diff of case %d did not apply.", i)) goto failure;
+    }
+
+    logger(PASS, "Test %d diffs.\n", n);
+
+    /**
+     * Test random edits of arrays.
+     */
+    for (i = 0; i < 500; i++)
+    {
+        n = sprintf(x, "[");
+        for (j = 0, count = (seed = seed * 1103515245 + 12345) >> 16 & 31; j < count; j++)
+            n += sprintf(x + n, "%s%u", j ? ", " : "", (seed = seed * 1103515245 + 12345) >> 16 & 7);
+        sprintf(x + n, "]");
+
+        // Keep, drop, change or insert around each element.
+        n = sprintf(y, "[");
+        for (j = 0, count = 0; x[j] != '\0'; j++)
+        {
+            if (x[j] < '0' || x[j] > '9')
+                continue;
+
+            switch ((seed = seed * 1103515245 + 12345) >> 16 & 3)
+            {
+                case 0: n += sprintf(y + n, "%s%c", count++ ? ", " : "", x[j]); break;
+                case 1: break;
+                case 2: n += sprintf(y + n, "%s{\"v\": %c}", count++ ? ", " : "", x[j]); break;
+                case 3: n += sprintf(y + n, "%s%c, 9", count++ ? ", " : "", x[j]); count++; break;
+            }
+        }
+        sprintf(y + n, "]");
+
+        if (!assert(diff_matches(x, y) >= 0, "Assert 3: The diff of %s and %s did not apply.", x, y)) goto failure;
+    }
+
+    // Long edit scripts pair elements by position.
+    n = sprintf(x, "[");
+    n += sprintf(y, "[");
+    for (j = 0; j < 600; j++)
+    {
+        sprintf(x + strlen(x), "%s%d", j ? "," : "", j);
+        sprintf(y + strlen(y), "%s%d", j ? "," : "", j % 2 ? j : -j - 1);
+    }
+    strcat(x, "]");
+    strcat(y, "]");
+
+    if (!assert(diff_matches(x, y) == 300, "Assert 4: The long diff was not applied by position.")) goto failure;
+
+    logger(PASS, "Test 501 diffs of arrays.\n");
+
+    /**
+     * Test memoized hashes.
+     */
+    a = jconf_json2c(cases[12].a, jconf_strlen(cases[12].a), &args);
+    b = jconf_json2c(cases[12].b, jconf_strlen(cases[12].b), &args);
+    patch = jconf_diff(b, a, NULL);
+    compiled = jconf_patch_compile(patch, NULL);
+
+    if (!assert(((jArray*)a->data)->digest != 0 && ((jMap*)jconf_get(a, "a", 2)->data)->digest != 0,
+        "Assert 5: The hashes were not memoized.")) goto digest_failure;
+
+    // Patching b clears the hashes on its path, so b becomes a again.
+    stops = 0;
+    if (!assert(jconf_patch_apply(compiled, &b, NULL, NULL) && ((jArray*)b->data)->digest == 0 &&
+        ((jMap*)jconf_get(b, "a", 1)->data)->digest == 0 && ((jMap*)jconf_get(b, "a", 2)->data)->digest != 0 &&
+        jconf_diff_each(a, b, &diff_stop, &stops) && stops == 0, "Assert 6: A patched tree was not rehashed.")) goto digest_failure;
+
+    jconf_patch_free(compiled);
+    jconf_free_token(patch);
+    patch = jconf_diff(a, b, NULL);
+    compiled = NULL;
+
+    if (!assert(patch != NULL && patch->type == JCONF_ARRAY && patch->data == NULL, "Assert 7: Equal trees had changes.")) goto digest_failure;
+    jconf_free_token(patch);
+    jconf_free_token(b);
+
+    b = jconf_json2c(cases[13].b, jconf_strlen(cases[13].b), &args);
+    patch = NULL;
+    if (!assert(!jconf_diff_each(a, b, &diff_stop, &stops) && stops == 1, "Assert 8: The callback did not stop the diff.")) goto digest_failure;
+
+    jconf_free_token(b);
+    jconf_free_token(a);
+    logger(PASS, "Test memoized hashes.\n");
+
+    /**
+     * Test containers whose hashes collide.
+     */
+    a = jconf_json2c("[{\"k\": 1}, {\"k\": 2}, [3]]", 25, &args);
+    b = jconf_json2c("[{\"k\": 1}, {\"k\": 5}, [4]]", 25, &args);
+    jconf_hash_token(a, 0);
+    jconf_hash_token(b, 0);
+
+    // Give the changed containers the hashes of the old ones.
+    ((jArray*)b->data)->digest = ((jArray*)a->data)->digest;
+    ((jMap*)jconf_get(b, "a", 1)->data)->digest = ((jMap*)jconf_get(a, "a", 1)->data)->digest;
+    ((jArray*)jconf_get(b, "a", 2)->data)->digest = ((jArray*)jconf_get(a, "a", 2)->data)->digest;
+
+    changes[0] = '\0';
+    j = jconf_diff_each(a, b, &diff_changes, changes);
+    jconf_free_token(b);
+    jconf_free_token(a);
+
+    if (!assert(j && !strcmp(changes, "replace /1/k;replace /2/0;"),
+        "Assert 9: Colliding hashes hid changes [%s].", changes)) goto failure;
+
+    logger(PASS, "Test colliding hashes.\n");
+
+    /**
+     * Test running out of memory while building a patch.
+     */
+    a = jconf_json2c(cases[14].a, jconf_strlen(cases[14].a), &args);
+    b = jconf_json2c(cases[14].b, jconf_strlen(cases[14].b), &args);
+    jconf_init_counting_allocator(&counting, &counter, &limited);
+
+    for (i = 0; ; i++)
+    {
+        alloc_budget = i;
+        if ((patch = jconf_diff(a, b, &counting)) != NULL)
+            break;
+
+        if (!assert(counter.live == 0, "Assert 10: Failed allocation %d leaked memory.", i))
+        {
+            jconf_free_token(b);
+            jconf_free_token(a);
+            goto failure;
+        }
+    }
+
+    j = patch->data != NULL && ((jArray*)patch->data)->end == 2;
+    jconf_free_token_with(patch, &counting);
+    jconf_free_token(b);
+    jconf_free_token(a);
+
+    if (!assert(j && counter.live == 0, "Assert 11: The patch was not built.")) goto failure;
+    logger(PASS, "Test running out of memory [%d failure points].\n", i);
+
+    tear_down();
+    return PASS;
+
+digest_failure:
+    jconf_patch_free(compiled);
+    jconf_free_token(patch);
+    jconf_free_token(b);
+    jconf_free_token(a);
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+/**
+ * Test Hash
+ *
+ * Description: Tests hashing trees and comparing them.
+ */
+int test_hash(void)
+{
+    static const struct
+    {
+        const char *a, *b;
+        int equal;
+
+    } cases[] = {
+        { "{\"a\": 1, \"b\": [1, 2]}", "{\"b\": [1, 2], \"a\": 1}", 1 },
+        { "{\"a\": 1, \"b\": 2}", "{\"a\": 2, \"b\": 1}", 0 },
+        { "[1, 2]", "[2, 1]", 0 },
+        { "[1, -0, 2.50]", "[1.0, 0, 25e-1]", 1 },
+        { "[\"a\", \"1\"]", "[\"a\", 1]", 0 },
+        { "[true, null, false]", "[true, null, false]", 1 },
+        { "[true, null, false]", "[true, false, null]", 0 },
+        { "{\"a\": {}, \"b\": []}", "{\"a\": [], \"b\": {}}", 0 },
+        { "{\"a\": {\"x\": [1, {\"y\": 2}]}}", "{\"a\": {\"x\": [1, {\"y\": 2.0}]}}", 1 },
+        { "{\"a\": {\"x\": [1, {\"y\": 2}]}}", "{\"a\": {\"x\": [1, {\"z\": 2}]}}", 0 },
+        { "{\"ab\": 1, \"c\": 2}", "{\"a\": 1, \"bc\": 2}", 0 },
+        { "{\"id\": 9007199254740993}", "{\"id\": 9007199254740992}", 0 },
+        { "[12345678901234567890, -1]", "[12345678901234567891, -1]", 0 },
+        { "[123456789012345678901234]", "[-123456789012345678901234]", 0 },
+        { "[9007199254740992, -9223372036854775808]", "[9007199254740992.0, -9.223372036854775808e18]", 1 }
+    };
+
+    jToken *a, *b;
+    jParseOptions options;
+    jArgs args;
+    jHash x, y;
+    int i, n;
+
+    set_up(TEST_JCONF_HASH);
+
+    /**
+     * Test that equal trees hash equally.
+     */
+    n = (int)(sizeof(cases) / sizeof(cases[0]));
+    for (i = 0; i < n; i++)
+    {
+        a = jconf_json2c(cases[i].a, jconf_strlen(cases[i].a), &args);
+        b = jconf_json2c(cases[i].b, jconf_strlen(cases[i].b), &args);
+
+        // Compare before and after the digests are memoized.
+        x = jconf_equal(a, b);
+        y = jconf_hash_token(a, 7) == jconf_hash_token(b, 7);
+        x = x == (jHash)cases[i].equal && x == (jHash)jconf_equal(a, b) && (jHash)jconf_equal(b, a) == x;
+
+        jconf_free_token(a);
+        jconf_free_token(b);
+        if (!assert(x && y == (jHash)cases[i].equal, "Assert 1: Case %d did not compare as expected.", i)) goto failure;
+    }
+
+    logger(PASS, "Test %d comparisons.\n", n);
+
+    /**
+     * Test seeds.
+     */
+    a = jconf_json2c(cases[0].a, jconf_strlen(cases[0].a), &args);
+    x = jconf_hash_token(a, 0);
+    y = jconf_hash_token(a, 1);
+    jconf_free_token(a);
+
+    // Hashes do not depend on the process.
+    if (!assert(x != y && x == 0x7db1af44bdda7365ULL, "Assert 2: Case 0 hashed to %llx, %llx.",
+        (unsigned long long)x, (unsigned long long)y)) goto failure;
+
+    logger(PASS, "Test seeds.\n");
+
+    /**
+     * Test memoizing the hashes while parsing.
+     */
+    options.allocator = NULL;
+    options.stats = NULL;
+    options.duplicates = JCONF_DUP_LAST_WINS;
+    options.mode = JCONF_MODE_DEFAULT;
+    options.hash = 1;
+
+    a = jconf_json2c_ex(cases[9].a, jconf_strlen(cases[9].a), &options, &args);
+    b = jconf_json2c_ex(cases[9].b, jconf_strlen(cases[9].b), &options, &args);
+    i = ((jMap*)a->data)->digest != 0 && ((jArray*)jconf_get(a, "oo", "a", "x")->data)->digest != 0 &&
+        ((jMap*)jconf_get(b, "ooa", "a", "x", 1)->data)->digest != 0 && !jconf_equal(a, b);
+
+    // Digests that differ reject equal trees without visiting them.
+    jconf_free_token(b);
+    b = jconf_json2c_ex(cases[9].a, jconf_strlen(cases[9].a), &options, &args);
+    i = i && jconf_equal(a, b);
+
+    ((jMap*)jconf_get(a, "o", "a")->data)->digest ^= 1;
+    i = i && !jconf_equal(a, b);
+
+    // Cleared digests are recomputed.
+    jconf_hash_clear(a);
+    i = i && ((jMap*)a->data)->digest == 0 && ((jMap*)jconf_get(a, "o", "a")->data)->digest == 0 &&
+        jconf_equal(a, b) && jconf_hash_token(a, 0) == jconf_hash_token(b, 0) &&
+        ((jMap*)a->data)->digest == ((jMap*)b->data)->digest;
+
+    jconf_free_token(a);
+    jconf_free_token(b);
+    if (!assert(i, "Assert 3: The hashes were not memoized while parsing.")) goto failure;
+
+    logger(PASS, "Test memoized hashes.\n");
+
+    tear_down();
+    return PASS;
+
+failure:
+    tear_down();
+    return FAILURE;
+}
+
+/**
+ * Merge Parse
+ *
+ * Description: Parses a test document in strict mode, so that any value can
+ *              be the root.
+ */
+static jToken* merge_parse(const char* json)
+{
+    jParseOptions options;
+    jArgs args;
+
+    options.allocator = NULL;
+    options.stats = NULL;
+    options.duplicates = JCONF_DUP_LAST_WINS;
+    options.mode = JCONF_MODE_STRICT;
+    options.hash = 0;
+
+    return jconf_json2c_ex(json, jconf_strlen(json), &options, &args);
+}
+
+/**
+ * Merge Refs
+ *
+ * Description: Returns the number of trees sharing a container besides its owner.
+ */
+static size_t merge_refs(const jToken* token)
+{
+    return token->type == JCONF_OBJECT ? ((jMap*)token->data)->refs : ((jArray*)token->data)->refs;
+}
+
+/**
+ * Test Merge
+ *
+ * Description: Tests merging trees with merge patch semantics.
+ */
+int test_merge(void)
+{
+    static const struct
+    {
+        const char *base, *overlay;
+        jMergePolicy policy;
+        const char* merged;
+
+    } cases[] = {
+        // RFC 7396, Appendix A.
+        { "{\"a\": \"b\"}", "{\"a\": \"c\"}", JCONF_MERGE_REPLACE, "{\"a\": \"c\"}" },
+        { "{\"a\": \"b\"}", "{\"b\": \"c\"}", JCONF_MERGE_REPLACE, "{\"a\": \"b\", \"b\": \"c\"}" },
+        { "{\"a\": \"b\"}", "{\"a\": null}", JCONF_MERGE_REPLACE, "{}" },
+        { "{\"a\": \"b\", \"b\": \"c\"}", "{\"a\": null}", JCONF_MERGE_REPLACE, "{\"b\": \"c\"}" },
+        { "{\"a\": [\"b\"]}", "{\"a\": \"c\"}", JCONF_MERGE_REPLACE, "{\"a\": \"c\"}" },
+        { "{\"a\": \"c\"}", "{\"a\": [\"b\"]}", JCONF_MERGE_REPLACE, "{\"a\": [\"b\"]}" },
+        { "{\"a\": {\"b\": \"c\"}}", "{\"a\": {\"b\": \"d\", \"c\": null}}", JCONF_MERGE_REPLACE, "{\"a\": {\"b\": \"d\"}}" },
+        { "{\"a\": [{\"b\": \"c\"}]}", "{\"a\": [1]}", JCONF_MERGE_REPLACE, "{\"a\": [1]}" },
+        { "[\"a\", \"b\"]", "[\"c\", \"d\"]", JCONF_MERGE_REPLACE, "[\"c\", \"d\"]" },
+        { "{\"a\": \"b\"}", "[\"c\"]", JCONF_MERGE_REPLACE, "[\"c\"]" },
+        { "{\"a\": \"foo\"}", "null", JCONF_MERGE_REPLACE, "null" },
+        { "{\"a\": \"foo\"}", "\"bar\"", JCONF_MERGE_REPLACE, "\"bar\"" },
+        { "{\"e\": null}", "{\"a\": 1}", JCONF_MERGE_REPLACE, "{\"e\": null, \"a\": 1}" },
+        { "[1, 2]", "{\"a\": \"b\", \"c\": null}", JCONF_MERGE_REPLACE, "{\"a\": \"b\"}" },
+        { "{}", "{\"a\": {\"bb\": {\"ccc\": null}}}", JCONF_MERGE_REPLACE, "{\"a\": {\"bb\": {}}}" },
+
+        // Array policies.
+        { "{\"a\": [1, 2]}", "{\"a\": [2, 3]}", JCONF_MERGE_APPEND, "{\"a\": [1, 2, 2, 3]}" },
+        { "{\"a\": [1, 2]}", "{\"a\": [2, 3, 3.0]}", JCONF_MERGE_UNION, "{\"a\": [1, 2, 3]}" },
+        { "{\"a\": [{\"x\": 1}]}", "{\"a\": [{\"x\": 1.0}, {\"x\": 2}]}", JCONF_MERGE_UNION, "{\"a\": [{\"x\": 1}, {\"x\": 2}]}" },
+        { "{\"a\": [{\"x\": 1, \"y\": 2}, 5, 6]}", "{\"a\": [{\"y\": null}, 7]}", JCONF_MERGE_INDEX, "{\"a\": [{\"x\": 1}, 7, 6]}" },
+        { "[1]", "[2, [3, null]]", JCONF_MERGE_INDEX, "[2, [3, null]]" },
+        { "{\"a\": 1}", "{\"a\": [1]}", JCONF_MERGE_APPEND, "{\"a\": [1]}" },
+        { "{\"a\": [1, 2]}", "{\"a\": []}", JCONF_MERGE_APPEND, "{\"a\": [1, 2]}" },
+        { "{\"a\": [1, 2]}", "{\"a\": [3]}", JCONF_MERGE_REPLACE, "{\"a\": [3]}" }
+    };
+
+    static const char* base_json = "{\"x\": {\"deep\": [1, 2, {\"k\": \"v\"}]}, \"y\": {\"p\": 1, \"q\": 2}, \"z\": [1, 2]}";
+
+    jToken *base, *overlay, *expected, *merged, *layered, *same;
+    jAllocator counting, limited = { limited_alloc, limited_realloc, limited_free, NULL };
+    jAllocCounter counter;
+    jObjectIter members;
+    jPatch *edit, *failed;
+    const char* key;
+    char changes[256];
+    size_t length;
+    int i, n, equal;
+
+    set_up(TEST_JCONF_MERGE);
+
+    /**
+     * Test merge patch semantics and the array policies.
+     */
+    n = (int)(sizeof(cases) / sizeof(cases[0]));
+    for (i = 0; i < n; i++)
+    {
+        base = merge_parse(cases[i].base);
+        overlay = merge_parse(cases[i].overlay);
+        expected = merge_parse(cases[i].merged);
+        merged = jconf_merge(base, overlay, cases[i].policy);
+
+        // The merged tree outlives its inputs.
+        jconf_free_token(base);
+        jconf_free_token(overlay);
+        equal = merged != NULL && jconf_equal(merged, expected);
+
+        jconf_free_token(merged);
+        jconf_free_token(expected);
+        if (!assert(equal, "Assert 1: Case %d was not merged.", i)) goto failure;
+    }
+
+    // Members of the base keep their order and new members follow.
+    base = merge_parse("{\"a\": 1, \"b\": 2, \"c\": 3}");
+    overlay = merge_parse("{\"b\": null, \"d\": 4, \"a\": 5}");
+    merged = jconf_merge(base, overlay, JCONF_MERGE_REPLACE);
+
+    changes[0] = '\0';
+    jconf_object_iter_begin(merged, &members);
+    while (jconf_object_iter_next(&members, &key, &length, NULL))
+        strncat(changes, key, length);
+
+    jconf_free_token(merged);
+    jconf_free_token(overlay);
+    jconf_free_token(base);
+    if (!assert(!strcmp(changes, "acd"), "Assert 2: The members were merged in the order %s.", changes)) goto failure;
+
+    logger(PASS, "Test %d merges.\n", n);
+
+    /**
+     * Test sharing the unchanged containers.
+     */
+    base = merge_parse(base_json);
+    overlay = merge_parse("{\"y\": {\"p\": 3}}");
+    merged = jconf_merge(base, overlay, JCONF_MERGE_REPLACE);
+    jconf_free_token(overlay);
+
+    equal = jconf_get(merged, "o", "x")->data == jconf_get(base, "o", "x")->data && merge_refs(jconf_get(base, "o", "x")) == 1 &&
+        jconf_get(merged, "o", "z")->data == jconf_get(base, "o", "z")->data && merge_refs(jconf_get(base, "o", "z")) == 1 &&
+        jconf_get(merged, "o", "y")->data != jconf_get(base, "o", "y")->data && merge_refs(jconf_get(base, "o", "y")) == 0;
+
+    // Shared containers are not visited by a diff.
+    changes[0] = '\0';
+    equal = equal && jconf_diff_each(base, merged, &diff_changes, changes) && !strcmp(changes, "replace /y/p;");
+
+    // An overlay that changes nothing shares the whole base.
+    overlay = merge_parse("{\"y\": {\"p\": 1.0}, \"w\": null}");
+    same = jconf_merge(base, overlay, JCONF_MERGE_REPLACE);
+    equal = equal && same->data == base->data && merge_refs(base) == 1;
+    jconf_free_token(same);
+    jconf_free_token(overlay);
+
+    if (!assert(equal && merge_refs(base) == 0, "Assert 3: The unchanged containers were not shared."))
+    {
+        jconf_free_token(merged);
+        jconf_free_token(base);
+        goto failure;
+    }
+
+    // Layers are freed in any order.
+    overlay = merge_parse("{\"x\": {\"deep\": null}, \"z\": [3]}");
+    layered = jconf_merge(merged, overlay, JCONF_MERGE_APPEND);
+    jconf_free_token(overlay);
+
+    equal = merge_refs(jconf_get(base, "o", "z")) == 1 && merge_refs(jconf_get(base, "ooa", "x", "deep", 2)) == 0;
+    jconf_free_token(base);
+    jconf_free_token(merged);
+
+    expected = merge_parse("{\"x\": {}, \"y\": {\"p\": 3, \"q\": 2}, \"z\": [1, 2, 3]}");
+    equal = equal && jconf_equal(layered, expected);
+    jconf_free_token(expected);
+    jconf_free_token(layered);
+
+    if (!assert(equal, "Assert 4: The layers were not merged.")) goto failure;
+    logger(PASS, "Test sharing containers.\n");
+
+    /**
+     * Test patching a merged tree.
+     */
+    base = merge_parse(base_json);
+    overlay = merge_parse("{\"y\": {\"p\": 3}}");
+    merged = jconf_merge(base, overlay, JCONF_MERGE_REPLACE);
+    jconf_free_token(overlay);
+
+    overlay = merge_parse("[{\"op\": \"replace\", \"path\": \"/x/deep/2/k\", \"value\": \"w\"}, "
+        "{\"op\": \"add\", \"path\": \"/z/-\", \"value\": 3}, {\"op\": \"remove\", \"path\": \"/y/q\"}]");
+    edit = jconf_patch_compile(overlay, NULL);
+
+    same = merge_parse("[{\"op\": \"replace\", \"path\": \"/x/deep/0\", \"value\": 9}, "
+        "{\"op\": \"test\", \"path\": \"/z/0\", \"value\": 2}]");
+    failed = jconf_patch_compile(same, NULL);
+
+    // A failed patch gives back the copies it made.
+    equal = edit != NULL && failed != NULL && !jconf_patch_apply(failed, &merged, NULL, NULL) &&
+        merge_refs(jconf_get(base, "o", "x")) == 1 && jconf_get(merged, "o", "x")->data == jconf_get(base, "o", "x")->data;
+
+    // The shared containers on the paths are copied; the base is unchanged.
+    equal = equal && jconf_patch_apply(edit, &merged, NULL, NULL) &&
+        merge_refs(jconf_get(base, "o", "x")) == 0 && merge_refs(jconf_get(base, "oo", "x", "deep")) == 0 &&
+        merge_refs(jconf_get(base, "o", "z")) == 0;
+
+    expected = merge_parse(base_json);
+    equal = equal && jconf_equal(base, expected);
+    jconf_free_token(expected);
+
+    expected = merge_parse("{\"x\": {\"deep\": [1, 2, {\"k\": \"w\"}]}, \"y\": {\"p\": 3}, \"z\": [1, 2, 3]}");
+    equal = equal && jconf_equal(merged, expected);
+    jconf_free_token(expected);
+
+    jconf_patch_free(edit);
+    jconf_patch_free(failed);
+    jconf_free_token(same);
+    jconf_free_token(overlay);
+    jconf_free_token(merged);
+    jconf_free_token(base);
+
+    if (!assert(equal, "Assert 5: Patching a merged tree changed its base.")) goto failure;
+    logger(PASS, "Test patching a merged tree.\n");
+
+    /**
+     * Test running out of memory while merging.
+     */
+    base = merge_parse(base_json);
+    overlay = merge_parse("{\"y\": {\"p\": 3, \"r\": [4]}, \"z\": [3, 4], \"v\": {\"a\": null, \"b\": 1}}");
+    jconf_init_counting_allocator(&counting, &counter, &limited);
+
+    for (i = 0; ; i++)
+    {
+        alloc_budget = i;
+        if ((merged = jconf_merge_with(base, overlay, JCONF_MERGE_UNION, &counting)) != NULL)
+            break;
+
+        if (!assert(counter.live == 0 && merge_refs(jconf_get(base, "o", "x")) == 0,
+            "Assert 7: Failed allocation %d leaked memory.", i))
+        {
+            jconf_free_token(overlay);
+            jconf_free_token(base);
+            goto failure;
+        }
+    }
+
+    expected = merge_parse("{\"x\": {\"deep\": [1, 2, {\"k\": \"v\"}]}, \"y\": {\"p\": 3, \"q\": 2, \"r\": [4]}, \"z\": [1, 2, 3, 4], \"v\": {\"b\": 1}}");
+    equal = jconf_equal(merged, expected);
+    jconf_free_token(expected);
+    jconf_free_token_with(merged, &counting);
+    jconf_free_token(overlay);
+    jconf_free_token(base);
+
+    if (!assert(equal && counter.live == 0, "Assert 8: The merged tree was not built.")) goto failure;
+    logger(PASS, "Test running out of memory [%d failure points].\n", i);
 
     tear_down();
     return PASS;
@@ -522,7 +3372,7 @@ int main(int argc, char* argv[])
 
     if (argc > 1)
     {
-        i = (int)(argv[1][0] - '0');
+        i = atoi(argv[1]);
         if (i < 0 || i >= TEST_JCONF_COUNT)
         {
             printf("Invalid test number provided.");
@@ -0,0 +1,182 @@
+/**
+ * JConf C++ Unittests
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/jconf.hpp>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+using namespace jconf::literals;
+
+// Keys are hashed at compile time.
+static_assert("servers"_jk.hash == jconf::hash("servers", 7) && "servers"_jk.size == 7, "Keys are not constant expressions.");
+
+#define FAILURE 0
+#define PASS 1
+
+// Result string array.
+static const char* jconf_test_result[] = {
+    "FAILURE", "PASS"
+};
+
+/**
+ * Logger
+ *
+ * Description: Prints the provided message.
+ *
+ * @param {level}[out]   // The test result (PASS or FAIL).
+ * @param {format}[out]  // The message to print.
+ */
+static void logger(int level, const char* format, ...)
+{
+    va_list ap;
+    va_start(ap, format);
+    printf("%10s : ", jconf_test_result[level]);
+    vfprintf(stdout, format, ap);
+    va_end(ap);
+}
+
+/**
+ * Check
+ *
+ * Description: Asserts the provided condition and logs errors.
+ *
+ * @param {condition}[out]  // The condition.
+ * @param {message}[out]    // The message.
+ * @returns                 // PASS or FAILURE
+ */
+static int check(bool condition, const char* message)
+{
+    if (!condition)
+        logger(FAILURE, "Assertion Error - %s\n", message);
+    return condition ? PASS : FAILURE;
+}
+
+/**
+ * Test Wrapper
+ *
+ * Description: Tests the C++ layer against the C API.
+ */
+static int test_wrapper()
+{
+    static const char json[] =
+        "{\"name\": \"web\", \"port\": 8080, \"ratio\": 0.5, \"debug\": true, \"none\": null,"
+        " \"servers\": [{\"host\": \"a\", \"weight\": -3}, {\"host\": \"b\\\"c\", \"weight\": 7}], \"empty\": []}";
+
+    jconf::document moved;
+    std::int64_t sum = 0;
+    std::size_t count = 0;
+    jArgs args;
+
+    printf("Running Test JConf C++ API...\n");
+
+    {
+        jconf::document doc = jconf::document::parse(json, &args);
+        if (!check(bool(doc) && doc.root().is_object() && doc.root().size() == 7, "Assert 1: The document was not parsed.")) return FAILURE;
+
+        // Accessors return the tokens of the C API.
+        if (!check(doc["servers"][1]["host"].token() == jconf_get(doc.root().token(), "oao", "servers", 1, "host"),
+            "Assert 2: Accessors do not return the tokens of jconf_get.")) return FAILURE;
+
+        if (!check(doc["name"].get<std::string_view>() == "web" && doc["port"].get<std::int64_t>() == 8080 &&
+            doc["port"].get<int>() == 8080 && doc["ratio"].get<double>() == 0.5 && doc["debug"].get<bool>() &&
+            doc["none"].is_null() && doc["servers"][1]["host"].get<std::string_view>() == "b\\\"c",
+            "Assert 3: Typed values are not correct.")) return FAILURE;
+
+        // Missing values are null views.
+        if (!check(!doc["missing"] && !doc["missing"]["deeper"][3] && !doc["servers"][5] && !doc["servers"][-1] &&
+            !doc["name"][0] && doc["missing"].get_or<std::int64_t>(42) == 42 && doc["name"].get_or<double>(1.5) == 1.5 &&
+            doc["port"].get_or<std::string_view>("none") == "none" && doc["missing"].size() == 0,
+            "Assert 4: Missing values are not null views.")) return FAILURE;
+
+        // Range-for over arrays and objects.
+        for (jconf::value_ref server : doc["servers"])
+            sum += server["weight"].get<std::int64_t>();
+
+        for (auto [key, value] : doc.root().members())
+            if (count++ == 1 && (key != "port" || value.get<int>() != 8080))
+                return check(false, "Assert 5: Members are not visited in document order.");
+
+        for (jconf::value_ref element : doc["empty"])
+            sum += element.get<int>();
+        for (jconf::value_ref element : doc["name"])
+            sum += element.get<int>();
+
+        if (!check(sum == 4 && count == 7, "Assert 6: Iteration did not visit every value.")) return FAILURE;
+
+        // Ownership moves with the document.
+        moved = std::move(doc);
+        if (!check(!doc && moved["port"].get<int>() == 8080, "Assert 7: The tree was not moved.")) return FAILURE;
+    }
+
+    if (!check(moved["servers"].size() == 2, "Assert 8: The moved tree was freed.")) return FAILURE;
+
+    // Errors are reported through jArgs.
+    if (!check(!jconf::document::parse("{\"a\" 1}", &args) && args.e == JCONF_UNEXPECTED_TOK, "Assert 9: The error was not reported.")) return FAILURE;
+
+    logger(PASS, "Test accessors, iteration and ownership.\n");
+    return PASS;
+}
+
+/**
+ * Test Hashed Keys
+ *
+ * Description: Tests that compile-time hashes match jconf_map_hash.
+ */
+static int test_keys()
+{
+    static constexpr jconf::key port = "port"_jk;
+    static constexpr jHash hashes[] = {
+        ""_jk.hash, "a"_jk.hash, "abc"_jk.hash, "port"_jk.hash, "servers"_jk.hash,
+        "0123456789abcdef"_jk.hash, "0123456789abcdefg"_jk.hash,
+        "a key that is longer than forty-eight bytes, to cover the wide loop"_jk.hash
+    };
+    static const char* names[] = {
+        "", "a", "abc", "port", "servers", "0123456789abcdef", "0123456789abcdefg",
+        "a key that is longer than forty-eight bytes, to cover the wide loop"
+    };
+
+    char bytes[300];
+    std::size_t i, n;
+
+    printf("Running Test JConf C++ Hashed Keys...\n");
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+        if (!check(hashes[i] == jconf_map_hash(names[i], std::strlen(names[i])), "Assert 1: A literal hash differs from jconf_map_hash.")) return FAILURE;
+
+    // Every length through each branch of the hash, with bytes above 0x7F.
+    for (i = 0; i < sizeof(bytes); i++)
+        bytes[i] = static_cast<char>(i * 167 + 13);
+
+    for (n = 0; n <= sizeof(bytes); n++)
+        for (i = 0; i + n <= sizeof(bytes) && i < 8; i++)
+            if (!check(jconf::hash(bytes + i, n) == jconf_map_hash(bytes + i, n), "Assert 2: jconf::hash differs from jconf_map_hash.")) return FAILURE;
+
+    // Lookups with hashed keys find the same members.
+    jconf::document doc = jconf::document::parse("{\"port\": 80, \"servers\": [{\"port\": 81}], \"x\": 1}");
+    if (!check(doc[port].token() == doc["port"].token() && doc["servers"_jk][0][port].get<int>() == 81 &&
+        !doc["missing"_jk] && !doc["x"][port], "Assert 3: Hashed lookups do not match.")) return FAILURE;
+
+    logger(PASS, "Test compile-time hashes of %zu lengths.\n", sizeof(bytes) + 1);
+    return PASS;
+}
+
+/**
+ * Entry point
+ */
+int main()
+{
+    int result = test_wrapper() & test_keys();
+
+    printf("\n");
+    logger(result, "Test JConf C++ API\n");
+    return result == PASS ? 0 : 1;
+}
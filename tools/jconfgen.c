@@ -0,0 +1,1200 @@
+/**
+ * JConf Parser Generator
+ *
+ * Copyright 2015 Mayank Sindwani
+ * Released under the MIT License:
+ * http://opensource.org/licenses/MIT
+ *
+ * Description: Generates a parser specialized for one message type from a
+ *              sample document or a JSON Schema. The shape is inferred into
+ *              C structs, and each struct gets a parse function with its keys
+ *              in a hard-coded switch (on the length, then a distinguishing
+ *              character) and its field types fixed, so documents of that
+ *              shape are decoded with no hashing, tree or type dispatch. The
+ *              generated code uses the scanners in jconf/cursor.h.
+ *
+ *                  jconfgen [-s] [-p prefix] [-o path] input.json
+ *
+ *              -s reads the input as a schema, -p names the generated types
+ *              and functions (default "message"), and the parser is written
+ *              to <path>.h and <path>.c (default the prefix).
+ * Author: Mayank Sindwani
+ * Date: 2026-10-18
+ */
+
+#include <jconf/parser.h>
+#include <jconf/string.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// The longest generated identifier.
+#define JGEN_NAME 128
+
+// Inferred kinds.
+typedef enum _j_gen_kind
+{
+    JGEN_NONE = 0,      // Only null was seen.
+    JGEN_BOOL,
+    JGEN_INT,
+    JGEN_DOUBLE,
+    JGEN_STRING,
+    JGEN_OBJECT,
+    JGEN_ARRAY,
+    JGEN_ANY            // Mixed types; values are skipped.
+
+} jGenKind;
+
+struct _j_gen_field;
+
+// jGenType struct definition.
+typedef struct _j_gen_type
+{
+    jGenKind kind;
+    struct _j_gen_field* fields;        // Objects.
+    size_t count, cap;
+    struct _j_gen_type* element;        // Arrays.
+
+    char name[JGEN_NAME];               // Objects: the struct name.
+    char func[JGEN_NAME];               // Objects: the function suffix.
+    struct _j_gen_type* next;           // Every object, in emission order.
+
+} jGenType;
+
+// jGenField struct definition.
+typedef struct _j_gen_field
+{
+    const char* key;                    // Raw key text (escapes kept).
+    size_t len;
+    char member[JGEN_NAME];
+    jGenType* type;
+
+} jGenField;
+
+// Generator state.
+typedef struct _j_gen
+{
+    const char* prefix;
+    char camel[JGEN_NAME];
+    jGenType* objects;
+    jGenType** last;
+    FILE *h, *c;
+
+} jGen;
+
+// C keywords, which are not used as member names.
+static const char* jgen_keywords[] = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum",
+    "extern", "float", "for", "goto", "if", "inline", "int", "long", "register", "restrict", "return",
+    "short", "signed", "sizeof", "static", "struct", "switch", "typedef", "union", "unsigned", "void",
+    "volatile", "while", "_Bool", "bool", "true", "false", "class", "new", "delete", "this"
+};
+
+/**
+ * Gen New
+ *
+ * Description: Allocates a type.
+ *
+ * @param {kind}[out] // The kind.
+ * @returns           // The type.
+ */
+static jGenType* gen_new(jGenKind kind)
+{
+    jGenType* type = (jGenType*)calloc(1, sizeof(jGenType));
+
+    if (type == NULL)
+    {
+        fprintf(stderr, "jconfgen: out of memory.\n");
+        exit(1);
+    }
+
+    type->kind = kind;
+    return type;
+}
+
+/**
+ * Gen Destroy
+ *
+ * Description: Frees a type and the types it contains.
+ *
+ * @param {type}[in] // The type.
+ */
+static void gen_destroy(jGenType* type)
+{
+    size_t i;
+
+    if (type == NULL)
+        return;
+
+    for (i = 0; i < type->count; i++)
+        gen_destroy(type->fields[i].type);
+
+    gen_destroy(type->element);
+    free(type->fields);
+    free(type);
+}
+
+/**
+ * Gen Field
+ *
+ * Description: Finds or adds the field of a key, keeping first appearance
+ *              order.
+ *
+ * @param {type}[in] // The object type.
+ * @param {key}[out] // The key.
+ * @param {len}[out] // The length of the key.
+ * @returns          // The field.
+ */
+static jGenField* gen_field(jGenType* type, const char* key, size_t len)
+{
+    jGenField* field;
+    size_t i;
+
+    for (i = 0; i < type->count; i++)
+        if (type->fields[i].len == len && !memcmp(type->fields[i].key, key, len))
+            return &type->fields[i];
+
+    if (type->count == type->cap)
+    {
+        type->cap = type->cap ? type->cap * 2 : 8;
+        if ((type->fields = (jGenField*)realloc(type->fields, type->cap * sizeof(jGenField))) == NULL)
+        {
+            fprintf(stderr, "jconfgen: out of memory.\n");
+            exit(1);
+        }
+    }
+
+    field = &type->fields[type->count++];
+    memset(field, 0, sizeof(*field));
+    field->key = key;
+    field->len = len;
+    return field;
+}
+
+/**
+ * Gen Sample
+ *
+ * Description: Merges the shape of a sample value into a type. Integers
+ *              and doubles merge into doubles, null merges into anything,
+ *              and other conflicts make the value skipped.
+ *
+ * @param {type}[in]   // The type (NULL for a new one).
+ * @param {token}[out] // The sample value.
+ * @returns            // The type.
+ */
+static jGenType* gen_sample(jGenType* type, const jToken* token)
+{
+    static const jGenKind kinds[] = {
+        JGEN_BOOL, JGEN_NONE, JGEN_BOOL, JGEN_ARRAY, JGEN_OBJECT, JGEN_STRING, JGEN_DOUBLE, JGEN_INT
+    };
+
+    jObjectIter members;
+    jArrayIter elements;
+    jToken* value;
+    const char* key;
+    jGenKind kind;
+    size_t len;
+
+    if (type == NULL)
+        type = gen_new(JGEN_NONE);
+
+    kind = kinds[token->type];
+    if (kind == JGEN_NONE || type->kind == JGEN_ANY)
+        return type;
+
+    if (type->kind == JGEN_NONE || (type->kind == JGEN_INT && kind == JGEN_DOUBLE))
+        type->kind = kind;
+    else if (type->kind != kind && !(type->kind == JGEN_DOUBLE && kind == JGEN_INT))
+    {
+        type->kind = JGEN_ANY;
+        return type;
+    }
+
+    if (kind == JGEN_OBJECT)
+    {
+        jconf_object_iter_begin(token, &members);
+        while (jconf_object_iter_next(&members, &key, &len, &value))
+        {
+            jGenField* field = gen_field(type, key, len);
+            field->type = gen_sample(field->type, value);
+        }
+    }
+    else if (kind == JGEN_ARRAY)
+    {
+        jconf_array_iter_begin(token, &elements);
+        while (jconf_array_iter_next(&elements, &value))
+            type->element = gen_sample(type->element, value);
+
+        if (type->element == NULL)
+            type->element = gen_new(JGEN_NONE);
+    }
+
+    return type;
+}
+
+/**
+ * Gen Schema Kind
+ *
+ * Description: Maps a schema type name to a kind.
+ *
+ * @param {name}[out] // The type name token.
+ * @returns           // The kind (JGEN_NONE for "null", JGEN_ANY if unknown).
+ */
+static jGenKind gen_schema_kind(const jToken* name)
+{
+    static const struct { const char* name; jGenKind kind; } names[] = {
+        { "boolean", JGEN_BOOL }, { "integer", JGEN_INT }, { "number", JGEN_DOUBLE }, { "string", JGEN_STRING },
+        { "object", JGEN_OBJECT }, { "array", JGEN_ARRAY }, { "null", JGEN_NONE }
+    };
+
+    size_t i;
+
+    if (name == NULL || name->type != JCONF_STRING)
+        return JGEN_ANY;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+        if (!jconf_strcmp((const char*)name->data, names[i].name))
+            return names[i].kind;
+
+    return JGEN_ANY;
+}
+
+/**
+ * Gen Schema
+ *
+ * Description: Builds a type from a schema: "type" (the first that is not
+ *              "null" when it is a list), "properties" and "items" (one
+ *              schema for every element). Other keywords are ignored.
+ *
+ * @param {schema}[out] // The schema.
+ * @returns             // The type.
+ */
+static jGenType* gen_schema(const jToken* schema)
+{
+    const jToken *name, *items;
+    jObjectIter members;
+    jArrayIter elements;
+    jGenType* type;
+    jToken* value;
+    const char* key;
+    size_t len;
+
+    type = gen_new(JGEN_ANY);
+    if (schema == NULL || schema->type != JCONF_OBJECT)
+        return type;
+
+    name = jconf_get(schema, "o", "type");
+    if (name != NULL && name->type == JCONF_ARRAY)
+    {
+        jconf_array_iter_begin(name, &elements);
+        while (jconf_array_iter_next(&elements, &value) && gen_schema_kind(value) == JGEN_NONE);
+        type->kind = value != NULL ? gen_schema_kind(value) : JGEN_ANY;
+    }
+    else if (name != NULL)
+        type->kind = gen_schema_kind(name);
+    else if (jconf_get(schema, "o", "properties") != NULL)
+        type->kind = JGEN_OBJECT;
+    else if (jconf_get(schema, "o", "items") != NULL)
+        type->kind = JGEN_ARRAY;
+
+    if (type->kind == JGEN_NONE)
+        type->kind = JGEN_ANY;
+
+    if (type->kind == JGEN_OBJECT && (value = jconf_get(schema, "o", "properties")) != NULL && value->type == JCONF_OBJECT)
+    {
+        jconf_object_iter_begin(value, &members);
+        while (jconf_object_iter_next(&members, &key, &len, &value))
+            gen_field(type, key, len)->type = gen_schema(value);
+    }
+    else if (type->kind == JGEN_ARRAY)
+    {
+        items = jconf_get(schema, "o", "items");
+        type->element = gen_schema(items != NULL && items->type == JCONF_OBJECT ? items : NULL);
+    }
+
+    return type;
+}
+
+/**
+ * Gen Bound
+ *
+ * Description: Checks whether a type has a C representation.
+ *
+ * @param {type}[out] // The type.
+ * @returns           // '1' for scalars, objects and arrays of those.
+ */
+static int gen_bound(const jGenType* type)
+{
+    if (type == NULL || type->kind == JGEN_NONE || type->kind == JGEN_ANY)
+        return 0;
+
+    if (type->kind == JGEN_ARRAY)
+        return gen_bound(type->element) && type->element->kind != JGEN_ARRAY;
+
+    return 1;
+}
+
+/**
+ * Gen Identifier
+ *
+ * Description: Converts a key to an identifier, either in camel case (for
+ *              type names) or with invalid characters replaced (for
+ *              members).
+ *
+ * @param {dest}[in]  // The destination (JGEN_NAME bytes).
+ * @param {key}[out]  // The key.
+ * @param {len}[out]  // The length of the key.
+ * @param {camel}[out]// '1' for camel case.
+ */
+static void gen_identifier(char* dest, const char* key, size_t len, int camel)
+{
+    size_t i, n = 0;
+    int upper = 1;
+    char c;
+
+    for (i = 0; i < len && n + 2 < JGEN_NAME; i++)
+    {
+        c = key[i];
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || (c == '_' && !camel)))
+        {
+            upper = 1;
+            if (!camel && n > 0 && dest[n - 1] != '_')
+                dest[n++] = '_';
+            continue;
+        }
+
+        if (n == 0 && c >= '0' && c <= '9')
+            dest[n++] = '_';
+
+        dest[n++] = camel && upper && c >= 'a' && c <= 'z' ? (char)(c - 'a' + 'A') : c;
+        upper = 0;
+    }
+
+    if (n == 0)
+        dest[n++] = camel ? 'V' : 'v';
+    dest[n] = 0;
+}
+
+/**
+ * Gen Unique Member
+ *
+ * Description: Checks that a member name is not used in a struct, counting
+ *              the _count members of arrays.
+ *
+ * @param {type}[out] // The struct type.
+ * @param {upto}[out] // The number of named fields.
+ * @param {name}[out] // The name.
+ * @returns           // '1' if the name is free.
+ */
+static int gen_unique_member(const jGenType* type, size_t upto, const char* name)
+{
+    char count[JGEN_NAME + 8];
+    size_t i;
+
+    for (i = 0; i < sizeof(jgen_keywords) / sizeof(jgen_keywords[0]); i++)
+        if (!strcmp(name, jgen_keywords[i]))
+            return 0;
+
+    for (i = 0; i < upto; i++)
+    {
+        if (!gen_bound(type->fields[i].type))
+            continue;
+
+        snprintf(count, sizeof(count), "%s_count", type->fields[i].member);
+        if (!strcmp(name, type->fields[i].member) || !strcmp(name, count))
+            return 0;
+
+        // The new member's count must be free too.
+        snprintf(count, sizeof(count), "%s_count", name);
+        if (!strcmp(count, type->fields[i].member))
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Gen Names
+ *
+ * Description: Names the structs, functions and members of a type, and
+ *              lists its structs children first.
+ *
+ * @param {gen}[in]   // The generator state.
+ * @param {type}[in]  // The type.
+ * @param {name}[out] // The camel case path name ("" for the root).
+ */
+static void gen_names(jGen* gen, jGenType* type, const char* name)
+{
+    char base[JGEN_NAME], child[JGEN_NAME], *p;
+    const jGenType* other;
+    jGenField* field;
+    size_t i;
+    int n;
+
+    if (type == NULL)
+        return;
+
+    if (type->kind == JGEN_ARRAY)
+    {
+        gen_names(gen, type->element, name[0] ? name : "Item");
+        return;
+    }
+
+    if (type->kind != JGEN_OBJECT)
+        return;
+
+    // Struct names are unique across the parser.
+    snprintf(type->name, JGEN_NAME, "%.32s%.80s", gen->camel, name);
+    for (n = 2, other = gen->objects; other != NULL; other = other->next)
+    {
+        if (!strcmp(other->name, type->name))
+        {
+            snprintf(type->name, JGEN_NAME, "%.32s%.80s%d", gen->camel, name, n++);
+            other = gen->objects;
+        }
+    }
+
+    // Functions are named after the path in snake case.
+    if (name[0] == 0)
+        strcpy(type->func, "root");
+    else
+    {
+        for (p = type->name + strlen(gen->camel), i = 0; *p && i + 2 < JGEN_NAME; p++)
+        {
+            if (*p >= 'A' && *p <= 'Z')
+            {
+                if (i > 0) type->func[i++] = '_';
+                type->func[i++] = (char)(*p - 'A' + 'a');
+            }
+            else
+                type->func[i++] = *p;
+        }
+        type->func[i] = 0;
+    }
+
+    for (i = 0; i < type->count; i++)
+    {
+        field = &type->fields[i];
+        gen_identifier(base, field->key, field->len, 0);
+
+        strcpy(field->member, base);
+        for (n = 2; !gen_unique_member(type, i, field->member); n++)
+            snprintf(field->member, JGEN_NAME, "%.100s_%d", base, n);
+
+        gen_identifier(child, field->key, field->len, 1);
+        gen_names(gen, field->type, child);
+    }
+
+    *gen->last = type;
+    gen->last = &type->next;
+}
+
+/**
+ * Gen C Type
+ *
+ * Description: Returns the C type of a bound scalar or struct.
+ *
+ * @param {type}[out] // The type.
+ * @returns           // The C type.
+ */
+static const char* gen_ctype(const jGenType* type)
+{
+    switch (type->kind)
+    {
+        case JGEN_BOOL:   return "int";
+        case JGEN_INT:    return "int64_t";
+        case JGEN_DOUBLE: return "double";
+        case JGEN_STRING: return "char*";
+        default:          return type->name;
+    }
+}
+
+/**
+ * Gen Element Function
+ *
+ * Description: Writes the suffix of the functions for arrays of a type.
+ *
+ * @param {dest}[in]     // The destination (JGEN_NAME bytes).
+ * @param {element}[out] // The element type.
+ */
+static void gen_array_func(char* dest, const jGenType* element)
+{
+    switch (element->kind)
+    {
+        case JGEN_BOOL:   strcpy(dest, "bools"); break;
+        case JGEN_INT:    strcpy(dest, "int64s"); break;
+        case JGEN_DOUBLE: strcpy(dest, "doubles"); break;
+        case JGEN_STRING: strcpy(dest, "strings"); break;
+        default:          snprintf(dest, JGEN_NAME, "%.100s_array", element->func); break;
+    }
+}
+
+/**
+ * Gen Literal
+ *
+ * Description: Writes a key as a C string literal.
+ *
+ * @param {out}[in]  // The output.
+ * @param {key}[out] // The key.
+ * @param {len}[out] // The length of the key.
+ */
+static void gen_literal(FILE* out, const char* key, size_t len)
+{
+    size_t i;
+
+    fputc('\"', out);
+    for (i = 0; i < len; i++)
+    {
+        if (key[i] == '\"' || key[i] == '\\')
+            fprintf(out, "\\%c", key[i]);
+        else if ((unsigned char)key[i] < 0x20 || (unsigned char)key[i] >= 0x7F || key[i] == '?')
+            fprintf(out, "\\%03o", (unsigned char)key[i]);
+        else
+            fputc(key[i], out);
+    }
+    fputc('\"', out);
+}
+
+/**
+ * Gen Char
+ *
+ * Description: Writes a key character as a C character constant.
+ *
+ * @param {out}[in] // The output.
+ * @param {c}[out]  // The character.
+ */
+static void gen_char(FILE* out, char c)
+{
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.' || c == ' ')
+        fprintf(out, "'%c'", c);
+    else
+        fprintf(out, "%d", (int)(unsigned char)c);
+}
+
+/**
+ * Gen Reason
+ *
+ * Description: Explains why a type has no C representation.
+ *
+ * @param {type}[out] // The type.
+ * @returns           // The reason.
+ */
+static const char* gen_reason(const jGenType* type)
+{
+    for (; type->kind == JGEN_ARRAY; type = type->element)
+        if (type->element->kind == JGEN_ARRAY)
+            return "nested arrays";
+
+    return type->kind == JGEN_ANY ? "mixed or unknown types" : "only null";
+}
+
+/**
+ * Gen Struct
+ *
+ * Description: Writes the typedef of a struct.
+ *
+ * @param {gen}[in]   // The generator state.
+ * @param {type}[out] // The struct type.
+ */
+static void gen_struct(jGen* gen, const jGenType* type)
+{
+    const jGenField* field;
+    size_t i, bound = 0;
+
+    fprintf(gen->h, "typedef struct _%s_%s\n{\n", gen->prefix, type->func);
+
+    for (i = 0; i < type->count; i++)
+    {
+        field = &type->fields[i];
+        if (!gen_bound(field->type))
+        {
+            fprintf(gen->h, "    // ");
+            gen_literal(gen->h, field->key, field->len);
+            fprintf(gen->h, " is skipped (%s).\n", gen_reason(field->type));
+            continue;
+        }
+
+        bound++;
+        if (field->type->kind == JGEN_ARRAY)
+            fprintf(gen->h, "    %s* %s;\n    size_t %s_count;\n", gen_ctype(field->type->element), field->member, field->member);
+        else
+            fprintf(gen->h, "    %s %s;\n", gen_ctype(field->type), field->member);
+    }
+
+    if (bound == 0)
+        fprintf(gen->h, "    char reserved;\n");
+
+    fprintf(gen->h, "\n} %s;\n\n", type->name);
+}
+
+/**
+ * Gen Value
+ *
+ * Description: Writes the call that decodes a value into a destination.
+ *
+ * @param {gen}[in]   // The generator state.
+ * @param {type}[out] // The value type.
+ * @param {dest}[out] // The destination expression.
+ * @param {count}[out]// The count expression (arrays).
+ */
+static void gen_value(jGen* gen, const jGenType* type, const char* dest, const char* count)
+{
+    char func[JGEN_NAME];
+
+    switch (type->kind)
+    {
+        case JGEN_BOOL:   fprintf(gen->c, "jconf_cursor_bool(c, %s)", dest); break;
+        case JGEN_INT:    fprintf(gen->c, "jconf_cursor_int64(c, %s)", dest); break;
+        case JGEN_DOUBLE: fprintf(gen->c, "jconf_cursor_double(c, %s)", dest); break;
+        case JGEN_STRING: fprintf(gen->c, "jconf_cursor_string(c, %s)", dest); break;
+        case JGEN_OBJECT: fprintf(gen->c, "%s_parse_%s(c, %s)", gen->prefix, type->func, dest); break;
+        default:
+            gen_array_func(func, type->element);
+            fprintf(gen->c, "%s_parse_%s(c, %s, %s)", gen->prefix, func, dest, count);
+            break;
+    }
+}
+
+/**
+ * Gen Case
+ *
+ * Description: Writes the comparison of a key and the decoding of its value.
+ *
+ * @param {gen}[in]    // The generator state.
+ * @param {field}[out] // The field.
+ * @param {indent}[out]// The indentation.
+ */
+static void gen_case(jGen* gen, const jGenField* field, const char* indent)
+{
+    char dest[JGEN_NAME + 16], count[JGEN_NAME + 16];
+
+    snprintf(dest, sizeof(dest), "&out->%s", field->member);
+    snprintf(count, sizeof(count), "&out->%s_count", field->member);
+
+    fprintf(gen->c, "%sif (!memcmp(key, ", indent);
+    gen_literal(gen->c, field->key, field->len);
+    fprintf(gen->c, ", %lu))\n%s{\n%s    if (!", (unsigned long)field->len, indent, indent);
+    gen_value(gen, field->type, dest, count);
+    fprintf(gen->c, ") return 0;\n%s    continue;\n%s}\n", indent, indent);
+}
+
+/**
+ * Gen Parse Struct
+ *
+ * Description: Writes the parse function of a struct. Keys are dispatched
+ *              on their length and, when several keys share it, on the
+ *              character that tells most of them apart.
+ *
+ * @param {gen}[in]   // The generator state.
+ * @param {type}[out] // The struct type.
+ */
+static void gen_parse_struct(jGen* gen, const jGenType* type)
+{
+    const jGenField *field, *other;
+    size_t i, j, k, len, pos, best, distinct;
+    unsigned char seen[256];
+    int started;
+
+    fprintf(gen->c,
+        "static int %s_parse_%s(jCursor* c, %s* out)\n"
+        "{\n"
+        "    const char* key;\n"
+        "    size_t len;\n"
+        "    int status;\n\n"
+        "    if (jconf_cursor_null(c)) return 1;\n"
+        "    if (c->buffer[c->args->pos] != '{') return jconf_cursor_mismatch(c);\n"
+        "    if (!jconf_cursor_enter(c)) return 0;\n"
+        "    if (jconf_cursor_close(c, '}')) return 1;\n\n"
+        "    do\n"
+        "    {\n"
+        "        if (!jconf_cursor_key(c, &key, &len)) return 0;\n\n"
+        "        switch (len)\n"
+        "        {\n", gen->prefix, type->func, type->name);
+
+    for (i = 0; i < type->count; i++)
+    {
+        field = &type->fields[i];
+        if (!gen_bound(field->type))
+            continue;
+
+        // Each length is written once, with every key of that length.
+        for (j = 0; j < i; j++)
+            if (gen_bound(type->fields[j].type) && type->fields[j].len == field->len)
+                break;
+        if (j < i)
+            continue;
+
+        len = field->len;
+        for (j = i, k = 0; j < type->count; j++)
+            k += gen_bound(type->fields[j].type) && type->fields[j].len == len;
+
+        fprintf(gen->c, "            case %lu:\n", (unsigned long)len);
+        if (k <= 2)
+        {
+            for (j = i; j < type->count; j++)
+                if (gen_bound(type->fields[j].type) && type->fields[j].len == len)
+                    gen_case(gen, &type->fields[j], "                ");
+            fprintf(gen->c, "                break;\n");
+            continue;
+        }
+
+        // Pick the position with the most distinct characters.
+        for (pos = 0, best = 0, distinct = 0; pos < len; pos++)
+        {
+            memset(seen, 0, sizeof(seen));
+            for (j = i, k = 0; j < type->count; j++)
+            {
+                other = &type->fields[j];
+                if (gen_bound(other->type) && other->len == len && !seen[(unsigned char)other->key[pos]]++)
+                    k++;
+            }
+
+            if (k > distinct)
+            {
+                distinct = k;
+                best = pos;
+            }
+        }
+
+        fprintf(gen->c, "                switch (key[%lu])\n                {\n", (unsigned long)best);
+        memset(seen, 0, sizeof(seen));
+        for (j = i; j < type->count; j++)
+        {
+            other = &type->fields[j];
+            if (!gen_bound(other->type) || other->len != len || seen[(unsigned char)other->key[best]])
+                continue;
+
+            seen[(unsigned char)other->key[best]] = 1;
+            fprintf(gen->c, "                    case ");
+            gen_char(gen->c, other->key[best]);
+            fprintf(gen->c, ":\n");
+
+            for (k = j, started = 0; k < type->count; k++)
+            {
+                if (gen_bound(type->fields[k].type) && type->fields[k].len == len && type->fields[k].key[best] == other->key[best])
+                {
+                    gen_case(gen, &type->fields[k], "                        ");
+                    started = 1;
+                }
+            }
+
+            if (started)
+                fprintf(gen->c, "                        break;\n");
+        }
+        fprintf(gen->c, "                }\n                break;\n");
+    }
+
+    fprintf(gen->c,
+        "        }\n\n"
+        "        // Keys without fields.\n"
+        "        if (!jconf_cursor_skip(c)) return 0;\n"
+        "    }\n"
+        "    while ((status = jconf_cursor_next(c, '}')) > 0);\n\n"
+        "    return status == 0;\n"
+        "}\n\n");
+}
+
+/**
+ * Gen Parse Array
+ *
+ * Description: Writes the parse and free functions of arrays of a type.
+ *
+ * @param {gen}[in]      // The generator state.
+ * @param {element}[out] // The element type.
+ */
+static void gen_parse_array(jGen* gen, const jGenType* element)
+{
+    const char* ctype = gen_ctype(element);
+    char func[JGEN_NAME];
+
+    gen_array_func(func, element);
+
+    fprintf(gen->c,
+        "static void %s_free_%s(%s* items, size_t count, const jAllocator* allocator)\n"
+        "{\n", gen->prefix, func, ctype);
+
+    if (element->kind == JGEN_STRING || element->kind == JGEN_OBJECT)
+    {
+        fprintf(gen->c, "    size_t i;\n\n    for (i = 0; i < count; i++)\n");
+        if (element->kind == JGEN_STRING)
+            fprintf(gen->c, "        jconf_free(allocator, items[i]);\n\n");
+        else
+            fprintf(gen->c, "        %s_free_%s(&items[i], allocator);\n\n", gen->prefix, element->func);
+    }
+    else
+        fprintf(gen->c, "    (void)count;\n");
+
+    fprintf(gen->c,
+        "    jconf_free(allocator, items);\n"
+        "}\n\n"
+        "static int %s_parse_%s(jCursor* c, %s** items, size_t* count)\n"
+        "{\n"
+        "    size_t cap = 0;\n"
+        "    int status;\n\n"
+        "    if (jconf_cursor_null(c)) return 1;\n"
+        "    if (c->buffer[c->args->pos] != '[') return jconf_cursor_mismatch(c);\n\n"
+        "    // The last of duplicate keys is kept.\n"
+        "    %s_free_%s(*items, *count, c->allocator);\n"
+        "    *items = NULL;\n"
+        "    *count = 0;\n\n"
+        "    if (!jconf_cursor_enter(c)) return 0;\n"
+        "    if (jconf_cursor_close(c, ']')) return 1;\n\n"
+        "    do\n"
+        "    {\n"
+        "        if (*count == cap && !jconf_cursor_grow(c, (void**)items, &cap, sizeof(**items))) return 0;\n\n"
+        "        memset(&(*items)[*count], 0, sizeof(**items));\n"
+        "        if (!", gen->prefix, func, ctype, gen->prefix, func);
+
+    gen_value(gen, element, "&(*items)[(*count)++]", NULL);
+
+    fprintf(gen->c,
+        ") return 0;\n"
+        "    }\n"
+        "    while ((status = jconf_cursor_next(c, ']')) > 0);\n\n"
+        "    return status == 0;\n"
+        "}\n\n");
+}
+
+/**
+ * Gen Free Struct
+ *
+ * Description: Writes the free function of a struct.
+ *
+ * @param {gen}[in]   // The generator state.
+ * @param {type}[out] // The struct type.
+ */
+static void gen_free_struct(jGen* gen, const jGenType* type)
+{
+    const jGenField* field;
+    char func[JGEN_NAME];
+    size_t i, freed = 0;
+
+    fprintf(gen->c, "static void %s_free_%s(%s* out, const jAllocator* allocator)\n{\n", gen->prefix, type->func, type->name);
+
+    for (i = 0; i < type->count; i++)
+    {
+        field = &type->fields[i];
+        if (!gen_bound(field->type))
+            continue;
+
+        freed += field->type->kind == JGEN_STRING || field->type->kind == JGEN_OBJECT || field->type->kind == JGEN_ARRAY;
+        switch (field->type->kind)
+        {
+            case JGEN_STRING:
+                fprintf(gen->c, "    jconf_free(allocator, out->%s);\n", field->member);
+                break;
+
+            case JGEN_OBJECT:
+                fprintf(gen->c, "    %s_free_%s(&out->%s, allocator);\n", gen->prefix, field->type->func, field->member);
+                break;
+
+            case JGEN_ARRAY:
+                gen_array_func(func, field->type->element);
+                fprintf(gen->c, "    %s_free_%s(out->%s, out->%s_count, allocator);\n", gen->prefix, func, field->member, field->member);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (freed == 0)
+        fprintf(gen->c, "    (void)out;\n    (void)allocator;\n");
+    fprintf(gen->c, "}\n\n");
+}
+
+/**
+ * Gen Collect Arrays
+ *
+ * Description: Collects the element types of the arrays of a struct whose
+ *              functions have not been declared.
+ *
+ * @param {type}[out]    // The struct type.
+ * @param {elements}[in] // The element types (8 scalar slots, then structs).
+ * @param {n}[in]        // The number of element types.
+ */
+static void gen_collect_arrays(const jGenType* type, const jGenType** elements, size_t* n)
+{
+    const jGenType* element;
+    size_t i, j;
+
+    for (i = 0; i < type->count; i++)
+    {
+        if (!gen_bound(type->fields[i].type) || type->fields[i].type->kind != JGEN_ARRAY)
+            continue;
+
+        element = type->fields[i].type->element;
+        for (j = 0; j < *n; j++)
+            if (elements[j] == element || (element->kind != JGEN_OBJECT && elements[j]->kind == element->kind))
+                break;
+
+        if (j == *n)
+            elements[(*n)++] = element;
+    }
+}
+
+/**
+ * Gen Emit
+ *
+ * Description: Writes the header and source of the parser.
+ *
+ * @param {gen}[in]     // The generator state.
+ * @param {root}[out]   // The root type.
+ * @param {input}[out]  // The input path.
+ * @param {header}[out] // The include name of the header.
+ */
+static void gen_emit(jGen* gen, jGenType* root, const char* input, const char* header)
+{
+    const jGenType **elements, *type;
+    char guard[JGEN_NAME], func[JGEN_NAME];
+    size_t i, n = 0, total = 0;
+
+    for (type = gen->objects; type != NULL; type = type->next)
+        total += type->count;
+
+    elements = (const jGenType**)calloc(total + 2, sizeof(jGenType*));
+    for (type = gen->objects; type != NULL; type = type->next)
+        gen_collect_arrays(type, elements, &n);
+
+    if (root->kind == JGEN_ARRAY)
+    {
+        for (i = 0; i < n && elements[i] != root->element && !(root->element->kind != JGEN_OBJECT && elements[i]->kind == root->element->kind); i++);
+        if (i == n)
+            elements[n++] = root->element;
+    }
+
+    for (i = 0; gen->prefix[i] && i + 1 < JGEN_NAME; i++)
+        guard[i] = gen->prefix[i] >= 'a' && gen->prefix[i] <= 'z' ? (char)(gen->prefix[i] - 'a' + 'A') : gen->prefix[i];
+    guard[i] = 0;
+
+    // Header.
+    fprintf(gen->h,
+        "/**\n"
+        " * %s Parser\n"
+        " *\n"
+        " * Description: Generated by jconfgen from %s; do not edit. Parses\n"
+        " *              documents of that shape into the structs below.\n"
+        " */\n\n"
+        "#ifndef __%s_JCONFGEN_H__\n"
+        "#define __%s_JCONFGEN_H__\n\n"
+        "#ifdef __cplusplus\n"
+        "extern \"C\" {\n"
+        "#endif\n\n"
+        "#include <jconf/parser.h>\n"
+        "#include <jconf/alloc.h>\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n\n", gen->camel, input, guard, guard);
+
+    for (type = gen->objects; type != NULL; type = type->next)
+        if (type != root)
+            gen_struct(gen, type);
+
+    if (root->kind == JGEN_OBJECT)
+        gen_struct(gen, root);
+    else
+        fprintf(gen->h, "typedef struct _%s\n{\n    %s* items;\n    size_t count;\n\n} %s;\n\n", gen->prefix, gen_ctype(root->element), gen->camel);
+
+    fprintf(gen->h,
+        "// Decodes a document into out (zeroed first). Strings and arrays are\n"
+        "// allocated with the allocator (NULL for the default); on error out is\n"
+        "// freed and the error is reported in jArgs.\n"
+        "int  %s_parse(const char*, size_t, %s*, const jAllocator*, jArgs*);\n"
+        "void %s_free(%s*, const jAllocator*);\n\n"
+        "#ifdef __cplusplus\n"
+        "}\n"
+        "#endif\n\n"
+        "#endif\n", gen->prefix, gen->camel, gen->prefix, gen->camel);
+
+    // Source.
+    fprintf(gen->c,
+        "/**\n"
+        " * %s Parser Implementation\n"
+        " *\n"
+        " * Description: Generated by jconfgen from %s; do not edit.\n"
+        " */\n\n"
+        "#include \"%s\"\n"
+        "#include <jconf/cursor.h>\n"
+        "#include <string.h>\n\n"
+        "// Forward declarations.\n", gen->camel, input, header);
+
+    for (type = gen->objects; type != NULL; type = type->next)
+    {
+        fprintf(gen->c, "static int  %s_parse_%s(jCursor*, %s*);\n", gen->prefix, type->func, type->name);
+        fprintf(gen->c, "static void %s_free_%s(%s*, const jAllocator*);\n", gen->prefix, type->func, type->name);
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        gen_array_func(func, elements[i]);
+        fprintf(gen->c, "static int  %s_parse_%s(jCursor*, %s**, size_t*);\n", gen->prefix, func, gen_ctype(elements[i]));
+        fprintf(gen->c, "static void %s_free_%s(%s*, size_t, const jAllocator*);\n", gen->prefix, func, gen_ctype(elements[i]));
+    }
+    fprintf(gen->c, "\n");
+
+    for (type = gen->objects; type != NULL; type = type->next)
+    {
+        gen_parse_struct(gen, type);
+        gen_free_struct(gen, type);
+    }
+
+    for (i = 0; i < n; i++)
+        gen_parse_array(gen, elements[i]);
+
+    fprintf(gen->c,
+        "int %s_parse(const char* buffer, size_t size, %s* out, const jAllocator* allocator, jArgs* args)\n"
+        "{\n"
+        "    jCursor c;\n\n"
+        "    memset(out, 0, sizeof(*out));\n"
+        "    jconf_cursor_init(&c, buffer, size, allocator, args);\n\n"
+        "    if (!jconf_cursor_space(&c))\n"
+        "        return 0;\n\n"
+        "    if (buffer[args->pos] != '%c')\n"
+        "    {\n"
+        "        args->e = JCONF_UNEXPECTED_TOK;\n"
+        "        return 0;\n"
+        "    }\n\n", gen->prefix, gen->camel, root->kind == JGEN_OBJECT ? '{' : '[');
+
+    if (root->kind == JGEN_OBJECT)
+        fprintf(gen->c, "    if (!%s_parse_root(&c, out))\n", gen->prefix);
+    else
+    {
+        gen_array_func(func, root->element);
+        fprintf(gen->c, "    if (!%s_parse_%s(&c, &out->items, &out->count))\n", gen->prefix, func);
+    }
+
+    fprintf(gen->c,
+        "    {\n"
+        "        %s_free(out, allocator);\n"
+        "        return 0;\n"
+        "    }\n\n"
+        "    return 1;\n"
+        "}\n\n"
+        "void %s_free(%s* out, const jAllocator* allocator)\n"
+        "{\n", gen->prefix, gen->prefix, gen->camel);
+
+    if (root->kind == JGEN_OBJECT)
+        fprintf(gen->c, "    %s_free_root(out, allocator);\n", gen->prefix);
+    else
+        fprintf(gen->c, "    %s_free_%s(out->items, out->count, allocator);\n", gen->prefix, func);
+
+    fprintf(gen->c, "    memset(out, 0, sizeof(*out));\n}\n");
+    free((void*)elements);
+}
+
+/**
+ * Load File
+ *
+ * Description: Loads a file into a dynamically allocated buffer.
+ *
+ * @param {resc}[out] // The source path.
+ * @param {len}[in]   // The length of the buffer.
+ * @returns           // The file content in a char buffer.
+ */
+static char* load_file(const char* resc, size_t* len)
+{
+    char* buffer;
+    FILE* file;
+    long length;
+
+    if ((file = fopen(resc, "rb")) == NULL || fseek(file, 0L, SEEK_END) || (length = ftell(file)) < 0 || fseek(file, 0L, SEEK_SET))
+        return NULL;
+
+    buffer = (char*)malloc(length + 1);
+    *len = fread(buffer, 1, length, file);
+    buffer[*len] = 0;
+
+    fclose(file);
+    return buffer;
+}
+
+/**
+ * Entry point
+ */
+int main(int argc, char* argv[])
+{
+    const char *input = NULL, *output = NULL, *header;
+    char path[1024];
+    int schema = 0, i;
+    jGenType* root;
+    jToken* token;
+    size_t length;
+    char* json;
+    jArgs args;
+    jGen gen;
+
+    memset(&gen, 0, sizeof(gen));
+    gen.prefix = "message";
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-s"))
+            schema = 1;
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc)
+            gen.prefix = argv[++i];
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+            output = argv[++i];
+        else
+            input = argv[i];
+    }
+
+    if (input == NULL)
+    {
+        fprintf(stderr, "usage: jconfgen [-s] [-p prefix] [-o path] input.json\n");
+        return 1;
+    }
+
+    gen_identifier(path, gen.prefix, strlen(gen.prefix), 0);
+    if (strcmp(path, gen.prefix) || strlen(gen.prefix) > 32)
+    {
+        fprintf(stderr, "jconfgen: the prefix must be a short C identifier.\n");
+        return 1;
+    }
+    gen_identifier(gen.camel, gen.prefix, strlen(gen.prefix), 1);
+
+    if ((json = load_file(input, &length)) == NULL)
+    {
+        fprintf(stderr, "jconfgen: cannot read %s.\n", input);
+        return 1;
+    }
+
+    if ((token = jconf_json2c(json, length, &args)) == NULL)
+    {
+        fprintf(stderr, "jconfgen: %s: error %d on line %lu.\n", input, args.e, (unsigned long)args.line);
+        return 1;
+    }
+
+    root = schema ? gen_schema(token) : gen_sample(NULL, token);
+    if (!gen_bound(root) || (root->kind != JGEN_OBJECT && root->kind != JGEN_ARRAY))
+    {
+        fprintf(stderr, "jconfgen: %s does not describe an object or an array of values of one type.\n", input);
+        return 1;
+    }
+
+    gen.last = &gen.objects;
+    gen_names(&gen, root, "");
+
+    // Write <path>.h and <path>.c.
+    output = output != NULL ? output : gen.prefix;
+    header = strrchr(output, '/') != NULL ? strrchr(output, '/') + 1 : output;
+
+    snprintf(path, sizeof(path), "%s.h", output);
+    gen.h = fopen(path, "w");
+    snprintf(path, sizeof(path), "%s.c", output);
+    gen.c = fopen(path, "w");
+
+    if (gen.h == NULL || gen.c == NULL)
+    {
+        fprintf(stderr, "jconfgen: cannot write %s.\n", path);
+        return 1;
+    }
+
+    snprintf(path, sizeof(path), "%s.h", header);
+    gen_emit(&gen, root, input, path);
+
+    fclose(gen.h);
+    fclose(gen.c);
+    gen_destroy(root);
+    jconf_free_token(token);
+    free(json);
+    return 0;
+}